@@ -3,6 +3,8 @@
 
 #include "AudioCommon/AudioCommon.h"
 
+#include <atomic>
+
 #include <fmt/chrono.h>
 #include <fmt/format.h>
 
@@ -26,6 +28,11 @@ namespace AudioCommon
 constexpr int AUDIO_VOLUME_MIN = 0;
 constexpr int AUDIO_VOLUME_MAX = 100;
 
+static std::string s_audio_dump_base_name;
+static std::atomic<u64> s_dsp_sample_count = 0;
+// In units of 1 / Mixer::FIXED_SAMPLE_RATE_DIVIDEND seconds.
+static std::atomic<u64> s_dsp_sample_ticks = 0;
+
 static std::unique_ptr<SoundStream> CreateSoundStreamForBackend(std::string_view backend)
 {
   if (backend == BACKEND_CUBEB)
@@ -66,6 +73,9 @@ void InitSoundStream(Core::System& system)
   }
 
   system.SetSoundStream(std::move(sound_stream));
+
+  s_dsp_sample_count.store(0);
+  s_dsp_sample_ticks.store(0);
 }
 
 void PostInitSoundStream(Core::System& system)
@@ -206,6 +216,10 @@ void SendAIBuffer(Core::System& system, const short* samples, unsigned int num_s
   if (mixer && samples)
   {
     mixer->PushSamples(samples, num_samples);
+
+    s_dsp_sample_count.fetch_add(num_samples, std::memory_order_relaxed);
+    s_dsp_sample_ticks.fetch_add(u64(num_samples) * mixer->GetDMAInputSampleRateDivisor(),
+                                 std::memory_order_relaxed);
   }
 }
 
@@ -213,19 +227,25 @@ void StartAudioDump(Core::System& system)
 {
   SoundStream* sound_stream = system.GetSoundStream();
 
-  std::time_t start_time = std::time(nullptr);
+  std::string base_name = s_audio_dump_base_name;
+  if (base_name.empty())
+  {
+    std::time_t start_time = std::time(nullptr);
 
-  std::string path_prefix = File::GetUserPath(D_DUMPAUDIO_IDX) + SConfig::GetInstance().GetGameID();
+    std::string path_prefix =
+        File::GetUserPath(D_DUMPAUDIO_IDX) + SConfig::GetInstance().GetGameID();
 
-  std::string base_name =
-      fmt::format("{}_{:%Y-%m-%d_%H-%M-%S}", path_prefix, fmt::localtime(start_time));
+    base_name = fmt::format("{}_{:%Y-%m-%d_%H-%M-%S}", path_prefix, fmt::localtime(start_time));
+  }
 
-  const std::string audio_file_name_dtk = fmt::format("{}_dtkdump.wav", base_name);
-  const std::string audio_file_name_dsp = fmt::format("{}_dspdump.wav", base_name);
+  const AudioDumpFormat format = Config::Get(Config::MAIN_DUMP_AUDIO_FORMAT);
+  const char* extension = format == AudioDumpFormat::FLAC ? "flac" : "wav";
+  const std::string audio_file_name_dtk = fmt::format("{}_dtkdump.{}", base_name, extension);
+  const std::string audio_file_name_dsp = fmt::format("{}_dspdump.{}", base_name, extension);
   File::CreateFullPath(audio_file_name_dtk);
   File::CreateFullPath(audio_file_name_dsp);
-  sound_stream->GetMixer()->StartLogDTKAudio(audio_file_name_dtk);
-  sound_stream->GetMixer()->StartLogDSPAudio(audio_file_name_dsp);
+  sound_stream->GetMixer()->StartLogDTKAudio(audio_file_name_dtk, format);
+  sound_stream->GetMixer()->StartLogDSPAudio(audio_file_name_dsp, format);
   system.SetAudioDumpStarted(true);
 }
 
@@ -240,6 +260,22 @@ void StopAudioDump(Core::System& system)
   system.SetAudioDumpStarted(false);
 }
 
+void SetAudioDumpBaseName(std::string base_name)
+{
+  s_audio_dump_base_name = std::move(base_name);
+}
+
+u64 GetDSPSampleCount()
+{
+  return s_dsp_sample_count.load(std::memory_order_relaxed);
+}
+
+double GetDSPAudioSeconds()
+{
+  return static_cast<double>(s_dsp_sample_ticks.load(std::memory_order_relaxed)) /
+         Mixer::FIXED_SAMPLE_RATE_DIVIDEND;
+}
+
 void IncreaseVolume(Core::System& system, unsigned short offset)
 {
   Config::SetBaseOrCurrent(Config::MAIN_AUDIO_MUTED, false);
@@ -10,6 +10,7 @@
 
 #include "AudioCommon/Enums.h"
 #include "AudioCommon/SoundStream.h"
+#include "Common/CommonTypes.h"
 
 class Mixer;
 
@@ -34,6 +35,13 @@ void SetSoundStreamRunning(Core::System& system, bool running);
 void SendAIBuffer(Core::System& system, const short* samples, unsigned int num_samples);
 void StartAudioDump(Core::System& system);
 void StopAudioDump(Core::System& system);
+// Makes audio dumps write to <base_name>_dtkdump.wav and <base_name>_dspdump.wav instead of
+// names derived from the game ID and the current time. An empty name restores the default.
+void SetAudioDumpBaseName(std::string base_name);
+// Number of samples that the emulated DSP has sent to the mixer since the sound stream was
+// initialized, and how many seconds of audio they make up. Safe to call from any thread.
+u64 GetDSPSampleCount();
+double GetDSPAudioSeconds();
 void IncreaseVolume(Core::System& system, unsigned short offset);
 void DecreaseVolume(Core::System& system, unsigned short offset);
 void ToggleMuteVolume(Core::System& system);
@@ -12,4 +12,16 @@ enum class DPL2Quality
   High = 2,
   Highest = 3
 };
+
+enum class ResamplerType
+{
+  Linear = 0,
+  WindowedSinc = 1
+};
+
+enum class AudioDumpFormat
+{
+  WAV = 0,
+  FLAC = 1
+};
 }  // namespace AudioCommon
@@ -0,0 +1,414 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "AudioCommon/FlacEncoder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+#include "Common/Assert.h"
+
+namespace AudioCommon
+{
+namespace
+{
+// Writes big endian bit fields, most significant bit first.
+class BitWriter
+{
+public:
+  explicit BitWriter(std::vector<u8>* out) : m_out(out) {}
+
+  // bits must be between 1 and 32.
+  void Write(u32 value, u32 bits)
+  {
+    m_accumulator = (m_accumulator << bits) | (value & (u64(-1) >> (64 - bits)));
+    m_pending_bits += bits;
+    while (m_pending_bits >= 8)
+    {
+      m_pending_bits -= 8;
+      m_out->push_back(static_cast<u8>(m_accumulator >> m_pending_bits));
+    }
+  }
+
+  void WriteSigned(s32 value, u32 bits) { Write(static_cast<u32>(value), bits); }
+
+  void WriteUnary(u32 zeros)
+  {
+    for (; zeros >= 32; zeros -= 32)
+      Write(0, 32);
+    Write(1, zeros + 1);
+  }
+
+  void AlignToByte()
+  {
+    if (m_pending_bits != 0)
+      Write(0, 8 - m_pending_bits);
+  }
+
+private:
+  std::vector<u8>* m_out;
+  u64 m_accumulator = 0;
+  u32 m_pending_bits = 0;
+};
+
+template <typename T, T Polynomial>
+constexpr std::array<T, 256> MakeCRCTable()
+{
+  constexpr u32 BITS = sizeof(T) * 8;
+  std::array<T, 256> table{};
+  for (u32 i = 0; i < 256; ++i)
+  {
+    T crc = static_cast<T>(i << (BITS - 8));
+    for (u32 j = 0; j < 8; ++j)
+      crc = static_cast<T>((crc & (T(1) << (BITS - 1))) ? (crc << 1) ^ Polynomial : crc << 1);
+    table[i] = crc;
+  }
+  return table;
+}
+
+constexpr auto CRC8_TABLE = MakeCRCTable<u8, 0x07>();
+constexpr auto CRC16_TABLE = MakeCRCTable<u16, 0x8005>();
+
+u8 ComputeCRC8(const u8* data, size_t size)
+{
+  u8 crc = 0;
+  for (size_t i = 0; i < size; ++i)
+    crc = CRC8_TABLE[crc ^ data[i]];
+  return crc;
+}
+
+u16 ComputeCRC16(const u8* data, size_t size)
+{
+  u16 crc = 0;
+  for (size_t i = 0; i < size; ++i)
+    crc = static_cast<u16>((crc << 8) ^ CRC16_TABLE[(crc >> 8) ^ data[i]]);
+  return crc;
+}
+
+// Residual of the fixed polynomial predictor of the given order at position i (which must be at
+// least order).
+s32 FixedResidual(const s32* x, u32 i, u32 order)
+{
+  switch (order)
+  {
+  case 0:
+    return x[i];
+  case 1:
+    return x[i] - x[i - 1];
+  case 2:
+    return x[i] - 2 * x[i - 1] + x[i - 2];
+  case 3:
+    return x[i] - 3 * x[i - 1] + 3 * x[i - 2] - x[i - 3];
+  default:
+    return x[i] - 4 * x[i - 1] + 6 * x[i - 2] - 4 * x[i - 3] + x[i - 4];
+  }
+}
+
+// Maps signed residuals to unsigned values for Rice coding: 0, -1, 1, -2, 2...
+u32 FoldResidual(s32 residual)
+{
+  return static_cast<u32>(residual << 1) ^ static_cast<u32>(residual >> 31);
+}
+
+constexpr u32 MAX_ORDER = 4;
+constexpr u32 MAX_PARTITION_ORDER = 8;
+
+struct Subframe
+{
+  enum class Type
+  {
+    Constant,
+    Verbatim,
+    Fixed,
+  };
+
+  Type type = Type::Verbatim;
+  u32 order = 0;
+  u32 partition_order = 0;
+  std::array<u8, 1 << MAX_PARTITION_ORDER> rice_parameters{};
+  u64 bits = 0;
+};
+
+// Parameters above 14 need the 5-bit parameter coding method. They are never worth it for 16-bit
+// audio, so clamp to what fits in 4 bits.
+constexpr u32 MAX_RICE_PARAMETER = 14;
+
+// Estimated size of a Rice coded partition of count values that add up to sum, and the
+// parameter that gives that size.
+std::pair<u64, u32> EstimateRiceSize(u64 sum, u32 count)
+{
+  u64 best_bits = std::numeric_limits<u64>::max();
+  u32 best_parameter = 0;
+  for (u32 parameter = 0; parameter <= MAX_RICE_PARAMETER; ++parameter)
+  {
+    const u64 bits = u64{count} * (parameter + 1) + (sum >> parameter);
+    if (bits < best_bits)
+    {
+      best_bits = bits;
+      best_parameter = parameter;
+    }
+  }
+  return {best_bits, best_parameter};
+}
+
+// Picks the cheapest way to code a subframe, based on estimated sizes.
+Subframe AnalyzeSubframe(const s32* x, u32 count, u32 bits_per_sample)
+{
+  Subframe verbatim;
+  verbatim.type = Subframe::Type::Verbatim;
+  verbatim.bits = 8 + u64{count} * bits_per_sample;
+
+  if (std::all_of(x, x + count, [&](s32 sample) { return sample == x[0]; }))
+  {
+    Subframe constant;
+    constant.type = Subframe::Type::Constant;
+    constant.bits = 8 + bits_per_sample;
+    return constant;
+  }
+
+  if (count <= 2 * MAX_ORDER)
+    return verbatim;
+
+  // Pick the predictor that minimizes the total magnitude of the residual.
+  u32 order = 0;
+  u64 best_sum = std::numeric_limits<u64>::max();
+  for (u32 candidate = 0; candidate <= MAX_ORDER; ++candidate)
+  {
+    u64 sum = 0;
+    for (u32 i = MAX_ORDER; i < count; ++i)
+      sum += static_cast<u32>(std::abs(FixedResidual(x, i, candidate)));
+    if (sum < best_sum)
+    {
+      best_sum = sum;
+      order = candidate;
+    }
+  }
+
+  // Sums of the partitions at the highest partition order that the block size allows. Lower
+  // orders are estimated by merging neighboring partitions.
+  u32 max_partition_order = 0;
+  while (max_partition_order < MAX_PARTITION_ORDER &&
+         (count & ((2u << max_partition_order) - 1)) == 0 &&
+         (count >> (max_partition_order + 1)) > order)
+  {
+    ++max_partition_order;
+  }
+
+  std::array<u64, 1 << MAX_PARTITION_ORDER> sums{};
+  const u32 finest_size = count >> max_partition_order;
+  for (u32 partition = 0; partition < (1u << max_partition_order); ++partition)
+  {
+    const u32 begin = std::max(partition * finest_size, order);
+    const u32 end = (partition + 1) * finest_size;
+    for (u32 i = begin; i < end; ++i)
+      sums[partition] += FoldResidual(FixedResidual(x, i, order));
+  }
+
+  Subframe best;
+  best.type = Subframe::Type::Fixed;
+  best.order = order;
+  best.bits = std::numeric_limits<u64>::max();
+  for (u32 partition_order = max_partition_order + 1; partition_order-- > 0;)
+  {
+    const u32 partitions = 1u << partition_order;
+    const u32 partition_size = count >> partition_order;
+
+    Subframe candidate = best;
+    candidate.partition_order = partition_order;
+    candidate.bits = 8 + u64{order} * bits_per_sample + 2 + 4;
+    for (u32 partition = 0; partition < partitions; ++partition)
+    {
+      const u32 values = partition == 0 ? partition_size - order : partition_size;
+      const auto [bits, parameter] = EstimateRiceSize(sums[partition], values);
+      candidate.rice_parameters[partition] = static_cast<u8>(parameter);
+      candidate.bits += 4 + bits;
+    }
+
+    if (candidate.bits < best.bits)
+      best = candidate;
+
+    // Merge pairs of partitions for the next lower order.
+    for (u32 partition = 0; partition < partitions / 2; ++partition)
+      sums[partition] = sums[2 * partition] + sums[2 * partition + 1];
+  }
+
+  return best.bits < verbatim.bits ? best : verbatim;
+}
+
+void WriteSubframe(BitWriter* writer, const s32* x, u32 count, u32 bits_per_sample,
+                   const Subframe& subframe)
+{
+  using Type = Subframe::Type;
+
+  // Zero padding bit, then the type, then no wasted bits.
+  switch (subframe.type)
+  {
+  case Type::Constant:
+    writer->Write(0b00000000, 8);
+    writer->WriteSigned(x[0], bits_per_sample);
+    return;
+  case Type::Verbatim:
+    writer->Write(0b00000010, 8);
+    for (u32 i = 0; i < count; ++i)
+      writer->WriteSigned(x[i], bits_per_sample);
+    return;
+  case Type::Fixed:
+    break;
+  }
+
+  const u32 order = subframe.order;
+  writer->Write((0b001000 | order) << 1, 8);
+  for (u32 i = 0; i < order; ++i)
+    writer->WriteSigned(x[i], bits_per_sample);
+
+  // 4-bit Rice parameters
+  writer->Write(0b00, 2);
+  writer->Write(subframe.partition_order, 4);
+
+  const u32 partitions = 1u << subframe.partition_order;
+  const u32 partition_size = count >> subframe.partition_order;
+  u32 i = order;
+  for (u32 partition = 0; partition < partitions; ++partition)
+  {
+    const u32 parameter = subframe.rice_parameters[partition];
+    writer->Write(parameter, 4);
+
+    const u32 end = (partition + 1) * partition_size;
+    for (; i < end; ++i)
+    {
+      const u32 value = FoldResidual(FixedResidual(x, i, order));
+      writer->WriteUnary(value >> parameter);
+      if (parameter != 0)
+        writer->Write(value, parameter);
+    }
+  }
+}
+
+void WriteUTF8(BitWriter* writer, u32 value)
+{
+  if (value < 0x80)
+  {
+    writer->Write(value, 8);
+    return;
+  }
+
+  // Number of continuation bytes, which hold 6 bits each.
+  u32 continuation_bytes = 1;
+  while (continuation_bytes < 5 && value >= (1u << (5 * continuation_bytes + 6)))
+    ++continuation_bytes;
+
+  const u32 lead_marker = (0xFF00 >> (continuation_bytes + 1)) & 0xFF;
+  writer->Write(lead_marker | (value >> (6 * continuation_bytes)), 8);
+  for (u32 i = continuation_bytes; i-- > 0;)
+    writer->Write(0x80 | ((value >> (6 * i)) & 0x3F), 8);
+}
+}  // namespace
+
+FlacEncoder::FlacEncoder(u32 sample_rate) : m_sample_rate(sample_rate)
+{
+  for (std::vector<s32>& signal : m_signals)
+    signal.resize(BLOCK_SIZE);
+}
+
+void FlacEncoder::WriteHeader(std::vector<u8>* out) const
+{
+  const size_t start = out->size();
+  BitWriter writer(out);
+
+  writer.Write('f', 8);
+  writer.Write('L', 8);
+  writer.Write('a', 8);
+  writer.Write('C', 8);
+
+  // Last metadata block, type STREAMINFO, 34 bytes long
+  writer.Write(0x80, 8);
+  writer.Write(34, 24);
+
+  writer.Write(BLOCK_SIZE, 16);
+  writer.Write(BLOCK_SIZE, 16);
+  writer.Write(m_min_frame_size, 24);
+  writer.Write(m_max_frame_size, 24);
+  writer.Write(m_sample_rate, 20);
+  writer.Write(2 - 1, 3);
+  writer.Write(16 - 1, 5);
+  writer.Write(static_cast<u32>(m_total_samples >> 32), 4);
+  writer.Write(static_cast<u32>(m_total_samples), 32);
+  // Unknown MD5 signature
+  for (u32 i = 0; i < 4; ++i)
+    writer.Write(0, 32);
+
+  ASSERT(out->size() - start == HEADER_SIZE);
+}
+
+void FlacEncoder::EncodeFrame(const s16* samples, u32 count, std::vector<u8>* out)
+{
+  ASSERT(count > 0 && count <= BLOCK_SIZE);
+
+  auto& [left, right, mid, side] = m_signals;
+  for (u32 i = 0; i < count; ++i)
+  {
+    left[i] = samples[2 * i];
+    right[i] = samples[2 * i + 1];
+    mid[i] = (left[i] + right[i]) >> 1;
+    side[i] = left[i] - right[i];
+  }
+
+  const Subframe left_subframe = AnalyzeSubframe(left.data(), count, 16);
+  const Subframe right_subframe = AnalyzeSubframe(right.data(), count, 16);
+  const Subframe mid_subframe = AnalyzeSubframe(mid.data(), count, 16);
+  const Subframe side_subframe = AnalyzeSubframe(side.data(), count, 17);
+
+  struct ChannelMode
+  {
+    u32 assignment;
+    const std::vector<s32>* signals[2];
+    const Subframe* subframes[2];
+    u32 bits_per_sample[2];
+  };
+  const ChannelMode modes[] = {
+      {0b0001, {&left, &right}, {&left_subframe, &right_subframe}, {16, 16}},
+      {0b1000, {&left, &side}, {&left_subframe, &side_subframe}, {16, 17}},
+      {0b1001, {&side, &right}, {&side_subframe, &right_subframe}, {17, 16}},
+      {0b1010, {&mid, &side}, {&mid_subframe, &side_subframe}, {16, 17}},
+  };
+  const ChannelMode& mode = *std::min_element(
+      std::begin(modes), std::end(modes), [](const ChannelMode& a, const ChannelMode& b) {
+        return a.subframes[0]->bits + a.subframes[1]->bits <
+               b.subframes[0]->bits + b.subframes[1]->bits;
+      });
+
+  const size_t start = out->size();
+  BitWriter writer(out);
+
+  // Sync code, fixed block size
+  writer.Write(0xFFF8, 16);
+  // 4096 samples, or an explicit 16-bit size for the last frame
+  writer.Write(count == BLOCK_SIZE ? 0b1100 : 0b0111, 4);
+  // Sample rate from STREAMINFO
+  writer.Write(0b0000, 4);
+  writer.Write(mode.assignment, 4);
+  // 16 bits per sample
+  writer.Write(0b100, 3);
+  writer.Write(0, 1);
+  WriteUTF8(&writer, m_frame_number);
+  if (count != BLOCK_SIZE)
+    writer.Write(count - 1, 16);
+  writer.Write(ComputeCRC8(out->data() + start, out->size() - start), 8);
+
+  for (u32 channel = 0; channel < 2; ++channel)
+  {
+    WriteSubframe(&writer, mode.signals[channel]->data(), count, mode.bits_per_sample[channel],
+                  *mode.subframes[channel]);
+  }
+  writer.AlignToByte();
+  const u16 crc = ComputeCRC16(out->data() + start, out->size() - start);
+  writer.Write(crc, 16);
+
+  const u32 frame_size = static_cast<u32>(out->size() - start);
+  m_min_frame_size = m_frame_number == 0 ? frame_size : std::min(m_min_frame_size, frame_size);
+  m_max_frame_size = std::max(m_max_frame_size, frame_size);
+  m_total_samples += count;
+  ++m_frame_number;
+}
+}  // namespace AudioCommon
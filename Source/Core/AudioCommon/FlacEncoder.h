@@ -0,0 +1,47 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace AudioCommon
+{
+// Minimal FLAC encoder for 16-bit stereo audio dumps. Every frame picks the best of the four
+// stereo decorrelation modes and the fixed polynomial predictors of order 0 to 4, and codes the
+// residual with partitioned Rice codes. The MD5 signature of the stream is left unset, which the
+// format allows.
+class FlacEncoder
+{
+public:
+  static constexpr u32 BLOCK_SIZE = 4096;
+  // Size of the "fLaC" marker and the STREAMINFO metadata block.
+  static constexpr size_t HEADER_SIZE = 42;
+
+  explicit FlacEncoder(u32 sample_rate);
+
+  // Appends the stream header to out. Since it contains the total number of samples and the
+  // frame sizes, it should be written again at the start of the file once all frames have been
+  // encoded. Its size doesn't change.
+  void WriteHeader(std::vector<u8>* out) const;
+
+  // Encodes count interleaved left/right sample pairs as one frame and appends it to out. count
+  // must be BLOCK_SIZE for every frame but the last one.
+  void EncodeFrame(const s16* samples, u32 count, std::vector<u8>* out);
+
+  u64 GetTotalSamples() const { return m_total_samples; }
+
+private:
+  u32 m_sample_rate;
+  u32 m_frame_number = 0;
+  u64 m_total_samples = 0;
+  u32 m_min_frame_size = 0;
+  u32 m_max_frame_size = 0;
+
+  // Left, right, mid and side signals of the current frame.
+  std::array<std::vector<s32>, 4> m_signals;
+};
+}  // namespace AudioCommon
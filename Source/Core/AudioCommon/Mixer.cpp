@@ -12,6 +12,7 @@
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/Swap.h"
+#include "Common/Thread.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 #include "VideoCommon/PerformanceMetrics.h"
@@ -44,6 +45,13 @@ Mixer::Mixer(unsigned int BackendSampleRate)
 
 Mixer::~Mixer()
 {
+  if (m_stretch_thread.joinable())
+  {
+    m_stretch_thread_running.Clear();
+    m_stretch_event.Set();
+    m_stretch_thread.join();
+  }
+
   Config::RemoveConfigChangedCallback(m_config_changed_callback_id);
 }
 
@@ -107,21 +115,11 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
     return m_little_endian ? m_buffer[index] : Common::swap16(m_buffer[index]);
   };
 
-  // TODO: consider a higher-quality resampling algorithm.
-  for (; currentSample < numSamples * 2 && ((indexW - indexR) & INDEX_MASK) > 2; currentSample += 2)
-  {
-    u32 indexR2 = indexR + 2;  // next sample
-
-    s16 l1 = read_buffer(indexR & INDEX_MASK);   // current
-    s16 l2 = read_buffer(indexR2 & INDEX_MASK);  // next
-    int sampleL = ((l1 << 16) + (l2 - l1) * (u16)m_frac) >> 16;
+  const auto mix_sample = [&](int sampleL, int sampleR) {
     sampleL = (sampleL * lvolume) >> 8;
     sampleL += samples[currentSample + 1];
     samples[currentSample + 1] = std::clamp(sampleL, -32767, 32767);
 
-    s16 r1 = read_buffer((indexR + 1) & INDEX_MASK);   // current
-    s16 r2 = read_buffer((indexR2 + 1) & INDEX_MASK);  // next
-    int sampleR = ((r1 << 16) + (r2 - r1) * (u16)m_frac) >> 16;
     sampleR = (sampleR * rvolume) >> 8;
     sampleR += samples[currentSample];
     samples[currentSample] = std::clamp(sampleR, -32767, 32767);
@@ -129,6 +127,54 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
     m_frac += ratio;
     indexR += 2 * (u16)(m_frac >> 16);
     m_frac &= 0xffff;
+  };
+
+  if (m_resampler.load() == AudioCommon::ResamplerType::WindowedSinc)
+  {
+    using AudioCommon::SincFilterBank;
+
+    m_sinc_filter.SetRates(FIXED_SAMPLE_RATE_DIVIDEND / double(m_input_sample_rate_divisor),
+                           m_mixer->m_sampleRate);
+
+    const auto to_s16 = [](float sample) {
+      return std::clamp(static_cast<int>(std::lrint(sample)), -32768, 32767);
+    };
+
+    for (; currentSample < numSamples * 2 &&
+           ((indexW - indexR) & INDEX_MASK) > SincFilterBank::LOOKAHEAD * 2;
+         currentSample += 2)
+    {
+      alignas(16) std::array<float, SincFilterBank::TAPS> left;
+      alignas(16) std::array<float, SincFilterBank::TAPS> right;
+      u32 index = indexR - SincFilterBank::HISTORY * 2;
+      for (u32 i = 0; i < SincFilterBank::TAPS; ++i, index += 2)
+      {
+        left[i] = read_buffer(index & INDEX_MASK);
+        right[i] = read_buffer((index + 1) & INDEX_MASK);
+      }
+
+      const auto [sampleL, sampleR] =
+          m_sinc_filter.Interpolate(left.data(), right.data(), static_cast<u16>(m_frac));
+      mix_sample(to_s16(sampleL), to_s16(sampleR));
+    }
+  }
+  else
+  {
+    for (; currentSample < numSamples * 2 && ((indexW - indexR) & INDEX_MASK) > 2;
+         currentSample += 2)
+    {
+      u32 indexR2 = indexR + 2;  // next sample
+
+      s16 l1 = read_buffer(indexR & INDEX_MASK);   // current
+      s16 l2 = read_buffer(indexR2 & INDEX_MASK);  // next
+      int sampleL = ((l1 << 16) + (l2 - l1) * (u16)m_frac) >> 16;
+
+      s16 r1 = read_buffer((indexR + 1) & INDEX_MASK);   // current
+      s16 r2 = read_buffer((indexR2 + 1) & INDEX_MASK);  // next
+      int sampleR = ((r1 << 16) + (r2 - r1) * (u16)m_frac) >> 16;
+
+      mix_sample(sampleL, sampleR);
+    }
   }
 
   // Actual number of samples written to the buffer without padding.
@@ -162,56 +208,111 @@ unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
 
   memset(samples, 0, num_samples * 2 * sizeof(short));
 
+  if (m_config_audio_stretch)
+  {
+    if (!m_stretch_active.load())
+    {
+      if (!m_stretch_thread.joinable())
+        m_stretch_thread = std::thread(&Mixer::StretchThread, this);
+
+      m_stretched_samples.Clear();
+      m_stretch_active.store(true);
+    }
+    m_stretch_request.store(num_samples);
+
+    const size_t popped = m_stretched_samples.Pop(samples, num_samples * 2);
+    if (popped != 0)
+      m_last_stretched_sample = {samples[popped - 2], samples[popped - 1]};
+
+    // Pad with the last sample if the stretching thread has fallen behind.
+    for (size_t i = popped; i < num_samples * 2; i += 2)
+    {
+      samples[i] = m_last_stretched_sample[0];
+      samples[i + 1] = m_last_stretched_sample[1];
+    }
+
+    m_stretch_event.Set();
+    return num_samples;
+  }
+
+  // Make sure that the stretching thread isn't reading from the FIFOs anymore before mixing them
+  // here. This only outputs silence for the callback during which stretching was disabled.
+  m_stretch_active.store(false);
+  if (m_stretch_busy.load())
+    return num_samples;
+
   // TODO: Determine how emulation speed will be used in audio
   // const float emulation_speed = g_perf_metrics.GetSpeed();
   const float emulation_speed = m_config_emulation_speed;
   const int timing_variance = m_config_timing_variance;
-  if (m_config_audio_stretch)
+  m_dma_mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
+  m_streaming_mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
+  m_wiimote_speaker_mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
+  m_skylander_portal_mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
+  for (auto& mixer : m_gba_mixers)
+    mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
+
+  return num_samples;
+}
+
+void Mixer::StretchThread()
+{
+  Common::SetCurrentThreadName("Audio Stretching");
+
+  while (m_stretch_thread_running.IsSet())
   {
-    unsigned int available_samples =
-        std::min(m_dma_mixer.AvailableSamples(), m_streaming_mixer.AvailableSamples());
-
-    ASSERT_MSG(AUDIO, available_samples <= MAX_SAMPLES,
-               "Audio stretching would overflow m_scratch_buffer: min({}, {}) -> {} > {} ({})",
-               m_dma_mixer.AvailableSamples(), m_streaming_mixer.AvailableSamples(),
-               available_samples, MAX_SAMPLES, num_samples);
-
-    m_scratch_buffer.fill(0);
-
-    m_dma_mixer.Mix(m_scratch_buffer.data(), available_samples, false, emulation_speed,
-                    timing_variance);
-    m_streaming_mixer.Mix(m_scratch_buffer.data(), available_samples, false, emulation_speed,
-                          timing_variance);
-    m_wiimote_speaker_mixer.Mix(m_scratch_buffer.data(), available_samples, false, emulation_speed,
-                                timing_variance);
-    m_skylander_portal_mixer.Mix(m_scratch_buffer.data(), available_samples, false, emulation_speed,
-                                 timing_variance);
-    for (auto& mixer : m_gba_mixers)
+    m_stretch_event.Wait();
+
+    m_stretch_busy.store(true);
+    if (m_stretch_active.load())
     {
-      mixer.Mix(m_scratch_buffer.data(), available_samples, false, emulation_speed,
-                timing_variance);
+      // Keep two callbacks' worth of samples buffered, so that the audio thread still has
+      // samples to copy if it runs again before this thread has been scheduled.
+      const u32 target = std::min(m_stretch_request.load() * 2, MAX_SAMPLES);
+      const u32 buffered = static_cast<u32>(m_stretched_samples.Size() / 2);
+      if (buffered < target)
+        StretchSamples(target - buffered);
     }
-
-    if (!m_is_stretching)
+    else
     {
-      m_stretcher.Clear();
-      m_is_stretching = true;
+      m_is_stretching = false;
     }
-    m_stretcher.ProcessSamples(m_scratch_buffer.data(), available_samples, num_samples);
-    m_stretcher.GetStretchedSamples(samples, num_samples);
+    m_stretch_busy.store(false);
   }
-  else
+}
+
+void Mixer::StretchSamples(unsigned int num_samples)
+{
+  const float emulation_speed = m_config_emulation_speed;
+  const int timing_variance = m_config_timing_variance;
+
+  unsigned int available_samples =
+      std::min(m_dma_mixer.AvailableSamples(), m_streaming_mixer.AvailableSamples());
+
+  ASSERT_MSG(AUDIO, available_samples <= MAX_SAMPLES,
+             "Audio stretching would overflow m_stretch_input_buffer: min({}, {}) -> {} > {} ({})",
+             m_dma_mixer.AvailableSamples(), m_streaming_mixer.AvailableSamples(),
+             available_samples, MAX_SAMPLES, num_samples);
+
+  m_stretch_input_buffer.fill(0);
+
+  short* const buffer = m_stretch_input_buffer.data();
+  m_dma_mixer.Mix(buffer, available_samples, false, emulation_speed, timing_variance);
+  m_streaming_mixer.Mix(buffer, available_samples, false, emulation_speed, timing_variance);
+  m_wiimote_speaker_mixer.Mix(buffer, available_samples, false, emulation_speed, timing_variance);
+  m_skylander_portal_mixer.Mix(buffer, available_samples, false, emulation_speed,
+                               timing_variance);
+  for (auto& mixer : m_gba_mixers)
+    mixer.Mix(buffer, available_samples, false, emulation_speed, timing_variance);
+
+  if (!m_is_stretching)
   {
-    m_dma_mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
-    m_streaming_mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
-    m_wiimote_speaker_mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
-    m_skylander_portal_mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
-    for (auto& mixer : m_gba_mixers)
-      mixer.Mix(samples, num_samples, true, emulation_speed, timing_variance);
-    m_is_stretching = false;
+    m_stretcher.Clear();
+    m_is_stretching = true;
   }
-
-  return num_samples;
+  m_stretcher.ProcessSamples(buffer, available_samples, num_samples);
+  m_stretcher.GetStretchedSamples(m_stretch_output_buffer.data(), num_samples);
+  m_stretched_samples.Push(m_stretch_output_buffer.data(), num_samples * 2);
 }
 
 unsigned int Mixer::MixSurround(float* samples, unsigned int num_samples)
@@ -223,8 +324,6 @@ unsigned int Mixer::MixSurround(float* samples, unsigned int num_samples)
 
   size_t needed_frames = m_surround_decoder.QueryFramesNeededForSurroundOutput(num_samples);
 
-  // Mix() may also use m_scratch_buffer internally, but is safe because it alternates reads
-  // and writes.
   ASSERT_MSG(AUDIO, needed_frames <= MAX_SAMPLES,
              "needed_frames would overflow m_scratch_buffer: {} -> {} > {}", num_samples,
              needed_frames, MAX_SAMPLES);
@@ -252,7 +351,8 @@ void Mixer::MixerFifo::PushSamples(const short* samples, unsigned int num_sample
 
   // Check if we have enough free space
   // indexW == m_indexR results in empty buffer, so indexR must always be smaller than indexW
-  if (num_samples * 2 + ((indexW - m_indexR.load()) & INDEX_MASK) >= MAX_SAMPLES * 2)
+  const u32 used = ((indexW - m_indexR.load()) & INDEX_MASK) + HISTORY_SAMPLES * 2;
+  if (num_samples * 2 + used >= MAX_SAMPLES * 2)
     return;
 
   // AyuanX: Actual re-sampling work has been moved to sound thread
@@ -354,6 +454,11 @@ void Mixer::SetDMAInputSampleRateDivisor(unsigned int rate_divisor)
   m_dma_mixer.SetInputSampleRateDivisor(rate_divisor);
 }
 
+unsigned int Mixer::GetDMAInputSampleRateDivisor() const
+{
+  return m_dma_mixer.GetInputSampleRateDivisor();
+}
+
 void Mixer::SetStreamInputSampleRateDivisor(unsigned int rate_divisor)
 {
   m_streaming_mixer.SetInputSampleRateDivisor(rate_divisor);
@@ -379,11 +484,12 @@ void Mixer::SetGBAVolume(int device_number, unsigned int lvolume, unsigned int r
   m_gba_mixers[device_number].SetVolume(lvolume, rvolume);
 }
 
-void Mixer::StartLogDTKAudio(const std::string& filename)
+void Mixer::StartLogDTKAudio(const std::string& filename, AudioCommon::AudioDumpFormat format)
 {
   if (!m_log_dtk_audio)
   {
-    bool success = m_wave_writer_dtk.Start(filename, m_streaming_mixer.GetInputSampleRateDivisor());
+    bool success =
+        m_wave_writer_dtk.Start(filename, m_streaming_mixer.GetInputSampleRateDivisor(), format);
     if (success)
     {
       m_log_dtk_audio = true;
@@ -416,11 +522,12 @@ void Mixer::StopLogDTKAudio()
   }
 }
 
-void Mixer::StartLogDSPAudio(const std::string& filename)
+void Mixer::StartLogDSPAudio(const std::string& filename, AudioCommon::AudioDumpFormat format)
 {
   if (!m_log_dsp_audio)
   {
-    bool success = m_wave_writer_dsp.Start(filename, m_dma_mixer.GetInputSampleRateDivisor());
+    bool success =
+        m_wave_writer_dsp.Start(filename, m_dma_mixer.GetInputSampleRateDivisor(), format);
     if (success)
     {
       m_log_dsp_audio = true;
@@ -458,6 +565,14 @@ void Mixer::RefreshConfig()
   m_config_emulation_speed = Config::Get(Config::MAIN_EMULATION_SPEED);
   m_config_timing_variance = Config::Get(Config::MAIN_TIMING_VARIANCE);
   m_config_audio_stretch = Config::Get(Config::MAIN_AUDIO_STRETCH);
+
+  const AudioCommon::ResamplerType resampler = Config::Get(Config::MAIN_AUDIO_RESAMPLER);
+  m_dma_mixer.SetResampler(resampler);
+  m_streaming_mixer.SetResampler(resampler);
+  m_wiimote_speaker_mixer.SetResampler(resampler);
+  m_skylander_portal_mixer.SetResampler(resampler);
+  for (auto& mixer : m_gba_mixers)
+    mixer.SetResampler(resampler);
 }
 
 void Mixer::MixerFifo::DoState(PointerWrap& p)
@@ -488,11 +603,25 @@ std::pair<s32, s32> Mixer::MixerFifo::GetVolume() const
   return std::make_pair(m_LVolume.load(), m_RVolume.load());
 }
 
+void Mixer::MixerFifo::SetResampler(AudioCommon::ResamplerType resampler)
+{
+  m_resampler.store(resampler);
+}
+
+u32 Mixer::MixerFifo::GetLookaheadSamples() const
+{
+  if (m_resampler.load() == AudioCommon::ResamplerType::WindowedSinc)
+    return AudioCommon::SincFilterBank::LOOKAHEAD;
+  return 1;
+}
+
 unsigned int Mixer::MixerFifo::AvailableSamples() const
 {
+  // Mixer::MixerFifo::Mix always keeps the samples that the resampler looks ahead at in the buffer.
+  const u32 lookahead = GetLookaheadSamples();
   unsigned int samples_in_fifo = ((m_indexW.load() - m_indexR.load()) & INDEX_MASK) / 2;
-  if (samples_in_fifo <= 1)
-    return 0;  // Mixer::MixerFifo::Mix always keeps one sample in the buffer.
-  return (samples_in_fifo - 1) * static_cast<u64>(m_mixer->m_sampleRate) *
+  if (samples_in_fifo <= lookahead)
+    return 0;
+  return (samples_in_fifo - lookahead) * static_cast<u64>(m_mixer->m_sampleRate) *
          m_input_sample_rate_divisor / FIXED_SAMPLE_RATE_DIVIDEND;
 }
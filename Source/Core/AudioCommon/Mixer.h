@@ -5,12 +5,18 @@
 
 #include <array>
 #include <atomic>
+#include <thread>
 
 #include "AudioCommon/AudioStretcher.h"
+#include "AudioCommon/Enums.h"
+#include "AudioCommon/SincFilterBank.h"
 #include "AudioCommon/SurroundDecoder.h"
 #include "AudioCommon/WaveFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Config/Config.h"
+#include "Common/Event.h"
+#include "Common/Flag.h"
+#include "Common/SPSCQueue.h"
 
 class PointerWrap;
 
@@ -37,6 +43,7 @@ public:
   unsigned int GetSampleRate() const { return m_sampleRate; }
 
   void SetDMAInputSampleRateDivisor(unsigned int rate_divisor);
+  unsigned int GetDMAInputSampleRateDivisor() const;
   void SetStreamInputSampleRateDivisor(unsigned int rate_divisor);
   void SetGBAInputSampleRateDivisors(int device_number, unsigned int rate_divisor);
 
@@ -44,10 +51,10 @@ public:
   void SetWiimoteSpeakerVolume(unsigned int lvolume, unsigned int rvolume);
   void SetGBAVolume(int device_number, unsigned int lvolume, unsigned int rvolume);
 
-  void StartLogDTKAudio(const std::string& filename);
+  void StartLogDTKAudio(const std::string& filename, AudioCommon::AudioDumpFormat format);
   void StopLogDTKAudio();
 
-  void StartLogDSPAudio(const std::string& filename);
+  void StartLogDSPAudio(const std::string& filename, AudioCommon::AudioDumpFormat format);
   void StopLogDSPAudio();
 
   // 54000000 doesn't work here as it doesn't evenly divide with 32000, but 108000000 does
@@ -78,9 +85,16 @@ private:
     unsigned int GetInputSampleRateDivisor() const;
     void SetVolume(unsigned int lvolume, unsigned int rvolume);
     std::pair<s32, s32> GetVolume() const;
+    void SetResampler(AudioCommon::ResamplerType resampler);
     unsigned int AvailableSamples() const;
 
   private:
+    // Samples before m_indexR that the windowed-sinc resampler still reads. PushSamples doesn't
+    // overwrite them.
+    static constexpr u32 HISTORY_SAMPLES = AudioCommon::SincFilterBank::HISTORY;
+
+    u32 GetLookaheadSamples() const;
+
     Mixer* m_mixer;
     unsigned m_input_sample_rate_divisor;
     bool m_little_endian;
@@ -92,10 +106,15 @@ private:
     std::atomic<s32> m_RVolume{256};
     float m_numLeftI = 0.0f;
     u32 m_frac = 0;
+    std::atomic<AudioCommon::ResamplerType> m_resampler{AudioCommon::ResamplerType::Linear};
+    AudioCommon::SincFilterBank m_sinc_filter;
   };
 
   void RefreshConfig();
 
+  void StretchThread();
+  void StretchSamples(unsigned int num_samples);
+
   MixerFifo m_dma_mixer{this, FIXED_SAMPLE_RATE_DIVIDEND / 32000, false};
   MixerFifo m_streaming_mixer{this, FIXED_SAMPLE_RATE_DIVIDEND / 48000, false};
   MixerFifo m_wiimote_speaker_mixer{this, FIXED_SAMPLE_RATE_DIVIDEND / 3000, true};
@@ -106,8 +125,27 @@ private:
                                         MixerFifo{this, FIXED_SAMPLE_RATE_DIVIDEND / 48000, true}};
   unsigned int m_sampleRate;
 
+  // Audio stretching runs on its own thread. It keeps m_stretched_samples filled, so all the audio
+  // thread has to do while stretching is copy samples out of it. The audio thread starts it the
+  // first time stretching is enabled, and it's kept until the mixer is destroyed.
+  std::thread m_stretch_thread;
+  Common::Flag m_stretch_thread_running{true};
+  Common::Event m_stretch_event;
+  // Set by the audio thread while it takes its samples from m_stretched_samples, so that only
+  // the stretching thread reads from the FIFOs. m_stretch_busy is set while that thread works.
+  std::atomic<bool> m_stretch_active{false};
+  std::atomic<bool> m_stretch_busy{false};
+  // Number of samples the audio thread asked for the last time.
+  std::atomic<u32> m_stretch_request{0};
+  Common::SPSCRingBuffer<short, MAX_SAMPLES * 2> m_stretched_samples;
+  std::array<short, 2> m_last_stretched_sample{};
+
+  // Only used by the stretching thread.
   bool m_is_stretching = false;
   AudioCommon::AudioStretcher m_stretcher;
+  std::array<short, MAX_SAMPLES * 2> m_stretch_input_buffer{};
+  std::array<short, MAX_SAMPLES * 2> m_stretch_output_buffer{};
+
   AudioCommon::SurroundDecoder m_surround_decoder;
   std::array<short, MAX_SAMPLES * 2> m_scratch_buffer{};
 
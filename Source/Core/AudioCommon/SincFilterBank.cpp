@@ -0,0 +1,118 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "AudioCommon/SincFilterBank.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X86_64)
+#include <emmintrin.h>
+#elif defined(_M_ARM_64)
+#include <arm_neon.h>
+#endif
+
+#include "Common/MathUtil.h"
+
+namespace AudioCommon
+{
+// Fraction of the Nyquist frequency that is passed through. 16 taps don't allow for a steep
+// transition band, so leave some room below the Nyquist frequency for it.
+constexpr double PASSBAND = 0.9;
+
+static double Sinc(double x)
+{
+  if (x == 0.0)
+    return 1.0;
+  return std::sin(MathUtil::PI * x) / (MathUtil::PI * x);
+}
+
+// Blackman window, defined for x in [-1, 1].
+static double Window(double x)
+{
+  return 0.42 + 0.5 * std::cos(MathUtil::PI * x) + 0.08 * std::cos(MathUtil::TAU * x);
+}
+
+void SincFilterBank::SetRates(double input_rate, double output_rate)
+{
+  if (input_rate == m_input_rate && output_rate == m_output_rate)
+    return;
+
+  m_input_rate = input_rate;
+  m_output_rate = output_rate;
+
+  const double cutoff = std::min(1.0, output_rate / input_rate) * PASSBAND;
+  for (u32 phase = 0; phase <= PHASES; ++phase)
+  {
+    float* coefficients = &m_coefficients[phase * TAPS];
+    const double position = static_cast<double>(HISTORY) + static_cast<double>(phase) / PHASES;
+
+    double sum = 0.0;
+    std::array<double, TAPS> taps;
+    for (u32 i = 0; i < TAPS; ++i)
+    {
+      const double x = i - position;
+      taps[i] = cutoff * Sinc(cutoff * x) * Window(x / (TAPS / 2));
+      sum += taps[i];
+    }
+
+    // Normalize every phase to unity gain so that interpolating a constant signal gives that
+    // constant, regardless of the fractional position.
+    for (u32 i = 0; i < TAPS; ++i)
+      coefficients[i] = static_cast<float>(taps[i] / sum);
+  }
+}
+
+std::pair<float, float> SincFilterBank::Interpolate(const float* left, const float* right,
+                                                    u16 fraction) const
+{
+  constexpr u32 BLEND_BITS = 16 - PHASE_BITS;
+  const float* const phase0 = &m_coefficients[(fraction >> BLEND_BITS) * TAPS];
+  const float* const phase1 = phase0 + TAPS;
+  const float blend =
+      static_cast<float>(fraction & ((1 << BLEND_BITS) - 1)) * (1.0f / (1 << BLEND_BITS));
+
+#if defined(_M_X86_64)
+  const __m128 blend_v = _mm_set1_ps(blend);
+  __m128 sum_left = _mm_setzero_ps();
+  __m128 sum_right = _mm_setzero_ps();
+  for (u32 i = 0; i < TAPS; i += 4)
+  {
+    const __m128 c0 = _mm_load_ps(phase0 + i);
+    const __m128 c1 = _mm_load_ps(phase1 + i);
+    const __m128 c = _mm_add_ps(c0, _mm_mul_ps(_mm_sub_ps(c1, c0), blend_v));
+    sum_left = _mm_add_ps(sum_left, _mm_mul_ps(c, _mm_loadu_ps(left + i)));
+    sum_right = _mm_add_ps(sum_right, _mm_mul_ps(c, _mm_loadu_ps(right + i)));
+  }
+
+  // {l0 + l2, r0 + r2, l1 + l3, r1 + r3}, then add the upper half to the lower half.
+  __m128 sums =
+      _mm_add_ps(_mm_unpacklo_ps(sum_left, sum_right), _mm_unpackhi_ps(sum_left, sum_right));
+  sums = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+  return {_mm_cvtss_f32(sums), _mm_cvtss_f32(_mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 1, 1, 1)))};
+#elif defined(_M_ARM_64)
+  const float32x4_t blend_v = vdupq_n_f32(blend);
+  float32x4_t sum_left = vdupq_n_f32(0.0f);
+  float32x4_t sum_right = vdupq_n_f32(0.0f);
+  for (u32 i = 0; i < TAPS; i += 4)
+  {
+    const float32x4_t c0 = vld1q_f32(phase0 + i);
+    const float32x4_t c1 = vld1q_f32(phase1 + i);
+    const float32x4_t c = vfmaq_f32(c0, vsubq_f32(c1, c0), blend_v);
+    sum_left = vfmaq_f32(sum_left, c, vld1q_f32(left + i));
+    sum_right = vfmaq_f32(sum_right, c, vld1q_f32(right + i));
+  }
+  return {vaddvq_f32(sum_left), vaddvq_f32(sum_right)};
+#else
+  float sum_left = 0.0f;
+  float sum_right = 0.0f;
+  for (u32 i = 0; i < TAPS; ++i)
+  {
+    const float c = phase0[i] + (phase1[i] - phase0[i]) * blend;
+    sum_left += c * left[i];
+    sum_right += c * right[i];
+  }
+  return {sum_left, sum_right};
+#endif
+}
+}  // namespace AudioCommon
@@ -0,0 +1,40 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <utility>
+
+#include "Common/CommonTypes.h"
+
+namespace AudioCommon
+{
+// Windowed-sinc interpolation filter, precomputed for PHASES fractional positions between two
+// input samples. Positions in between two phases use a linear blend of their coefficients. The
+// coefficients of each phase are stored contiguously so they can be applied with SIMD.
+class SincFilterBank
+{
+public:
+  static constexpr u32 TAPS = 16;
+  static constexpr u32 PHASE_BITS = 6;
+  static constexpr u32 PHASES = 1 << PHASE_BITS;
+
+  // Number of input samples that are read before and after the one that is interpolated from.
+  static constexpr u32 HISTORY = TAPS / 2 - 1;
+  static constexpr u32 LOOKAHEAD = TAPS / 2;
+
+  // Recomputes the coefficients for the given nominal conversion. When downsampling, the cutoff
+  // frequency is lowered to the output Nyquist frequency. Does nothing if the rates are unchanged.
+  void SetRates(double input_rate, double output_rate);
+
+  // left and right must each point to TAPS input samples. Returns the left and right samples at
+  // position HISTORY + fraction / 65536.
+  std::pair<float, float> Interpolate(const float* left, const float* right, u16 fraction) const;
+
+private:
+  double m_input_rate = 0.0;
+  double m_output_rate = 0.0;
+  alignas(16) std::array<float, (PHASES + 1) * TAPS> m_coefficients{};
+};
+}  // namespace AudioCommon
@@ -4,6 +4,8 @@
 #include "AudioCommon/WaveFile.h"
 #include "AudioCommon/Mixer.h"
 
+#include <algorithm>
+#include <chrono>
 #include <string>
 
 #include <fmt/format.h>
@@ -15,10 +17,23 @@
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
+#include "Common/Thread.h"
 #include "Core/Config/MainSettings.h"
 #include "Core/ConfigManager.h"
 
-constexpr size_t WaveFileWriter::BUFFER_SIZE;
+namespace
+{
+void AppendU32(std::vector<u8>* out, u32 value)
+{
+  for (u32 i = 0; i < 4; ++i)
+    out->push_back(static_cast<u8>(value >> (8 * i)));
+}
+
+void AppendTag(std::vector<u8>* out, const char* tag)
+{
+  out->insert(out->end(), tag, tag + 4);
+}
+}  // namespace
 
 WaveFileWriter::WaveFileWriter()
 {
@@ -29,7 +44,44 @@ WaveFileWriter::~WaveFileWriter()
   Stop();
 }
 
-bool WaveFileWriter::Start(const std::string& filename, u32 sample_rate_divisor)
+bool WaveFileWriter::Start(const std::string& filename, u32 sample_rate_divisor,
+                           AudioCommon::AudioDumpFormat format)
+{
+  // Check if the file is already open
+  if (m_file || m_thread.joinable())
+  {
+    PanicAlertFmtT("The file {0} was already open, the file header will not be written.", filename);
+    return false;
+  }
+
+  m_format = format;
+  if (!OpenFile(filename, sample_rate_divisor))
+    return false;
+
+  if (m_basename.empty())
+    SplitPath(filename, nullptr, &m_basename, nullptr);
+
+  m_samples = std::make_unique<Common::SPSCRingBuffer<s16, SAMPLE_QUEUE_SIZE>>();
+  m_segments = std::make_unique<Common::SPSCRingBuffer<Segment, SEGMENT_QUEUE_SIZE>>();
+  m_running.Set();
+  m_thread = std::thread(&WaveFileWriter::WriterThread, this);
+  return true;
+}
+
+void WaveFileWriter::Stop()
+{
+  if (m_thread.joinable())
+  {
+    // The writer thread drains the queues before it exits.
+    m_running.Clear();
+    m_wake_up.Set();
+    m_thread.join();
+  }
+
+  CloseFile();
+}
+
+bool WaveFileWriter::OpenFile(const std::string& filename, u32 sample_rate_divisor)
 {
   // Ask to delete file
   if (File::Exists(filename))
@@ -46,15 +98,8 @@ bool WaveFileWriter::Start(const std::string& filename, u32 sample_rate_divisor)
     }
   }
 
-  // Check if the file is already open
-  if (file)
-  {
-    PanicAlertFmtT("The file {0} was already open, the file header will not be written.", filename);
-    return false;
-  }
-
-  file.Open(filename, "wb");
-  if (!file)
+  m_file.Open(filename, "wb");
+  if (!m_file)
   {
     PanicAlertFmtT(
         "The file {0} could not be opened for writing. Please check if it's already opened "
@@ -63,110 +108,228 @@ bool WaveFileWriter::Start(const std::string& filename, u32 sample_rate_divisor)
     return false;
   }
 
-  audio_size = 0;
-
-  if (basename.empty())
-    SplitPath(filename, nullptr, &basename, nullptr);
-
-  current_sample_rate_divisor = sample_rate_divisor;
-
-  // -----------------
-  // Write file header
-  // -----------------
-  Write4("RIFF");
-  Write(100 * 1000 * 1000);  // write big value in case the file gets truncated
-  Write4("WAVE");
-  Write4("fmt ");
-
-  Write(16);          // size of fmt block
-  Write(0x00020001);  // two channels, uncompressed
+  m_audio_size = 0;
+  m_current_sample_rate_divisor = sample_rate_divisor;
+  m_output.clear();
+  m_output.reserve(WRITE_BLOCK_SIZE + AudioCommon::FlacEncoder::BLOCK_SIZE * 8);
 
   const u32 sample_rate = Mixer::FIXED_SAMPLE_RATE_DIVIDEND / sample_rate_divisor;
-  Write(sample_rate);
-  Write(sample_rate * 2 * 2);  // two channels, 16bit
-
-  Write(0x00100004);
-  Write4("data");
-  Write(100 * 1000 * 1000 - 32);
-
-  // We are now at offset 44
-  if (file.Tell() != 44)
-    PanicAlertFmt("Wrong offset: {}", file.Tell());
+  if (m_format == AudioCommon::AudioDumpFormat::FLAC)
+  {
+    m_flac_encoder.emplace(sample_rate);
+    m_flac_block.clear();
+    m_flac_block.reserve(AudioCommon::FlacEncoder::BLOCK_SIZE * 2);
+    m_flac_encoder->WriteHeader(&m_output);
+  }
+  else
+  {
+    // -----------------
+    // Write file header
+    // -----------------
+    AppendTag(&m_output, "RIFF");
+    AppendU32(&m_output, 100 * 1000 * 1000);  // write big value in case the file gets truncated
+    AppendTag(&m_output, "WAVE");
+    AppendTag(&m_output, "fmt ");
+
+    AppendU32(&m_output, 16);          // size of fmt block
+    AppendU32(&m_output, 0x00020001);  // two channels, uncompressed
+
+    AppendU32(&m_output, sample_rate);
+    AppendU32(&m_output, sample_rate * 2 * 2);  // two channels, 16bit
+
+    AppendU32(&m_output, 0x00100004);
+    AppendTag(&m_output, "data");
+    AppendU32(&m_output, 100 * 1000 * 1000 - 32);
+
+    // We are now at offset 44
+    if (m_output.size() != 44)
+      PanicAlertFmt("Wrong offset: {}", m_output.size());
+  }
 
+  FlushOutput();
   return true;
 }
 
-void WaveFileWriter::Stop()
+void WaveFileWriter::CloseFile()
 {
-  file.Seek(4, File::SeekOrigin::Begin);
-  Write(audio_size + 36);
+  if (!m_file)
+    return;
 
-  file.Seek(40, File::SeekOrigin::Begin);
-  Write(audio_size);
+  if (m_format == AudioCommon::AudioDumpFormat::FLAC)
+  {
+    if (!m_flac_block.empty())
+    {
+      m_flac_encoder->EncodeFrame(m_flac_block.data(), static_cast<u32>(m_flac_block.size() / 2),
+                                  &m_output);
+      m_flac_block.clear();
+    }
+    FlushOutput();
 
-  file.Close();
-}
+    // Now that the number of samples is known, rewrite the header.
+    m_flac_encoder->WriteHeader(&m_output);
+    m_file.Seek(0, File::SeekOrigin::Begin);
+    FlushOutput();
+    m_flac_encoder.reset();
+  }
+  else
+  {
+    FlushOutput();
 
-void WaveFileWriter::Write(u32 value)
-{
-  file.WriteArray(&value, 1);
+    const u32 riff_size = m_audio_size + 36;
+    m_file.Seek(4, File::SeekOrigin::Begin);
+    m_file.WriteArray(&riff_size, 1);
+
+    m_file.Seek(40, File::SeekOrigin::Begin);
+    m_file.WriteArray(&m_audio_size, 1);
+  }
+
+  m_file.Close();
 }
 
-void WaveFileWriter::Write4(const char* ptr)
+void WaveFileWriter::FlushOutput()
 {
-  file.WriteBytes(ptr, 4);
+  if (!m_output.empty())
+    m_file.WriteBytes(m_output.data(), m_output.size());
+  m_output.clear();
 }
 
 void WaveFileWriter::AddStereoSamplesBE(const short* sample_data, u32 count,
                                         u32 sample_rate_divisor, int l_volume, int r_volume)
 {
-  if (!file)
+  if (!m_thread.joinable())
   {
     ERROR_LOG_FMT(AUDIO, "WaveFileWriter - file not open.");
     return;
   }
 
-  if (count * 2 > BUFFER_SIZE)
+  if (count > MAX_SEGMENT_SAMPLES)
   {
     ERROR_LOG_FMT(AUDIO, "WaveFileWriter - buffer too small (count = {}).", count);
     return;
   }
 
-  if (skip_silence)
+  if (sample_rate_divisor != m_current_sample_rate_divisor)
+  {
+    // Silence that would be skipped anyway doesn't start a new file.
+    if (m_skip_silence.load(std::memory_order_relaxed) &&
+        std::all_of(sample_data, sample_data + count * 2, [](short sample) { return !sample; }))
+    {
+      return;
+    }
+
+    // Starting the new file happens on this thread, so that any questions and errors are shown
+    // here and not on the writer thread.
+    Stop();
+    m_file_index++;
+    const char* extension = m_format == AudioCommon::AudioDumpFormat::FLAC ? "flac" : "wav";
+    const std::string filename = fmt::format("{}{}{}.{}", File::GetUserPath(D_DUMPAUDIO_IDX),
+                                             m_basename, m_file_index, extension);
+    if (!Start(filename, sample_rate_divisor, m_format))
+      return;
+  }
+
+  // Only copy the samples here and leave everything else to the writer thread. If it can't keep
+  // up, wait for it to make room instead of dropping samples.
+  const size_t total = count * 2;
+  size_t pushed = m_samples->Push(sample_data, total);
+  while (pushed < total)
+  {
+    m_wake_up.Set();
+    m_space_available.Wait();
+    pushed += m_samples->Push(sample_data + pushed, total - pushed);
+  }
+
+  const Segment segment{count, l_volume, r_volume};
+  while (m_segments->Push(&segment, 1) == 0)
+  {
+    m_wake_up.Set();
+    m_space_available.Wait();
+  }
+
+  if (m_samples->Size() >= WAKE_UP_THRESHOLD)
+    m_wake_up.Set();
+}
+
+void WaveFileWriter::WriterThread()
+{
+  Common::SetCurrentThreadName("Audio Dump Writer");
+
+  std::vector<short> sample_data(MAX_SEGMENT_SAMPLES * 2);
+  m_conv_buffer.resize(MAX_SEGMENT_SAMPLES * 2);
+
+  while (true)
   {
-    bool all_zero = true;
+    // Check the flag before draining, so that everything queued before Stop gets written.
+    const bool running = m_running.IsSet();
 
-    for (u32 i = 0; i < count * 2; i++)
+    // A segment is only queued after all of its samples.
+    Segment segment;
+    while (m_segments->Pop(&segment, 1) != 0)
     {
-      if (sample_data[i])
-        all_zero = false;
+      m_samples->Pop(sample_data.data(), segment.count * 2);
+      m_space_available.Set();
+      ProcessSegment(segment, sample_data.data());
     }
 
-    if (all_zero)
+    if (!running)
+      break;
+
+    m_wake_up.WaitFor(std::chrono::seconds(1));
+  }
+}
+
+void WaveFileWriter::ProcessSegment(const Segment& segment, const short* sample_data)
+{
+  const u32 count = segment.count;
+
+  if (m_skip_silence.load(std::memory_order_relaxed))
+  {
+    if (std::all_of(sample_data, sample_data + count * 2, [](short sample) { return !sample; }))
       return;
   }
 
   for (u32 i = 0; i < count; i++)
   {
     // Flip the audio channels from RL to LR
-    conv_buffer[2 * i] = Common::swap16((u16)sample_data[2 * i + 1]);
-    conv_buffer[2 * i + 1] = Common::swap16((u16)sample_data[2 * i]);
+    m_conv_buffer[2 * i] = Common::swap16((u16)sample_data[2 * i + 1]);
+    m_conv_buffer[2 * i + 1] = Common::swap16((u16)sample_data[2 * i]);
 
     // Apply volume (volume ranges from 0 to 256)
-    conv_buffer[2 * i] = conv_buffer[2 * i] * l_volume / 256;
-    conv_buffer[2 * i + 1] = conv_buffer[2 * i + 1] * r_volume / 256;
+    m_conv_buffer[2 * i] = m_conv_buffer[2 * i] * segment.l_volume / 256;
+    m_conv_buffer[2 * i + 1] = m_conv_buffer[2 * i + 1] * segment.r_volume / 256;
   }
 
-  if (sample_rate_divisor != current_sample_rate_divisor)
+  WriteSamples(m_conv_buffer.data(), count);
+}
+
+void WaveFileWriter::WriteSamples(const s16* samples, u32 count)
+{
+  if (m_format == AudioCommon::AudioDumpFormat::FLAC)
   {
-    Stop();
-    file_index++;
-    const std::string filename =
-        fmt::format("{}{}{}.wav", File::GetUserPath(D_DUMPAUDIO_IDX), basename, file_index);
-    Start(filename, sample_rate_divisor);
-    current_sample_rate_divisor = sample_rate_divisor;
+    constexpr size_t BLOCK_SAMPLES = AudioCommon::FlacEncoder::BLOCK_SIZE * 2;
+    const s16* end = samples + count * 2;
+    while (samples != end)
+    {
+      const size_t to_copy =
+          std::min<size_t>(end - samples, BLOCK_SAMPLES - m_flac_block.size());
+      m_flac_block.insert(m_flac_block.end(), samples, samples + to_copy);
+      samples += to_copy;
+
+      if (m_flac_block.size() == BLOCK_SAMPLES)
+      {
+        m_flac_encoder->EncodeFrame(m_flac_block.data(), AudioCommon::FlacEncoder::BLOCK_SIZE,
+                                    &m_output);
+        m_flac_block.clear();
+      }
+    }
+  }
+  else
+  {
+    const u8* bytes = reinterpret_cast<const u8*>(samples);
+    m_output.insert(m_output.end(), bytes, bytes + count * 4);
+    m_audio_size += count * 4;
   }
 
-  file.WriteBytes(conv_buffer.data(), count * 4);
-  audio_size += count * 4;
+  if (m_output.size() >= WRITE_BLOCK_SIZE)
+    FlushOutput();
 }
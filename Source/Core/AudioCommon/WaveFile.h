@@ -4,20 +4,29 @@
 // ---------------------------------------------------------------------------------
 // Class: WaveFileWriter
 // Description: Simple utility class to make it easy to write long 16-bit stereo
-// audio streams to disk.
-// Use Start() to start recording to a file, and AddStereoSamples to add wave data.
-// The float variant will convert from -1.0-1.0 range and clamp.
-// Alternatively, AddSamplesBE for big endian wave data.
+// audio streams to disk, either as WAV or as FLAC.
+// Use Start() to start recording to a file, and AddStereoSamplesBE to add big endian
+// wave data. The samples are only queued on the calling thread. Converting, encoding
+// and writing them happens on a background thread, in large blocks.
 // If Stop is not called when it destructs, the destructor will call Stop().
 // ---------------------------------------------------------------------------------
 
 #pragma once
 
-#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "AudioCommon/Enums.h"
+#include "AudioCommon/FlacEncoder.h"
 #include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "Common/Flag.h"
 #include "Common/IOFile.h"
+#include "Common/SPSCQueue.h"
 
 class WaveFileWriter
 {
@@ -30,28 +39,60 @@ public:
   WaveFileWriter(WaveFileWriter&&) = delete;
   WaveFileWriter& operator=(WaveFileWriter&&) = delete;
 
-  bool Start(const std::string& filename, u32 sample_rate_divisor);
+  bool Start(const std::string& filename, u32 sample_rate_divisor,
+             AudioCommon::AudioDumpFormat format = AudioCommon::AudioDumpFormat::WAV);
   void Stop();
 
-  void SetSkipSilence(bool skip) { skip_silence = skip; }
+  void SetSkipSilence(bool skip) { m_skip_silence.store(skip, std::memory_order_relaxed); }
   // big endian
   void AddStereoSamplesBE(const short* sample_data, u32 count, u32 sample_rate_divisor,
                           int l_volume, int r_volume);
-  u32 GetAudioSize() const { return audio_size; }
 
 private:
-  static constexpr size_t BUFFER_SIZE = 32 * 1024;
+  // A run of samples that were added with the same parameters.
+  struct Segment
+  {
+    u32 count;
+    int l_volume;
+    int r_volume;
+  };
 
-  void Write(u32 value);
-  void Write4(const char* ptr);
+  static constexpr size_t MAX_SEGMENT_SAMPLES = 16 * 1024;
+  // About 8 seconds of 32 kHz audio.
+  static constexpr size_t SAMPLE_QUEUE_SIZE = 512 * 1024;
+  static constexpr size_t SEGMENT_QUEUE_SIZE = 4096;
+  // The writer thread also wakes up on its own once a second.
+  static constexpr size_t WAKE_UP_THRESHOLD = SAMPLE_QUEUE_SIZE / 8;
+  static constexpr size_t WRITE_BLOCK_SIZE = 1024 * 1024;
 
-  File::IOFile file;
-  std::string basename;
-  u32 file_index = 0;
-  u32 audio_size = 0;
+  bool OpenFile(const std::string& filename, u32 sample_rate_divisor);
+  void CloseFile();
+  void WriterThread();
+  void ProcessSegment(const Segment& segment, const short* sample_data);
+  void WriteSamples(const s16* samples, u32 count);
+  void FlushOutput();
 
-  u32 current_sample_rate_divisor;
-  std::array<short, BUFFER_SIZE> conv_buffer{};
+  // Only changed by the thread that adds samples, while the writer thread is stopped. Opening a
+  // file can ask the user questions, so it never happens on the writer thread.
+  std::string m_basename;
+  u32 m_file_index = 0;
+  u32 m_current_sample_rate_divisor = 0;
+  AudioCommon::AudioDumpFormat m_format = AudioCommon::AudioDumpFormat::WAV;
 
-  bool skip_silence = false;
+  // Only accessed by the writer thread while it is running.
+  File::IOFile m_file;
+  u32 m_audio_size = 0;
+  std::optional<AudioCommon::FlacEncoder> m_flac_encoder;
+  std::vector<s16> m_flac_block;
+  std::vector<s16> m_conv_buffer;
+  std::vector<u8> m_output;
+
+  std::thread m_thread;
+  Common::Flag m_running;
+  Common::Event m_wake_up;
+  // Set by the writer thread whenever it makes room in the queues.
+  Common::Event m_space_available;
+  std::atomic<bool> m_skip_silence = false;
+  std::unique_ptr<Common::SPSCRingBuffer<s16, SAMPLE_QUEUE_SIZE>> m_samples;
+  std::unique_ptr<Common::SPSCRingBuffer<Segment, SEGMENT_QUEUE_SIZE>> m_segments;
 };
@@ -0,0 +1,448 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Common/ChildProcess.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#ifndef ANDROID
+#include <spawn.h>
+#endif
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "Common/CommonFuncs.h"
+#include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+
+#ifdef _WIN32
+#include "Common/ScopeGuard.h"
+#include "Common/StringUtil.h"
+#elif !defined(ANDROID)
+extern char** environ;
+#endif
+
+namespace Common
+{
+ChildProcess::~ChildProcess()
+{
+  Stop();
+}
+
+// Returns -1 for no timeout.
+static int GetRemainingMilliseconds(std::chrono::milliseconds timeout,
+                                    std::chrono::steady_clock::time_point deadline)
+{
+  if (timeout < std::chrono::milliseconds::zero())
+    return -1;
+
+  const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+      deadline - std::chrono::steady_clock::now());
+  return static_cast<int>(std::clamp<s64>(remaining.count(), 0, INT_MAX));
+}
+
+#ifdef _WIN32
+static void QuoteArgument(std::wstring* command_line, const std::string& arg)
+{
+  if (!command_line->empty())
+    command_line->push_back(L' ');
+
+  command_line->push_back(L'"');
+  for (const wchar_t c : UTF8ToWString(arg))
+  {
+    if (c == L'"')
+      command_line->push_back(L'\\');
+    command_line->push_back(c);
+  }
+  command_line->push_back(L'"');
+}
+
+// Anonymous pipes can't be read or written with a timeout, so named pipes are used instead, which
+// the parent accesses asynchronously. The child's end is synchronous and inheritable.
+static bool CreateOverlappedPipe(bool child_writes, HANDLE* parent_end, HANDLE* child_end)
+{
+  static std::atomic<u32> s_pipe_counter = 0;
+  const std::wstring pipe_name = L"\\\\.\\pipe\\dolphin-child-" +
+                                 std::to_wstring(GetCurrentProcessId()) + L"-" +
+                                 std::to_wstring(s_pipe_counter++);
+
+  const DWORD parent_access = child_writes ? PIPE_ACCESS_INBOUND : PIPE_ACCESS_OUTBOUND;
+  const DWORD in_buffer_size = child_writes ? 64 * 1024 : 0;
+  const DWORD out_buffer_size = child_writes ? 0 : 64 * 1024;
+  *parent_end = CreateNamedPipeW(
+      pipe_name.c_str(), parent_access | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+      PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, 1, out_buffer_size, in_buffer_size,
+      0, nullptr);
+  if (*parent_end == INVALID_HANDLE_VALUE)
+  {
+    *parent_end = nullptr;
+    return false;
+  }
+
+  SECURITY_ATTRIBUTES security_attributes{};
+  security_attributes.nLength = sizeof(security_attributes);
+  security_attributes.bInheritHandle = TRUE;
+  *child_end = CreateFileW(pipe_name.c_str(), child_writes ? GENERIC_WRITE : GENERIC_READ, 0,
+                           &security_attributes, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (*child_end == INVALID_HANDLE_VALUE)
+  {
+    *child_end = nullptr;
+    return false;
+  }
+  return true;
+}
+
+// Waits for an overlapped ReadFile or WriteFile on a pipe to finish, and cancels it if it doesn't
+// before the deadline.
+static bool FinishOverlappedIO(HANDLE pipe, OVERLAPPED* overlapped, DWORD wait_ms,
+                               DWORD* transferred)
+{
+  if (WaitForSingleObject(overlapped->hEvent, wait_ms) != WAIT_OBJECT_0)
+  {
+    CancelIo(pipe);
+    GetOverlappedResult(pipe, overlapped, transferred, TRUE);
+    return false;
+  }
+  return GetOverlappedResult(pipe, overlapped, transferred, FALSE) && *transferred != 0;
+}
+
+bool ChildProcess::Start(const std::string& executable, const std::vector<std::string>& args)
+{
+  Stop();
+
+  HANDLE child_input = nullptr;
+  HANDLE child_output = nullptr;
+  HANDLE child_error = nullptr;
+  Common::ScopeGuard close_child_handles([&] {
+    for (const HANDLE handle : {child_input, child_output, child_error})
+    {
+      if (handle)
+        CloseHandle(handle);
+    }
+  });
+
+  m_read_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+  m_write_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+  if (!CreateOverlappedPipe(false, &m_input, &child_input) ||
+      !CreateOverlappedPipe(true, &m_output, &child_output) || !m_read_event || !m_write_event)
+  {
+    ERROR_LOG_FMT(COMMON, "Failed to create pipe for child process: {}", GetLastErrorString());
+    Stop();
+    return false;
+  }
+
+  std::array<HANDLE, 3> inherited_handles{child_input, child_output};
+  DWORD num_inherited_handles = 2;
+  const HANDLE error = GetStdHandle(STD_ERROR_HANDLE);
+  if (error && error != INVALID_HANDLE_VALUE &&
+      DuplicateHandle(GetCurrentProcess(), error, GetCurrentProcess(), &child_error, 0, TRUE,
+                      DUPLICATE_SAME_ACCESS))
+  {
+    inherited_handles[num_inherited_handles++] = child_error;
+  }
+
+  // Only pass on this child's handles. Otherwise a child started by another thread at the same
+  // time could inherit them as well, and keep the pipes open after this child has exited.
+  SIZE_T attribute_list_size = 0;
+  InitializeProcThreadAttributeList(nullptr, 1, 0, &attribute_list_size);
+  std::vector<u8> attribute_list_buffer(attribute_list_size);
+  const auto attribute_list =
+      reinterpret_cast<LPPROC_THREAD_ATTRIBUTE_LIST>(attribute_list_buffer.data());
+  if (!InitializeProcThreadAttributeList(attribute_list, 1, 0, &attribute_list_size))
+  {
+    ERROR_LOG_FMT(COMMON, "Failed to start {}: {}", executable, GetLastErrorString());
+    Stop();
+    return false;
+  }
+  Common::ScopeGuard delete_attribute_list(
+      [&] { DeleteProcThreadAttributeList(attribute_list); });
+  if (!UpdateProcThreadAttribute(attribute_list, 0, PROC_THREAD_ATTRIBUTE_HANDLE_LIST,
+                                 inherited_handles.data(), num_inherited_handles * sizeof(HANDLE),
+                                 nullptr, nullptr))
+  {
+    ERROR_LOG_FMT(COMMON, "Failed to start {}: {}", executable, GetLastErrorString());
+    Stop();
+    return false;
+  }
+
+  STARTUPINFOEXW startup_info{};
+  startup_info.StartupInfo.cb = sizeof(startup_info);
+  startup_info.StartupInfo.dwFlags = STARTF_USESTDHANDLES;
+  startup_info.StartupInfo.hStdInput = child_input;
+  startup_info.StartupInfo.hStdOutput = child_output;
+  startup_info.StartupInfo.hStdError = child_error;
+  startup_info.lpAttributeList = attribute_list;
+
+  std::wstring command_line;
+  QuoteArgument(&command_line, executable);
+  for (const std::string& arg : args)
+    QuoteArgument(&command_line, arg);
+
+  PROCESS_INFORMATION process_info{};
+  if (!CreateProcessW(UTF8ToWString(executable).c_str(), command_line.data(), nullptr, nullptr,
+                      TRUE, CREATE_NO_WINDOW | EXTENDED_STARTUPINFO_PRESENT, nullptr, nullptr,
+                      &startup_info.StartupInfo, &process_info))
+  {
+    ERROR_LOG_FMT(COMMON, "Failed to start {}: {}", executable, GetLastErrorString());
+    Stop();
+    return false;
+  }
+
+  CloseHandle(process_info.hThread);
+  m_process = process_info.hProcess;
+  return true;
+}
+
+void ChildProcess::Stop()
+{
+  if (m_input)
+    CloseHandle(m_input);
+  if (m_output)
+    CloseHandle(m_output);
+  if (m_read_event)
+    CloseHandle(m_read_event);
+  if (m_write_event)
+    CloseHandle(m_write_event);
+  if (m_process)
+  {
+    TerminateProcess(m_process, 1);
+    WaitForSingleObject(m_process, INFINITE);
+    CloseHandle(m_process);
+  }
+
+  m_process = nullptr;
+  m_input = nullptr;
+  m_output = nullptr;
+  m_read_event = nullptr;
+  m_write_event = nullptr;
+}
+
+bool ChildProcess::IsRunning() const
+{
+  return m_process != nullptr;
+}
+
+bool ChildProcess::Write(const void* data, size_t size, std::chrono::milliseconds timeout)
+{
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  const u8* ptr = static_cast<const u8*>(data);
+  while (size > 0)
+  {
+    OVERLAPPED overlapped{};
+    overlapped.hEvent = m_write_event;
+    if (!WriteFile(m_input, ptr, static_cast<DWORD>(std::min<size_t>(size, 1 << 30)), nullptr,
+                   &overlapped) &&
+        GetLastError() != ERROR_IO_PENDING)
+    {
+      return false;
+    }
+
+    DWORD written = 0;
+    const DWORD wait_ms = static_cast<DWORD>(GetRemainingMilliseconds(timeout, deadline));
+    if (!FinishOverlappedIO(m_input, &overlapped, wait_ms, &written))
+      return false;
+    ptr += written;
+    size -= written;
+  }
+  return true;
+}
+
+bool ChildProcess::Read(void* data, size_t size, std::chrono::milliseconds timeout)
+{
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  u8* ptr = static_cast<u8*>(data);
+  while (size > 0)
+  {
+    OVERLAPPED overlapped{};
+    overlapped.hEvent = m_read_event;
+    if (!ReadFile(m_output, ptr, static_cast<DWORD>(std::min<size_t>(size, 1 << 30)), nullptr,
+                  &overlapped) &&
+        GetLastError() != ERROR_IO_PENDING)
+    {
+      return false;
+    }
+
+    DWORD read = 0;
+    const DWORD wait_ms = static_cast<DWORD>(GetRemainingMilliseconds(timeout, deadline));
+    if (!FinishOverlappedIO(m_output, &overlapped, wait_ms, &read))
+      return false;
+    ptr += read;
+    size -= read;
+  }
+  return true;
+}
+
+#else
+
+bool ChildProcess::Start(const std::string& executable, const std::vector<std::string>& args)
+{
+  Stop();
+
+#ifdef ANDROID
+  // There is no executable to start a helper process from on Android.
+  ERROR_LOG_FMT(COMMON, "Failed to start {}: Not supported on Android", executable);
+  return false;
+#else
+  // A socket rather than a pair of pipes, so that writing to a process that has exited fails
+  // instead of raising SIGPIPE.
+  //
+  // Both ends are close-on-exec, and the child only gets its end as standard input and output.
+  // The flag has to be set before another thread starts a process that could inherit the socket
+  // and keep it open after this child has exited.
+#ifdef SOCK_CLOEXEC
+  int sockets[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0)
+  {
+    ERROR_LOG_FMT(COMMON, "Failed to create socket for child process: {}", LastStrerrorString());
+    return false;
+  }
+#else
+  static std::mutex s_spawn_lock;
+  std::lock_guard spawn_guard(s_spawn_lock);
+
+  int sockets[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+  {
+    ERROR_LOG_FMT(COMMON, "Failed to create socket for child process: {}", LastStrerrorString());
+    return false;
+  }
+  fcntl(sockets[0], F_SETFD, FD_CLOEXEC);
+  fcntl(sockets[1], F_SETFD, FD_CLOEXEC);
+#endif
+
+#ifdef __APPLE__
+  int opt_no_sigpipe = 1;
+  if (setsockopt(sockets[0], SOL_SOCKET, SO_NOSIGPIPE, &opt_no_sigpipe,
+                 sizeof(opt_no_sigpipe)) < 0)
+  {
+    ERROR_LOG_FMT(COMMON, "Failed to set SO_NOSIGPIPE on socket");
+  }
+#endif
+
+  posix_spawn_file_actions_t file_actions;
+  posix_spawn_file_actions_init(&file_actions);
+  posix_spawn_file_actions_adddup2(&file_actions, sockets[1], STDIN_FILENO);
+  posix_spawn_file_actions_adddup2(&file_actions, sockets[1], STDOUT_FILENO);
+
+  std::vector<char*> argv;
+  argv.push_back(const_cast<char*>(executable.c_str()));
+  for (const std::string& arg : args)
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  argv.push_back(nullptr);
+
+  pid_t pid;
+  const int result =
+      posix_spawn(&pid, executable.c_str(), &file_actions, nullptr, argv.data(), environ);
+  posix_spawn_file_actions_destroy(&file_actions);
+  close(sockets[1]);
+
+  if (result != 0)
+  {
+    char buffer[256];
+    ERROR_LOG_FMT(COMMON, "Failed to start {}: {}", executable,
+                  StrErrorWrapper(result, buffer, sizeof(buffer)));
+    close(sockets[0]);
+    return false;
+  }
+
+  m_pid = pid;
+  m_socket = sockets[0];
+  return true;
+#endif
+}
+
+void ChildProcess::Stop()
+{
+  if (m_socket != -1)
+    close(m_socket);
+  if (m_pid != -1)
+  {
+    kill(m_pid, SIGKILL);
+    while (waitpid(m_pid, nullptr, 0) == -1 && errno == EINTR)
+    {
+    }
+  }
+
+  m_pid = -1;
+  m_socket = -1;
+}
+
+bool ChildProcess::IsRunning() const
+{
+  return m_pid != -1;
+}
+
+bool ChildProcess::Write(const void* data, size_t size, std::chrono::milliseconds timeout)
+{
+  // Only as much as fits into the socket buffer is sent at a time, so that a child that has
+  // stopped reading can't block the caller past the deadline.
+#ifdef MSG_NOSIGNAL
+  constexpr int flags = MSG_NOSIGNAL | MSG_DONTWAIT;
+#else
+  constexpr int flags = MSG_DONTWAIT;
+#endif
+
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  const u8* ptr = static_cast<const u8*>(data);
+  while (size > 0)
+  {
+    pollfd fd{m_socket, POLLOUT, 0};
+    const int ready = poll(&fd, 1, GetRemainingMilliseconds(timeout, deadline));
+    if (ready < 0 && errno == EINTR)
+      continue;
+    if (ready <= 0)
+      return false;
+
+    const ssize_t written = send(m_socket, ptr, size, flags);
+    if (written < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+      continue;
+    if (written <= 0)
+      return false;
+    ptr += written;
+    size -= written;
+  }
+  return true;
+}
+
+bool ChildProcess::Read(void* data, size_t size, std::chrono::milliseconds timeout)
+{
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  u8* ptr = static_cast<u8*>(data);
+  while (size > 0)
+  {
+    pollfd fd{m_socket, POLLIN, 0};
+    const int ready = poll(&fd, 1, GetRemainingMilliseconds(timeout, deadline));
+    if (ready < 0 && errno == EINTR)
+      continue;
+    if (ready <= 0)
+      return false;
+
+    const ssize_t read = recv(m_socket, ptr, size, 0);
+    if (read < 0 && errno == EINTR)
+      continue;
+    if (read <= 0)
+      return false;
+    ptr += read;
+    size -= read;
+  }
+  return true;
+}
+#endif
+}  // namespace Common
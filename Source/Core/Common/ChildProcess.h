@@ -0,0 +1,56 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Common
+{
+// A helper process whose standard input and output are connected to the parent process, which
+// exchanges messages with it through Read and Write. Standard error is inherited, so anything the
+// child logs there ends up in the same place as the parent's output.
+//
+// Only one thread may read and only one thread may write at a time.
+class ChildProcess final
+{
+public:
+  ChildProcess() = default;
+  ~ChildProcess();
+
+  ChildProcess(const ChildProcess&) = delete;
+  ChildProcess(ChildProcess&&) = delete;
+  ChildProcess& operator=(const ChildProcess&) = delete;
+  ChildProcess& operator=(ChildProcess&&) = delete;
+
+  bool Start(const std::string& executable, const std::vector<std::string>& args);
+
+  // Terminates the process if it is still running, and waits for it to exit.
+  void Stop();
+
+  bool IsRunning() const;
+
+  static constexpr std::chrono::milliseconds NO_TIMEOUT{-1};
+
+  // These fail once the process has exited or closed its standard input/output, or if the process
+  // hasn't taken or sent all of the data before the timeout. The process has to be stopped after
+  // a timeout.
+  bool Write(const void* data, size_t size, std::chrono::milliseconds timeout = NO_TIMEOUT);
+  bool Read(void* data, size_t size, std::chrono::milliseconds timeout = NO_TIMEOUT);
+
+private:
+#ifdef _WIN32
+  void* m_process = nullptr;
+  void* m_input = nullptr;
+  void* m_output = nullptr;
+  void* m_read_event = nullptr;
+  void* m_write_event = nullptr;
+#else
+  int m_pid = -1;
+  int m_socket = -1;
+#endif
+};
+}  // namespace Common
@@ -0,0 +1,115 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Common/LinearDiskCache.h"
+
+#include <map>
+#include <string_view>
+#include <vector>
+
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+
+namespace Common
+{
+static bool ReadCurrentHeader(File::IOFile& file, LinearDiskCacheHeader* header)
+{
+  LinearDiskCacheHeader expected;
+  if (!file.ReadArray(header, 1))
+    return false;
+
+  // The key and value sizes are whatever the file says, as they depend on the type of cache.
+  expected.Init(header->key_t_size, header->value_t_size);
+  return std::memcmp(header, &expected, sizeof(expected)) == 0;
+}
+
+bool IsCurrentLinearDiskCache(const std::string& filename)
+{
+  File::IOFile file(filename, "rb");
+  LinearDiskCacheHeader header;
+  return ReadCurrentHeader(file, &header);
+}
+
+std::optional<LinearDiskCacheCompactionResult> CompactLinearDiskCache(const std::string& filename)
+{
+  File::IOFile file(filename, "rb");
+  LinearDiskCacheHeader header;
+  if (!ReadCurrentHeader(file, &header) || header.key_t_size == 0)
+    return std::nullopt;
+
+  LinearDiskCacheCompactionResult result;
+  result.old_size = file.GetSize();
+
+  std::vector<u8> data(result.old_size - sizeof(header));
+  if (!file.ReadBytes(data.data(), data.size()))
+    return std::nullopt;
+  file.Close();
+
+  struct Value
+  {
+    const u8* data;
+    u32 size;
+  };
+
+  // Same layout as LinearDiskCache::OpenAndRead, but with keys and values as plain bytes.
+  std::map<std::string_view, Value> entries;
+  u32 entry_count = 0;
+  size_t offset = 0;
+  while (data.size() - offset >= sizeof(u32))
+  {
+    u32 value_size;
+    std::memcpy(&value_size, data.data() + offset, sizeof(value_size));
+    const u64 value_bytes = u64{value_size} * header.value_t_size;
+    const u64 entry_size = sizeof(u32) + header.key_t_size + value_bytes + sizeof(u32);
+    if (entry_size > data.size() - offset)
+      break;
+
+    const u8* key = data.data() + offset + sizeof(u32);
+    const u8* value = key + header.key_t_size;
+    u32 entry_number;
+    std::memcpy(&entry_number, value + value_bytes, sizeof(entry_number));
+    if (entry_number != entry_count + 1)
+      break;
+
+    entries.insert_or_assign(
+        std::string_view(reinterpret_cast<const char*>(key), header.key_t_size),
+        Value{value, value_size});
+    entry_count++;
+    offset += entry_size;
+  }
+
+  result.entries = static_cast<u32>(entries.size());
+  result.removed_entries = entry_count - result.entries;
+
+  const std::string temp_filename = filename + ".tmp";
+  {
+    File::IOFile out(temp_filename, "wb");
+    bool success = out.WriteArray(&header, 1);
+    u32 entry_number = 0;
+    for (const auto& [key, value] : entries)
+    {
+      entry_number++;
+      success &= out.WriteArray(&value.size, 1) && out.WriteBytes(key.data(), key.size()) &&
+                 out.WriteBytes(value.data, u64{value.size} * header.value_t_size) &&
+                 out.WriteArray(&entry_number, 1);
+    }
+
+    if (!success)
+    {
+      ERROR_LOG_FMT(COMMON, "Failed to write compacted cache {}", temp_filename);
+      out.Close();
+      File::Delete(temp_filename);
+      return std::nullopt;
+    }
+  }
+
+  if (!File::Rename(temp_filename, filename))
+    return std::nullopt;
+
+  // The entries have moved, so the index has to be made again.
+  File::Delete(filename + ".idx", File::IfAbsentBehavior::NoConsoleWarning);
+
+  result.new_size = File::GetSize(filename);
+  return result;
+}
+}  // namespace Common
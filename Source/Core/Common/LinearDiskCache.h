@@ -4,13 +4,20 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
 #include <cstring>
 #include <memory>
+#include <optional>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
 #include "Common/IOFile.h"
+#include "Common/MappedFile.h"
 #include "Common/Version.h"
 
 // On disk format:
@@ -25,10 +32,90 @@
 // u32 value_size;
 // key_type   key;
 // value_type[value_size]   value;
+// u32 entry_number;
 //}
 
+// Index file format (<cache filename>.idx), see LinearDiskCache::OpenIndexed:
+// LinearDiskCacheIndexHeader header;
+// LinearDiskCacheIndexSlot slots[header.bucket_count];
+
 namespace Common
 {
+struct LinearDiskCacheHeader
+{
+  void Init(u16 key_size, u16 value_size)
+  {
+    // Null-terminator is intentionally not copied.
+    std::memcpy(&id, "DCAC", sizeof(u32));
+    key_t_size = key_size;
+    value_t_size = value_size;
+    std::memcpy(ver, Common::GetScmRevGitStr().c_str(),
+                std::min(Common::GetScmRevGitStr().size(), sizeof(ver)));
+  }
+
+  u32 id = 0;
+  u16 key_t_size = 0;
+  u16 value_t_size = 0;
+  char ver[40] = {};
+};
+static_assert(sizeof(LinearDiskCacheHeader) == 48);
+
+// A hash table of the keys in a cache file, using linear probing.
+struct LinearDiskCacheIndexHeader
+{
+  static constexpr u32 ID = 0x58494344;  // DCIX
+  static constexpr u32 VERSION = 1;
+
+  u32 id = ID;
+  u32 version = VERSION;
+  LinearDiskCacheHeader cache_header;
+  // The part of the cache file the index covers, and the number of entries in it.
+  u64 cache_size = 0;
+  u32 entry_count = 0;
+  // Always a power of two.
+  u32 bucket_count = 0;
+  // Checked when the index is opened, in case the cache was replaced by a different one.
+  u64 last_entry_offset = 0;
+  u64 last_entry_key_hash = 0;
+};
+static_assert(sizeof(LinearDiskCacheIndexHeader) == 88);
+
+struct LinearDiskCacheIndexSlot
+{
+  u64 key_hash;
+  // Zero for empty slots, as no entry can start there.
+  u64 entry_offset;
+};
+
+// FNV-1a, which has to stay the same as long as the index version does.
+inline u64 HashLinearDiskCacheKey(const void* key, size_t size)
+{
+  u64 hash = 0xcbf29ce484222325;
+  for (size_t i = 0; i < size; i++)
+  {
+    hash ^= static_cast<const u8*>(key)[i];
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+struct LinearDiskCacheCompactionResult
+{
+  u32 entries = 0;
+  u32 removed_entries = 0;
+  u64 old_size = 0;
+  u64 new_size = 0;
+};
+
+// Returns whether the file is a LinearDiskCache written by this version of Dolphin.
+// Caches from other versions are discarded when they are opened.
+bool IsCurrentLinearDiskCache(const std::string& filename);
+
+// Rewrites a LinearDiskCache of any key and value type with each key only once (keeping its most
+// recent value), sorted by the bytes of the key, and without any incomplete entry at the end.
+// Returns nullopt if the file can't be read or isn't a cache from this version of Dolphin.
+std::optional<LinearDiskCacheCompactionResult> CompactLinearDiskCache(const std::string& filename);
+
 template <typename K, typename V>
 class LinearDiskCacheReader
 {
@@ -37,7 +124,8 @@ public:
 };
 
 // Dead simple unsorted key-value store with append functionality.
-// No random read functionality, all reading is done in OpenAndRead.
+// Either all reading is done in OpenAndRead, or values are looked up one at a time with Find
+// after OpenIndexed.
 // Keys and values can contain any characters, including \0.
 //
 // Suitable for caching generated shader bytecode between executions.
@@ -52,6 +140,12 @@ template <typename K, typename V>
 class LinearDiskCache
 {
 public:
+  LinearDiskCache() = default;
+  ~LinearDiskCache() { Close(); }
+
+  LinearDiskCache(const LinearDiskCache&) = delete;
+  LinearDiskCache& operator=(const LinearDiskCache&) = delete;
+
   // return number of read entries
   u32 OpenAndRead(const std::string& filename, LinearDiskCacheReader<K, V>& reader)
   {
@@ -62,13 +156,14 @@ public:
     // close any currently opened file
     Close();
     m_num_entries = 0;
+    m_discarded_stale_cache = false;
 
     // try opening for reading/writing
     m_file.Open(filename, "r+b");
 
     const u64 file_size = m_file.GetSize();
 
-    m_header.Init();
+    m_header.Init(sizeof(K), sizeof(V));
     if (m_file.IsOpen() && ValidateHeader())
     {
       // good header, read some key/value pairs
@@ -110,15 +205,94 @@ public:
 
     // failed to open file for reading or bad header
     // close and recreate file
-    Close();
-    m_file.Open(filename, "wb");
-    WriteHeader();
+    m_discarded_stale_cache = m_file.IsOpen() && file_size != 0;
+    Recreate(filename);
     return 0;
   }
 
+  // Opens the cache without reading any values, they are looked up with Find() when needed.
+  // The cache file is memory-mapped, and its keys are found through an index that is kept next
+  // to it and mapped as well, so only the entries appended since the index was last written
+  // have to be read. The index is brought up to date on Close().
+  // Returns the number of entries.
+  u32 OpenIndexed(const std::string& filename)
+  {
+    static_assert(std::is_trivially_copyable<K>::value, "K must be a trivially copyable type");
+
+    Close();
+    m_num_entries = 0;
+    m_discarded_stale_cache = false;
+
+    m_file.Open(filename, "r+b");
+    const u64 file_size = m_file.GetSize();
+
+    m_header.Init(sizeof(K), sizeof(V));
+    if (!m_file.IsOpen() || !ValidateHeader())
+    {
+      m_discarded_stale_cache = m_file.IsOpen() && file_size != 0;
+      Recreate(filename);
+      m_indexed = true;
+      m_index_filename = filename + ".idx";
+      return 0;
+    }
+
+    m_indexed = true;
+    m_index_filename = filename + ".idx";
+    m_mapping = MappedFile::Map(m_file, MappedFile::AccessPattern::Normal);
+
+    u64 offset = OpenIndex(file_size);
+    const u64 indexed_size = offset;
+    offset = ReadUnindexedEntries(offset, file_size);
+
+    // If the entries after the index don't continue from it, the cache was rewritten since the
+    // index was made.
+    if (m_index_mapping && offset == indexed_size && offset != file_size)
+    {
+      m_index_mapping.reset();
+      m_num_entries = 0;
+      m_unindexed_entries.clear();
+      offset = ReadUnindexedEntries(sizeof(LinearDiskCacheHeader), file_size);
+    }
+
+    m_file.Seek(offset, File::SeekOrigin::Begin);
+    return m_num_entries;
+  }
+
+  // Copies the most recent value of the key to *value.
+  // Only finds anything if the cache was opened with OpenIndexed.
+  bool Find(const K& key, std::vector<V>* value)
+  {
+    if (!m_indexed)
+      return false;
+
+    const u64 hash = HashLinearDiskCacheKey(&key, sizeof(K));
+    std::optional<u64> offset = FindUnindexedEntry(key, hash);
+    if (!offset)
+      offset = FindIndexedEntry(key, hash);
+
+    u32 value_size;
+    if (!offset || !ReadAt(*offset, &value_size, sizeof(value_size)))
+      return false;
+
+    value->resize(value_size);
+    return ReadAt(*offset + sizeof(u32) + sizeof(K), value->data(), u64{value_size} * sizeof(V));
+  }
+
+  // Whether the last OpenAndRead replaced a file that was written by another version of Dolphin
+  // or was damaged.
+  bool DiscardedStaleCache() const { return m_discarded_stale_cache; }
+
   void Sync() { m_file.Flush(); }
   void Close()
   {
+    if (m_indexed && m_file.IsOpen() && !m_unindexed_entries.empty())
+      WriteIndex();
+
+    m_indexed = false;
+    m_mapping.reset();
+    m_index_mapping.reset();
+    m_unindexed_entries.clear();
+
     if (m_file.IsOpen())
       m_file.Close();
   }
@@ -128,6 +302,9 @@ public:
   {
     // TODO: Should do a check that we don't already have "key"? (I think each caller does that
     // already.)
+    if (m_indexed)
+      m_unindexed_entries.emplace(HashLinearDiskCacheKey(&key, sizeof(K)), m_file.Tell());
+
     m_file.WriteArray(&value_size, 1);
     m_file.WriteArray(&key, 1);
     m_file.WriteArray(value, value_size);
@@ -137,32 +314,227 @@ public:
 
 private:
   void WriteHeader() { m_file.WriteArray(&m_header, 1); }
-  bool ValidateHeader()
+
+  void Recreate(const std::string& filename)
   {
-    char file_header[sizeof(Header)];
+    Close();
+    // An index of the old file would point at the wrong entries.
+    File::Delete(filename + ".idx", File::IfAbsentBehavior::NoConsoleWarning);
+    m_file.Open(filename, "w+b");
+    WriteHeader();
+  }
 
-    return (m_file.ReadArray(file_header, sizeof(Header)) &&
-            !memcmp((const char*)&m_header, file_header, sizeof(Header)));
+  // Reads from the cache file, through the mapping where it covers the data.
+  bool ReadAt(u64 offset, void* data, u64 size)
+  {
+    if (m_mapping && offset <= m_mapping->GetSize() && size <= m_mapping->GetSize() - offset)
+    {
+      std::memcpy(data, m_mapping->GetData() + offset, size);
+      return true;
+    }
+
+    const u64 position = m_file.Tell();
+    const bool success =
+        m_file.Seek(offset, File::SeekOrigin::Begin) && m_file.ReadBytes(data, size);
+    m_file.ClearError();
+    m_file.Seek(position, File::SeekOrigin::Begin);
+    return success;
+  }
+
+  bool HasKeyAt(u64 entry_offset, const K& key)
+  {
+    K entry_key;
+    return ReadAt(entry_offset + sizeof(u32), &entry_key, sizeof(K)) &&
+           std::memcmp(&entry_key, &key, sizeof(K)) == 0;
+  }
+
+  // Maps the index if it's valid for this cache, and returns the size of the cache file it covers.
+  u64 OpenIndex(u64 file_size)
+  {
+    File::IOFile index_file(m_index_filename, "rb");
+    m_index_mapping = MappedFile::Map(index_file, MappedFile::AccessPattern::Normal);
+    if (m_index_mapping && m_index_mapping->GetSize() >= sizeof(LinearDiskCacheIndexHeader))
+    {
+      LinearDiskCacheIndexHeader header;
+      std::memcpy(&header, m_index_mapping->GetData(), sizeof(header));
+
+      u32 last_entry_number = 0;
+      K last_key{};
+      if (header.entry_count != 0 && header.cache_size >= sizeof(u32))
+      {
+        ReadAt(header.cache_size - sizeof(u32), &last_entry_number, sizeof(u32));
+        ReadAt(header.last_entry_offset + sizeof(u32), &last_key, sizeof(K));
+      }
+      const bool last_key_matches =
+          header.entry_count == 0 ||
+          HashLinearDiskCacheKey(&last_key, sizeof(K)) == header.last_entry_key_hash;
+
+      if (header.id == LinearDiskCacheIndexHeader::ID &&
+          header.version == LinearDiskCacheIndexHeader::VERSION &&
+          std::memcmp(&header.cache_header, &m_header, sizeof(m_header)) == 0 &&
+          header.cache_size >= sizeof(LinearDiskCacheHeader) && header.cache_size <= file_size &&
+          last_entry_number == header.entry_count && last_key_matches &&
+          std::has_single_bit(header.bucket_count) &&
+          m_index_mapping->GetSize() == sizeof(header) + u64{header.bucket_count} *
+                                                             sizeof(LinearDiskCacheIndexSlot))
+      {
+        m_index_bucket_count = header.bucket_count;
+        m_num_entries = header.entry_count;
+        return header.cache_size;
+      }
+    }
+
+    m_index_mapping.reset();
+    return sizeof(LinearDiskCacheHeader);
+  }
+
+  // Adds the entries from the offset on to m_unindexed_entries, and returns the end of the last
+  // valid one.
+  u64 ReadUnindexedEntries(u64 offset, u64 file_size)
+  {
+    u32 value_size;
+    K key;
+    while (ReadAt(offset, &value_size, sizeof(value_size)))
+    {
+      const u64 entry_size = sizeof(u32) + sizeof(K) + u64{value_size} * sizeof(V) + sizeof(u32);
+      u32 entry_number;
+      if (entry_size > file_size - offset || !ReadAt(offset + sizeof(u32), &key, sizeof(K)) ||
+          !ReadAt(offset + entry_size - sizeof(u32), &entry_number, sizeof(u32)) ||
+          entry_number != m_num_entries + 1)
+      {
+        break;
+      }
+
+      m_unindexed_entries.emplace(HashLinearDiskCacheKey(&key, sizeof(K)), offset);
+      m_num_entries++;
+      offset += entry_size;
+    }
+    return offset;
+  }
+
+  std::optional<u64> FindUnindexedEntry(const K& key, u64 hash)
+  {
+    // Newer entries replace older ones.
+    std::optional<u64> result;
+    const auto [begin, end] = m_unindexed_entries.equal_range(hash);
+    for (auto it = begin; it != end; ++it)
+    {
+      if ((!result || it->second > *result) && HasKeyAt(it->second, key))
+        result = it->second;
+    }
+    return result;
+  }
+
+  std::optional<u64> FindIndexedEntry(const K& key, u64 hash)
+  {
+    if (!m_index_mapping)
+      return std::nullopt;
+
+    const u8* slots = m_index_mapping->GetData() + sizeof(LinearDiskCacheIndexHeader);
+    const u32 mask = m_index_bucket_count - 1;
+    for (u32 i = hash & mask;; i = (i + 1) & mask)
+    {
+      LinearDiskCacheIndexSlot slot;
+      std::memcpy(&slot, slots + i * sizeof(slot), sizeof(slot));
+      if (slot.entry_offset == 0)
+        return std::nullopt;
+      if (slot.key_hash == hash && HasKeyAt(slot.entry_offset, key))
+        return slot.entry_offset;
+    }
   }
 
-  struct Header
+  void WriteIndex()
   {
-    void Init()
+    std::vector<LinearDiskCacheIndexSlot> entries;
+    if (m_index_mapping)
     {
-      // Null-terminator is intentionally not copied.
-      std::memcpy(&id, "DCAC", sizeof(u32));
-      std::memcpy(ver, Common::GetScmRevGitStr().c_str(),
-                  std::min(Common::GetScmRevGitStr().size(), sizeof(ver)));
+      const u8* slots = m_index_mapping->GetData() + sizeof(LinearDiskCacheIndexHeader);
+      for (u32 i = 0; i < m_index_bucket_count; i++)
+      {
+        LinearDiskCacheIndexSlot slot;
+        std::memcpy(&slot, slots + i * sizeof(slot), sizeof(slot));
+        if (slot.entry_offset != 0)
+          entries.push_back(slot);
+      }
     }
 
-    u32 id = 0;
-    const u16 key_t_size = sizeof(K);
-    const u16 value_t_size = sizeof(V);
-    char ver[40] = {};
+    // Unindexed entries come last and in file order, so that they replace older values.
+    const size_t indexed_count = entries.size();
+    for (const auto& [hash, offset] : m_unindexed_entries)
+      entries.push_back({hash, offset});
+    std::sort(entries.begin() + indexed_count, entries.end(),
+              [](const auto& a, const auto& b) { return a.entry_offset < b.entry_offset; });
 
-  } m_header;
+    const u32 bucket_count = std::bit_ceil(std::max<u32>(static_cast<u32>(entries.size()) * 2, 16));
+    const u32 mask = bucket_count - 1;
+    std::vector<LinearDiskCacheIndexSlot> slots(bucket_count, LinearDiskCacheIndexSlot{0, 0});
+    for (const LinearDiskCacheIndexSlot& entry : entries)
+    {
+      for (u32 i = entry.key_hash & mask;; i = (i + 1) & mask)
+      {
+        LinearDiskCacheIndexSlot& slot = slots[i];
+        if (slot.entry_offset == 0 ||
+            (slot.key_hash == entry.key_hash && HasSameKey(slot.entry_offset, entry.entry_offset)))
+        {
+          slot = entry;
+          break;
+        }
+      }
+    }
+
+    LinearDiskCacheIndexHeader header;
+    header.cache_header = m_header;
+    header.cache_size = m_file.Tell();
+    header.entry_count = m_num_entries;
+    header.bucket_count = bucket_count;
+    for (const LinearDiskCacheIndexSlot& entry : entries)
+    {
+      if (entry.entry_offset >= header.last_entry_offset)
+      {
+        header.last_entry_offset = entry.entry_offset;
+        header.last_entry_key_hash = entry.key_hash;
+      }
+    }
+
+    m_file.Flush();
+    m_index_mapping.reset();
+
+    const std::string temp_filename = m_index_filename + ".tmp";
+    File::IOFile index_file(temp_filename, "wb");
+    const bool success = index_file.WriteArray(&header, 1) &&
+                         index_file.WriteArray(slots.data(), slots.size());
+    index_file.Close();
+    if (!success || !File::Rename(temp_filename, m_index_filename))
+      File::Delete(temp_filename, File::IfAbsentBehavior::NoConsoleWarning);
+  }
+
+  bool HasSameKey(u64 entry_offset_a, u64 entry_offset_b)
+  {
+    K key;
+    return ReadAt(entry_offset_b + sizeof(u32), &key, sizeof(K)) &&
+           HasKeyAt(entry_offset_a, key);
+  }
+  bool ValidateHeader()
+  {
+    char file_header[sizeof(LinearDiskCacheHeader)];
+
+    return (m_file.ReadArray(file_header, sizeof(LinearDiskCacheHeader)) &&
+            !memcmp((const char*)&m_header, file_header, sizeof(LinearDiskCacheHeader)));
+  }
+
+  LinearDiskCacheHeader m_header;
 
   File::IOFile m_file;
   u32 m_num_entries = 0;
+  bool m_discarded_stale_cache = false;
+
+  // Only used after OpenIndexed.
+  bool m_indexed = false;
+  std::string m_index_filename;
+  std::unique_ptr<MappedFile> m_mapping;
+  std::unique_ptr<MappedFile> m_index_mapping;
+  u32 m_index_bucket_count = 0;
+  // Offsets of the entries that aren't in the index file yet, by the hash of their key.
+  std::unordered_multimap<u64, u64> m_unindexed_entries;
 };
 }  // namespace Common
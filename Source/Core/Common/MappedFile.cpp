@@ -0,0 +1,129 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Common/MappedFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+
+#ifdef _WIN32
+#include "Common/CommonFuncs.h"
+#endif
+
+namespace Common
+{
+MappedFile::MappedFile(const u8* data, u64 size) : m_data(data), m_size(size)
+{
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+  UnmapViewOfFile(m_data);
+#else
+  munmap(const_cast<u8*>(m_data), m_size);
+#endif
+}
+
+std::unique_ptr<MappedFile> MappedFile::Map(File::IOFile& file, AccessPattern access_pattern)
+{
+  const u64 size = file.GetSize();
+  if (!file.IsOpen() || size == 0 || size > static_cast<u64>(SIZE_MAX))
+    return nullptr;
+
+#ifdef _WIN32
+  const HANDLE file_handle =
+      reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file.GetHandle())));
+  if (file_handle == INVALID_HANDLE_VALUE)
+    return nullptr;
+
+  const HANDLE mapping_handle =
+      CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping_handle)
+  {
+    ERROR_LOG_FMT(COMMON, "CreateFileMapping failed: {}", GetLastErrorString());
+    return nullptr;
+  }
+
+  void* data = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+
+  // The view keeps the file mapping object alive
+  CloseHandle(mapping_handle);
+
+  if (!data)
+  {
+    ERROR_LOG_FMT(COMMON, "MapViewOfFile failed: {}", GetLastErrorString());
+    return nullptr;
+  }
+#else
+  void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileno(file.GetHandle()), 0);
+  if (data == MAP_FAILED)
+  {
+    ERROR_LOG_FMT(COMMON, "mmap failed: {}", std::strerror(errno));
+    return nullptr;
+  }
+#endif
+
+  std::unique_ptr<MappedFile> mapped_file(new MappedFile(static_cast<const u8*>(data), size));
+  if (access_pattern != AccessPattern::Normal)
+    mapped_file->SetAccessPattern(access_pattern);
+  return mapped_file;
+}
+
+void MappedFile::SetAccessPattern(AccessPattern access_pattern) const
+{
+#if defined(_WIN32)
+  if (access_pattern == AccessPattern::Sequential)
+  {
+    // Windows has no equivalent of MADV_SEQUENTIAL for mapped views, but prefetching the
+    // beginning of the file gets the read-ahead going.
+    WIN32_MEMORY_RANGE_ENTRY range{const_cast<u8*>(m_data),
+                                   static_cast<SIZE_T>(std::min<u64>(m_size, 0x1000000))};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+  }
+#elif defined(POSIX_MADV_SEQUENTIAL)
+  const int advice =
+      access_pattern == AccessPattern::Sequential ? POSIX_MADV_SEQUENTIAL : POSIX_MADV_NORMAL;
+  if (posix_madvise(const_cast<u8*>(m_data), m_size, advice) != 0)
+    WARN_LOG_FMT(COMMON, "posix_madvise failed");
+#endif
+}
+
+void MappedFile::Prefetch(const u8* data, u64 size)
+{
+  // No supported system has pages smaller than this
+  constexpr uintptr_t MIN_PAGE_SIZE = 0x1000;
+
+  if (size == 0)
+    return;
+
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(data) & ~(MIN_PAGE_SIZE - 1);
+  const uintptr_t end = reinterpret_cast<uintptr_t>(data) + size;
+
+  // Let the OS read the whole range at once instead of one fault at a time...
+#if defined(_WIN32)
+  WIN32_MEMORY_RANGE_ENTRY range{reinterpret_cast<void*>(begin), static_cast<SIZE_T>(end - begin)};
+  PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#elif defined(POSIX_MADV_WILLNEED)
+  posix_madvise(reinterpret_cast<void*>(begin), end - begin, POSIX_MADV_WILLNEED);
+#endif
+
+  // ...and wait for it, since both of the above only start the reads.
+  for (uintptr_t page = begin; page < end; page += MIN_PAGE_SIZE)
+    static_cast<void>(*reinterpret_cast<const volatile u8*>(page));
+}
+}  // namespace Common
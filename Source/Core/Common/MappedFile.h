@@ -0,0 +1,55 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+
+#include "Common/CommonTypes.h"
+
+namespace File
+{
+class IOFile;
+}
+
+namespace Common
+{
+// A read-only memory mapping of an entire file. Reading from the mapping is thread-safe.
+class MappedFile final
+{
+public:
+  enum class AccessPattern
+  {
+    Normal,
+    Sequential,
+  };
+
+  // Returns nullptr if the file could not be mapped (for instance because it is empty).
+  // The mapping stays valid after the IOFile is closed.
+  static std::unique_ptr<MappedFile> Map(File::IOFile& file, AccessPattern access_pattern);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile(MappedFile&&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile& operator=(MappedFile&&) = delete;
+
+  const u8* GetData() const { return m_data; }
+  u64 GetSize() const { return m_size; }
+
+  // Tells the OS how the mapping is going to be accessed, so that it can adjust its read-ahead.
+  // This is only a hint, and it does nothing on systems that don't support it.
+  void SetAccessPattern(AccessPattern access_pattern) const;
+
+  // Faults in the pages of a range of a mapping, so that whichever thread reads the range next
+  // doesn't have to wait for the disk.
+  static void Prefetch(const u8* data, u64 size);
+
+private:
+  MappedFile(const u8* data, u64 size);
+
+  const u8* m_data;
+  u64 m_size;
+};
+}  // namespace Common
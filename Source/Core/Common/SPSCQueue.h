@@ -7,8 +7,10 @@
 // single producer, single consumer queue
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cstddef>
+#include <type_traits>
 
 #include "Common/CommonTypes.h"
 
@@ -106,4 +108,71 @@ private:
   ElementPtr* m_read_ptr;
   std::atomic<u32> m_size;
 };
+
+// A lockless single producer, single consumer ring buffer with a fixed capacity. Unlike
+// SPSCQueue, it never allocates memory and transfers elements in bulk, which makes it suitable
+// for passing sample data to real-time threads.
+template <typename T, size_t Capacity>
+class SPSCRingBuffer
+{
+  static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+  static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+  size_t Size() const
+  {
+    return m_write_index.load(std::memory_order_acquire) -
+           m_read_index.load(std::memory_order_acquire);
+  }
+
+  // Producer only. Copies as many of the count elements as fit into the buffer and returns how
+  // many were copied.
+  size_t Push(const T* data, size_t count)
+  {
+    const size_t write_index = m_write_index.load(std::memory_order_relaxed);
+    const size_t read_index = m_read_index.load(std::memory_order_acquire);
+    count = std::min(count, Capacity - (write_index - read_index));
+
+    const size_t offset = write_index & MASK;
+    const size_t first = std::min(count, Capacity - offset);
+    std::copy_n(data, first, m_buffer.begin() + offset);
+    std::copy_n(data + first, count - first, m_buffer.begin());
+
+    m_write_index.store(write_index + count, std::memory_order_release);
+    return count;
+  }
+
+  // Consumer only. Copies up to count elements out of the buffer and returns how many were
+  // copied.
+  size_t Pop(T* data, size_t count)
+  {
+    const size_t read_index = m_read_index.load(std::memory_order_relaxed);
+    const size_t write_index = m_write_index.load(std::memory_order_acquire);
+    count = std::min(count, write_index - read_index);
+
+    const size_t offset = read_index & MASK;
+    const size_t first = std::min(count, Capacity - offset);
+    std::copy_n(m_buffer.begin() + offset, first, data);
+    std::copy_n(m_buffer.begin(), count - first, data + first);
+
+    m_read_index.store(read_index + count, std::memory_order_release);
+    return count;
+  }
+
+  // Consumer only. Discards all elements that are currently in the buffer.
+  void Clear()
+  {
+    m_read_index.store(m_write_index.load(std::memory_order_acquire), std::memory_order_release);
+  }
+
+private:
+  static constexpr size_t MASK = Capacity - 1;
+
+  std::array<T, Capacity> m_buffer{};
+  // Both indices only ever increase. Keep them on separate cache lines so that the producer and
+  // the consumer don't keep invalidating each other's cache line.
+  alignas(64) std::atomic<size_t> m_write_index{0};
+  alignas(64) std::atomic<size_t> m_read_index{0};
+};
 }  // namespace Common
@@ -4,6 +4,7 @@
 #include "Core/DSP/DSPAccelerator.h"
 
 #include <algorithm>
+#include <array>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -160,6 +161,118 @@ u16 Accelerator::Read(const s16* coefs)
   return val;
 }
 
+void Accelerator::ReadMemoryBlock(u32 address, u8* data, u32 size)
+{
+  for (u32 i = 0; i < size; ++i)
+    data[i] = ReadMemory(address + i);
+}
+
+void Accelerator::ReadSamples(const s16* coefs, s16* output, u32 count)
+{
+  while (count != 0)
+  {
+    // Nothing but a write to YN2 resumes reads, and Read only does that from OnEndException.
+    if (m_reads_stopped)
+    {
+      std::fill_n(output, count, 0);
+      return;
+    }
+
+    u32 decoded = DecodeRun(coefs, output, count);
+    if (decoded == 0)
+    {
+      *output = static_cast<s16>(Read(coefs));
+      decoded = 1;
+    }
+
+    output += decoded;
+    count -= decoded;
+  }
+}
+
+u32 Accelerator::DecodeRun(const s16* coefs, s16* output, u32 count)
+{
+  // Read raises the end exception after reading the sample at the end address.
+  const u32 current = m_current_address;
+  if (m_end_address >= current)
+    count = std::min(count, m_end_address - current);
+
+  switch (m_sample_format)
+  {
+  case 0x00:  // ADPCM audio
+  {
+    // Stop before the current address reaches the next frame header. That also avoids the two
+    // special cases for end addresses in the last frame, and the current address masking.
+    count = std::min(count, 15 - (current & 15));
+    if (count == 0)
+      return 0;
+
+    const u32 first_byte = current >> 1;
+    std::array<u8, 8> bytes;
+    ReadMemoryBlock(first_byte, bytes.data(), ((current + count - 1) >> 1) - first_byte + 1);
+
+    // Unpacking the nibbles and scaling them doesn't depend on previous samples, so keep it
+    // separate from the prediction to let the compiler vectorize it.
+    const s32 scale = 1 << (m_pred_scale & 0xF);
+    std::array<s32, 16> scaled;
+    for (u32 i = 0; i < count; ++i)
+    {
+      const u32 nibble = (current & 1) + i;
+      const s32 value = (nibble & 1) ? (bytes[nibble >> 1] & 0xF) : (bytes[nibble >> 1] >> 4);
+      scaled[i] = scale * ((value ^ 8) - 8);
+    }
+
+    const int coef_idx = (m_pred_scale >> 4) & 0x7;
+    const s32 coef1 = coefs[coef_idx * 2 + 0];
+    const s32 coef2 = coefs[coef_idx * 2 + 1];
+    s32 yn1 = m_yn1;
+    s32 yn2 = m_yn2;
+    for (u32 i = 0; i < count; ++i)
+    {
+      const s32 val32 = scaled[i] + ((0x400 + coef1 * yn1 + coef2 * yn2) >> 11);
+      yn2 = yn1;
+      yn1 = std::clamp<s32>(val32, -0x7FFF, 0x7FFF);
+      output[i] = static_cast<s16>(yn1);
+    }
+    m_yn1 = static_cast<s16>(yn1);
+    m_yn2 = static_cast<s16>(yn2);
+    break;
+  }
+  case 0x0A:  // 16-bit PCM audio
+  case 0x19:  // 8-bit PCM audio
+  {
+    // Stop before the current address would carry into bit 30, which Read masks off.
+    constexpr u32 PCM_RUN_SIZE = 64;
+    count = std::min({count, PCM_RUN_SIZE, 0x3fffffff - (current & 0x3fffffff)});
+    if (count == 0)
+      return 0;
+
+    std::array<u8, PCM_RUN_SIZE * 2> bytes;
+    if (m_sample_format == 0x0A)
+    {
+      ReadMemoryBlock(current * 2, bytes.data(), count * 2);
+      for (u32 i = 0; i < count; ++i)
+        output[i] = static_cast<s16>(bytes[i * 2] << 8 | bytes[i * 2 + 1]);
+    }
+    else
+    {
+      ReadMemoryBlock(current, bytes.data(), count);
+      for (u32 i = 0; i < count; ++i)
+        output[i] = static_cast<s16>(bytes[i] << 8);
+    }
+
+    m_yn2 = count >= 2 ? output[count - 2] : m_yn1;
+    m_yn1 = output[count - 1];
+    break;
+  }
+  default:
+    return 0;
+  }
+
+  m_current_address = current + count;
+  return count;
+}
+
 void Accelerator::DoState(PointerWrap& p)
 {
   p.Do(m_start_address);
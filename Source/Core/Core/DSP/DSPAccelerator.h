@@ -15,6 +15,9 @@ public:
   virtual ~Accelerator() = default;
 
   u16 Read(const s16* coefs);
+  // Same as calling Read count times, but runs of samples that don't reach an ADPCM frame header
+  // or the end address are fetched and decoded in one go.
+  void ReadSamples(const s16* coefs, s16* output, u32 count);
   // Zelda ucode reads ARAM through 0xffd3.
   u16 ReadD3();
   void WriteD3(u16 value);
@@ -40,6 +43,8 @@ protected:
   virtual void OnEndException() = 0;
   virtual u8 ReadMemory(u32 address) = 0;
   virtual void WriteMemory(u32 address, u8 value) = 0;
+  // Reads size consecutive bytes starting at address, wrapping around like the address does.
+  virtual void ReadMemoryBlock(u32 address, u8* data, u32 size);
 
   // DSP accelerator registers.
   u32 m_start_address = 0;
@@ -54,5 +59,10 @@ protected:
   // and updating the current address register, unless the YN2 register is written to.
   // This is kept track of internally; this state is not exposed via any register.
   bool m_reads_stopped = false;
+
+private:
+  // Decodes up to count samples for which Read wouldn't have to handle anything but the sample
+  // itself. Returns how many samples were decoded, which is 0 if the next one needs Read.
+  u32 DecodeRun(const s16* coefs, s16* output, u32 count);
 };
 }  // namespace DSP
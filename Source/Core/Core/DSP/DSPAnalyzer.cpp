@@ -83,6 +83,7 @@ void Analyzer::AnalyzeRange(const SDSP& dsp, u16 start_addr, u16 end_addr)
 
   // Next, we'll scan for potential idle skips.
   FindIdleSkips(dsp, start_addr, end_addr);
+  FindPollLoops(dsp, start_addr, end_addr);
 
   INFO_LOG_FMT(DSPLLE, "Finished analysis.");
 }
@@ -170,4 +171,73 @@ void Analyzer::FindIdleSkips(const SDSP& dsp, u16 start_addr, u16 end_addr)
     }
   }
 }
+
+// Returns the register that a LR or LRS at addr loads from a mailbox or DSCR, or 0 if the
+// instruction is anything else. size is set to the size of the instruction.
+static u16 GetPolledRegister(const SDSP& dsp, u16 addr, u16* size)
+{
+  const UDSPInstruction inst = dsp.ReadIMEM(addr);
+  u16 source;
+  u16 reg;
+  if ((inst & 0xf800) == 0x2000)
+  {
+    // LRS $(0x18+D), @M
+    source = 0xff00 | (inst & 0xff);
+    reg = 0x18 + ((inst >> 8) & 0x7);
+    *size = 1;
+  }
+  else if ((inst & 0xffe0) == 0x00c0)
+  {
+    // LR $D, @M
+    source = dsp.ReadIMEM(static_cast<u16>(addr + 1));
+    reg = inst & 0x1f;
+    *size = 2;
+  }
+  else
+  {
+    return 0;
+  }
+
+  if (source != (0xff00 | DSP_DMBH) && source != (0xff00 | DSP_CMBH) &&
+      source != (0xff00 | DSP_DSCR))
+  {
+    return 0;
+  }
+
+  return reg;
+}
+
+void Analyzer::FindPollLoops(const SDSP& dsp, u16 start_addr, u16 end_addr)
+{
+  for (u16 addr = start_addr; addr < end_addr; addr++)
+  {
+    if (!IsStartOfInstruction(addr) || IsIdleSkip(addr))
+      continue;
+
+    u16 load_size;
+    const u16 reg = GetPolledRegister(dsp, addr, &load_size);
+    // Only $ac0.m and $ac1.m can be tested with ANDF/ANDCF.
+    if (reg != DSP_REG_ACM0 && reg != DSP_REG_ACM1)
+      continue;
+
+    // ANDF/ANDCF $acD.m, #I
+    const u16 test_addr = addr + load_size;
+    const UDSPInstruction test = dsp.ReadIMEM(test_addr);
+    if ((test & 0xfeff) != 0x02a0 && (test & 0xfeff) != 0x02c0)
+      continue;
+    if (DSP_REG_ACM0 + ((test >> 8) & 0x1) != reg)
+      continue;
+
+    // Jcc back to the load, with any condition except "always"
+    const u16 jump_addr = test_addr + 2;
+    const UDSPInstruction jump = dsp.ReadIMEM(jump_addr);
+    if ((jump & 0xfff0) != 0x0290 || (jump & 0xf) == 0xf)
+      continue;
+    if (dsp.ReadIMEM(static_cast<u16>(jump_addr + 1)) != addr)
+      continue;
+
+    INFO_LOG_FMT(DSPLLE, "Poll loop found at {:04x}", addr);
+    m_code_flags[addr] |= CODE_IDLE_SKIP;
+  }
+}
 }  // namespace DSP
@@ -110,6 +110,12 @@ private:
   // Finds locations within the range [start_addr, end_addr) that may contain idle skips.
   void FindIdleSkips(const SDSP& dsp, u16 start_addr, u16 end_addr);
 
+  // Finds loops within the range [start_addr, end_addr) that do nothing but poll a mailbox or the
+  // DMA control register until a bit changes, and marks them as idle skips. Unlike the signatures
+  // used by FindIdleSkips, this matches any register and condition, but only if the conditional
+  // jump at the end of the loop really goes back to the load.
+  void FindPollLoops(const SDSP& dsp, u16 start_addr, u16 end_addr);
+
   // Retrieves the flags set during analysis for code in memory.
   [[nodiscard]] u8 GetCodeFlags(u16 address) const { return m_code_flags[address]; }
 
@@ -27,7 +27,6 @@ namespace DSP::JIT::x64
 {
 constexpr size_t COMPILED_CODE_SIZE = 2097152;
 constexpr size_t MAX_BLOCK_SIZE = 250;
-constexpr u16 DSP_IDLE_SKIP_CYCLES = 0x1000;
 
 DSPEmitter::DSPEmitter(DSPCore& dsp)
     : m_compile_status_register{SR_INT_ENABLE | SR_EXT_INT_ENABLE}, m_blocks(MAX_BLOCKS),
@@ -78,7 +77,6 @@ void DSPEmitter::ClearIRAM()
     m_blocks[i] = (DSPCompiledCode)m_stub_entry_point;
     m_block_links[i] = nullptr;
     m_block_size[i] = 0;
-    m_unresolved_jumps[i].clear();
   }
   m_dsp_core.DSPState().reset_dspjit_codespace = true;
 }
@@ -94,7 +92,6 @@ void DSPEmitter::ClearIRAMandDSPJITCodespaceReset()
     m_blocks[i] = (DSPCompiledCode)m_stub_entry_point;
     m_block_links[i] = nullptr;
     m_block_size[i] = 0;
-    m_unresolved_jumps[i].clear();
   }
   m_dsp_core.DSPState().reset_dspjit_codespace = false;
 }
@@ -228,7 +225,6 @@ void DSPEmitter::Compile(u16 start_addr)
 {
   // Remember the current block address for later
   m_start_address = start_addr;
-  m_unresolved_jumps[start_addr].clear();
 
   const u8* entryPoint = AlignCode16();
 
@@ -254,9 +250,6 @@ void DSPEmitter::Compile(u16 start_addr)
     m_block_size[start_addr]++;
     m_compile_pc += opcode->size;
 
-    // If the block was trying to link into itself, remove the link
-    m_unresolved_jumps[start_addr].remove(m_compile_pc);
-
     fixup_pc = true;
 
     // Handle loop condition, only if current instruction was flagged as a loop destination
@@ -282,14 +275,7 @@ void DSPEmitter::Compile(u16 start_addr)
       DSPJitRegCache c(m_gpr);
       HandleLoop();
       m_gpr.SaveRegs();
-      if (!Host::OnThread() && analyzer.IsIdleSkip(start_addr))
-      {
-        MOV(16, R(EAX), Imm16(DSP_IDLE_SKIP_CYCLES));
-      }
-      else
-      {
-        MOV(16, R(EAX), Imm16(m_block_size[start_addr]));
-      }
+      MOV(16, R(EAX), Imm16(m_block_size[start_addr]));
       JMP(m_return_dispatcher, Jump::Near);
       m_gpr.LoadRegs(false);
       m_gpr.FlushRegs(c, false);
@@ -318,14 +304,7 @@ void DSPEmitter::Compile(u16 start_addr)
         DSPJitRegCache c(m_gpr);
         // don't update g_dsp.pc -- the branch insn already did
         m_gpr.SaveRegs();
-        if (!Host::OnThread() && analyzer.IsIdleSkip(start_addr))
-        {
-          MOV(16, R(EAX), Imm16(DSP_IDLE_SKIP_CYCLES));
-        }
-        else
-        {
-          MOV(16, R(EAX), Imm16(m_block_size[start_addr]));
-        }
+        MOV(16, R(EAX), Imm16(m_block_size[start_addr]));
         JMP(m_return_dispatcher, Jump::Near);
         m_gpr.LoadRegs(false);
         m_gpr.FlushRegs(c, false);
@@ -341,37 +320,6 @@ void DSPEmitter::Compile(u16 start_addr)
     }
   }
 
-  if (fixup_pc)
-  {
-    MOV(16, M_SDSP_pc(), Imm16(m_compile_pc));
-  }
-
-  m_blocks[start_addr] = (DSPCompiledCode)entryPoint;
-
-  // Mark this block as a linkable destination if it does not contain
-  // any unresolved CALL's
-  if (m_unresolved_jumps[start_addr].empty())
-  {
-    m_block_links[start_addr] = m_block_link_entry;
-
-    for (size_t i = 0; i < 0xffff; ++i)
-    {
-      if (!m_unresolved_jumps[i].empty())
-      {
-        // Check if there were any blocks waiting for this block to be linkable
-        size_t size = m_unresolved_jumps[i].size();
-        m_unresolved_jumps[i].remove(start_addr);
-        if (m_unresolved_jumps[i].size() < size)
-        {
-          // Mark the block to be recompiled again
-          m_blocks[i] = (DSPCompiledCode)m_stub_entry_point;
-          m_block_links[i] = nullptr;
-          m_block_size[i] = 0;
-        }
-      }
-    }
-  }
-
   if (m_block_size[start_addr] == 0)
   {
     // just a safeguard, should never happen anymore.
@@ -380,38 +328,25 @@ void DSPEmitter::Compile(u16 start_addr)
     m_block_size[start_addr] = 1;
   }
 
-  m_gpr.SaveRegs();
-  if (!Host::OnThread() && analyzer.IsIdleSkip(start_addr))
-  {
-    MOV(16, R(EAX), Imm16(DSP_IDLE_SKIP_CYCLES));
-  }
-  else
+  if (fixup_pc)
   {
-    MOV(16, R(EAX), Imm16(m_block_size[start_addr]));
+    MOV(16, M_SDSP_pc(), Imm16(m_compile_pc));
+
+    // The block ended without a branch, so it can continue straight into the next one.
+    WriteBlockLink(m_compile_pc);
   }
+
+  m_blocks[start_addr] = (DSPCompiledCode)entryPoint;
+  m_block_links[start_addr] = m_block_link_entry;
+
+  m_gpr.SaveRegs();
+  MOV(16, R(EAX), Imm16(m_block_size[start_addr]));
   JMP(m_return_dispatcher, Jump::Near);
 }
 
 void DSPEmitter::CompileCurrent(DSPEmitter& emitter)
 {
   emitter.Compile(emitter.m_dsp_core.DSPState().pc);
-
-  bool retry = true;
-
-  while (retry)
-  {
-    retry = false;
-    for (size_t i = 0; i < 0xffff; ++i)
-    {
-      if (!emitter.m_unresolved_jumps[i].empty())
-      {
-        const u16 address_to_compile = emitter.m_unresolved_jumps[i].front();
-        emitter.Compile(address_to_compile);
-        if (!emitter.m_unresolved_jumps[i].empty())
-          retry = true;
-      }
-    }
-  }
 }
 
 const u8* DSPEmitter::CompileStub()
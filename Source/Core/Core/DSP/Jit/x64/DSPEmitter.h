@@ -3,9 +3,7 @@
 
 #pragma once
 
-#include <array>
 #include <cstddef>
-#include <list>
 #include <vector>
 
 #include "Common/CommonTypes.h"
@@ -211,7 +209,8 @@ private:
 
   void FallBackToInterpreter(UDSPInstruction inst);
 
-  void WriteBranchExit();
+  bool IsIdleLoopBranch(u16 dest) const;
+  void WriteBranchExit(bool idle_loop = false);
   void WriteBlockLink(u16 dest);
 
   void ReJitConditional(UDSPInstruction opc, void (DSPEmitter::*conditional_fn)(UDSPInstruction));
@@ -310,6 +309,10 @@ private:
 
   static constexpr size_t MAX_BLOCKS = 0x10000;
 
+  // The number of cycles that a block reports when it branches back into an idle loop, which
+  // makes the dispatcher give up the rest of the time slice.
+  static constexpr u16 IDLE_SKIP_CYCLES = 0x1000;
+
   DSPJitRegCache m_gpr{*this};
 
   u16 m_compile_pc;
@@ -321,8 +324,6 @@ private:
   std::vector<Block> m_block_links;
   Block m_block_link_entry;
 
-  std::array<std::list<u16>, MAX_BLOCKS> m_unresolved_jumps;
-
   u16 m_cycles_left = 0;
 
   // The index of the last stored ext value (compile time).
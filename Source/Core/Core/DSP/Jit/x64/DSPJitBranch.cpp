@@ -7,6 +7,7 @@
 
 #include "Core/DSP/DSPAnalyzer.h"
 #include "Core/DSP/DSPCore.h"
+#include "Core/DSP/DSPHost.h"
 #include "Core/DSP/DSPTables.h"
 
 using namespace Gen;
@@ -97,13 +98,24 @@ void DSPEmitter::ReJitConditional(const UDSPInstruction opc,
   SetJumpTarget(skip_code);
 }
 
-void DSPEmitter::WriteBranchExit()
+// Branching back into a mailbox or DMA poll loop means that the DSP is waiting for the CPU, so
+// there is no point in running it any further until the next time slice. Other exits of idle loop
+// blocks (i.e. when the loop ends) are counted normally, and so are branches to a loop from
+// outside of it, which only start waiting. Blocks end before idle skip addresses, so the loop is
+// the block that starts at dest.
+bool DSPEmitter::IsIdleLoopBranch(u16 dest) const
+{
+  return dest == m_start_address && m_compile_pc >= dest &&
+         m_dsp_core.DSPState().GetAnalyzer().IsIdleSkip(dest);
+}
+
+void DSPEmitter::WriteBranchExit(bool idle_loop)
 {
   DSPJitRegCache c(m_gpr);
   m_gpr.SaveRegs();
-  if (m_dsp_core.DSPState().GetAnalyzer().IsIdleSkip(m_start_address))
+  if (idle_loop)
   {
-    MOV(16, R(EAX), Imm16(0x1000));
+    MOV(16, R(EAX), Imm16(IDLE_SKIP_CYCLES));
   }
   else
   {
@@ -116,42 +128,72 @@ void DSPEmitter::WriteBranchExit()
 
 void DSPEmitter::WriteBlockLink(u16 dest)
 {
-  // Jump directly to the called block if it has already been compiled.
-  if (!(dest >= m_start_address && dest <= m_compile_pc))
+  const u16 cycles = m_block_size[m_start_address];
+
+  m_gpr.FlushRegs();
+
+  // The dispatcher checks these before running a block, so linked blocks have to check them too.
+  // Otherwise a halt or an interrupt from the CPU would only be noticed at the next exit.
+  TEST(8, M_SDSP_control_reg(), Imm8(CR_HALT));
+  FixupBranch halted = J_CC(CC_NZ, Jump::Near);
+  FixupBranch external_interrupt;
+  if (Host::OnThread())
+  {
+    CMP(8, M_SDSP_external_interrupt_waiting(), Imm8(0));
+    external_interrupt = J_CC(CC_NE, Jump::Near);
+  }
+
+  if (m_block_links[dest] != nullptr)
+  {
+    // Jump directly to the destination if it has already been compiled, as long as we have enough
+    // cycles to execute it.
+    MOV(64, R(RAX), ImmPtr(&m_cycles_left));
+    MOV(16, R(ECX), MatR(RAX));
+    CMP(16, R(ECX), Imm16(cycles + m_block_size[dest]));
+    FixupBranch not_enough_cycles = J_CC(CC_BE);
+
+    SUB(16, R(ECX), Imm16(cycles));
+    MOV(16, MatR(RAX), R(ECX));
+    JMP(m_block_links[dest], Jump::Near);
+    SetJumpTarget(not_enough_cycles);
+  }
+  else
   {
-    if (m_block_links[dest] != nullptr)
-    {
-      m_gpr.FlushRegs();
-      // Check if we have enough cycles to execute the next block
-      MOV(64, R(RAX), ImmPtr(&m_cycles_left));
-      MOV(16, R(ECX), MatR(RAX));
-      CMP(16, R(ECX), Imm16(m_block_size[m_start_address] + m_block_size[dest]));
-      FixupBranch notEnoughCycles = J_CC(CC_BE);
-
-      SUB(16, R(ECX), Imm16(m_block_size[m_start_address]));
-      MOV(16, MatR(RAX), R(ECX));
-      JMP(m_block_links[dest], Jump::Near);
-      SetJumpTarget(notEnoughCycles);
-    }
-    else
-    {
-      // The destination has not been compiled yet.  Add it to the list
-      // of blocks that this block is waiting on.
-      m_unresolved_jumps[m_start_address].push_back(dest);
-    }
+    // Otherwise, go through the link table, which gets filled in once the destination has been
+    // compiled. This also covers branches into the block that is being compiled.
+    MOV(64, R(RAX), ImmPtr(&m_block_links[dest]));
+    MOV(64, R(RDX), MatR(RAX));
+    TEST(64, R(RDX), R(RDX));
+    FixupBranch not_compiled = J_CC(CC_Z);
+
+    MOV(64, R(RAX), ImmPtr(&m_block_size[dest]));
+    MOVZX(32, 16, ECX, MatR(RAX));
+    ADD(32, R(ECX), Imm32(cycles));
+    MOV(64, R(RAX), ImmPtr(&m_cycles_left));
+    CMP(16, MatR(RAX), R(ECX));
+    FixupBranch not_enough_cycles = J_CC(CC_BE);
+
+    SUB(16, MatR(RAX), Imm16(cycles));
+    JMPptr(R(RDX));
+    SetJumpTarget(not_compiled);
+    SetJumpTarget(not_enough_cycles);
   }
+
+  SetJumpTarget(halted);
+  if (Host::OnThread())
+    SetJumpTarget(external_interrupt);
 }
 
 void DSPEmitter::r_jcc(const UDSPInstruction opc)
 {
   const u16 dest = m_dsp_core.DSPState().ReadIMEM(m_compile_pc + 1);
-  const DSPOPCTemplate* opcode = GetOpTemplate(opc);
+  const bool idle_loop = IsIdleLoopBranch(dest);
 
-  // If the block is unconditional, attempt to link block
-  if (opcode->uncond_branch)
+  // Link to the destination block, unless the DSP is about to wait for the CPU
+  if (!idle_loop)
     WriteBlockLink(dest);
   MOV(16, M_SDSP_pc(), Imm16(dest));
-  WriteBranchExit();
+  WriteBranchExit(idle_loop);
 }
 // Generic jmp implementation
 // Jcc addressA
@@ -192,13 +234,13 @@ void DSPEmitter::r_call(const UDSPInstruction opc)
   MOV(16, R(DX), Imm16(m_compile_pc + 2));
   dsp_reg_store_stack(StackRegister::Call);
   const u16 dest = m_dsp_core.DSPState().ReadIMEM(m_compile_pc + 1);
-  const DSPOPCTemplate* opcode = GetOpTemplate(opc);
+  const bool idle_loop = IsIdleLoopBranch(dest);
 
-  // If the block is unconditional, attempt to link block
-  if (opcode->uncond_branch)
+  // Link to the destination block, unless the DSP is about to wait for the CPU
+  if (!idle_loop)
     WriteBlockLink(dest);
   MOV(16, M_SDSP_pc(), Imm16(dest));
-  WriteBranchExit();
+  WriteBranchExit(idle_loop);
 }
 // Generic call implementation
 // CALLcc addressA
@@ -23,6 +23,7 @@
 
 #include "Core/HW/DSP.h"
 
+#include <cstring>
 #include <memory>
 
 #include "AudioCommon/AudioCommon.h"
@@ -592,6 +593,41 @@ u8 DSPManager::ReadARAM(u32 address) const
   }
 }
 
+void DSPManager::ReadARAM(u32 address, u8* data, u32 size) const
+{
+  // Copy directly unless the range crosses between MEM1 and MEM2 or wraps around.
+  const u32 last_address = address + size - 1;
+  if (size == 0 || last_address < address || ((address ^ last_address) & 0x10000000) != 0)
+  {
+    for (u32 i = 0; i < size; ++i)
+      data[i] = ReadARAM(address + i);
+    return;
+  }
+
+  if (!m_aram.wii_mode || (address & 0x10000000))
+  {
+    const u32 offset = address & m_aram.mask;
+    if (offset + size - 1 <= m_aram.mask)
+    {
+      std::memcpy(data, m_aram.ptr + offset, size);
+      return;
+    }
+  }
+  else
+  {
+    auto& memory = m_system.GetMemory();
+    const u32 offset = address & memory.GetRamMask();
+    if (offset + size - 1 <= memory.GetRamMask())
+    {
+      memory.CopyFromEmu(data, offset, size);
+      return;
+    }
+  }
+
+  for (u32 i = 0; i < size; ++i)
+    data[i] = ReadARAM(address + i);
+}
+
 void DSPManager::WriteARAM(u8 value, u32 address)
 {
   // TODO: verify this on Wii
@@ -93,6 +93,8 @@ public:
 
   // Audio/DSP Helper
   u8 ReadARAM(u32 address) const;
+  // Same as calling ReadARAM for size consecutive addresses.
+  void ReadARAM(u32 address, u8* data, u32 size) const;
   void WriteARAM(u8 value, u32 address);
 
   // Debugger Helper
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstring>
 #include <iterator>
 
@@ -15,6 +16,7 @@
 #include "Common/IOFile.h"
 #include "Common/Logging/Log.h"
 #include "Common/Swap.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/Core.h"
 #include "Core/DolphinAnalytics.h"
 #include "Core/HW/DSP.h"
@@ -50,6 +52,9 @@ void AXUCode::InitializeShared()
   m_mail_handler.PushMail(DSP_INIT, true);
 
   LoadResamplingCoefficients(false, 0);
+
+  m_voice_render_threads = static_cast<u32>(std::clamp<int>(
+      Config::Get(Config::MAIN_DSP_HLE_AX_THREADS), 1, MAX_VOICE_RENDER_THREADS));
 }
 
 bool AXUCode::LoadResamplingCoefficients(bool require_same_checksum, u32 desired_checksum)
@@ -418,17 +423,13 @@ void AXUCode::ProcessPBList(u32 pb_addr)
   // 32KHz to 48KHz, but AX always process at 32KHz.
   constexpr u32 spms = 32;
 
-  AXPB pb;
-
   auto& memory = m_dsphle->GetSystem().GetMemory();
-  while (pb_addr)
-  {
-    AXBuffers buffers = {{m_samples_main_left, m_samples_main_right, m_samples_main_surround,
-                          m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
-                          m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround}};
-
-    ReadPB(memory, pb_addr, pb, m_crc);
+  const AXBuffers buffers = {{m_samples_main_left, m_samples_main_right, m_samples_main_surround,
+                              m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
+                              m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround}};
 
+  const auto process_pb = [this, &memory](HLEAccelerator* accelerator, AXPB& pb,
+                                          AXBuffers voice_buffers) {
     u32 updates_addr = HILO_TO_32(pb.updates.data);
     u16* updates = (u16*)HLEMemory_Get_Pointer(memory, updates_addr);
 
@@ -436,15 +437,55 @@ void AXUCode::ProcessPBList(u32 pb_addr)
     {
       ApplyUpdatesForMs(curr_ms, pb, pb.updates.num_updates, updates);
 
-      ProcessVoice(static_cast<HLEAccelerator*>(m_accelerator.get()), pb, buffers, spms,
-                   ConvertMixerControl(pb.mixer_control),
+      ProcessVoice(accelerator, pb, voice_buffers, spms, ConvertMixerControl(pb.mixer_control),
                    m_coeffs_checksum ? m_coeffs.data() : nullptr);
 
       // Forward the buffers
-      for (auto& ptr : buffers.ptrs)
+      for (auto& ptr : voice_buffers.ptrs)
         ptr += spms;
     }
+  };
+
+  // Voices can only be rendered ahead of time if their updates don't change where the list
+  // continues, or how many updates are applied.
+  const auto updates_keep_list = [&memory](const AXPB& pb) {
+    constexpr u16 num_updates_off = offsetof(AXPB, updates) / sizeof(u16);
+    constexpr u16 next_pb_end = offsetof(AXPB, this_pb_hi) / sizeof(u16);
+
+    u32 count = 0;
+    for (u16 num_updates : pb.updates.num_updates)
+      count += num_updates;
+    if (count == 0)
+      return true;
 
+    const u16* updates = (u16*)HLEMemory_Get_Pointer(memory, HILO_TO_32(pb.updates.data));
+    for (u32 i = 0; i < count; ++i)
+    {
+      const u16 update_off = Common::swap16(updates[2 * i]);
+      if (update_off < next_pb_end ||
+          (update_off >= num_updates_off && update_off < num_updates_off + 5))
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  auto* accelerator = static_cast<HLEAccelerator*>(m_accelerator.get());
+  if (m_voice_render_threads > 1 &&
+      ProcessPBListInParallel(m_dsphle->GetSystem().GetDSP(), memory, m_crc, pb_addr,
+                              m_voice_render_threads, accelerator, buffers, m_voice_render_workers,
+                              updates_keep_list, process_pb))
+  {
+    return;
+  }
+
+  AXPB pb;
+  while (pb_addr)
+  {
+    ReadPB(memory, pb_addr, pb, m_crc);
+    process_pb(accelerator, pb, buffers);
+    ReportVoiceQuirks(pb);
     WritePB(memory, pb_addr, pb, m_crc);
     pb_addr = HILO_TO_32(pb.next_pb);
   }
@@ -12,12 +12,15 @@
 #pragma once
 
 #include <array>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "Common/BitUtils.h"
 #include "Common/CommonTypes.h"
 #include "Common/Swap.h"
+#include "Common/WorkQueueThread.h"
 #include "Core/HW/DSPHLE/DSPHLE.h"
 #include "Core/HW/DSPHLE/UCodes/UCodes.h"
 #include "Core/HW/Memmap.h"
@@ -70,6 +73,15 @@ enum AXMixControl
   // clang-format on
 };
 
+// A thread that renders voices for ProcessPBListInParallel (see AXVoice.h), with its own
+// accelerator and mixing buffers.
+struct AXVoiceRenderWorker
+{
+  std::unique_ptr<Accelerator> accelerator;
+  std::vector<int> samples;
+  Common::WorkQueueThread<std::function<void()>> thread;
+};
+
 class AXUCode /* not final: subclassed by AXWiiUCode */ : public UCodeInterface
 {
 public:
@@ -110,6 +122,10 @@ protected:
 
   std::unique_ptr<Accelerator> m_accelerator;
 
+  // Number of threads that render the voices of a PB list, including the DSP thread itself.
+  u32 m_voice_render_threads = 1;
+  std::vector<std::unique_ptr<AXVoiceRenderWorker>> m_voice_render_workers;
+
   // Constructs without any GC-specific state, so it can be used by the deriving AXWii.
   AXUCode(DSPHLE* dsphle, u32 crc, bool dummy);
 
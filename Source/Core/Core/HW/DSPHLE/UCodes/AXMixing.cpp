@@ -0,0 +1,485 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/HW/DSPHLE/UCodes/AXMixing.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
+#include "Common/MathUtil.h"
+
+#ifdef _M_ARM_64
+#include <arm_neon.h>
+#endif
+
+namespace DSP::HLE::AXMixing
+{
+namespace
+{
+// Advances the position by one output sample and returns the number of input samples consumed.
+u32 AdvancePosition(u32* curr_pos, u32 ratio)
+{
+  *curr_pos += ratio;
+  const u32 consumed = *curr_pos >> 16;
+  *curr_pos &= 0xFFFF;
+  return consumed;
+}
+
+s16 InterpolateLinear(const s16* samples, u32 frac)
+{
+  // If frac is 0, we can simply take the first sample without any multiplying.
+  if (frac == 0)
+    return samples[0];
+
+  const u16 inv_frac = -frac;
+  return static_cast<s16>((samples[0] * inv_frac + samples[1] * static_cast<s32>(frac)) >> 16);
+}
+
+s16 InterpolatePolyphase(const s16* samples, u32 frac, const s16* coeffs)
+{
+  const s16* c = &coeffs[(frac >> 9) << 2];
+  const s64 sample = (s64(samples[0]) * c[0] + s64(samples[1]) * c[1] + s64(samples[2]) * c[2] +
+                      s64(samples[3]) * c[3]) >>
+                     15;
+  return MathUtil::SaturatingCast<s16>(sample);
+}
+
+// The scalar implementations are also used for whatever is left over by the vectorized loops.
+
+void MixAddGeneric(int* out, const s16* input, u32 count, u16* volume, u16 volume_delta,
+                   s16* dpop)
+{
+  u16 vol = *volume;
+  for (u32 i = 0; i < count; ++i)
+  {
+    const s32 sample = std::clamp((input[i] * s32(vol)) >> 15, -32767, 32767);
+    out[i] += sample;
+    vol += volume_delta;
+    *dpop = static_cast<s16>(sample);
+  }
+  *volume = vol;
+}
+
+void ApplyVolumeEnvelopeGeneric(s16* samples, u32 count, u16* volume, u16 volume_delta,
+                                bool signed_volume)
+{
+  u16 vol = *volume;
+  for (u32 i = 0; i < count; ++i)
+  {
+    const s32 v = signed_volume ? s32(s16(vol)) : s32(vol);
+    samples[i] = static_cast<s16>(std::clamp((samples[i] * v) >> 15, -32767, 32767));
+    vol += volume_delta;
+  }
+  *volume = vol;
+}
+
+void ResampleLinearGeneric(const s16* history, s16* output, u32 count, u32 curr_pos, u32 ratio)
+{
+  u32 position = 0;
+  for (u32 i = 0; i < count; ++i)
+  {
+    position += AdvancePosition(&curr_pos, ratio);
+    output[i] = InterpolateLinear(history + position, curr_pos);
+  }
+}
+
+void ResamplePolyphaseGeneric(const s16* history, s16* output, u32 count, u32 curr_pos, u32 ratio,
+                              const s16* coeffs)
+{
+  u32 position = 0;
+  for (u32 i = 0; i < count; ++i)
+  {
+    position += AdvancePosition(&curr_pos, ratio);
+    output[i] = InterpolatePolyphase(history + position, curr_pos, coeffs);
+  }
+}
+
+// The four products of a polyphase tap each fit in 32 bits, but their sum doesn't. Since only the
+// sum shifted right by 15 is needed, the vectorized versions split every product into its bits
+// above and below bit 15 and add those up separately, which gives the same result:
+//   sum(p) >> 15 == sum(p >> 15) + (sum(p & 0x7FFF) >> 15)
+
+#ifdef _M_X86_64
+
+FUNCTION_TARGET_SSR41
+void MixAddSSE41(int* out, const s16* input, u32 count, u16* volume, u16 volume_delta, s16* dpop)
+{
+  u32 i = 0;
+  if (count >= 4)
+  {
+    const __m128i mask = _mm_set1_epi32(0xFFFF);
+    const __m128i min = _mm_set1_epi32(-32767);
+    const __m128i max = _mm_set1_epi32(32767);
+    const __m128i step = _mm_set1_epi32(volume_delta * 4);
+    __m128i vol = _mm_and_si128(
+        _mm_add_epi32(_mm_set1_epi32(*volume),
+                      _mm_mullo_epi32(_mm_set1_epi32(volume_delta), _mm_setr_epi32(0, 1, 2, 3))),
+        mask);
+    __m128i sample = _mm_setzero_si128();
+
+    for (; i + 4 <= count; i += 4)
+    {
+      const __m128i in =
+          _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(input + i)));
+      sample = _mm_min_epi32(_mm_max_epi32(_mm_srai_epi32(_mm_mullo_epi32(in, vol), 15), min), max);
+      __m128i* dest = reinterpret_cast<__m128i*>(out + i);
+      _mm_storeu_si128(dest, _mm_add_epi32(_mm_loadu_si128(dest), sample));
+      vol = _mm_and_si128(_mm_add_epi32(vol, step), mask);
+    }
+
+    *dpop = static_cast<s16>(_mm_extract_epi32(sample, 3));
+    *volume = static_cast<u16>(*volume + i * volume_delta);
+  }
+  MixAddGeneric(out + i, input + i, count - i, volume, volume_delta, dpop);
+}
+
+FUNCTION_TARGET_AVX2
+void MixAddAVX2(int* out, const s16* input, u32 count, u16* volume, u16 volume_delta, s16* dpop)
+{
+  u32 i = 0;
+  if (count >= 8)
+  {
+    const __m256i mask = _mm256_set1_epi32(0xFFFF);
+    const __m256i min = _mm256_set1_epi32(-32767);
+    const __m256i max = _mm256_set1_epi32(32767);
+    const __m256i step = _mm256_set1_epi32(volume_delta * 8);
+    __m256i vol = _mm256_and_si256(
+        _mm256_add_epi32(_mm256_set1_epi32(*volume),
+                         _mm256_mullo_epi32(_mm256_set1_epi32(volume_delta),
+                                            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7))),
+        mask);
+    __m256i sample = _mm256_setzero_si256();
+
+    for (; i + 8 <= count; i += 8)
+    {
+      const __m256i in =
+          _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i)));
+      sample = _mm256_min_epi32(
+          _mm256_max_epi32(_mm256_srai_epi32(_mm256_mullo_epi32(in, vol), 15), min), max);
+      __m256i* dest = reinterpret_cast<__m256i*>(out + i);
+      _mm256_storeu_si256(dest, _mm256_add_epi32(_mm256_loadu_si256(dest), sample));
+      vol = _mm256_and_si256(_mm256_add_epi32(vol, step), mask);
+    }
+
+    *dpop = static_cast<s16>(_mm256_extract_epi32(sample, 7));
+    *volume = static_cast<u16>(*volume + i * volume_delta);
+  }
+  MixAddGeneric(out + i, input + i, count - i, volume, volume_delta, dpop);
+}
+
+FUNCTION_TARGET_SSR41
+void ApplyVolumeEnvelopeSSE41(s16* samples, u32 count, u16* volume, u16 volume_delta,
+                              bool signed_volume)
+{
+  u32 i = 0;
+  if (count >= 4)
+  {
+    const __m128i min = _mm_set1_epi32(-32767);
+    const __m128i max = _mm_set1_epi32(32767);
+    const __m128i step = _mm_set1_epi32(volume_delta * 4);
+    __m128i vol = _mm_add_epi32(
+        _mm_set1_epi32(*volume),
+        _mm_mullo_epi32(_mm_set1_epi32(volume_delta), _mm_setr_epi32(0, 1, 2, 3)));
+
+    for (; i + 4 <= count; i += 4)
+    {
+      // Truncate the volume to 16 bits, sign extending it if needed
+      const __m128i v = signed_volume ? _mm_srai_epi32(_mm_slli_epi32(vol, 16), 16) :
+                                        _mm_srli_epi32(_mm_slli_epi32(vol, 16), 16);
+      __m128i* data = reinterpret_cast<__m128i*>(samples + i);
+      const __m128i in = _mm_cvtepi16_epi32(_mm_loadl_epi64(data));
+      const __m128i sample =
+          _mm_min_epi32(_mm_max_epi32(_mm_srai_epi32(_mm_mullo_epi32(in, v), 15), min), max);
+      _mm_storel_epi64(data, _mm_packs_epi32(sample, sample));
+      vol = _mm_add_epi32(vol, step);
+    }
+
+    *volume = static_cast<u16>(*volume + i * volume_delta);
+  }
+  ApplyVolumeEnvelopeGeneric(samples + i, count - i, volume, volume_delta, signed_volume);
+}
+
+FUNCTION_TARGET_AVX2
+void ApplyVolumeEnvelopeAVX2(s16* samples, u32 count, u16* volume, u16 volume_delta,
+                             bool signed_volume)
+{
+  u32 i = 0;
+  if (count >= 8)
+  {
+    const __m256i min = _mm256_set1_epi32(-32767);
+    const __m256i max = _mm256_set1_epi32(32767);
+    const __m256i step = _mm256_set1_epi32(volume_delta * 8);
+    __m256i vol = _mm256_add_epi32(_mm256_set1_epi32(*volume),
+                                   _mm256_mullo_epi32(_mm256_set1_epi32(volume_delta),
+                                                      _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+
+    for (; i + 8 <= count; i += 8)
+    {
+      // Truncate the volume to 16 bits, sign extending it if needed
+      const __m256i v = signed_volume ? _mm256_srai_epi32(_mm256_slli_epi32(vol, 16), 16) :
+                                        _mm256_srli_epi32(_mm256_slli_epi32(vol, 16), 16);
+      __m128i* data = reinterpret_cast<__m128i*>(samples + i);
+      const __m256i in = _mm256_cvtepi16_epi32(_mm_loadu_si128(data));
+      const __m256i sample = _mm256_min_epi32(
+          _mm256_max_epi32(_mm256_srai_epi32(_mm256_mullo_epi32(in, v), 15), min), max);
+      // packs works within 128-bit lanes, so gather the two packed halves afterwards
+      const __m256i packed =
+          _mm256_permute4x64_epi64(_mm256_packs_epi32(sample, sample), 0b1000);
+      _mm_storeu_si128(data, _mm256_castsi256_si128(packed));
+      vol = _mm256_add_epi32(vol, step);
+    }
+
+    *volume = static_cast<u16>(*volume + i * volume_delta);
+  }
+  ApplyVolumeEnvelopeGeneric(samples + i, count - i, volume, volume_delta, signed_volume);
+}
+
+FUNCTION_TARGET_SSR41
+void ResampleLinearSSE41(const s16* history, s16* output, u32 count, u32 curr_pos, u32 ratio)
+{
+  u32 position = 0;
+  u32 i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    alignas(16) s32 s0[4];
+    alignas(16) s32 s1[4];
+    alignas(16) s32 frac[4];
+    for (u32 j = 0; j < 4; ++j)
+    {
+      position += AdvancePosition(&curr_pos, ratio);
+      s0[j] = history[position];
+      s1[j] = history[position + 1];
+      frac[j] = curr_pos;
+    }
+
+    const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(s0));
+    const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(s1));
+    const __m128i f = _mm_load_si128(reinterpret_cast<const __m128i*>(frac));
+    const __m128i inv_f =
+        _mm_and_si128(_mm_sub_epi32(_mm_setzero_si128(), f), _mm_set1_epi32(0xFFFF));
+    const __m128i interpolated =
+        _mm_srai_epi32(_mm_add_epi32(_mm_mullo_epi32(a, inv_f), _mm_mullo_epi32(b, f)), 16);
+    const __m128i sample =
+        _mm_blendv_epi8(interpolated, a, _mm_cmpeq_epi32(f, _mm_setzero_si128()));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(sample, sample));
+  }
+  ResampleLinearGeneric(history + position, output + i, count - i, curr_pos, ratio);
+}
+
+FUNCTION_TARGET_SSR41
+void ResamplePolyphaseSSE41(const s16* history, s16* output, u32 count, u32 curr_pos, u32 ratio,
+                            const s16* coeffs)
+{
+  const __m128i low_mask = _mm_set1_epi32(0x7FFF);
+
+  u32 position = 0;
+  u32 i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i high[4];
+    __m128i low[4];
+    for (u32 j = 0; j < 4; ++j)
+    {
+      position += AdvancePosition(&curr_pos, ratio);
+      const __m128i t = _mm_cvtepi16_epi32(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(history + position)));
+      const __m128i c = _mm_cvtepi16_epi32(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&coeffs[(curr_pos >> 9) << 2])));
+      const __m128i product = _mm_mullo_epi32(t, c);
+      high[j] = _mm_srai_epi32(product, 15);
+      low[j] = _mm_and_si128(product, low_mask);
+    }
+
+    const __m128i high_sum = _mm_hadd_epi32(_mm_hadd_epi32(high[0], high[1]),
+                                            _mm_hadd_epi32(high[2], high[3]));
+    const __m128i low_sum =
+        _mm_hadd_epi32(_mm_hadd_epi32(low[0], low[1]), _mm_hadd_epi32(low[2], low[3]));
+    const __m128i sample = _mm_add_epi32(high_sum, _mm_srai_epi32(low_sum, 15));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(sample, sample));
+  }
+  ResamplePolyphaseGeneric(history + position, output + i, count - i, curr_pos, ratio, coeffs);
+}
+
+#endif  // _M_X86_64
+
+#ifdef _M_ARM_64
+
+void MixAddNEON(int* out, const s16* input, u32 count, u16* volume, u16 volume_delta, s16* dpop)
+{
+  u32 i = 0;
+  if (count >= 4)
+  {
+    static constexpr s32 LANES[4] = {0, 1, 2, 3};
+    const int32x4_t mask = vdupq_n_s32(0xFFFF);
+    const int32x4_t min = vdupq_n_s32(-32767);
+    const int32x4_t max = vdupq_n_s32(32767);
+    const int32x4_t step = vdupq_n_s32(volume_delta * 4);
+    int32x4_t vol = vandq_s32(
+        vmlaq_s32(vdupq_n_s32(*volume), vdupq_n_s32(volume_delta), vld1q_s32(LANES)), mask);
+    int32x4_t sample = vdupq_n_s32(0);
+
+    for (; i + 4 <= count; i += 4)
+    {
+      const int32x4_t in = vmovl_s16(vld1_s16(input + i));
+      sample = vminq_s32(vmaxq_s32(vshrq_n_s32(vmulq_s32(in, vol), 15), min), max);
+      vst1q_s32(out + i, vaddq_s32(vld1q_s32(out + i), sample));
+      vol = vandq_s32(vaddq_s32(vol, step), mask);
+    }
+
+    *dpop = static_cast<s16>(vgetq_lane_s32(sample, 3));
+    *volume = static_cast<u16>(*volume + i * volume_delta);
+  }
+  MixAddGeneric(out + i, input + i, count - i, volume, volume_delta, dpop);
+}
+
+void ApplyVolumeEnvelopeNEON(s16* samples, u32 count, u16* volume, u16 volume_delta,
+                             bool signed_volume)
+{
+  u32 i = 0;
+  if (count >= 4)
+  {
+    static constexpr s32 LANES[4] = {0, 1, 2, 3};
+    const int32x4_t min = vdupq_n_s32(-32767);
+    const int32x4_t max = vdupq_n_s32(32767);
+    const int32x4_t step = vdupq_n_s32(volume_delta * 4);
+    int32x4_t vol = vmlaq_s32(vdupq_n_s32(*volume), vdupq_n_s32(volume_delta), vld1q_s32(LANES));
+
+    for (; i + 4 <= count; i += 4)
+    {
+      // Truncate the volume to 16 bits, sign extending it if needed
+      const int32x4_t v = signed_volume ? vmovl_s16(vmovn_s32(vol)) :
+                                          vreinterpretq_s32_u32(vmovl_u16(vmovn_u32(
+                                              vreinterpretq_u32_s32(vol))));
+      const int32x4_t in = vmovl_s16(vld1_s16(samples + i));
+      const int32x4_t sample = vminq_s32(vmaxq_s32(vshrq_n_s32(vmulq_s32(in, v), 15), min), max);
+      vst1_s16(samples + i, vmovn_s32(sample));
+      vol = vaddq_s32(vol, step);
+    }
+
+    *volume = static_cast<u16>(*volume + i * volume_delta);
+  }
+  ApplyVolumeEnvelopeGeneric(samples + i, count - i, volume, volume_delta, signed_volume);
+}
+
+void ResampleLinearNEON(const s16* history, s16* output, u32 count, u32 curr_pos, u32 ratio)
+{
+  u32 position = 0;
+  u32 i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    s32 s0[4];
+    s32 s1[4];
+    s32 frac[4];
+    for (u32 j = 0; j < 4; ++j)
+    {
+      position += AdvancePosition(&curr_pos, ratio);
+      s0[j] = history[position];
+      s1[j] = history[position + 1];
+      frac[j] = curr_pos;
+    }
+
+    const int32x4_t a = vld1q_s32(s0);
+    const int32x4_t b = vld1q_s32(s1);
+    const int32x4_t f = vld1q_s32(frac);
+    const int32x4_t inv_f = vandq_s32(vnegq_s32(f), vdupq_n_s32(0xFFFF));
+    const int32x4_t interpolated = vshrq_n_s32(vmlaq_s32(vmulq_s32(a, inv_f), b, f), 16);
+    const int32x4_t sample = vbslq_s32(vceqzq_s32(f), a, interpolated);
+    vst1_s16(output + i, vmovn_s32(sample));
+  }
+  ResampleLinearGeneric(history + position, output + i, count - i, curr_pos, ratio);
+}
+
+void ResamplePolyphaseNEON(const s16* history, s16* output, u32 count, u32 curr_pos, u32 ratio,
+                           const s16* coeffs)
+{
+  const int32x4_t low_mask = vdupq_n_s32(0x7FFF);
+
+  u32 position = 0;
+  u32 i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    int32x4_t high[4];
+    int32x4_t low[4];
+    for (u32 j = 0; j < 4; ++j)
+    {
+      position += AdvancePosition(&curr_pos, ratio);
+      const int32x4_t product =
+          vmull_s16(vld1_s16(history + position), vld1_s16(&coeffs[(curr_pos >> 9) << 2]));
+      high[j] = vshrq_n_s32(product, 15);
+      low[j] = vandq_s32(product, low_mask);
+    }
+
+    const int32x4_t high_sum =
+        vpaddq_s32(vpaddq_s32(high[0], high[1]), vpaddq_s32(high[2], high[3]));
+    const int32x4_t low_sum = vpaddq_s32(vpaddq_s32(low[0], low[1]), vpaddq_s32(low[2], low[3]));
+    const int32x4_t sample = vaddq_s32(high_sum, vshrq_n_s32(low_sum, 15));
+    vst1_s16(output + i, vqmovn_s32(sample));
+  }
+  ResamplePolyphaseGeneric(history + position, output + i, count - i, curr_pos, ratio, coeffs);
+}
+
+#endif  // _M_ARM_64
+
+const Kernels& GetKernels()
+{
+  static const Kernels kernels = GetSupportedKernels().back();
+  return kernels;
+}
+}  // namespace
+
+std::vector<Kernels> GetSupportedKernels()
+{
+  std::vector<Kernels> kernels;
+  kernels.push_back({"Generic", MixAddGeneric, ApplyVolumeEnvelopeGeneric, ResampleLinearGeneric,
+                     ResamplePolyphaseGeneric});
+#if defined(_M_X86_64)
+  if (cpu_info.bSSE4_1)
+  {
+    kernels.push_back({"SSE4.1", MixAddSSE41, ApplyVolumeEnvelopeSSE41, ResampleLinearSSE41,
+                       ResamplePolyphaseSSE41});
+  }
+  if (cpu_info.bAVX2)
+  {
+    kernels.push_back({"AVX2", MixAddAVX2, ApplyVolumeEnvelopeAVX2, ResampleLinearSSE41,
+                       ResamplePolyphaseSSE41});
+  }
+#elif defined(_M_ARM_64)
+  kernels.push_back({"NEON", MixAddNEON, ApplyVolumeEnvelopeNEON, ResampleLinearNEON,
+                     ResamplePolyphaseNEON});
+#endif
+  return kernels;
+}
+
+void MixAdd(int* out, const s16* input, u32 count, u16* volume, u16 volume_delta, s16* dpop)
+{
+  GetKernels().mix_add(out, input, count, volume, volume_delta, dpop);
+}
+
+void ApplyVolumeEnvelope(s16* samples, u32 count, u16* volume, u16 volume_delta,
+                         bool signed_volume)
+{
+  GetKernels().apply_volume_envelope(samples, count, volume, volume_delta, signed_volume);
+}
+
+u32 AdvanceResamplePosition(u32 count, u32* curr_pos, u32 ratio)
+{
+  u32 consumed = 0;
+  for (u32 i = 0; i < count; ++i)
+    consumed += AdvancePosition(curr_pos, ratio);
+  return consumed;
+}
+
+void ResampleLinear(const s16* history, s16* output, u32 count, u32 curr_pos, u32 ratio)
+{
+  GetKernels().resample_linear(history, output, count, curr_pos, ratio);
+}
+
+void ResamplePolyphase(const s16* history, s16* output, u32 count, u32 curr_pos, u32 ratio,
+                       const s16* coeffs)
+{
+  GetKernels().resample_polyphase(history, output, count, curr_pos, ratio, coeffs);
+}
+}  // namespace DSP::HLE::AXMixing
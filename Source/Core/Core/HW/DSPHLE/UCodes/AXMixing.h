@@ -0,0 +1,53 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Sample processing kernels shared by the AX GC and AX Wii HLE ucodes. Every function has
+// vectorized implementations (SSE4.1/AVX2 on x86-64, NEON on AArch64) that are selected at
+// runtime, and all of them produce exactly the same output as the scalar fallback.
+
+#pragma once
+
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace DSP::HLE::AXMixing
+{
+// Adds (input * volume) >> 15, clamped to [-32767, 32767], to each sample in out. volume is
+// advanced by volume_delta after every sample, wrapping around like the 16-bit value it is, and
+// dpop is set to the last sample that was added.
+void MixAdd(int* out, const s16* input, u32 count, u16* volume, u16 volume_delta, s16* dpop);
+
+// Multiplies each sample by the envelope volume (treated as signed on GameCube and as unsigned on
+// Wii) and clamps it to [-32767, 32767]. volume is advanced by volume_delta after every sample.
+void ApplyVolumeEnvelope(s16* samples, u32 count, u16* volume, u16 volume_delta,
+                         bool signed_volume);
+
+// Advances a 16.16 fixed point resampling position by count output samples and returns the
+// number of input samples that are consumed in the process.
+u32 AdvanceResamplePosition(u32 count, u32* curr_pos, u32 ratio);
+
+// Resamples to count output samples, starting at the fractional position curr_pos. history must
+// contain the four previous input samples followed by the number of input samples that
+// AdvanceResamplePosition returns for the same arguments.
+void ResampleLinear(const s16* history, s16* output, u32 count, u32 curr_pos, u32 ratio);
+void ResamplePolyphase(const s16* history, s16* output, u32 count, u32 curr_pos, u32 ratio,
+                       const s16* coeffs);
+
+// One implementation of each of the kernels above.
+struct Kernels
+{
+  const char* name;
+  void (*mix_add)(int* out, const s16* input, u32 count, u16* volume, u16 volume_delta,
+                  s16* dpop);
+  void (*apply_volume_envelope)(s16* samples, u32 count, u16* volume, u16 volume_delta,
+                                bool signed_volume);
+  void (*resample_linear)(const s16* history, s16* output, u32 count, u32 curr_pos, u32 ratio);
+  void (*resample_polyphase)(const s16* history, s16* output, u32 count, u32 curr_pos, u32 ratio,
+                             const s16* coeffs);
+};
+
+// All the implementations the host CPU can run, starting with the scalar fallback. The functions
+// above use the last one. This is mostly useful for testing.
+std::vector<Kernels> GetSupportedKernels();
+}  // namespace DSP::HLE::AXMixing
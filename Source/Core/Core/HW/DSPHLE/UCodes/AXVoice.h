@@ -12,14 +12,16 @@
 #endif
 
 #include <algorithm>
-#include <functional>
+#include <array>
 #include <memory>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Core/DSP/DSPAccelerator.h"
 #include "Core/DolphinAnalytics.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/DSPHLE/UCodes/AX.h"
+#include "Core/HW/DSPHLE/UCodes/AXMixing.h"
 #include "Core/HW/DSPHLE/UCodes/AXStructs.h"
 #include "Core/HW/Memmap.h"
 #include "Core/System.h"
@@ -159,6 +161,19 @@ public:
 
   PB_TYPE* acc_pb = nullptr;
 
+  // Copies the accelerator registers (but not acc_pb) from another accelerator.
+  void CopyRegistersFrom(const HLEAccelerator& other)
+  {
+    m_start_address = other.m_start_address;
+    m_end_address = other.m_end_address;
+    m_current_address = other.m_current_address;
+    m_sample_format = other.m_sample_format;
+    m_yn1 = other.m_yn1;
+    m_yn2 = other.m_yn2;
+    m_pred_scale = other.m_pred_scale;
+    m_reads_stopped = other.m_reads_stopped;
+  }
+
 protected:
   void OnEndException() override
   {
@@ -190,6 +205,10 @@ protected:
   }
 
   u8 ReadMemory(u32 address) override { return m_dsp.ReadARAM(address); }
+  void ReadMemoryBlock(u32 address, u8* data, u32 size) override
+  {
+    m_dsp.ReadARAM(address, data, size);
+  }
 
   void WriteMemory(u32 address, u8 value) override { m_dsp.WriteARAM(value, address); }
 
@@ -210,16 +229,17 @@ void AcceleratorSetup(HLEAccelerator* accelerator, PB_TYPE* pb)
   accelerator->SetPredScale(pb->adpcm.pred_scale);
 }
 
-// Reads a sample from the accelerator. Also handles looping and
+// Reads samples from the accelerator. Also handles looping and
 // disabling streams that reached the end (this is done by an exception raised
 // by the accelerator on real hardware).
-u16 AcceleratorGetSample(HLEAccelerator* accelerator)
+void AcceleratorGetSamples(HLEAccelerator* accelerator, s16* samples, u32 count)
 {
-  return accelerator->Read(accelerator->acc_pb->adpcm.coefs);
+  accelerator->ReadSamples(accelerator->acc_pb->adpcm.coefs, samples, count);
 }
 
 // Reads samples from the input callback, resamples them to <count> samples at
-// the wanted sample rate (computed from the ratio, see below).
+// the wanted sample rate (computed from the ratio, see below). The callback is
+// called once with a buffer to fill and the number of input samples needed.
 //
 // If srctype is SRCTYPE_POLYPHASE, coefficients need to be provided as well
 // (or the srctype will automatically be changed to LINEAR).
@@ -238,114 +258,45 @@ u16 AcceleratorGetSample(HLEAccelerator* accelerator)
 // We start getting samples not from sample 0, but 0.<curr_pos_frac>. This
 // avoids discontinuities in the audio stream, especially with very low ratios
 // which interpolate a lot of values between two "real" samples.
-u32 ResampleAudio(std::function<s16(u32)> input_callback, s16* output, u32 count, s16* last_samples,
+template <typename InputCallback>
+u32 ResampleAudio(InputCallback input_callback, s16* output, u32 count, s16* last_samples,
                   u32 curr_pos, u32 ratio, int srctype, const s16* coeffs)
 {
-  int read_samples_count = 0;
-
-  // If DSP DROM coefficients are available, support polyphase resampling.
-  if (coeffs && srctype == SRCTYPE_POLYPHASE)
+  if (srctype != SRCTYPE_LINEAR && srctype != SRCTYPE_POLYPHASE)  // SRCTYPE_NEAREST
   {
-    s16 temp[4];
-    u32 idx = 0;
-
-    temp[idx++ & 3] = last_samples[0];
-    temp[idx++ & 3] = last_samples[1];
-    temp[idx++ & 3] = last_samples[2];
-    temp[idx++ & 3] = last_samples[3];
-
-    for (u32 i = 0; i < count; ++i)
-    {
-      curr_pos += ratio;
-      while (curr_pos >= 0x10000)
-      {
-        temp[idx++ & 3] = input_callback(read_samples_count++);
-        curr_pos -= 0x10000;
-      }
-
-      u16 curr_pos_frac = ((curr_pos & 0xFFFF) >> 9) << 2;
-      const s16* c = &coeffs[curr_pos_frac];
-
-      s64 t0 = temp[idx++ & 3];
-      s64 t1 = temp[idx++ & 3];
-      s64 t2 = temp[idx++ & 3];
-      s64 t3 = temp[idx++ & 3];
-
-      s64 samp = (t0 * c[0] + t1 * c[1] + t2 * c[2] + t3 * c[3]) >> 15;
-
-      output[i] = MathUtil::SaturatingCast<s16>(samp);
-    }
+    // No sample rate conversion here: simply read samples from the
+    // accelerator to the output buffer.
+    input_callback(output, count);
 
-    last_samples[3] = temp[--idx & 3];
-    last_samples[2] = temp[--idx & 3];
-    last_samples[1] = temp[--idx & 3];
-    last_samples[0] = temp[--idx & 3];
+    memcpy(last_samples, output + count - 4, 4 * sizeof(u16));
+    return curr_pos;
   }
-  else if (srctype == SRCTYPE_LINEAR || srctype == SRCTYPE_POLYPHASE)
-  {
-    // This is the circular buffer containing samples to use for the
-    // interpolation. It is initialized with the values from the PB, and it
-    // will be stored back to the PB at the end.
-    s16 temp[4];
-    u32 idx = 0;
-
-    temp[idx++ & 3] = last_samples[0];
-    temp[idx++ & 3] = last_samples[1];
-    temp[idx++ & 3] = last_samples[2];
-    temp[idx++ & 3] = last_samples[3];
-
-    for (u32 i = 0; i < count; ++i)
-    {
-      curr_pos += ratio;
-
-      // While our current position is >= 1.0, push new samples to the
-      // circular buffer.
-      while (curr_pos >= 0x10000)
-      {
-        temp[idx++ & 3] = input_callback(read_samples_count++);
-        curr_pos -= 0x10000;
-      }
 
-      // Get our current fractional position, used to know how much of
-      // curr0 and how much of curr1 the output sample should be.
-      u16 curr_frac = curr_pos & 0xFFFF;
-      u16 inv_curr_frac = -curr_frac;
+  // Fetch all the input samples that are needed up front and put them after the four last_samples
+  // values, so that the interpolation itself (which is vectorized) doesn't have to call back.
+  const u32 start_pos = curr_pos;
+  const u32 input_count = AXMixing::AdvanceResamplePosition(count, &curr_pos, ratio);
 
-      // Interpolate! If curr_frac is 0, we can simply take the last
-      // sample without any multiplying.
-      s16 sample;
-      if (curr_frac)
-      {
-        s32 s0 = temp[idx++ & 3];
-        s32 s1 = temp[idx++ & 3];
-
-        sample = ((s0 * inv_curr_frac) + (s1 * curr_frac)) >> 16;
-        idx += 2;
-      }
-      else
-      {
-        sample = temp[idx++ & 3];
-        idx += 3;
-      }
+  std::array<s16, 4 + MAX_SAMPLES_PER_FRAME * 4> history_buffer;
+  std::vector<s16> large_history_buffer;
+  s16* history = history_buffer.data();
+  if (input_count > history_buffer.size() - 4)
+  {
+    large_history_buffer.resize(input_count + 4);
+    history = large_history_buffer.data();
+  }
 
-      output[i] = sample;
-    }
+  std::copy_n(last_samples, 4, history);
+  input_callback(history + 4, input_count);
 
-    // Update the four last_samples values.
-    last_samples[3] = temp[--idx & 3];
-    last_samples[2] = temp[--idx & 3];
-    last_samples[1] = temp[--idx & 3];
-    last_samples[0] = temp[--idx & 3];
-  }
-  else  // SRCTYPE_NEAREST
-  {
-    // No sample rate conversion here: simply read samples from the
-    // accelerator to the output buffer.
-    for (u32 i = 0; i < count; ++i)
-      output[i] = input_callback(i);
+  // If DSP DROM coefficients are available, support polyphase resampling.
+  if (coeffs && srctype == SRCTYPE_POLYPHASE)
+    AXMixing::ResamplePolyphase(history, output, count, start_pos, ratio, coeffs);
+  else
+    AXMixing::ResampleLinear(history, output, count, start_pos, ratio);
 
-    memcpy(last_samples, output + count - 4, 4 * sizeof(u16));
-  }
+  // Update the four last_samples values.
+  std::copy_n(history + input_count, 4, last_samples);
 
   return curr_pos;
 }
@@ -359,9 +310,12 @@ void GetInputSamples(HLEAccelerator* accelerator, PB_TYPE& pb, s16* samples, u16
 
   if (coeffs)
     coeffs += pb.coef_select * 0x200;
-  u32 curr_pos = ResampleAudio([accelerator](u32) { return AcceleratorGetSample(accelerator); },
-                               samples, count, pb.src.last_samples, pb.src.cur_addr_frac,
-                               HILO_TO_32(pb.src.ratio), pb.src_type, coeffs);
+  u32 curr_pos = ResampleAudio(
+      [accelerator](s16* input, u32 input_count) {
+        AcceleratorGetSamples(accelerator, input, input_count);
+      },
+      samples, count, pb.src.last_samples, pb.src.cur_addr_frac, HILO_TO_32(pb.src.ratio),
+      pb.src_type, coeffs);
   pb.src.cur_addr_frac = (curr_pos & 0xFFFF);
 
   // Update current position, YN1, YN2 and pred scale in the PB.
@@ -375,27 +329,10 @@ void GetInputSamples(HLEAccelerator* accelerator, PB_TYPE& pb, s16* samples, u16
 // Add samples to an output buffer, with optional volume ramping.
 void MixAdd(int* out, const s16* input, u32 count, VolumeData* vd, s16* dpop, bool ramp)
 {
-  u16& volume = vd->volume;
-  u16 volume_delta = vd->volume_delta;
-
   // If volume ramping is disabled, set volume_delta to 0. That way, the
   // mixing loop can avoid testing if volume ramping is enabled at each step,
   // and just add volume_delta.
-  if (!ramp)
-    volume_delta = 0;
-
-  for (u32 i = 0; i < count; ++i)
-  {
-    s64 sample = input[i];
-    sample *= volume;
-    sample >>= 15;
-    sample = std::clamp((s32)sample, -32767, 32767);  // -32768 ?
-
-    out[i] += (s16)sample;
-    volume += volume_delta;
-
-    *dpop = (s16)sample;
-  }
+  AXMixing::MixAdd(out, input, count, &vd->volume, ramp ? vd->volume_delta : 0, dpop);
 }
 
 // Execute a low pass filter on the samples using one history value. Returns
@@ -421,19 +358,16 @@ void ProcessVoice(HLEAccelerator* accelerator, PB_TYPE& pb, const AXBuffers& buf
   GetInputSamples(accelerator, pb, samples, count, coeffs);
 
   // Apply a global volume ramp using the volume envelope parameters.
-  for (u32 i = 0; i < count; ++i)
-  {
+  // The volume is signed on GameCube and unsigned on Wii.
+  u16 volume = static_cast<u16>(pb.vol_env.cur_volume);
 #ifdef AX_GC
-    // signed on GameCube
-    const s32 volume = (s16)pb.vol_env.cur_volume;
+  constexpr bool signed_volume = true;
 #else
-    // unsigned on Wii
-    const s32 volume = (u16)pb.vol_env.cur_volume;
+  constexpr bool signed_volume = false;
 #endif
-    const s32 sample = ((s32)samples[i] * volume) >> 15;
-    samples[i] = std::clamp(sample, -32767, 32767);  // -32768 ?
-    pb.vol_env.cur_volume += pb.vol_env.cur_volume_delta;
-  }
+  AXMixing::ApplyVolumeEnvelope(samples, count, &volume,
+                                static_cast<u16>(pb.vol_env.cur_volume_delta), signed_volume);
+  pb.vol_env.cur_volume = static_cast<s16>(volume);
 
   // Optionally, execute a low pass filter
   if (pb.lpf.enabled)
@@ -517,11 +451,7 @@ void ProcessVoice(HLEAccelerator* accelerator, PB_TYPE& pb, const AXBuffers& buf
 #undef RAMP_ON
 
   // Optionally, phase shift left or right channel to simulate 3D sound.
-  if (pb.initial_time_delay.on)
-  {
-    // TODO
-    DolphinAnalytics::Instance().ReportGameQuirk(GameQuirk::USES_AX_INITIAL_TIME_DELAY);
-  }
+  // TODO: Not implemented, see ReportVoiceQuirks.
 
 #ifdef AX_WII
   // Wiimote mixing.
@@ -535,9 +465,10 @@ void ProcessVoice(HLEAccelerator* accelerator, PB_TYPE& pb, const AXBuffers& buf
 
     // We use ratio 0x55555 == (5 * 65536 + 21845) / 65536 == 5.3333 which
     // is the nearest we can get to 96/18
-    u32 curr_pos = ResampleAudio([&samples](u32 i) { return samples[i]; }, wm_samples, wm_count,
-                                 pb.remote_src.last_samples, pb.remote_src.cur_addr_frac, 0x55555,
-                                 SRCTYPE_POLYPHASE, coeffs);
+    u32 curr_pos = ResampleAudio(
+        [&samples](s16* input, u32 input_count) { std::copy_n(samples, input_count, input); },
+        wm_samples, wm_count, pb.remote_src.last_samples, pb.remote_src.cur_addr_frac, 0x55555,
+        SRCTYPE_POLYPHASE, coeffs);
     pb.remote_src.cur_addr_frac = curr_pos & 0xFFFF;
 
 // Mix to main[0-3] and aux[0-3]
@@ -574,6 +505,142 @@ void ProcessVoice(HLEAccelerator* accelerator, PB_TYPE& pb, const AXBuffers& buf
 #endif
 }
 
+// Reports the features that a voice uses but that aren't emulated. ProcessVoice can run on the
+// voice render threads, so this is called for each voice once it has been rendered instead.
+void ReportVoiceQuirks(const PB_TYPE& pb)
+{
+  if (pb.running == 1 && pb.initial_time_delay.on)
+    DolphinAnalytics::Instance().ReportGameQuirk(GameQuirk::USES_AX_INITIAL_TIME_DELAY);
+}
+
+// Number of samples in each of the mixing buffers of AXBuffers.
+#ifdef AX_GC
+constexpr std::array<u32, 9> MIXING_BUFFER_SIZES{160, 160, 160, 160, 160, 160, 160, 160, 160};
+#else
+constexpr std::array<u32, 20> MIXING_BUFFER_SIZES{96, 96, 96, 96, 96, 96, 96, 96, 96, 96,
+                                                  96, 96, 18, 18, 18, 18, 18, 18, 18, 18};
+#endif
+
+// Limits for ProcessPBListInParallel. Splitting off fewer voices than the minimum costs more in
+// synchronization than it saves, and longer lists than the maximum are most likely circular.
+constexpr u32 MAX_VOICE_RENDER_THREADS = 8;
+constexpr size_t MIN_VOICES_PER_RENDER_THREAD = 8;
+constexpr size_t MAX_PARALLEL_VOICES = 1024;
+
+// Renders all voices of a PB list using up to num_threads threads. The PBs are read up front and
+// split into contiguous ranges. The calling thread renders the first range into buffers, and each
+// worker renders another range with its own accelerator into its own zeroed mixing buffers, which
+// are then added to buffers in worker order. The PBs are written back in list order once all
+// ranges are done. Since mixing only adds to the buffers, the result is identical to rendering the
+// voices one after the other, and the accelerator is left in the state of the last voice that
+// used it, like it would be when rendering sequentially.
+//
+// render_pb(accelerator, pb, buffers) renders a single voice and may be called from any thread.
+// If the list can't be rendered this way, because it is too long or because can_render(pb) is
+// false for one of its PBs, nothing is changed and false is returned.
+template <typename CanRenderFunction, typename RenderFunction>
+bool ProcessPBListInParallel(DSP::DSPManager& dsp, Memory::MemoryManager& memory, u32 crc,
+                             u32 pb_addr, u32 num_threads, HLEAccelerator* accelerator,
+                             const AXBuffers& buffers,
+                             std::vector<std::unique_ptr<AXVoiceRenderWorker>>& workers,
+                             const CanRenderFunction& can_render, const RenderFunction& render_pb)
+{
+  struct Voice
+  {
+    u32 addr;
+    PB_TYPE pb;
+  };
+
+  std::vector<Voice> voices;
+  while (pb_addr)
+  {
+    if (voices.size() == MAX_PARALLEL_VOICES)
+      return false;
+
+    Voice& voice = voices.emplace_back();
+    voice.addr = pb_addr;
+    ReadPB(memory, pb_addr, voice.pb, crc);
+    if (!can_render(voice.pb))
+      return false;
+
+    pb_addr = HILO_TO_32(voice.pb.next_pb);
+  }
+
+  const size_t num_ranges = std::clamp<size_t>(voices.size() / MIN_VOICES_PER_RENDER_THREAD, 1,
+                                               std::min(num_threads, MAX_VOICE_RENDER_THREADS));
+  const auto range_begin = [&](size_t i) { return voices.size() * i / num_ranges; };
+  const auto render_range = [&](HLEAccelerator* range_accelerator,
+                                const AXBuffers& range_buffers, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i)
+      render_pb(range_accelerator, voices[i].pb, range_buffers);
+  };
+
+  u32 samples_per_worker = 0;
+  for (u32 size : MIXING_BUFFER_SIZES)
+    samples_per_worker += size;
+
+  for (size_t i = 1; i < num_ranges; ++i)
+  {
+    if (workers.size() < i)
+    {
+      auto worker = std::make_unique<AXVoiceRenderWorker>();
+      worker->accelerator = std::make_unique<HLEAccelerator>(dsp);
+      worker->samples.resize(samples_per_worker);
+      worker->thread.Reset("AX Voice Renderer", [](std::function<void()> task) { task(); });
+      workers.push_back(std::move(worker));
+    }
+
+    AXVoiceRenderWorker* worker = workers[i - 1].get();
+    worker->thread.Push([worker, &render_range, begin = range_begin(i), end = range_begin(i + 1)] {
+      AXBuffers worker_buffers;
+      int* ptr = worker->samples.data();
+      for (size_t j = 0; j < MIXING_BUFFER_SIZES.size(); ++j)
+      {
+        worker_buffers.ptrs[j] = ptr;
+        ptr += MIXING_BUFFER_SIZES[j];
+      }
+      std::fill(worker->samples.begin(), worker->samples.end(), 0);
+
+      auto* worker_accelerator = static_cast<HLEAccelerator*>(worker->accelerator.get());
+      worker_accelerator->acc_pb = nullptr;
+      render_range(worker_accelerator, worker_buffers, begin, end);
+    });
+  }
+
+  render_range(accelerator, buffers, 0, range_begin(1));
+
+  HLEAccelerator* last_used_accelerator = nullptr;
+  for (size_t i = 1; i < num_ranges; ++i)
+  {
+    AXVoiceRenderWorker& worker = *workers[i - 1];
+    worker.thread.WaitForCompletion();
+
+    const int* src = worker.samples.data();
+    for (size_t j = 0; j < MIXING_BUFFER_SIZES.size(); ++j)
+    {
+      for (u32 k = 0; k < MIXING_BUFFER_SIZES[j]; ++k)
+        buffers.ptrs[j][k] += src[k];
+      src += MIXING_BUFFER_SIZES[j];
+    }
+
+    // acc_pb is only set once a voice has been set up on the accelerator.
+    auto* worker_accelerator = static_cast<HLEAccelerator*>(worker.accelerator.get());
+    if (worker_accelerator->acc_pb)
+      last_used_accelerator = worker_accelerator;
+  }
+
+  if (last_used_accelerator)
+    accelerator->CopyRegistersFrom(*last_used_accelerator);
+
+  for (const Voice& voice : voices)
+  {
+    ReportVoiceQuirks(voice.pb);
+    WritePB(memory, voice.addr, voice.pb, crc);
+  }
+
+  return true;
+}
+
 }  // namespace
 }  // inline namespace AXGC/AXWii
 }  // namespace DSP::HLE
@@ -425,18 +425,40 @@ void AXWiiUCode::ProcessPBList(u32 pb_addr)
   // 32KHz to 48KHz, but AX always process at 32KHz.
   constexpr u32 spms = 32;
 
-  AXPBWii pb;
-
   auto& memory = m_dsphle->GetSystem().GetMemory();
+  const AXBuffers buffers = {{m_samples_main_left, m_samples_main_right, m_samples_main_surround,
+                              m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
+                              m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround,
+                              m_samples_auxC_left, m_samples_auxC_right, m_samples_auxC_surround,
+                              m_samples_wm0,       m_samples_aux0,       m_samples_wm1,
+                              m_samples_aux1,      m_samples_wm2,        m_samples_aux2,
+                              m_samples_wm3,       m_samples_aux3}};
+
+  // Old versions of AXWii have updates, which are applied ms per ms and could change where the
+  // list continues, so only newer versions can render voices in parallel.
+  if (m_voice_render_threads > 1 && !m_old_axwii)
+  {
+    const auto process_pb = [this](HLEAccelerator* accelerator, AXPBWii& pb,
+                                   const AXBuffers& voice_buffers) {
+      ProcessVoice(accelerator, pb, voice_buffers, 96,
+                   ConvertMixerControl(HILO_TO_32(pb.mixer_control)),
+                   m_coeffs_checksum ? m_coeffs.data() : nullptr);
+    };
+
+    if (ProcessPBListInParallel(m_dsphle->GetSystem().GetDSP(), memory, m_crc, pb_addr,
+                                m_voice_render_threads,
+                                static_cast<HLEAccelerator*>(m_accelerator.get()), buffers,
+                                m_voice_render_workers, [](const AXPBWii&) { return true; },
+                                process_pb))
+    {
+      return;
+    }
+  }
+
+  AXPBWii pb;
   while (pb_addr)
   {
-    AXBuffers buffers = {{m_samples_main_left, m_samples_main_right, m_samples_main_surround,
-                          m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
-                          m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround,
-                          m_samples_auxC_left, m_samples_auxC_right, m_samples_auxC_surround,
-                          m_samples_wm0,       m_samples_aux0,       m_samples_wm1,
-                          m_samples_aux1,      m_samples_wm2,        m_samples_aux2,
-                          m_samples_wm3,       m_samples_aux3}};
+    AXBuffers voice_buffers = buffers;
 
     ReadPB(memory, pb_addr, pb, m_crc);
 
@@ -448,23 +470,24 @@ void AXWiiUCode::ProcessPBList(u32 pb_addr)
       for (int curr_ms = 0; curr_ms < 3; ++curr_ms)
       {
         ApplyUpdatesForMs(curr_ms, pb, num_updates, updates);
-        ProcessVoice(static_cast<HLEAccelerator*>(m_accelerator.get()), pb, buffers, spms,
+        ProcessVoice(static_cast<HLEAccelerator*>(m_accelerator.get()), pb, voice_buffers, spms,
                      ConvertMixerControl(HILO_TO_32(pb.mixer_control)),
                      m_coeffs_checksum ? m_coeffs.data() : nullptr);
 
         // Forward the buffers
-        for (auto& ptr : buffers.ptrs)
+        for (auto& ptr : voice_buffers.ptrs)
           ptr += spms;
       }
       ReinjectUpdatesFields(pb, num_updates, updates_addr);
     }
     else
     {
-      ProcessVoice(static_cast<HLEAccelerator*>(m_accelerator.get()), pb, buffers, 96,
+      ProcessVoice(static_cast<HLEAccelerator*>(m_accelerator.get()), pb, voice_buffers, 96,
                    ConvertMixerControl(HILO_TO_32(pb.mixer_control)),
                    m_coeffs_checksum ? m_coeffs.data() : nullptr);
     }
 
+    ReportVoiceQuirks(pb);
     WritePB(memory, pb_addr, pb, m_crc);
     pb_addr = HILO_TO_32(pb.next_pb);
   }
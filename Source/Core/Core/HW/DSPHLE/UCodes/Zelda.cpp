@@ -1087,14 +1087,7 @@ void ZeldaAudioRenderer::ApplyReverb(bool post_rendering)
 
       auto ApplyFilter = [&]() {
         // Filter the buffer using provided coefficients.
-        for (u16 i = 0; i < 0x50; ++i)
-        {
-          s32 sample = 0;
-          for (u16 j = 0; j < 8; ++j)
-            sample += (s32)buffer[i + j] * rpb.filter_coeffs[j];
-          sample >>= 15;
-          buffer[i] = std::clamp(sample, -0x8000, 0x7FFF);
-        }
+        ZeldaMixing::ApplyReverbFilter(buffer.data(), 0x50, rpb.filter_coeffs);
       };
 
       // LSB set -> pre-filtering.
@@ -1504,41 +1497,9 @@ u16 ZeldaAudioRenderer::NeededRawSamplesCount(const VPB& vpb)
 void ZeldaAudioRenderer::Resample(VPB* vpb, const s16* src, MixingBuffer* dst)
 {
   // Both in 20.12 format.
-  u32 ratio = vpb->resampling_ratio;
-  u32 pos = vpb->current_pos_frac;
-
-  // Check if we need to do some interpolation. If the resampling ratio is
-  // more than 4:1, it's not worth it.
-  if ((ratio >> 12) >= 4)
-  {
-    for (s16& dst_sample : *dst)
-    {
-      pos += ratio;
-      dst_sample = src[pos >> 12];
-    }
-  }
-  else
-  {
-    for (auto& dst_sample : *dst)
-    {
-      // We have 0x40 * 4 coeffs that need to be selected based on the
-      // most significant bits of the fractional part of the position. 12
-      // bits >> 6 = 6 bits = 0x40. Multiply by 4 since there are 4
-      // consecutive coeffs.
-      u32 coeffs_idx = ((pos & 0xFFF) >> 6) * 4;
-      const s16* coeffs = &m_resampling_coeffs[coeffs_idx];
-      const s16* input = &src[pos >> 12];
-
-      s64 dst_sample_unclamped = 0;
-      for (size_t i = 0; i < 4; ++i)
-        dst_sample_unclamped += (s64)2 * coeffs[i] * input[i];
-      dst_sample_unclamped >>= 16;
-
-      dst_sample = (s16)std::clamp<s64>(dst_sample_unclamped, -0x8000, 0x7FFF);
-
-      pos += ratio;
-    }
-  }
+  const u32 pos = ZeldaMixing::Resample(src, dst->data(), static_cast<u32>(dst->size()),
+                                        vpb->current_pos_frac, vpb->resampling_ratio,
+                                        m_resampling_coeffs.data());
 
   for (u32 i = 0; i < 4; ++i)
     vpb->resample_buffer[i] = src[(pos >> 12) + i];
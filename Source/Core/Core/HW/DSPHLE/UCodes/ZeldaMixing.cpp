@@ -0,0 +1,396 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Core/HW/DSPHLE/UCodes/ZeldaMixing.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/Intrinsics.h"
+#include "Common/MathUtil.h"
+
+#ifdef _M_ARM_64
+#include <arm_neon.h>
+#endif
+
+namespace DSP::HLE::ZeldaMixing
+{
+namespace
+{
+s16 ScaleSample(s16 sample, u16 volume, u32 shift)
+{
+  // The product of a signed and an unsigned 16-bit value always fits in 32 bits.
+  const s32 product = sample * s32(volume);
+  return static_cast<s16>(std::clamp(product >> shift, -0x8000, 0x7FFF));
+}
+
+// The scalar implementations are also used for whatever is left over by the vectorized loops.
+
+void ApplyVolumeGeneric(s16* samples, u32 count, u16 volume, u32 shift)
+{
+  for (u32 i = 0; i < count; ++i)
+    samples[i] = ScaleSample(samples[i], volume, shift);
+}
+
+s32 AddWithVolumeRampGeneric(s16* dst, const s16* src, u32 count, s32 volume, s32 step)
+{
+  // Let the volume wrap around instead of overflowing.
+  u32 vol = static_cast<u32>(volume);
+  for (u32 i = 0; i < count; ++i)
+  {
+    dst[i] += static_cast<s16>(((static_cast<s32>(vol) >> 16) * src[i]) >> 16);
+    vol += static_cast<u32>(step);
+  }
+  return static_cast<s32>(vol);
+}
+
+void AddWithVolumeGeneric(s16* dst, const s16* src, u32 count, u16 volume)
+{
+  for (u32 i = 0; i < count; ++i)
+    dst[i] += ScaleSample(src[i], volume, 15);
+}
+
+u32 ResampleFilteredGeneric(const s16* src, s16* dst, u32 count, u32 pos, u32 ratio,
+                            const s16* coeffs)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    // We have 0x40 * 4 coeffs that need to be selected based on the most significant bits of the
+    // fractional part of the position. 12 bits >> 6 = 6 bits = 0x40. Multiply by 4 since there
+    // are 4 consecutive coeffs.
+    const s16* c = &coeffs[((pos & 0xFFF) >> 6) * 4];
+    const s16* input = &src[pos >> 12];
+
+    s64 sample = 0;
+    for (u32 j = 0; j < 4; ++j)
+      sample += s64(2) * c[j] * input[j];
+    dst[i] = MathUtil::SaturatingCast<s16>(sample >> 16);
+
+    pos += ratio;
+  }
+  return pos;
+}
+
+void ApplyReverbFilterGeneric(s16* samples, u32 count, const s16* coeffs)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    s32 sample = 0;
+    for (u32 j = 0; j < 8; ++j)
+      sample += s32(samples[i + j]) * coeffs[j];
+    samples[i] = static_cast<s16>(std::clamp(sample >> 15, -0x8000, 0x7FFF));
+  }
+}
+
+// The sums of the resampling filter don't fit in 32 bits. Since only the sum shifted right by 15
+// is needed (which is the same as the doubled sum shifted right by 16), the vectorized versions
+// use the same trick as the AX polyphase resampler and add up the bits of every product above and
+// below bit 15 separately:
+//   sum(p) >> 15 == sum(p >> 15) + (sum(p & 0x7FFF) >> 15)
+//
+// The reverb filter sums are 32-bit in the original code as well, so they wrap around the same
+// way in every implementation.
+
+#ifdef _M_X86_64
+
+FUNCTION_TARGET_SSR41
+__m128i ScaleSamplesSSE41(__m128i samples, __m128i volume, __m128i shift)
+{
+  const __m128i low = _mm_mullo_epi32(_mm_cvtepi16_epi32(samples), volume);
+  const __m128i high = _mm_mullo_epi32(_mm_cvtepi16_epi32(_mm_srli_si128(samples, 8)), volume);
+  return _mm_packs_epi32(_mm_sra_epi32(low, shift), _mm_sra_epi32(high, shift));
+}
+
+FUNCTION_TARGET_SSR41
+void ApplyVolumeSSE41(s16* samples, u32 count, u16 volume, u32 shift)
+{
+  const __m128i vol = _mm_set1_epi32(volume);
+  const __m128i shift_count = _mm_cvtsi32_si128(shift);
+
+  u32 i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128i* data = reinterpret_cast<__m128i*>(samples + i);
+    _mm_storeu_si128(data, ScaleSamplesSSE41(_mm_loadu_si128(data), vol, shift_count));
+  }
+  ApplyVolumeGeneric(samples + i, count - i, volume, shift);
+}
+
+FUNCTION_TARGET_SSR41
+s32 AddWithVolumeRampSSE41(s16* dst, const s16* src, u32 count, s32 volume, s32 step)
+{
+  const u32 vol = static_cast<u32>(volume);
+  const u32 delta = static_cast<u32>(step);
+  const __m128i step8 = _mm_set1_epi32(static_cast<s32>(delta * 8));
+  __m128i vol_low = _mm_add_epi32(
+      _mm_set1_epi32(volume), _mm_mullo_epi32(_mm_set1_epi32(step), _mm_setr_epi32(0, 1, 2, 3)));
+  __m128i vol_high = _mm_add_epi32(vol_low, _mm_set1_epi32(static_cast<s32>(delta * 4)));
+
+  u32 i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    // The upper halves of the volumes are exactly what mulhi needs: (v * s) >> 16.
+    const __m128i v = _mm_packs_epi32(_mm_srai_epi32(vol_low, 16), _mm_srai_epi32(vol_high, 16));
+    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i* out = reinterpret_cast<__m128i*>(dst + i);
+    _mm_storeu_si128(out, _mm_add_epi16(_mm_loadu_si128(out), _mm_mulhi_epi16(v, in)));
+    vol_low = _mm_add_epi32(vol_low, step8);
+    vol_high = _mm_add_epi32(vol_high, step8);
+  }
+  return AddWithVolumeRampGeneric(dst + i, src + i, count - i, static_cast<s32>(vol + i * delta),
+                                  step);
+}
+
+FUNCTION_TARGET_SSR41
+void AddWithVolumeSSE41(s16* dst, const s16* src, u32 count, u16 volume)
+{
+  const __m128i vol = _mm_set1_epi32(volume);
+  const __m128i shift = _mm_cvtsi32_si128(15);
+
+  u32 i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i* out = reinterpret_cast<__m128i*>(dst + i);
+    _mm_storeu_si128(out,
+                     _mm_add_epi16(_mm_loadu_si128(out), ScaleSamplesSSE41(in, vol, shift)));
+  }
+  AddWithVolumeGeneric(dst + i, src + i, count - i, volume);
+}
+
+FUNCTION_TARGET_SSR41
+u32 ResampleFilteredSSE41(const s16* src, s16* dst, u32 count, u32 pos, u32 ratio,
+                          const s16* coeffs)
+{
+  const __m128i low_mask = _mm_set1_epi32(0x7FFF);
+
+  u32 i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i high[4];
+    __m128i low[4];
+    for (u32 j = 0; j < 4; ++j)
+    {
+      const __m128i t =
+          _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + (pos >> 12))));
+      const __m128i c = _mm_cvtepi16_epi32(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&coeffs[((pos & 0xFFF) >> 6) * 4])));
+      const __m128i product = _mm_mullo_epi32(t, c);
+      high[j] = _mm_srai_epi32(product, 15);
+      low[j] = _mm_and_si128(product, low_mask);
+      pos += ratio;
+    }
+
+    const __m128i high_sum = _mm_hadd_epi32(_mm_hadd_epi32(high[0], high[1]),
+                                            _mm_hadd_epi32(high[2], high[3]));
+    const __m128i low_sum =
+        _mm_hadd_epi32(_mm_hadd_epi32(low[0], low[1]), _mm_hadd_epi32(low[2], low[3]));
+    const __m128i sample = _mm_add_epi32(high_sum, _mm_srai_epi32(low_sum, 15));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(sample, sample));
+  }
+  return ResampleFilteredGeneric(src, dst + i, count - i, pos, ratio, coeffs);
+}
+
+FUNCTION_TARGET_SSR41
+void ApplyReverbFilterSSE41(s16* samples, u32 count, const s16* coeffs)
+{
+  const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(coeffs));
+
+  // Every output sample only depends on input samples at the same or later positions, so writing
+  // four outputs after all of their inputs have been loaded doesn't affect later iterations.
+  u32 i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128i sums[4];
+    for (u32 j = 0; j < 4; ++j)
+    {
+      sums[j] =
+          _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i + j)), c);
+    }
+
+    const __m128i sum =
+        _mm_hadd_epi32(_mm_hadd_epi32(sums[0], sums[1]), _mm_hadd_epi32(sums[2], sums[3]));
+    const __m128i sample = _mm_srai_epi32(sum, 15);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(samples + i), _mm_packs_epi32(sample, sample));
+  }
+  ApplyReverbFilterGeneric(samples + i, count - i, coeffs);
+}
+
+#endif  // _M_X86_64
+
+#ifdef _M_ARM_64
+
+int16x8_t ScaleSamplesNEON(int16x8_t samples, int32x4_t volume, int32x4_t shift)
+{
+  const int32x4_t low = vshlq_s32(vmulq_s32(vmovl_s16(vget_low_s16(samples)), volume), shift);
+  const int32x4_t high = vshlq_s32(vmulq_s32(vmovl_s16(vget_high_s16(samples)), volume), shift);
+  return vcombine_s16(vqmovn_s32(low), vqmovn_s32(high));
+}
+
+void ApplyVolumeNEON(s16* samples, u32 count, u16 volume, u32 shift)
+{
+  const int32x4_t vol = vdupq_n_s32(volume);
+  // A negative shift count shifts to the right.
+  const int32x4_t shift_count = vdupq_n_s32(-static_cast<s32>(shift));
+
+  u32 i = 0;
+  for (; i + 8 <= count; i += 8)
+    vst1q_s16(samples + i, ScaleSamplesNEON(vld1q_s16(samples + i), vol, shift_count));
+  ApplyVolumeGeneric(samples + i, count - i, volume, shift);
+}
+
+s32 AddWithVolumeRampNEON(s16* dst, const s16* src, u32 count, s32 volume, s32 step)
+{
+  static constexpr u32 LANES[4] = {0, 1, 2, 3};
+  const u32 vol = static_cast<u32>(volume);
+  const u32 delta = static_cast<u32>(step);
+  const uint32x4_t step8 = vdupq_n_u32(delta * 8);
+  uint32x4_t vol_low = vmlaq_u32(vdupq_n_u32(vol), vdupq_n_u32(delta), vld1q_u32(LANES));
+  uint32x4_t vol_high = vaddq_u32(vol_low, vdupq_n_u32(delta * 4));
+
+  u32 i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    const int16x4_t v_low = vshrn_n_s32(vreinterpretq_s32_u32(vol_low), 16);
+    const int16x4_t v_high = vshrn_n_s32(vreinterpretq_s32_u32(vol_high), 16);
+    const int16x8_t in = vld1q_s16(src + i);
+    const int16x8_t scaled = vcombine_s16(vshrn_n_s32(vmull_s16(v_low, vget_low_s16(in)), 16),
+                                          vshrn_n_s32(vmull_s16(v_high, vget_high_s16(in)), 16));
+    vst1q_s16(dst + i, vaddq_s16(vld1q_s16(dst + i), scaled));
+    vol_low = vaddq_u32(vol_low, step8);
+    vol_high = vaddq_u32(vol_high, step8);
+  }
+  return AddWithVolumeRampGeneric(dst + i, src + i, count - i, static_cast<s32>(vol + i * delta),
+                                  step);
+}
+
+void AddWithVolumeNEON(s16* dst, const s16* src, u32 count, u16 volume)
+{
+  const int32x4_t vol = vdupq_n_s32(volume);
+  const int32x4_t shift = vdupq_n_s32(-15);
+
+  u32 i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    vst1q_s16(dst + i,
+              vaddq_s16(vld1q_s16(dst + i), ScaleSamplesNEON(vld1q_s16(src + i), vol, shift)));
+  }
+  AddWithVolumeGeneric(dst + i, src + i, count - i, volume);
+}
+
+u32 ResampleFilteredNEON(const s16* src, s16* dst, u32 count, u32 pos, u32 ratio,
+                         const s16* coeffs)
+{
+  const int32x4_t low_mask = vdupq_n_s32(0x7FFF);
+
+  u32 i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    int32x4_t high[4];
+    int32x4_t low[4];
+    for (u32 j = 0; j < 4; ++j)
+    {
+      const int32x4_t product =
+          vmull_s16(vld1_s16(src + (pos >> 12)), vld1_s16(&coeffs[((pos & 0xFFF) >> 6) * 4]));
+      high[j] = vshrq_n_s32(product, 15);
+      low[j] = vandq_s32(product, low_mask);
+      pos += ratio;
+    }
+
+    const int32x4_t high_sum =
+        vpaddq_s32(vpaddq_s32(high[0], high[1]), vpaddq_s32(high[2], high[3]));
+    const int32x4_t low_sum = vpaddq_s32(vpaddq_s32(low[0], low[1]), vpaddq_s32(low[2], low[3]));
+    const int32x4_t sample = vaddq_s32(high_sum, vshrq_n_s32(low_sum, 15));
+    vst1_s16(dst + i, vqmovn_s32(sample));
+  }
+  return ResampleFilteredGeneric(src, dst + i, count - i, pos, ratio, coeffs);
+}
+
+void ApplyReverbFilterNEON(s16* samples, u32 count, const s16* coeffs)
+{
+  const int16x4_t c_low = vld1_s16(coeffs);
+  const int16x4_t c_high = vld1_s16(coeffs + 4);
+
+  // Every output sample only depends on input samples at the same or later positions, so writing
+  // four outputs after all of their inputs have been loaded doesn't affect later iterations.
+  u32 i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    int32x4_t sums[4];
+    for (u32 j = 0; j < 4; ++j)
+    {
+      const s16* input = samples + i + j;
+      sums[j] = vmlal_s16(vmull_s16(vld1_s16(input), c_low), vld1_s16(input + 4), c_high);
+    }
+
+    const int32x4_t sum = vpaddq_s32(vpaddq_s32(sums[0], sums[1]), vpaddq_s32(sums[2], sums[3]));
+    vst1_s16(samples + i, vqmovn_s32(vshrq_n_s32(sum, 15)));
+  }
+  ApplyReverbFilterGeneric(samples + i, count - i, coeffs);
+}
+
+#endif  // _M_ARM_64
+
+const Kernels& GetKernels()
+{
+  static const Kernels kernels = GetSupportedKernels().back();
+  return kernels;
+}
+}  // namespace
+
+std::vector<Kernels> GetSupportedKernels()
+{
+  std::vector<Kernels> kernels;
+  kernels.push_back({"Generic", ApplyVolumeGeneric, AddWithVolumeRampGeneric,
+                     AddWithVolumeGeneric, ResampleFilteredGeneric, ApplyReverbFilterGeneric});
+#if defined(_M_X86_64)
+  if (cpu_info.bSSE4_1)
+  {
+    kernels.push_back({"SSE4.1", ApplyVolumeSSE41, AddWithVolumeRampSSE41, AddWithVolumeSSE41,
+                       ResampleFilteredSSE41, ApplyReverbFilterSSE41});
+  }
+#elif defined(_M_ARM_64)
+  kernels.push_back({"NEON", ApplyVolumeNEON, AddWithVolumeRampNEON, AddWithVolumeNEON,
+                     ResampleFilteredNEON, ApplyReverbFilterNEON});
+#endif
+  return kernels;
+}
+
+void ApplyVolume(s16* samples, u32 count, u16 volume, u32 shift)
+{
+  GetKernels().apply_volume(samples, count, volume, shift);
+}
+
+s32 AddWithVolumeRamp(s16* dst, const s16* src, u32 count, s32 volume, s32 step)
+{
+  return GetKernels().add_with_volume_ramp(dst, src, count, volume, step);
+}
+
+void AddWithVolume(s16* dst, const s16* src, u32 count, u16 volume)
+{
+  GetKernels().add_with_volume(dst, src, count, volume);
+}
+
+u32 Resample(const s16* src, s16* dst, u32 count, u32 pos, u32 ratio, const s16* coeffs)
+{
+  // If the resampling ratio is more than 4:1, interpolating isn't worth it.
+  if ((ratio >> 12) >= 4)
+  {
+    for (u32 i = 0; i < count; ++i)
+    {
+      pos += ratio;
+      dst[i] = src[pos >> 12];
+    }
+    return pos;
+  }
+
+  return GetKernels().resample_filtered(src, dst, count, pos, ratio, coeffs);
+}
+
+void ApplyReverbFilter(s16* samples, u32 count, const s16* coeffs)
+{
+  GetKernels().apply_reverb_filter(samples, count, coeffs);
+}
+}  // namespace DSP::HLE::ZeldaMixing
@@ -0,0 +1,54 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// Sample processing kernels of the Zelda HLE ucode. Like the AX ones, every function has
+// vectorized implementations (SSE4.1 on x86-64, NEON on AArch64) that are selected at runtime and
+// produce exactly the same output as the scalar fallback.
+
+#pragma once
+
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace DSP::HLE::ZeldaMixing
+{
+// Multiplies each sample by the unsigned volume, shifts the product right by shift and clamps it
+// to the s16 range.
+void ApplyVolume(s16* samples, u32 count, u16 volume, u32 shift);
+
+// Adds ((volume >> 16) * src) >> 16 to each sample in dst, wrapping around on overflow. volume is
+// in 1.31 format and is advanced by step after every sample. Returns the final volume.
+s32 AddWithVolumeRamp(s16* dst, const s16* src, u32 count, s32 volume, s32 step);
+
+// Adds (src * volume) >> 15, clamped to the s16 range, to each sample in dst, wrapping around on
+// overflow. volume is in 1.15 format.
+void AddWithVolume(s16* dst, const s16* src, u32 count, u16 volume);
+
+// Resamples src to count output samples, starting at the 20.12 fixed point position pos, and
+// returns the position after the last output sample. Uses the 4-tap filter from coeffs (0x40
+// phases of 4 coefficients) unless the ratio is 4:1 or more, in which case samples are picked
+// without any interpolation.
+u32 Resample(const s16* src, s16* dst, u32 count, u32 pos, u32 ratio, const s16* coeffs);
+
+// Applies the 8-tap reverb FIR filter in place: samples[i] becomes the clamped sum of
+// samples[i + j] * coeffs[j] >> 15. samples must contain count + 7 samples.
+void ApplyReverbFilter(s16* samples, u32 count, const s16* coeffs);
+
+// One implementation of each of the kernels above. resample_filtered is only used for ratios
+// below 4:1.
+struct Kernels
+{
+  const char* name;
+  void (*apply_volume)(s16* samples, u32 count, u16 volume, u32 shift);
+  s32 (*add_with_volume_ramp)(s16* dst, const s16* src, u32 count, s32 volume, s32 step);
+  void (*add_with_volume)(s16* dst, const s16* src, u32 count, u16 volume);
+  u32 (*resample_filtered)(const s16* src, s16* dst, u32 count, u32 pos, u32 ratio,
+                           const s16* coeffs);
+  void (*apply_reverb_filter)(s16* samples, u32 count, const s16* coeffs);
+};
+
+// All the implementations the host CPU can run, starting with the scalar fallback. The functions
+// above use the last one. This is mostly useful for testing.
+std::vector<Kernels> GetSupportedKernels();
+}  // namespace DSP::HLE::ZeldaMixing
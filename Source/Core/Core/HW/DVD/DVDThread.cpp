@@ -7,6 +7,7 @@
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <span>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -16,6 +17,7 @@
 #include "Common/Event.h"
 #include "Common/Flag.h"
 #include "Common/Logging/Log.h"
+#include "Common/MappedFile.h"
 #include "Common/MsgHandler.h"
 #include "Common/SPSCQueue.h"
 #include "Common/Thread.h"
@@ -94,9 +96,9 @@ void DVDThread::DoState(PointerWrap& p)
   // Move all results from result_queue to result_map because
   // PointerWrap::Do supports std::map but not Common::SPSCQueue.
   // This won't affect the behavior of FinishRead.
-  ReadResult result;
-  while (m_result_queue.Pop(result))
-    m_result_map.emplace(result.first.id, std::move(result));
+  // Results that point into the memory mapping of m_disc get their data copied into their
+  // buffers, since the mapping isn't savestated.
+  MaterializeMappedResults();
 
   // Both queues are now empty, so we don't need to savestate them.
   p.Do(m_result_map);
@@ -131,9 +133,35 @@ void DVDThread::DoState(PointerWrap& p)
 void DVDThread::SetDisc(std::unique_ptr<DiscIO::Volume> disc)
 {
   WaitUntilIdle();
+  MaterializeMappedResults();
   m_disc = std::move(disc);
 }
 
+void DVDThread::MaterializeMappedResults()
+{
+  // This won't affect the behavior of FinishRead, which checks result_map before result_queue.
+  ReadResult result;
+  while (m_result_queue.Pop(result))
+    m_result_map.emplace(result.first.id, std::move(result));
+
+  for (auto& [id, map_result] : m_result_map)
+  {
+    ReadRequest& request = map_result.first;
+    if (!request.mapped)
+      continue;
+
+    request.mapped = false;
+
+    const u8* data =
+        m_disc ? m_disc->GetMappedData(request.dvd_offset, request.length, request.partition) :
+                 nullptr;
+    if (data)
+      map_result.second.assign(data, data + request.length);
+    else
+      map_result.second.clear();
+  }
+}
+
 bool DVDThread::HasDisc() const
 {
   return m_disc != nullptr;
@@ -292,7 +320,13 @@ void DVDThread::FinishRead(u64 id, s64 cycles_late)
   // We have now obtained the right ReadResult.
 
   const ReadRequest& request = result.first;
-  const std::vector<u8>& buffer = result.second;
+  std::span<const u8> buffer = result.second;
+  if (request.mapped)
+  {
+    const u8* data =
+        m_disc->GetMappedData(request.dvd_offset, request.length, request.partition);
+    buffer = data ? std::span<const u8>(data, request.length) : std::span<const u8>();
+  }
 
   DEBUG_LOG_FMT(DVDINTERFACE,
                 "Disc has been read. Real time: {} us. "
@@ -344,9 +378,25 @@ void DVDThread::DVDThreadMain()
     {
       m_file_logger.Log(*m_disc, request.partition, request.dvd_offset);
 
-      std::vector<u8> buffer(request.length);
-      if (!m_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
-        buffer.resize(0);
+      // If the disc is memory mapped, FinishRead can copy the data straight from the mapping to
+      // emulated RAM, so there's no need to read it into an intermediate buffer here. The pages
+      // are faulted in on this thread though, so that the copy doesn't stall the CPU thread.
+      std::vector<u8> buffer;
+      const u8* mapped_data =
+          request.copy_to_ram ?
+              m_disc->GetMappedData(request.dvd_offset, request.length, request.partition) :
+              nullptr;
+      if (mapped_data)
+      {
+        Common::MappedFile::Prefetch(mapped_data, request.length);
+        request.mapped = true;
+      }
+      else
+      {
+        buffer.resize(request.length);
+        if (!m_disc->Read(request.dvd_offset, request.length, buffer.data(), request.partition))
+          buffer.resize(0);
+      }
 
       request.realtime_done_us = Common::Timer::NowUs();
 
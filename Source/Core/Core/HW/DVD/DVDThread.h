@@ -100,6 +100,10 @@ private:
 
   void DVDThreadMain();
 
+  // Copies the data of results that refer to memory mapped disc data into their buffers, so that
+  // they stay usable after the disc is changed or after a savestate is loaded
+  void MaterializeMappedResults();
+
   struct ReadRequest
   {
     bool copy_to_ram = false;
@@ -113,6 +117,10 @@ private:
     // because function pointers can't be stored in savestates.
     DVD::ReplyType reply_type = DVD::ReplyType::NoReply;
 
+    // If this is set, the DVD thread didn't read anything into the result buffer because the data
+    // can be copied directly from m_disc's memory mapping to emulated RAM by FinishRead
+    bool mapped = false;
+
     // IDs are used to uniquely identify a request. They must not be
     // identical to IDs of any other requests that currently exist, but
     // it's fine to re-use IDs of requests that have existed in the past.
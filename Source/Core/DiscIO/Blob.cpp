@@ -11,10 +11,13 @@
 #include <utility>
 
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/IOFile.h"
 #include "Common/MsgHandler.h"
+#include "Core/Config/MainSettings.h"
 
 #include "DiscIO/CISOBlob.h"
+#include "DiscIO/ChunkStoreBlob.h"
 #include "DiscIO/CompressedBlob.h"
 #include "DiscIO/DirectoryBlob.h"
 #include "DiscIO/FileBlob.h"
@@ -56,6 +59,8 @@ std::string GetName(BlobType blob_type, bool translate)
     return "NFS";
   case BlobType::SPLIT_PLAIN:
     return translate_str("Multi-part ISO");
+  case BlobType::CHUNK_STORE:
+    return "DCS";
   default:
     return "";
   }
@@ -214,6 +219,16 @@ u32 SectorReader::ReadChunk(u8* buffer, u64 chunk_num)
   return 0;
 }
 
+static PlainFileAccess GetPlainFileAccess()
+{
+  if (!Config::Get(Config::MAIN_MEMORY_MAP_DISC_IMAGES))
+    return PlainFileAccess::Buffered;
+
+  return Config::Get(Config::MAIN_MEMORY_MAP_SEQUENTIAL_HINT) ?
+             PlainFileAccess::MemoryMappedSequential :
+             PlainFileAccess::MemoryMapped;
+}
+
 std::unique_ptr<BlobReader> CreateBlobReader(const std::string& filename)
 {
   File::IOFile file(filename, "rb");
@@ -245,13 +260,15 @@ std::unique_ptr<BlobReader> CreateBlobReader(const std::string& filename)
     return RVZFileReader::Create(std::move(file), filename);
   case NFS_MAGIC:
     return NFSFileReader::Create(std::move(file), filename);
+  case DCS_MAGIC:
+    return ChunkStoreReader::Create(std::move(file), filename);
   default:
     if (auto directory_blob = DirectoryBlobReader::Create(filename))
       return std::move(directory_blob);
     if (auto split_blob = SplitPlainFileReader::Create(filename))
       return std::move(split_blob);
 
-    return PlainFileReader::Create(std::move(file));
+    return PlainFileReader::Create(std::move(file), GetPlainFileAccess());
   }
 }
 
@@ -42,6 +42,7 @@ enum class BlobType
   MOD_DESCRIPTOR,
   NFS,
   SPLIT_PLAIN,
+  CHUNK_STORE,
 };
 
 // If you convert an ISO file to another format and then call GetDataSize on it, what is the result?
@@ -87,6 +88,11 @@ public:
     return Common::FromBigEndian(temp);
   }
 
+  // Returns a pointer to the requested data if the blob is backed by memory that holds the data
+  // as-is (such as a memory mapped plain disc image), or nullptr otherwise. The returned pointer
+  // stays valid for as long as this reader exists. Unlike Read, this is thread-safe.
+  virtual const u8* GetMappedData(u64 offset, u64 size) const { return nullptr; }
+
   virtual bool SupportsReadWiiDecrypted(u64 offset, u64 size, u64 partition_data_offset) const
   {
     return false;
@@ -203,5 +209,9 @@ bool ConvertToWIAOrRVZ(BlobReader* infile, const std::string& infile_path,
                        const std::string& outfile_path, bool rvz,
                        WIARVZCompressionType compression_type, int compression_level,
                        int chunk_size, CompressCB callback);
+bool ConvertToChunkStore(const std::vector<BlobReader*>& infiles,
+                         const std::vector<std::string>& infile_paths,
+                         const std::string& outfile_path, int compression_level,
+                         CompressCB callback);
 
 }  // namespace DiscIO
@@ -0,0 +1,662 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DiscIO/ChunkStoreBlob.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <zstd.h>
+
+#include "Common/Assert.h"
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/MsgHandler.h"
+#include "Common/StringUtil.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/MultithreadedCompressor.h"
+#include "DiscIO/Volume.h"
+#include "DiscIO/VolumeDisc.h"
+
+namespace DiscIO
+{
+static constexpr u32 CHUNK_STORE_VERSION = 0x01000000;
+static constexpr u32 CHUNK_STORE_VERSION_READ_COMPATIBLE = 0x01000000;
+
+// Random values used by the gear rolling hash. They are generated with SplitMix64 so that the
+// table doesn't have to be spelled out.
+static constexpr std::array<u64, 256> GEAR_TABLE = [] {
+  std::array<u64, 256> table{};
+  u64 state = 0x44434B53544F5245;  // "DCKSTORE"
+  for (u64& value : table)
+  {
+    state += 0x9E3779B97F4A7C15;
+    u64 z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    value = z ^ (z >> 31);
+  }
+  return table;
+}();
+
+// Normalized chunking (as in FastCDC): a stricter mask is used before the average chunk size is
+// reached and a looser mask after it, which keeps the chunk sizes close to the average.
+// The masks use the top bits of the hash, since those depend on the most input bytes.
+static constexpr u64 CHUNK_MASK_STRICT = 0xFFFFC00000000000;  // 18 bits
+static constexpr u64 CHUNK_MASK_LOOSE = 0xFFFC000000000000;   // 14 bits
+
+size_t FindChunkStoreBoundary(const u8* data, size_t size)
+{
+  if (size <= CHUNK_STORE_MIN_CHUNK_SIZE)
+    return size;
+
+  const size_t max_size = std::min<size_t>(size, CHUNK_STORE_MAX_CHUNK_SIZE);
+  const size_t normal_size = std::min<size_t>(max_size, CHUNK_STORE_AVERAGE_CHUNK_SIZE);
+
+  u64 hash = 0;
+  size_t i = CHUNK_STORE_MIN_CHUNK_SIZE;
+  for (; i < normal_size; ++i)
+  {
+    hash = (hash << 1) + GEAR_TABLE[data[i]];
+    if (!(hash & CHUNK_MASK_STRICT))
+      return i + 1;
+  }
+  for (; i < max_size; ++i)
+  {
+    hash = (hash << 1) + GEAR_TABLE[data[i]];
+    if (!(hash & CHUNK_MASK_LOOSE))
+      return i + 1;
+  }
+
+  return max_size;
+}
+
+ChunkStoreReader::ChunkStoreReader(File::IOFile file, const std::string& path, u32 disc_index)
+    : m_file(std::move(file)), m_path(path), m_disc_index(disc_index)
+{
+}
+
+ChunkStoreReader::~ChunkStoreReader()
+{
+  ZSTD_freeDCtx(m_decompression_context);
+}
+
+std::unique_ptr<ChunkStoreReader> ChunkStoreReader::Create(File::IOFile file,
+                                                           const std::string& path,
+                                                           u32 disc_index)
+{
+  std::unique_ptr<ChunkStoreReader> blob(new ChunkStoreReader(std::move(file), path, disc_index));
+  return blob->Initialize() ? std::move(blob) : nullptr;
+}
+
+bool ChunkStoreReader::Initialize()
+{
+  if (!m_file.Seek(0, File::SeekOrigin::Begin) || !m_file.ReadArray(&m_header, 1))
+    return false;
+
+  if (m_header.magic != DCS_MAGIC)
+    return false;
+
+  if (m_header.version < CHUNK_STORE_VERSION_READ_COMPATIBLE ||
+      (m_header.version >> 24) != (CHUNK_STORE_VERSION >> 24))
+  {
+    ERROR_LOG_FMT(DISCIO, "Unsupported chunk store version {:08x} in {}", m_header.version,
+                  m_path);
+    return false;
+  }
+
+  if (m_disc_index >= m_header.number_of_discs)
+  {
+    ERROR_LOG_FMT(DISCIO, "Chunk store {} has no disc with index {}", m_path, m_disc_index);
+    return false;
+  }
+
+  const u64 disc_entry_offset =
+      m_header.disc_entries_offset + u64(m_disc_index) * sizeof(ChunkStoreDiscEntry);
+  if (!m_file.Seek(disc_entry_offset, File::SeekOrigin::Begin) || !m_file.ReadArray(&m_disc, 1))
+    return false;
+
+  m_chunk_list.resize(m_disc.number_of_chunks);
+  if (!m_file.Seek(m_disc.chunk_list_offset, File::SeekOrigin::Begin) ||
+      !m_file.ReadArray(m_chunk_list.data(), m_chunk_list.size()))
+  {
+    return false;
+  }
+
+  u32 max_data_size = 0;
+  u32 max_compressed_size = 0;
+  u64 offset = 0;
+  m_chunk_offsets.reserve(m_chunk_list.size());
+  for (const ChunkStoreChunkReference& chunk : m_chunk_list)
+  {
+    if (chunk.data_size == 0 || chunk.compressed_size == 0)
+      return false;
+
+    m_chunk_offsets.push_back(offset);
+    offset += chunk.data_size;
+    max_data_size = std::max(max_data_size, chunk.data_size);
+    max_compressed_size = std::max(max_compressed_size, chunk.compressed_size);
+  }
+
+  if (offset != m_disc.data_size)
+  {
+    ERROR_LOG_FMT(DISCIO, "The chunks of disc {} in {} add up to {} bytes instead of {}",
+                  m_disc_index, m_path, offset, m_disc.data_size);
+    return false;
+  }
+
+  m_cached_chunk.resize(max_data_size);
+  m_compressed_buffer.resize(max_compressed_size);
+
+  m_decompression_context = ZSTD_createDCtx();
+  return m_decompression_context != nullptr;
+}
+
+std::unique_ptr<BlobReader> ChunkStoreReader::CopyReader() const
+{
+  return Create(m_file.Duplicate("rb"), m_path, m_disc_index);
+}
+
+std::string ChunkStoreReader::GetCompressionMethod() const
+{
+  return "Zstandard";
+}
+
+std::string ChunkStoreReader::GetDiscName() const
+{
+  return std::string(m_disc.name.data(), strnlen(m_disc.name.data(), m_disc.name.size()));
+}
+
+u64 ChunkStoreReader::GetReferencedChunkSize() const
+{
+  std::vector<std::pair<u64, u32>> chunks;
+  chunks.reserve(m_chunk_list.size());
+  for (const ChunkStoreChunkReference& chunk : m_chunk_list)
+    chunks.emplace_back(chunk.data_offset, chunk.compressed_size);
+
+  std::sort(chunks.begin(), chunks.end());
+  chunks.erase(std::unique(chunks.begin(), chunks.end()), chunks.end());
+
+  u64 size = 0;
+  for (const auto& chunk : chunks)
+    size += chunk.second;
+  return size;
+}
+
+size_t ChunkStoreReader::FindChunk(u64 offset) const
+{
+  const auto it = std::upper_bound(m_chunk_offsets.begin(), m_chunk_offsets.end(), offset);
+  return static_cast<size_t>(it - m_chunk_offsets.begin()) - 1;
+}
+
+bool ChunkStoreReader::LoadChunk(const ChunkStoreChunkReference& chunk)
+{
+  if (m_cached_chunk_offset == chunk.data_offset)
+    return true;
+
+  // Invalidate the cache first in case loading fails halfway through
+  m_cached_chunk_offset = std::numeric_limits<u64>::max();
+
+  const bool compressed = chunk.compressed_size != chunk.data_size;
+  u8* read_buffer = compressed ? m_compressed_buffer.data() : m_cached_chunk.data();
+
+  if (!m_file.Seek(chunk.data_offset, File::SeekOrigin::Begin) ||
+      !m_file.ReadBytes(read_buffer, chunk.compressed_size))
+  {
+    ERROR_LOG_FMT(DISCIO, "The chunk store \"{}\" is truncated, some of the data is missing.",
+                  m_path);
+    m_file.ClearError();
+    return false;
+  }
+
+  if (compressed)
+  {
+    const size_t result =
+        ZSTD_decompressDCtx(m_decompression_context, m_cached_chunk.data(), chunk.data_size,
+                            m_compressed_buffer.data(), chunk.compressed_size);
+    if (ZSTD_isError(result) || result != chunk.data_size)
+    {
+      ERROR_LOG_FMT(DISCIO, "Failed to decompress the chunk at {:#x} in {}", chunk.data_offset,
+                    m_path);
+      return false;
+    }
+  }
+
+  m_cached_chunk_offset = chunk.data_offset;
+  return true;
+}
+
+bool ChunkStoreReader::Read(u64 offset, u64 size, u8* out_ptr)
+{
+  if (offset + size > m_disc.data_size)
+    return false;
+
+  while (size > 0)
+  {
+    const size_t index = FindChunk(offset);
+    const ChunkStoreChunkReference& chunk = m_chunk_list[index];
+    if (!LoadChunk(chunk))
+      return false;
+
+    const u64 offset_in_chunk = offset - m_chunk_offsets[index];
+    const u64 bytes_to_read = std::min<u64>(chunk.data_size - offset_in_chunk, size);
+    std::memcpy(out_ptr, m_cached_chunk.data() + offset_in_chunk, bytes_to_read);
+
+    offset += bytes_to_read;
+    size -= bytes_to_read;
+    out_ptr += bytes_to_read;
+  }
+
+  return true;
+}
+
+namespace
+{
+struct CompressThreadState
+{
+  CompressThreadState() = default;
+  ~CompressThreadState() { ZSTD_freeCCtx(context); }
+
+  CompressThreadState(const CompressThreadState&) = delete;
+  CompressThreadState(CompressThreadState&&) = delete;
+  CompressThreadState& operator=(const CompressThreadState&) = delete;
+  CompressThreadState& operator=(CompressThreadState&&) = delete;
+
+  ZSTD_CCtx* context = nullptr;
+};
+
+struct CompressParameters
+{
+  std::vector<u8> data{};
+  std::vector<u32> chunk_sizes{};
+  // Encrypted chunks don't compress, so they are stored as they are without trying
+  std::vector<bool> chunk_encrypted{};
+  size_t disc_index = 0;
+  u64 bytes_read = 0;
+};
+
+struct OutputChunk
+{
+  Common::SHA1::Digest hash;
+  u32 data_size = 0;
+  // Empty if the chunk was already known to be in the store when it was processed
+  std::vector<u8> data{};
+};
+
+struct OutputParameters
+{
+  std::vector<OutputChunk> chunks{};
+  size_t disc_index = 0;
+  u64 bytes_read = 0;
+};
+}  // namespace
+
+using ChunkMap = std::map<Common::SHA1::Digest, ChunkStoreChunkReference>;
+
+static ConversionResult<OutputParameters> Compress(CompressThreadState* state,
+                                                   CompressParameters parameters,
+                                                   const ChunkMap* chunk_map,
+                                                   std::mutex* chunk_map_mutex,
+                                                   int compression_level)
+{
+  OutputParameters output_parameters;
+  output_parameters.chunks.resize(parameters.chunk_sizes.size());
+  output_parameters.disc_index = parameters.disc_index;
+  output_parameters.bytes_read = parameters.bytes_read;
+
+  const u8* data = parameters.data.data();
+  for (size_t i = 0; i < parameters.chunk_sizes.size(); ++i)
+  {
+    OutputChunk& chunk = output_parameters.chunks[i];
+    chunk.data_size = parameters.chunk_sizes[i];
+    chunk.hash = Common::SHA1::CalculateDigest(data, chunk.data_size);
+
+    bool known;
+    {
+      std::lock_guard lk(*chunk_map_mutex);
+      known = chunk_map->contains(chunk.hash);
+    }
+
+    // Two threads may end up compressing the same new chunk. The output thread will take care of
+    // only storing it once, so this is only a waste of time and is harmless.
+    if (!known && parameters.chunk_encrypted[i])
+    {
+      chunk.data.assign(data, data + chunk.data_size);
+    }
+    else if (!known)
+    {
+      chunk.data.resize(ZSTD_compressBound(chunk.data_size));
+      const size_t result =
+          ZSTD_compressCCtx(state->context, chunk.data.data(), chunk.data.size(), data,
+                            chunk.data_size, compression_level);
+      if (ZSTD_isError(result))
+        return ConversionResultCode::InternalError;
+
+      if (result < chunk.data_size)
+        chunk.data.resize(result);
+      else
+        chunk.data.assign(data, data + chunk.data_size);
+    }
+
+    data += chunk.data_size;
+  }
+
+  return std::move(output_parameters);
+}
+
+static ConversionResultCode Output(OutputParameters parameters, File::IOFile* outfile,
+                                   u64* position, ChunkMap* chunk_map, std::mutex* chunk_map_mutex,
+                                   std::vector<ChunkStoreChunkEntry>* chunk_entries,
+                                   std::vector<std::vector<ChunkStoreChunkReference>>* chunk_lists,
+                                   u64 total_size, CompressCB callback)
+{
+  std::vector<ChunkStoreChunkReference>& chunk_list = (*chunk_lists)[parameters.disc_index];
+
+  for (const OutputChunk& chunk : parameters.chunks)
+  {
+    // Only this thread inserts into the map, so looking things up doesn't need the mutex
+    const auto it = chunk_map->find(chunk.hash);
+    if (it != chunk_map->end())
+    {
+      chunk_list.push_back(it->second);
+      continue;
+    }
+
+    if (chunk.data.empty())
+      return ConversionResultCode::InternalError;
+
+    const ChunkStoreChunkReference reference{*position, chunk.data_size,
+                                             static_cast<u32>(chunk.data.size())};
+    if (!outfile->WriteBytes(chunk.data.data(), chunk.data.size()))
+      return ConversionResultCode::WriteFailed;
+    *position += chunk.data.size();
+
+    chunk_entries->push_back(ChunkStoreChunkEntry{chunk.hash, reference.data_size,
+                                                  reference.compressed_size,
+                                                  reference.data_offset});
+    chunk_list.push_back(reference);
+
+    std::lock_guard lk(*chunk_map_mutex);
+    chunk_map->emplace(chunk.hash, reference);
+  }
+
+  const int ratio = parameters.bytes_read == 0 ?
+                        0 :
+                        static_cast<int>(100 * *position / parameters.bytes_read);
+  const std::string text = Common::FmtFormatT("Disc {0} of {1}. Compression ratio {2}%",
+                                              parameters.disc_index + 1, chunk_lists->size(),
+                                              ratio);
+  const float completion = static_cast<float>(parameters.bytes_read) / total_size;
+
+  if (!callback(text, completion))
+    return ConversionResultCode::Canceled;
+
+  return ConversionResultCode::Success;
+}
+
+// Returns the ranges of the disc that hold encrypted Wii partition data, as [start, end) pairs
+// in ascending order.
+static std::vector<std::pair<u64, u64>> GetEncryptedRanges(const std::string& path, u64 data_size)
+{
+  std::vector<std::pair<u64, u64>> ranges;
+
+  const std::unique_ptr<VolumeDisc> volume = CreateDisc(path);
+  if (!volume || !volume->HasWiiEncryption())
+    return ranges;
+
+  for (const Partition& partition : volume->GetPartitions())
+  {
+    if (volume->ReadSwapped<u32>(partition.offset, PARTITION_NONE) != 0x10001U)
+      continue;
+
+    const std::optional<u64> partition_data_offset =
+        volume->ReadSwappedAndShifted(partition.offset + 0x2b8, PARTITION_NONE);
+    const std::optional<u64> partition_data_size =
+        volume->ReadSwappedAndShifted(partition.offset + 0x2bc, PARTITION_NONE);
+    if (!partition_data_offset || !partition_data_size)
+      continue;
+
+    const u64 start = partition.offset + *partition_data_offset;
+    const u64 end = std::min(start + *partition_data_size, data_size);
+    if (start < end)
+      ranges.emplace_back(start, end);
+  }
+
+  std::sort(ranges.begin(), ranges.end());
+  return ranges;
+}
+
+// Returns the size of the first chunk at the given offset of the disc, and whether it's encrypted.
+// Content-defined chunking can't find anything in encrypted data that another disc would share,
+// so encrypted partition data is cut into fixed chunks counted from the start of the partition.
+// Identical partitions, such as the update partitions of games from the same region, still end
+// up with identical chunks that way.
+static std::pair<size_t, bool> FindNextChunk(const u8* data, size_t size, u64 offset,
+                                             const std::vector<std::pair<u64, u64>>& encrypted_ranges)
+{
+  for (const auto& [start, end] : encrypted_ranges)
+  {
+    if (offset >= end)
+      continue;
+
+    if (offset >= start)
+    {
+      const u64 chunk_size = std::min<u64>(
+          {CHUNK_STORE_MAX_CHUNK_SIZE - (offset - start) % CHUNK_STORE_MAX_CHUNK_SIZE,
+           end - offset, size});
+      return {static_cast<size_t>(chunk_size), true};
+    }
+
+    // Don't let a content-defined chunk reach into the partition
+    size = static_cast<size_t>(std::min<u64>(size, start - offset));
+    break;
+  }
+
+  return {FindChunkStoreBoundary(data, size), false};
+}
+
+static ConversionResultCode ConvertToChunkStore(const std::vector<BlobReader*>& infiles,
+                                                const std::vector<std::string>& infile_paths,
+                                                File::IOFile* outfile, int compression_level,
+                                                CompressCB callback, size_t* failed_infile)
+{
+  ChunkMap chunk_map;
+  std::mutex chunk_map_mutex;
+  std::vector<ChunkStoreChunkEntry> chunk_entries;
+  std::vector<std::vector<ChunkStoreChunkReference>> chunk_lists(infiles.size());
+
+  u64 total_size = 0;
+  for (BlobReader* infile : infiles)
+    total_size += infile->GetDataSize();
+
+  u64 position = sizeof(ChunkStoreHeader);
+  if (!outfile->Seek(position, File::SeekOrigin::Begin))
+    return ConversionResultCode::WriteFailed;
+
+  const auto set_up_compress_thread_state = [](CompressThreadState* state) {
+    state->context = ZSTD_createCCtx();
+    return state->context ? ConversionResultCode::Success : ConversionResultCode::InternalError;
+  };
+
+  const auto compress = [&](CompressThreadState* state, CompressParameters parameters) {
+    return Compress(state, std::move(parameters), &chunk_map, &chunk_map_mutex,
+                    compression_level);
+  };
+
+  const auto output = [&](OutputParameters parameters) {
+    return Output(std::move(parameters), outfile, &position, &chunk_map, &chunk_map_mutex,
+                  &chunk_entries, &chunk_lists, total_size, callback);
+  };
+
+  MultithreadedCompressor<CompressThreadState, CompressParameters, OutputParameters> mt_compressor(
+      set_up_compress_thread_state, compress, output);
+
+  // Each batch handed to the compression threads contains a few dozen chunks
+  constexpr u64 READ_SIZE = 0x400000;
+
+  u64 total_bytes_read = 0;
+  std::vector<u8> buffer;
+  for (size_t i = 0; i < infiles.size(); ++i)
+  {
+    BlobReader* infile = infiles[i];
+    const u64 data_size = infile->GetDataSize();
+    const std::vector<std::pair<u64, u64>> encrypted_ranges =
+        GetEncryptedRanges(infile_paths[i], data_size);
+
+    u64 bytes_read = 0;
+    buffer.clear();
+    while (bytes_read < data_size || !buffer.empty())
+    {
+      const ConversionResultCode status = mt_compressor.GetStatus();
+      if (status != ConversionResultCode::Success)
+        return status;
+
+      const u64 bytes_to_read = std::min(READ_SIZE, data_size - bytes_read);
+      const size_t old_buffer_size = buffer.size();
+      buffer.resize(old_buffer_size + bytes_to_read);
+      if (!infile->Read(bytes_read, bytes_to_read, buffer.data() + old_buffer_size))
+      {
+        *failed_infile = i;
+        return ConversionResultCode::ReadFailed;
+      }
+      bytes_read += bytes_to_read;
+      total_bytes_read += bytes_to_read;
+
+      // Unless we're at the end of the disc, a chunk can only be cut once we have enough data
+      // to know that no later boundary would have been picked instead
+      const bool end_of_disc = bytes_read == data_size;
+      const u64 buffer_offset = bytes_read - buffer.size();
+      std::vector<u32> chunk_sizes;
+      std::vector<bool> chunk_encrypted;
+      size_t chunked_bytes = 0;
+      while (chunked_bytes < buffer.size() &&
+             (end_of_disc || buffer.size() - chunked_bytes >= CHUNK_STORE_MAX_CHUNK_SIZE))
+      {
+        const auto [chunk_size, encrypted] =
+            FindNextChunk(buffer.data() + chunked_bytes, buffer.size() - chunked_bytes,
+                          buffer_offset + chunked_bytes, encrypted_ranges);
+        chunk_sizes.push_back(static_cast<u32>(chunk_size));
+        chunk_encrypted.push_back(encrypted);
+        chunked_bytes += chunk_size;
+      }
+
+      if (chunk_sizes.empty())
+        continue;
+
+      mt_compressor.CompressAndWrite(CompressParameters{
+          std::vector<u8>(buffer.begin(), buffer.begin() + chunked_bytes), std::move(chunk_sizes),
+          std::move(chunk_encrypted), i, total_bytes_read});
+
+      buffer.erase(buffer.begin(), buffer.begin() + chunked_bytes);
+    }
+  }
+
+  mt_compressor.Shutdown();
+
+  const ConversionResultCode status = mt_compressor.GetStatus();
+  if (status != ConversionResultCode::Success)
+    return status;
+
+  ChunkStoreHeader header{};
+  header.magic = DCS_MAGIC;
+  header.version = CHUNK_STORE_VERSION;
+  header.number_of_discs = static_cast<u32>(infiles.size());
+  header.number_of_chunks = static_cast<u32>(chunk_entries.size());
+  header.compression_level = compression_level;
+
+  header.chunk_entries_offset = position;
+  if (!outfile->WriteArray(chunk_entries.data(), chunk_entries.size()))
+    return ConversionResultCode::WriteFailed;
+  position += chunk_entries.size() * sizeof(ChunkStoreChunkEntry);
+
+  std::vector<ChunkStoreDiscEntry> disc_entries(infiles.size());
+  header.disc_entries_offset = position;
+  position += disc_entries.size() * sizeof(ChunkStoreDiscEntry);
+
+  for (size_t i = 0; i < infiles.size(); ++i)
+  {
+    ChunkStoreDiscEntry& disc_entry = disc_entries[i];
+    disc_entry.data_size = infiles[i]->GetDataSize();
+    disc_entry.chunk_list_offset = position;
+    disc_entry.number_of_chunks = static_cast<u32>(chunk_lists[i].size());
+    disc_entry.original_blob_type = static_cast<u32>(infiles[i]->GetBlobType());
+
+    std::string name;
+    SplitPath(infile_paths[i], nullptr, &name, nullptr);
+    name.resize(std::min(name.size(), disc_entry.name.size() - 1));
+    disc_entry.name.fill(0);
+    std::copy(name.begin(), name.end(), disc_entry.name.begin());
+
+    position += chunk_lists[i].size() * sizeof(ChunkStoreChunkReference);
+  }
+
+  if (!outfile->WriteArray(disc_entries.data(), disc_entries.size()))
+    return ConversionResultCode::WriteFailed;
+
+  for (const std::vector<ChunkStoreChunkReference>& chunk_list : chunk_lists)
+  {
+    if (!outfile->WriteArray(chunk_list.data(), chunk_list.size()))
+      return ConversionResultCode::WriteFailed;
+  }
+
+  header.file_size = position;
+  if (!outfile->Seek(0, File::SeekOrigin::Begin) || !outfile->WriteArray(&header, 1))
+    return ConversionResultCode::WriteFailed;
+
+  return ConversionResultCode::Success;
+}
+
+bool ConvertToChunkStore(const std::vector<BlobReader*>& infiles,
+                         const std::vector<std::string>& infile_paths,
+                         const std::string& outfile_path, int compression_level,
+                         CompressCB callback)
+{
+  ASSERT(infiles.size() == infile_paths.size());
+
+  File::IOFile outfile(outfile_path, "wb");
+  if (!outfile)
+  {
+    PanicAlertFmtT(
+        "Failed to open the output file \"{0}\".\n"
+        "Check that you have permissions to write the target folder and that the media can "
+        "be written.",
+        outfile_path);
+    return false;
+  }
+
+  size_t failed_infile = 0;
+  const ConversionResultCode result = ConvertToChunkStore(
+      infiles, infile_paths, &outfile, compression_level, callback, &failed_infile);
+
+  if (result == ConversionResultCode::ReadFailed)
+    PanicAlertFmtT("Failed to read from the input file \"{0}\".", infile_paths[failed_infile]);
+
+  if (result == ConversionResultCode::WriteFailed)
+  {
+    PanicAlertFmtT("Failed to write the output file \"{0}\".\n"
+                   "Check that you have enough space available on the target drive.",
+                   outfile_path);
+  }
+
+  if (result != ConversionResultCode::Success)
+  {
+    // Remove the incomplete output file
+    outfile.Close();
+    File::Delete(outfile_path);
+  }
+
+  return result == ConversionResultCode::Success;
+}
+
+}  // namespace DiscIO
@@ -0,0 +1,142 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <zstd.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
+#include "Common/IOFile.h"
+#include "DiscIO/Blob.h"
+
+// A chunk store is an archive that holds any number of disc images. Each disc is split into
+// content-defined chunks, and every chunk is stored only once no matter how many discs (or how
+// many places in the same disc) contain it. This makes it possible to keep all the regional
+// variants and revisions of a game in roughly the space of one of them. Encrypted Wii partitions
+// can only be shared with identical partitions, so this mostly helps GameCube games.
+// See docs/ChunkStore.md for details about the format.
+
+namespace DiscIO
+{
+constexpr u32 DCS_MAGIC = 0x01534344;  // "DCS\x1" (byteswapped to little endian)
+
+#pragma pack(push, 1)
+struct ChunkStoreHeader
+{
+  u32 magic;
+  u32 version;
+  u32 number_of_discs;
+  u32 number_of_chunks;
+  u64 disc_entries_offset;
+  u64 chunk_entries_offset;
+  u64 file_size;
+  s32 compression_level;  // Informative only
+  u32 reserved;
+};
+static_assert(sizeof(ChunkStoreHeader) == 0x30, "Wrong size for chunk store header");
+
+struct ChunkStoreChunkEntry
+{
+  Common::SHA1::Digest hash;  // Hash of the decompressed data
+  u32 data_size;
+  u32 compressed_size;  // Equal to data_size if the chunk is stored uncompressed
+  u64 data_offset;
+};
+static_assert(sizeof(ChunkStoreChunkEntry) == 0x24, "Wrong size for chunk store chunk entry");
+
+// The location of a chunk as referenced from a disc. This duplicates the information in the
+// chunk table so that a reader only has to load the chunk list of its own disc.
+struct ChunkStoreChunkReference
+{
+  u64 data_offset;
+  u32 data_size;
+  u32 compressed_size;
+};
+static_assert(sizeof(ChunkStoreChunkReference) == 0x10,
+              "Wrong size for chunk store chunk reference");
+
+struct ChunkStoreDiscEntry
+{
+  u64 data_size;
+  u64 chunk_list_offset;  // Points to number_of_chunks chunk references
+  u32 number_of_chunks;
+  u32 original_blob_type;  // Informative only
+  std::array<char, 0x40> name;
+};
+static_assert(sizeof(ChunkStoreDiscEntry) == 0x58, "Wrong size for chunk store disc entry");
+#pragma pack(pop)
+
+class ChunkStoreReader : public BlobReader
+{
+public:
+  static std::unique_ptr<ChunkStoreReader> Create(File::IOFile file, const std::string& path,
+                                                  u32 disc_index = 0);
+  ~ChunkStoreReader();
+
+  BlobType GetBlobType() const override { return BlobType::CHUNK_STORE; }
+  std::unique_ptr<BlobReader> CopyReader() const override;
+
+  u64 GetRawSize() const override { return m_header.file_size; }
+  u64 GetDataSize() const override { return m_disc.data_size; }
+  DataSizeType GetDataSizeType() const override { return DataSizeType::Accurate; }
+
+  // Chunks have variable sizes, so there is no meaningful block size
+  u64 GetBlockSize() const override { return 0; }
+  bool HasFastRandomAccessInBlock() const override { return false; }
+  std::string GetCompressionMethod() const override;
+  std::optional<int> GetCompressionLevel() const override { return m_header.compression_level; }
+
+  bool Read(u64 offset, u64 size, u8* out_ptr) override;
+
+  u32 GetDiscIndex() const { return m_disc_index; }
+  u32 GetNumberOfDiscs() const { return m_header.number_of_discs; }
+  u32 GetNumberOfChunks() const { return m_header.number_of_chunks; }
+  std::string GetDiscName() const;
+
+  // The sum of the compressed sizes of the distinct chunks that this disc uses, including chunks
+  // that are shared with other discs in the store
+  u64 GetReferencedChunkSize() const;
+
+private:
+  ChunkStoreReader(File::IOFile file, const std::string& path, u32 disc_index);
+  bool Initialize();
+
+  // Returns the index into m_chunk_list of the chunk that contains the given offset
+  size_t FindChunk(u64 offset) const;
+  bool LoadChunk(const ChunkStoreChunkReference& chunk);
+
+  File::IOFile m_file;
+  std::string m_path;
+  u32 m_disc_index;
+
+  ChunkStoreHeader m_header;
+  ChunkStoreDiscEntry m_disc;
+  std::vector<ChunkStoreChunkReference> m_chunk_list;
+  // m_chunk_offsets[i] is the offset in the disc where m_chunk_list[i] starts
+  std::vector<u64> m_chunk_offsets;
+
+  std::vector<u8> m_compressed_buffer;
+  std::vector<u8> m_cached_chunk;
+  u64 m_cached_chunk_offset = std::numeric_limits<u64>::max();
+  ZSTD_DCtx* m_decompression_context = nullptr;
+};
+
+// Content-defined chunking parameters. Boundaries are found with a gear rolling hash, so data
+// that has merely been moved (for instance a file that was relocated in another revision of the
+// disc) still produces the same chunks.
+constexpr u32 CHUNK_STORE_MIN_CHUNK_SIZE = 0x4000;
+constexpr u32 CHUNK_STORE_AVERAGE_CHUNK_SIZE = 0x10000;
+constexpr u32 CHUNK_STORE_MAX_CHUNK_SIZE = 0x40000;
+
+// Returns the size of the first chunk in the given data. If the data is shorter than
+// CHUNK_STORE_MAX_CHUNK_SIZE and no boundary is found, the whole data is returned as one chunk.
+size_t FindChunkStoreBoundary(const u8* data, size_t size);
+
+}  // namespace DiscIO
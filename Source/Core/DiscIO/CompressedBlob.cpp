@@ -8,6 +8,7 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -32,6 +33,17 @@
 
 namespace DiscIO
 {
+// The amount of data that SectorReader caches and requests from ReadMultipleAlignedBlocks at once
+// while the disc is read sequentially. Scattered reads only read the blocks they need.
+constexpr u32 GCZ_CHUNK_SIZE = 0x40000;
+// The number of chunks that are decompressed ahead of time once sequential reading is detected,
+// and the number of consecutive sequential (or scattered) reads that are needed to switch between
+// reading chunks and single blocks
+constexpr u32 READ_AHEAD_CHUNKS = 8;
+constexpr u32 READ_AHEAD_TRIGGER = 2;
+constexpr u32 MAX_DECOMPRESSION_THREADS = 4;
+constexpr u64 MIN_BLOCKS_PER_DECOMPRESSION_THREAD = 2;
+
 bool IsGCZBlob(File::IOFile& file);
 
 CompressedBlobReader::CompressedBlobReader(File::IOFile file, const std::string& filename)
@@ -72,6 +84,9 @@ std::unique_ptr<CompressedBlobReader> CompressedBlobReader::Create(File::IOFile
 
 CompressedBlobReader::~CompressedBlobReader()
 {
+  m_read_ahead_thread.Shutdown(true);
+  for (auto& thread : m_decompression_threads)
+    thread->Shutdown();
 }
 
 std::unique_ptr<BlobReader> CompressedBlobReader::CopyReader() const
@@ -92,34 +107,45 @@ u64 CompressedBlobReader::GetBlockCompressedSize(u64 block_num) const
   return 0;
 }
 
-bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
+u64 CompressedBlobReader::GetBlockOffset(u64 block_num) const
 {
-  bool uncompressed = false;
-  u32 comp_block_size = (u32)GetBlockCompressedSize(block_num);
-  u64 offset = m_block_pointers[block_num] + m_data_offset;
+  return (m_block_pointers[block_num] & ~(1ULL << 63)) + m_data_offset;
+}
 
-  if (offset & (1ULL << 63))
+bool CompressedBlobReader::ReadCompressedBlocks(File::IOFile& file, u64 block_num, u64 num_blocks,
+                                                std::vector<u8>* buffer) const
+{
+  // Blocks are stored in order, so the compressed data of a range of blocks is contiguous
+  const u64 last_block = block_num + num_blocks - 1;
+  const u64 start = GetBlockOffset(block_num);
+  const u64 end = GetBlockOffset(last_block) + static_cast<u32>(GetBlockCompressedSize(last_block));
+  if (end < start)
   {
-    if (comp_block_size != m_header.block_size)
-      ERROR_LOG_FMT(DISCIO, "Uncompressed block with wrong size");
-    uncompressed = true;
-    offset &= ~(1ULL << 63);
+    ERROR_LOG_FMT(DISCIO, "The disc image \"{}\" is corrupt. Block {} has an invalid offset.",
+                  m_file_name, last_block);
+    return false;
   }
 
-  // clear unused part of zlib buffer. maybe this can be deleted when it works fully.
-  memset(&m_zlib_buffer[comp_block_size], 0, m_zlib_buffer.size() - comp_block_size);
-
-  m_file.Seek(offset, File::SeekOrigin::Begin);
-  if (!m_file.ReadBytes(m_zlib_buffer.data(), comp_block_size))
+  buffer->resize(end - start);
+  file.Seek(start, File::SeekOrigin::Begin);
+  if (!file.ReadBytes(buffer->data(), buffer->size()))
   {
     ERROR_LOG_FMT(DISCIO, "The disc image \"{}\" is truncated, some of the data is missing.",
                   m_file_name);
-    m_file.ClearError();
+    file.ClearError();
     return false;
   }
 
+  return true;
+}
+
+bool CompressedBlobReader::DecompressBlock(u64 block_num, const u8* data, u8* out_ptr) const
+{
+  const u32 comp_block_size = static_cast<u32>(GetBlockCompressedSize(block_num));
+  const bool uncompressed = (m_block_pointers[block_num] & (1ULL << 63)) != 0;
+
   // First, check hash.
-  const u32 block_hash = Common::HashAdler32(m_zlib_buffer.data(), comp_block_size);
+  const u32 block_hash = Common::HashAdler32(data, comp_block_size);
   if (block_hash != m_hashes[block_num])
   {
     ERROR_LOG_FMT(DISCIO,
@@ -130,36 +156,258 @@ bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
 
   if (uncompressed)
   {
-    std::copy(m_zlib_buffer.begin(), m_zlib_buffer.begin() + comp_block_size, out_ptr);
-  }
-  else
-  {
-    z_stream z = {};
-    z.next_in = m_zlib_buffer.data();
-    z.avail_in = comp_block_size;
-    if (z.avail_in > m_header.block_size)
+    if (comp_block_size != m_header.block_size)
     {
-      ERROR_LOG_FMT(DISCIO, "Compressed block size is larger than uncompressed block size");
+      ERROR_LOG_FMT(DISCIO, "Uncompressed block with wrong size");
+      if (comp_block_size > m_header.block_size)
+        return false;
     }
-    z.next_out = out_ptr;
-    z.avail_out = m_header.block_size;
-    inflateInit(&z);
-    int status = inflate(&z, Z_FULL_FLUSH);
-    u32 uncomp_size = m_header.block_size - z.avail_out;
-    if (status != Z_STREAM_END)
+    std::copy(data, data + comp_block_size, out_ptr);
+    return true;
+  }
+
+  z_stream z = {};
+  z.next_in = const_cast<u8*>(data);
+  z.avail_in = comp_block_size;
+  if (z.avail_in > m_header.block_size)
+  {
+    ERROR_LOG_FMT(DISCIO, "Compressed block size is larger than uncompressed block size");
+  }
+  z.next_out = out_ptr;
+  z.avail_out = m_header.block_size;
+  inflateInit(&z);
+  int status = inflate(&z, Z_FULL_FLUSH);
+  u32 uncomp_size = m_header.block_size - z.avail_out;
+  if (status != Z_STREAM_END)
+  {
+    // this seem to fire wrongly from time to time
+    // to be sure, don't use compressed isos :P
+    ERROR_LOG_FMT(DISCIO, "Failure reading block {} - out of data and not at end.", block_num);
+  }
+  inflateEnd(&z);
+  if (uncomp_size != m_header.block_size)
+  {
+    ERROR_LOG_FMT(DISCIO, "Wrong block size");
+    return false;
+  }
+  return true;
+}
+
+bool CompressedBlobReader::DecompressBlocks(u64 block_num, u64 num_blocks, const u8* data,
+                                            u8* out_ptr) const
+{
+  const u64 base_offset = GetBlockOffset(block_num);
+  for (u64 i = block_num; i < block_num + num_blocks; ++i)
+  {
+    if (!DecompressBlock(i, data + (GetBlockOffset(i) - base_offset), out_ptr))
+      return false;
+    out_ptr += m_header.block_size;
+  }
+  return true;
+}
+
+bool CompressedBlobReader::DecompressBlocksInParallel(u64 block_num, u64 num_blocks,
+                                                      const u8* data, u8* out_ptr)
+{
+  // Spinning up the threads only pays off for fairly large reads, and readers that are only used
+  // for reading a few headers (like the ones the game list creates) never get that far
+  if (num_blocks >= 2 * MIN_BLOCKS_PER_DECOMPRESSION_THREAD && m_decompression_threads.empty())
+  {
+    const u32 thread_count = std::clamp<u32>(std::thread::hardware_concurrency(), 1,
+                                             MAX_DECOMPRESSION_THREADS);
+    for (u32 i = 1; i < thread_count; ++i)
     {
-      // this seem to fire wrongly from time to time
-      // to be sure, don't use compressed isos :P
-      ERROR_LOG_FMT(DISCIO, "Failure reading block {} - out of data and not at end.", block_num);
+      m_decompression_threads.push_back(
+          std::make_unique<Common::WorkQueueThread<DecompressionTask>>(
+              "GCZ Decompression", [this](DecompressionTask task) {
+                if (!DecompressBlocks(task.block_num, task.num_blocks, task.data, task.out_ptr))
+                  m_decompression_failed = true;
+              }));
     }
-    inflateEnd(&z);
-    if (uncomp_size != m_header.block_size)
+  }
+
+  // The calling thread takes a share of the blocks too
+  const u64 thread_count =
+      std::min<u64>(m_decompression_threads.size() + 1,
+                    std::max<u64>(num_blocks / MIN_BLOCKS_PER_DECOMPRESSION_THREAD, 1));
+  if (thread_count == 1)
+    return DecompressBlocks(block_num, num_blocks, data, out_ptr);
+
+  m_decompression_failed = false;
+
+  const u64 base_offset = GetBlockOffset(block_num);
+  const u64 blocks_per_thread = num_blocks / thread_count;
+  u64 first_block = block_num;
+  for (u64 i = 0; i < thread_count - 1; ++i)
+  {
+    m_decompression_threads[i]->Push(DecompressionTask{
+        first_block, blocks_per_thread, data + (GetBlockOffset(first_block) - base_offset),
+        out_ptr + (first_block - block_num) * m_header.block_size});
+    first_block += blocks_per_thread;
+  }
+
+  bool success = DecompressBlocks(first_block, block_num + num_blocks - first_block,
+                                  data + (GetBlockOffset(first_block) - base_offset),
+                                  out_ptr + (first_block - block_num) * m_header.block_size);
+
+  for (u64 i = 0; i < thread_count - 1; ++i)
+    m_decompression_threads[i]->WaitForCompletion();
+
+  return success && !m_decompression_failed;
+}
+
+bool CompressedBlobReader::Read(u64 offset, u64 size, u8* out_ptr)
+{
+  UpdateChunkSize(offset, size);
+  return SectorReader::Read(offset, size, out_ptr);
+}
+
+void CompressedBlobReader::UpdateChunkSize(u64 offset, u64 size)
+{
+  const bool sequential = offset == m_next_sequential_offset;
+  m_next_sequential_offset = offset + size;
+  m_sequential_requests = sequential ? m_sequential_requests + 1 : 0;
+  m_random_requests = sequential ? 0 : m_random_requests + 1;
+
+  // Changing the chunk size empties the cache, so it's only done after a few reads in a row
+  // agree on the access pattern
+  const int chunk_blocks =
+      m_header.block_size != 0 ? std::max<int>(GCZ_CHUNK_SIZE / m_header.block_size, 1) : 1;
+  if (GetChunkSize() != chunk_blocks && m_sequential_requests >= READ_AHEAD_TRIGGER)
+    SetChunkSize(chunk_blocks);
+  else if (GetChunkSize() != 1 && m_random_requests >= READ_AHEAD_TRIGGER)
+    SetChunkSize(1);
+}
+
+bool CompressedBlobReader::GetBlock(u64 block_num, u8* out_ptr)
+{
+  return ReadCompressedBlocks(m_file, block_num, 1, &m_zlib_buffer) &&
+         DecompressBlock(block_num, m_zlib_buffer.data(), out_ptr);
+}
+
+bool CompressedBlobReader::ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* out_ptr)
+{
+  if (num_blocks == 0)
+    return true;
+
+  bool success;
+  if (!TakeReadAheadChunk(block_num, num_blocks, out_ptr, &success))
+  {
+    success = ReadCompressedBlocks(m_file, block_num, num_blocks, &m_zlib_buffer) &&
+              DecompressBlocksInParallel(block_num, num_blocks, m_zlib_buffer.data(), out_ptr);
+  }
+
+  UpdateReadAhead(block_num, num_blocks);
+  return success;
+}
+
+bool CompressedBlobReader::TakeReadAheadChunk(u64 block_num, u64 num_blocks, u8* out_ptr,
+                                              bool* success)
+{
+  std::unique_lock lk(m_read_ahead_mutex);
+
+  const auto it = m_read_ahead_chunks.find(block_num);
+  if (it == m_read_ahead_chunks.end() || it->second.num_blocks != num_blocks)
+    return false;
+
+  // The chunk is queued or being decompressed. Since the read-ahead thread works through the
+  // chunks in order and this is the first chunk that anyone is waiting for, waiting is never
+  // slower than decompressing the chunk again on this thread.
+  m_read_ahead_cv.wait(lk, [&] { return it->second.done; });
+
+  const ReadAheadChunk chunk = std::move(it->second);
+  m_read_ahead_chunks.erase(it);
+
+  // The size is checked against the stored data itself, since out_ptr only has room for the
+  // blocks that were asked for
+  if (chunk.success && chunk.data.size() != num_blocks * m_header.block_size)
+    return false;
+
+  *success = chunk.success;
+  if (*success)
+    std::copy(chunk.data.begin(), chunk.data.end(), out_ptr);
+  return true;
+}
+
+void CompressedBlobReader::UpdateReadAhead(u64 block_num, u64 num_blocks)
+{
+  const bool sequential = block_num == m_next_sequential_block;
+  m_next_sequential_block = block_num + num_blocks;
+  m_sequential_reads = sequential ? m_sequential_reads + 1 : 0;
+
+  std::unique_lock lk(m_read_ahead_mutex);
+
+  if (!sequential)
+  {
+    // The chunks that were read ahead are unlikely to be needed now. Chunks that the read-ahead
+    // thread is currently working on are simply discarded when it is done with them.
+    if (!m_read_ahead_chunks.empty())
     {
-      ERROR_LOG_FMT(DISCIO, "Wrong block size");
-      return false;
+      m_read_ahead_chunks.clear();
+      lk.unlock();
+      m_read_ahead_thread.Cancel();
     }
+    return;
   }
-  return true;
+
+  // Drop chunks that were skipped over
+  m_read_ahead_chunks.erase(m_read_ahead_chunks.begin(),
+                            m_read_ahead_chunks.lower_bound(m_next_sequential_block));
+
+  if (m_sequential_reads < READ_AHEAD_TRIGGER)
+    return;
+
+  if (!m_read_ahead_file)
+  {
+    m_read_ahead_file = m_file.Duplicate("rb");
+    if (!m_read_ahead_file)
+      return;
+    m_read_ahead_thread.Reset("GCZ Read-Ahead", [this](u64 block) { ReadAhead(block); });
+  }
+
+  for (u32 i = 0; i < READ_AHEAD_CHUNKS; ++i)
+  {
+    const u64 chunk_block = m_next_sequential_block + i * num_blocks;
+    if (chunk_block >= m_header.num_blocks)
+      break;
+
+    const auto [it, inserted] = m_read_ahead_chunks.try_emplace(chunk_block);
+    if (!inserted)
+      continue;
+
+    it->second.num_blocks = std::min<u64>(num_blocks, m_header.num_blocks - chunk_block);
+    m_read_ahead_thread.Push(chunk_block);
+  }
+}
+
+void CompressedBlobReader::ReadAhead(u64 block_num)
+{
+  u64 num_blocks;
+  {
+    std::lock_guard lk(m_read_ahead_mutex);
+    const auto it = m_read_ahead_chunks.find(block_num);
+    if (it == m_read_ahead_chunks.end())
+      return;
+    num_blocks = it->second.num_blocks;
+  }
+
+  std::vector<u8> compressed_data;
+  std::vector<u8> data(num_blocks * m_header.block_size);
+  const bool success = ReadCompressedBlocks(m_read_ahead_file, block_num, num_blocks,
+                                            &compressed_data) &&
+                       DecompressBlocks(block_num, num_blocks, compressed_data.data(), data.data());
+
+  // The chunk may have been dropped and queued again (possibly with a different size) while this
+  // copy of it was being decompressed
+  std::lock_guard lk(m_read_ahead_mutex);
+  const auto it = m_read_ahead_chunks.find(block_num);
+  if (it == m_read_ahead_chunks.end() || it->second.done || it->second.num_blocks != num_blocks)
+    return;
+
+  it->second.data = std::move(data);
+  it->second.success = success;
+  it->second.done = true;
+  m_read_ahead_cv.notify_all();
 }
 
 struct CompressThreadState
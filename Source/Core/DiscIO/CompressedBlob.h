@@ -12,12 +12,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/IOFile.h"
+#include "Common/WorkQueueThread.h"
 #include "DiscIO/Blob.h"
 
 namespace DiscIO
@@ -61,12 +66,55 @@ public:
   std::string GetCompressionMethod() const override { return "Deflate"; }
   std::optional<int> GetCompressionLevel() const override { return std::nullopt; }
 
+  bool Read(u64 offset, u64 size, u8* out_ptr) override;
+
   u64 GetBlockCompressedSize(u64 block_num) const;
   bool GetBlock(u64 block_num, u8* out_ptr) override;
+  bool ReadMultipleAlignedBlocks(u64 block_num, u64 num_blocks, u8* out_ptr) override;
 
 private:
+  struct DecompressionTask
+  {
+    u64 block_num;
+    u64 num_blocks;
+    const u8* data;  // The compressed data of block_num
+    u8* out_ptr;
+  };
+
+  struct ReadAheadChunk
+  {
+    u64 num_blocks = 0;
+    std::vector<u8> data;
+    bool done = false;
+    bool success = false;
+  };
+
   CompressedBlobReader(File::IOFile file, const std::string& filename);
 
+  // The offset in the file of the compressed data of a block
+  u64 GetBlockOffset(u64 block_num) const;
+
+  // Reads the compressed data of a range of blocks into buffer using a single read
+  bool ReadCompressedBlocks(File::IOFile& file, u64 block_num, u64 num_blocks,
+                            std::vector<u8>* buffer) const;
+
+  // Checks the hash of a block and decompresses it. Safe to call from multiple threads.
+  bool DecompressBlock(u64 block_num, const u8* data, u8* out_ptr) const;
+  bool DecompressBlocks(u64 block_num, u64 num_blocks, const u8* data, u8* out_ptr) const;
+
+  // Splits the decompression of a range of blocks across the decompression threads
+  bool DecompressBlocksInParallel(u64 block_num, u64 num_blocks, const u8* data, u8* out_ptr);
+
+  // Switches between reading single blocks and whole chunks depending on whether the data is read
+  // sequentially
+  void UpdateChunkSize(u64 offset, u64 size);
+
+  // Copies a chunk out of the read-ahead buffers if it has been (or is being) read ahead
+  bool TakeReadAheadChunk(u64 block_num, u64 num_blocks, u8* out_ptr, bool* success);
+  // Detects sequential reads and queues up the chunks that are likely to be read next
+  void UpdateReadAhead(u64 block_num, u64 num_blocks);
+  void ReadAhead(u64 block_num);
+
   CompressedBlobHeader m_header;
   std::vector<u64> m_block_pointers;
   std::vector<u32> m_hashes;
@@ -75,6 +123,26 @@ private:
   u64 m_file_size;
   std::vector<u8> m_zlib_buffer;
   std::string m_file_name;
+
+  u64 m_next_sequential_offset = 0;
+  u32 m_sequential_requests = 0;
+  u32 m_random_requests = 0;
+
+  // Read-ahead state. m_read_ahead_chunks is keyed by the first block of each chunk and is shared
+  // with the read-ahead thread, which uses its own file handle.
+  std::mutex m_read_ahead_mutex;
+  std::condition_variable m_read_ahead_cv;
+  std::map<u64, ReadAheadChunk> m_read_ahead_chunks;
+  u64 m_next_sequential_block = 0;
+  u32 m_sequential_reads = 0;
+  File::IOFile m_read_ahead_file;
+
+  std::atomic<bool> m_decompression_failed = false;
+
+  // These are declared last so that the threads are stopped before anything they use is destroyed
+  std::vector<std::unique_ptr<Common::WorkQueueThread<DecompressionTask>>>
+      m_decompression_threads;
+  Common::WorkQueueThread<u64> m_read_ahead_thread;
 };
 
 }  // namespace DiscIO
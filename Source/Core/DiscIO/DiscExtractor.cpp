@@ -11,10 +11,17 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
+#include "Common/Logging/Log.h"
+#include "Common/Semaphore.h"
+#include "Common/WorkQueueThread.h"
 #include "DiscIO/DiscUtils.h"
 #include "DiscIO/Enums.h"
 #include "DiscIO/Filesystem.h"
@@ -98,10 +105,48 @@ bool ExportFile(const Volume& volume, const Partition& partition, std::string_vi
   return ExportFile(volume, partition, file_system->FindFileInfo(path).get(), export_filename);
 }
 
-void ExportDirectory(const Volume& volume, const Partition& partition, const FileInfo& directory,
-                     bool recursive, const std::string& filesystem_path,
-                     const std::string& export_folder,
-                     const std::function<bool(const std::string& path)>& update_progress)
+namespace
+{
+// Files are read in batches of up to this size. Files that are larger than this are split into
+// several batches.
+constexpr u64 EXPORT_BATCH_SIZE = 0x800000;
+// Files that are closer than this to the end of the current batch are read as part of the same
+// batch even though the data between them will be thrown away, so that a Wii group that contains
+// the end of one file and the start of another only has to be decrypted once.
+constexpr u64 EXPORT_MAX_GAP = 0x200000;
+constexpr u32 MAX_EXPORT_THREADS = 4;
+
+struct ExportFileEntry
+{
+  std::string path;
+  std::string export_path;
+  u64 offset;
+  u64 size;
+};
+
+struct ExportRange
+{
+  const ExportFileEntry* file;
+  u64 offset_in_buffer;
+  u64 size;
+  // True for the first (or only) range of a file, false for the ones that follow it
+  bool create;
+  // True for the last (or only) range of a file
+  bool finish;
+  bool read_succeeded = true;
+};
+
+struct ExportBatch
+{
+  std::vector<u8> buffer;
+  std::vector<ExportRange> ranges;
+};
+
+// Creates the directories to export and collects the files in them, in FST order
+bool CollectExportEntries(const FileInfo& directory, bool recursive,
+                          const std::string& filesystem_path, const std::string& export_folder,
+                          const std::function<bool(const std::string& path)>& update_progress,
+                          std::vector<ExportFileEntry>* files)
 {
   std::string export_root = export_folder + '/';
   if (directory.IsDirectory() && !directory.IsRoot())
@@ -115,25 +160,185 @@ void ExportDirectory(const Volume& volume, const Partition& partition, const Fil
     const std::string path = filesystem_path + name;
     const std::string export_path = export_root + name;
 
+    if (!file_info.IsDirectory() && !File::Exists(export_path))
+    {
+      // Progress is reported when the file actually gets exported
+      files->push_back({path, export_path, file_info.GetOffset(), file_info.GetSize()});
+      continue;
+    }
+
     if (update_progress(path))
-      return;
+      return false;
 
     DEBUG_LOG_FMT(DISCIO, "{}", export_path);
 
     if (!file_info.IsDirectory())
+      NOTICE_LOG_FMT(DISCIO, "{} already exists", export_path);
+    else if (recursive)
     {
-      if (File::Exists(export_path))
-        NOTICE_LOG_FMT(DISCIO, "{} already exists", export_path);
-      else if (!ExportFile(volume, partition, &file_info, export_path))
-        ERROR_LOG_FMT(DISCIO, "Could not export {}", export_path);
+      if (!CollectExportEntries(file_info, recursive, path, export_root, update_progress, files))
+        return false;
     }
-    else if (recursive)
+  }
+
+  return true;
+}
+
+void WriteExportBatch(ExportBatch batch, File::IOFile* file)
+{
+  for (const ExportRange& range : batch.ranges)
+  {
+    if (range.create)
     {
-      ExportDirectory(volume, partition, file_info, recursive, filesystem_path, export_root,
-                      update_progress);
+      *file = File::IOFile(range.file->export_path, "wb");
+      if (!*file)
+      {
+        ERROR_LOG_FMT(DISCIO, "Could not export {}", range.file->export_path);
+        continue;
+      }
     }
+    else if (!*file)
+    {
+      // An earlier range of this file failed
+      continue;
+    }
+
+    if (!range.read_succeeded ||
+        !file->WriteBytes(batch.buffer.data() + range.offset_in_buffer, range.size))
+    {
+      // Don't leave a partially written file behind
+      ERROR_LOG_FMT(DISCIO, "Could not export {}", range.file->export_path);
+      file->Close();
+      File::Delete(range.file->export_path);
+      continue;
+    }
+
+    if (range.finish)
+      file->Close();
   }
 }
+}  // namespace
+
+void ExportDirectory(const Volume& volume, const Partition& partition, const FileInfo& directory,
+                     bool recursive, const std::string& filesystem_path,
+                     const std::string& export_folder,
+                     const std::function<bool(const std::string& path)>& update_progress)
+{
+  // All directories are created up front. The files are then read in the order they are stored
+  // on the disc, which avoids seeking and lets files that share a Wii group be read with a single
+  // decryption of that group. Writing the files is left to a few worker threads.
+  std::vector<ExportFileEntry> files;
+  if (!CollectExportEntries(directory, recursive, filesystem_path, export_folder, update_progress,
+                            &files))
+  {
+    return;
+  }
+
+  // If the FST contains several files with the same path, only the first one gets exported
+  std::unordered_set<std::string> export_paths;
+  std::erase_if(files, [&export_paths](const ExportFileEntry& file) {
+    return !export_paths.insert(file.export_path).second;
+  });
+
+  std::stable_sort(files.begin(), files.end(),
+                   [](const ExportFileEntry& a, const ExportFileEntry& b) {
+                     return a.offset < b.offset;
+                   });
+
+  const u32 thread_count =
+      std::clamp<u32>(std::thread::hardware_concurrency(), 1, MAX_EXPORT_THREADS);
+
+  // Limits how much data can have been read but not yet written
+  Common::Semaphore free_batches(thread_count * 2, thread_count * 2);
+
+  // Each worker keeps the file it's currently writing open, so that a file which is split into
+  // several batches can be written by pushing all of those batches to the same worker
+  std::vector<File::IOFile> open_files(thread_count);
+  std::vector<Common::WorkQueueThread<ExportBatch>> workers(thread_count);
+  for (u32 i = 0; i < thread_count; ++i)
+  {
+    workers[i].Reset("Export Worker", [&free_batches, file = &open_files[i]](ExportBatch batch) {
+      WriteExportBatch(std::move(batch), file);
+      free_batches.Post();
+    });
+  }
+
+  u32 next_worker = 0;
+  const auto submit_batch = [&](u64 offset, u64 size, std::vector<ExportRange> ranges) {
+    free_batches.Wait();
+
+    ExportBatch batch{std::vector<u8>(size), std::move(ranges)};
+    if (size != 0 && !volume.Read(offset, size, batch.buffer.data(), partition))
+    {
+      // Retry file by file so that one unreadable file doesn't take the rest of the batch with it
+      for (ExportRange& range : batch.ranges)
+      {
+        range.read_succeeded = volume.Read(offset + range.offset_in_buffer, range.size,
+                                           batch.buffer.data() + range.offset_in_buffer, partition);
+      }
+    }
+
+    workers[next_worker].Push(std::move(batch));
+  };
+
+  u64 batch_offset = 0;
+  u64 batch_end = 0;
+  std::vector<ExportRange> batch_ranges;
+  bool cancelled = false;
+
+  const auto flush_batch = [&] {
+    if (batch_ranges.empty() || cancelled)
+      return;
+
+    submit_batch(batch_offset, batch_end - batch_offset, std::move(batch_ranges));
+    batch_ranges.clear();
+    next_worker = (next_worker + 1) % thread_count;
+  };
+
+  for (const ExportFileEntry& file : files)
+  {
+    if (update_progress(file.path))
+    {
+      cancelled = true;
+      break;
+    }
+
+    DEBUG_LOG_FMT(DISCIO, "{}", file.export_path);
+
+    if (file.size > EXPORT_BATCH_SIZE)
+    {
+      // Large files get batches of their own, which all go to the same worker
+      flush_batch();
+      for (u64 offset = 0; offset < file.size; offset += EXPORT_BATCH_SIZE)
+      {
+        const u64 size = std::min(EXPORT_BATCH_SIZE, file.size - offset);
+        submit_batch(file.offset + offset, size,
+                     {{&file, 0, size, offset == 0, offset + size == file.size}});
+      }
+      next_worker = (next_worker + 1) % thread_count;
+      continue;
+    }
+
+    const u64 file_end = file.offset + file.size;
+    const bool fits_in_batch = file.offset <= batch_end + EXPORT_MAX_GAP &&
+                               std::max(batch_end, file_end) - batch_offset <= EXPORT_BATCH_SIZE;
+    if (!fits_in_batch)
+      flush_batch();
+
+    if (batch_ranges.empty())
+    {
+      batch_offset = file.offset;
+      batch_end = file.offset;
+    }
+
+    batch_ranges.push_back({&file, file.offset - batch_offset, file.size, true, true});
+    batch_end = std::max(batch_end, file_end);
+  }
+  flush_batch();
+
+  for (Common::WorkQueueThread<ExportBatch>& worker : workers)
+    worker.Shutdown();
+}
 
 bool ExportWiiUnencryptedHeader(const Volume& volume, const std::string& export_filename)
 {
@@ -4,6 +4,7 @@
 #include "DiscIO/FileBlob.h"
 
 #include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
@@ -11,30 +12,67 @@
 
 #include "Common/Assert.h"
 #include "Common/FileUtil.h"
+#include "Common/MappedFile.h"
 #include "Common/MsgHandler.h"
 
 namespace DiscIO
 {
-PlainFileReader::PlainFileReader(File::IOFile file) : m_file(std::move(file))
+PlainFileReader::PlainFileReader(File::IOFile file,
+                                 std::shared_ptr<const Common::MappedFile> mapping,
+                                 PlainFileAccess access)
+    : m_file(std::move(file)), m_mapping(std::move(mapping)), m_access(access)
 {
   m_size = m_file.GetSize();
 }
 
-std::unique_ptr<PlainFileReader> PlainFileReader::Create(File::IOFile file)
+PlainFileReader::~PlainFileReader() = default;
+
+std::unique_ptr<PlainFileReader> PlainFileReader::Create(File::IOFile file,
+                                                         PlainFileAccess access)
 {
-  if (file)
-    return std::unique_ptr<PlainFileReader>(new PlainFileReader(std::move(file)));
+  if (!file)
+    return nullptr;
+
+  std::shared_ptr<const Common::MappedFile> mapping;
+  if (access != PlainFileAccess::Buffered)
+  {
+    mapping = Common::MappedFile::Map(file, access == PlainFileAccess::MemoryMappedSequential ?
+                                                Common::MappedFile::AccessPattern::Sequential :
+                                                Common::MappedFile::AccessPattern::Normal);
+    if (!mapping)
+      access = PlainFileAccess::Buffered;
+  }
 
-  return nullptr;
+  return std::unique_ptr<PlainFileReader>(
+      new PlainFileReader(std::move(file), std::move(mapping), access));
 }
 
 std::unique_ptr<BlobReader> PlainFileReader::CopyReader() const
 {
-  return Create(m_file.Duplicate("rb"));
+  File::IOFile file = m_file.Duplicate("rb");
+  if (!file)
+    return nullptr;
+
+  return std::unique_ptr<PlainFileReader>(
+      new PlainFileReader(std::move(file), m_mapping, m_access));
+}
+
+const u8* PlainFileReader::GetMappedData(u64 offset, u64 nbytes) const
+{
+  if (!m_mapping || offset > m_mapping->GetSize() || nbytes > m_mapping->GetSize() - offset)
+    return nullptr;
+
+  return m_mapping->GetData() + offset;
 }
 
 bool PlainFileReader::Read(u64 offset, u64 nbytes, u8* out_ptr)
 {
+  if (const u8* data = GetMappedData(offset, nbytes))
+  {
+    std::memcpy(out_ptr, data, nbytes);
+    return true;
+  }
+
   if (m_file.Seek(offset, File::SeekOrigin::Begin) && m_file.ReadBytes(out_ptr, nbytes))
   {
     return true;
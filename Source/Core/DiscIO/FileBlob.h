@@ -11,12 +11,30 @@
 #include "Common/IOFile.h"
 #include "DiscIO/Blob.h"
 
+namespace Common
+{
+class MappedFile;
+}
+
 namespace DiscIO
 {
+enum class PlainFileAccess
+{
+  // Every read is a seek and a read on the file
+  Buffered,
+  // Reads are served from a memory mapping of the file
+  MemoryMapped,
+  // Like MemoryMapped, but tells the OS to expect sequential access so that it reads ahead further
+  MemoryMappedSequential,
+};
+
 class PlainFileReader : public BlobReader
 {
 public:
-  static std::unique_ptr<PlainFileReader> Create(File::IOFile file);
+  // If mapping the file fails, PlainFileAccess::Buffered is used instead.
+  static std::unique_ptr<PlainFileReader>
+  Create(File::IOFile file, PlainFileAccess access = PlainFileAccess::Buffered);
+  ~PlainFileReader();
 
   BlobType GetBlobType() const override { return BlobType::PLAIN; }
   std::unique_ptr<BlobReader> CopyReader() const override;
@@ -31,12 +49,20 @@ public:
   std::optional<int> GetCompressionLevel() const override { return std::nullopt; }
 
   bool Read(u64 offset, u64 nbytes, u8* out_ptr) override;
+  const u8* GetMappedData(u64 offset, u64 nbytes) const override;
+
+  PlainFileAccess GetAccess() const { return m_access; }
 
 private:
-  PlainFileReader(File::IOFile file);
+  PlainFileReader(File::IOFile file, std::shared_ptr<const Common::MappedFile> mapping,
+                  PlainFileAccess access);
 
   File::IOFile m_file;
   u64 m_size;
+
+  // Shared with readers created by CopyReader
+  std::shared_ptr<const Common::MappedFile> m_mapping;
+  PlainFileAccess m_access;
 };
 
 }  // namespace DiscIO
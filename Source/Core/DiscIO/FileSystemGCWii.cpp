@@ -12,6 +12,8 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "Common/CommonFuncs.h"
@@ -301,9 +303,58 @@ std::unique_ptr<FileInfo> FileSystemGCWii::FindFileInfo(std::string_view path) c
   if (!IsValid())
     return nullptr;
 
+  // Build a cache (unless there already is one)
+  if (m_path_file_info_cache.empty())
+    BuildPathFileInfoCache();
+
+  std::string normalized_path;
+  for (size_t name_start = path.find_first_not_of('/'); name_start != std::string::npos;
+       name_start = path.find_first_not_of('/', name_start))
+  {
+    const size_t name_end = path.find('/', name_start);
+    if (!normalized_path.empty())
+      normalized_path += '/';
+    normalized_path += path.substr(name_start, name_end - name_start);
+    name_start = name_end;
+  }
+  Common::ToLower(&normalized_path);
+
+  if (normalized_path.empty())
+    return m_root.clone();
+
+  const auto it = m_path_file_info_cache.find(normalized_path);
+  if (it != m_path_file_info_cache.end())
+    return std::make_unique<FileInfoGCWii>(m_root, it->second);
+
+  // The cache only folds the case of ASCII characters, so fall back to searching the tree
   return FindFileInfo(path, m_root);
 }
 
+void FileSystemGCWii::BuildPathFileInfoCache() const
+{
+  // The FST lists every directory's contents right after the directory itself, so the path of
+  // each entry can be built by keeping track of which directories we're currently inside
+  std::vector<std::pair<u32, std::string>> directory_stack;  // End index and path of directories
+  const u32 fst_entries = m_root.GetSize();
+  for (u32 i = 1; i < fst_entries; i++)
+  {
+    while (!directory_stack.empty() && i >= directory_stack.back().first)
+      directory_stack.pop_back();
+
+    const FileInfoGCWii file_info(m_root, i);
+    std::string path = file_info.GetName();
+    Common::ToLower(&path);
+    if (!directory_stack.empty())
+      path = directory_stack.back().second + '/' + path;
+
+    // If several entries have the same path, the first one wins, like in the tree search
+    m_path_file_info_cache.emplace(path, i);
+
+    if (file_info.IsDirectory())
+      directory_stack.emplace_back(file_info.GetSize(), std::move(path));
+  }
+}
+
 std::unique_ptr<FileInfo> FileSystemGCWii::FindFileInfo(std::string_view path,
                                                         const FileInfo& file_info) const
 {
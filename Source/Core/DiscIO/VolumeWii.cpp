@@ -240,6 +240,15 @@ bool VolumeWii::Read(u64 offset, u64 length, u8* buffer, const Partition& partit
   return true;
 }
 
+const u8* VolumeWii::GetMappedData(u64 offset, u64 length, const Partition& partition) const
+{
+  // Partition data has to be decrypted or reassembled from blocks, so it can't be mapped
+  if (partition != PARTITION_NONE)
+    return nullptr;
+
+  return m_reader->GetMappedData(offset, length);
+}
+
 bool VolumeWii::HasWiiHashes() const
 {
   return m_has_hashes;
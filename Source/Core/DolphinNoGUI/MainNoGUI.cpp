@@ -9,6 +9,7 @@
 #include <cstring>
 #include <signal.h>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifndef _WIN32
@@ -17,10 +18,16 @@
 #include <Windows.h>
 #endif
 
+#include "AudioCommon/AudioCommon.h"
+#include "Common/Config/Config.h"
+#include "Common/Flag.h"
 #include "Common/ScopeGuard.h"
 #include "Common/StringUtil.h"
+#include "Common/Thread.h"
+#include "Common/Timer.h"
 #include "Core/Boot/Boot.h"
 #include "Core/BootManager.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/Core.h"
 #include "Core/DolphinAnalytics.h"
 #include "Core/Host.h"
@@ -185,6 +192,56 @@ static std::unique_ptr<Platform> GetPlatform(const optparse::Values& options)
   return nullptr;
 }
 
+// Audio rendering writes the audio of the emulated DSP and the DTK stream to WAV files as fast as
+// the host can emulate, without a sound device. This is meant for benchmarking and regression
+// testing the audio emulation, ideally together with the Null video backend.
+static void SetUpAudioRender(const std::string& base_name)
+{
+  Config::SetCurrent(Config::MAIN_AUDIO_BACKEND, BACKEND_NULLSOUND);
+  Config::SetCurrent(Config::MAIN_EMULATION_SPEED, 0.0f);
+  Config::SetCurrent(Config::MAIN_DUMP_AUDIO, true);
+  Config::SetCurrent(Config::MAIN_DUMP_AUDIO_SILENT, true);
+  AudioCommon::SetAudioDumpBaseName(base_name);
+}
+
+static void PrintAudioRenderProgress(u64 start_us)
+{
+  const double host_seconds = (Common::Timer::NowUs() - start_us) / 1000000.0;
+  const double audio_seconds = AudioCommon::GetDSPAudioSeconds();
+  const u64 samples = AudioCommon::GetDSPSampleCount();
+  fprintf(stdout,
+          "Rendered %llu samples (%.2f s of audio) in %.2f s: %.0f samples/s, %.2fx speed\n",
+          static_cast<unsigned long long>(samples), audio_seconds, host_seconds,
+          host_seconds > 0 ? samples / host_seconds : 0.0,
+          host_seconds > 0 ? audio_seconds / host_seconds : 0.0);
+}
+
+// Prints the progress once per second and stops emulation once length seconds of audio have been
+// rendered. A length of 0 renders until emulation is stopped.
+static void AudioRenderMonitor(const Common::Flag& running, u64 start_us, double length)
+{
+  Common::SetCurrentThreadName("Audio Render Monitor");
+
+  u64 last_report_us = start_us;
+  while (running.IsSet())
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    if (length > 0 && AudioCommon::GetDSPAudioSeconds() >= length)
+    {
+      s_platform->Stop();
+      return;
+    }
+
+    const u64 now_us = Common::Timer::NowUs();
+    if (now_us - last_report_us >= 1000000)
+    {
+      PrintAudioRenderProgress(start_us);
+      last_report_us = now_us;
+    }
+  }
+}
+
 #ifdef _WIN32
 #define main app_main
 #endif
@@ -216,6 +273,16 @@ int main(int argc, char* argv[])
             "macos"
 #endif
       });
+  parser->add_option("--render-audio")
+      .action("store")
+      .metavar("<base name>")
+      .help("Render the audio to <base name>_dspdump.wav and <base name>_dtkdump.wav as fast as "
+            "possible, without a sound device");
+  parser->add_option("--render-seconds")
+      .action("store")
+      .type("double")
+      .metavar("<seconds>")
+      .help("Stop after rendering this many seconds of DSP audio with --render-audio");
 
   optparse::Values& options = CommandLineParse::ParseArguments(parser.get(), argc, argv);
   std::vector<std::string> args = parser->args();
@@ -290,6 +357,10 @@ int main(int argc, char* argv[])
     return 1;
   }
 
+  const bool render_audio = options.is_set("render_audio");
+  if (render_audio)
+    SetUpAudioRender(static_cast<const char*>(options.get("render_audio")));
+
   Core::AddOnStateChangedCallback([](Core::State state) {
     if (state == Core::State::Uninitialized)
       s_platform->Stop();
@@ -320,9 +391,27 @@ int main(int argc, char* argv[])
   Discord::UpdateDiscordPresence();
 #endif
 
+  Common::Flag render_monitor_running{render_audio};
+  std::thread render_monitor;
+  const u64 render_start_us = Common::Timer::NowUs();
+  if (render_audio)
+  {
+    const double render_seconds =
+        options.is_set("render_seconds") ? static_cast<double>(options.get("render_seconds")) : 0.0;
+    render_monitor = std::thread(AudioRenderMonitor, std::cref(render_monitor_running),
+                                 render_start_us, render_seconds);
+  }
+
   s_platform->MainLoop();
   Core::Stop(Core::System::GetInstance());
 
+  if (render_audio)
+  {
+    render_monitor_running.Clear();
+    render_monitor.join();
+    PrintAudioRenderProgress(render_start_us);
+  }
+
   Core::Shutdown(Core::System::GetInstance());
   s_platform.reset();
 
@@ -26,9 +26,9 @@ static const QStringList game_filters{
     QStringLiteral("*.[tT][gG][cC]"),    QStringLiteral("*.[cC][iI][sS][oO]"),
     QStringLiteral("*.[gG][cC][zZ]"),    QStringLiteral("*.[wW][bB][fF][sS]"),
     QStringLiteral("*.[wW][iI][aA]"),    QStringLiteral("*.[rR][vV][zZ]"),
-    QStringLiteral("hif_000000.nfs"),    QStringLiteral("*.[wW][aA][dD]"),
-    QStringLiteral("*.[eE][lL][fF]"),    QStringLiteral("*.[dD][oO][lL]"),
-    QStringLiteral("*.[jJ][sS][oO][nN]")};
+    QStringLiteral("hif_000000.nfs"),    QStringLiteral("*.[dD][cC][sS]"),
+    QStringLiteral("*.[wW][aA][dD]"),    QStringLiteral("*.[eE][lL][fF]"),
+    QStringLiteral("*.[dD][oO][lL]"),    QStringLiteral("*.[jJ][sS][oO][nN]")};
 
 GameTracker::GameTracker(QObject* parent) : QFileSystemWatcher(parent)
 {
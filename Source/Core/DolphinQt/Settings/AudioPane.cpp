@@ -82,6 +82,13 @@ void AudioPane::CreateWidgets()
   m_backend_label = new QLabel(tr("Audio Backend:"));
   m_backend_combo = new QComboBox();
   m_dolby_pro_logic = new QCheckBox(tr("Dolby Pro Logic II Decoder"));
+  m_resampler_label = new QLabel(tr("Resampling:"));
+  m_resampler_combo = new QComboBox();
+  m_resampler_combo->addItem(tr("Linear"));
+  m_resampler_combo->addItem(tr("Windowed Sinc"));
+  m_resampler_combo->setToolTip(
+      tr("Method used to convert the emulated audio to the output sample rate. Windowed Sinc "
+         "sounds clearer, especially for high-pitched sounds, but uses more CPU time."));
 
   if (m_latency_control_supported)
   {
@@ -125,6 +132,7 @@ void AudioPane::CreateWidgets()
   backend_layout->addRow(m_backend_label, m_backend_combo);
   if (m_latency_control_supported)
     backend_layout->addRow(m_latency_label, m_latency_spin);
+  backend_layout->addRow(m_resampler_label, m_resampler_combo);
 
 #ifdef _WIN32
   m_wasapi_device_label = new QLabel(tr("Device:"));
@@ -181,6 +189,7 @@ void AudioPane::ConnectWidgets()
   {
     connect(m_latency_spin, &QSpinBox::valueChanged, this, &AudioPane::SaveSettings);
   }
+  connect(m_resampler_combo, &QComboBox::currentIndexChanged, this, &AudioPane::SaveSettings);
   connect(m_stretching_buffer_slider, &QSlider::valueChanged, this, &AudioPane::SaveSettings);
   connect(m_dolby_pro_logic, &QCheckBox::toggled, this, &AudioPane::SaveSettings);
   connect(m_dolby_quality_slider, &QSlider::valueChanged, this, &AudioPane::SaveSettings);
@@ -243,6 +252,9 @@ void AudioPane::LoadSettings()
   if (m_latency_control_supported)
     m_latency_spin->setValue(Config::Get(Config::MAIN_AUDIO_LATENCY));
 
+  // Resampling
+  m_resampler_combo->setCurrentIndex(static_cast<int>(Config::Get(Config::MAIN_AUDIO_RESAMPLER)));
+
   // Stretch
   m_stretching_enable->setChecked(Config::Get(Config::MAIN_AUDIO_STRETCH));
   m_stretching_buffer_label->setEnabled(m_stretching_enable->isChecked());
@@ -311,6 +323,10 @@ void AudioPane::SaveSettings()
   if (m_latency_control_supported)
     Config::SetBaseOrCurrent(Config::MAIN_AUDIO_LATENCY, m_latency_spin->value());
 
+  // Resampling
+  Config::SetBaseOrCurrent(Config::MAIN_AUDIO_RESAMPLER, static_cast<AudioCommon::ResamplerType>(
+                                                             m_resampler_combo->currentIndex()));
+
   // Stretch
   Config::SetBaseOrCurrent(Config::MAIN_AUDIO_STRETCH, m_stretching_enable->isChecked());
   Config::SetBaseOrCurrent(Config::MAIN_AUDIO_STRETCH_LATENCY, m_stretching_buffer_slider->value());
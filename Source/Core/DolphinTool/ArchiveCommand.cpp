@@ -0,0 +1,304 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/ArchiveCommand.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <OptionParser.h>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Timer.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/ChunkStoreBlob.h"
+#include "DiscIO/WIABlob.h"
+#include "UICommon/UICommon.h"
+
+namespace DolphinTool
+{
+static double ToMiB(u64 bytes)
+{
+  return bytes / (1024.0 * 1024.0);
+}
+
+static double ToMiBPerSecond(u64 bytes, u64 microseconds)
+{
+  return microseconds == 0 ? 0.0 : ToMiB(bytes) * 1000000.0 / microseconds;
+}
+
+static std::unique_ptr<DiscIO::ChunkStoreReader> OpenDisc(const std::string& path, u32 disc_index)
+{
+  return DiscIO::ChunkStoreReader::Create(File::IOFile(path, "rb"), path, disc_index);
+}
+
+static bool ListDiscs(const std::string& path)
+{
+  const std::unique_ptr<DiscIO::ChunkStoreReader> first_disc = OpenDisc(path, 0);
+  if (!first_disc)
+    return false;
+
+  const u32 number_of_discs = first_disc->GetNumberOfDiscs();
+  fmt::println(std::cout, "{} discs, {} unique chunks, {:.1f} MiB", number_of_discs,
+               first_disc->GetNumberOfChunks(), ToMiB(first_disc->GetRawSize()));
+
+  for (u32 i = 0; i < number_of_discs; ++i)
+  {
+    const std::unique_ptr<DiscIO::ChunkStoreReader> disc = OpenDisc(path, i);
+    if (!disc)
+      return false;
+
+    fmt::println(std::cout, "{:4}: {} ({:.1f} MiB, {:.1f} MiB of chunks)", i, disc->GetDiscName(),
+                 ToMiB(disc->GetDataSize()), ToMiB(disc->GetReferencedChunkSize()));
+  }
+
+  return true;
+}
+
+// Reads every disc in the store sequentially and then with DVD-sized random reads, and reports
+// how much space the store saves over storing each disc on its own.
+static bool Benchmark(const std::string& path, std::optional<u64> input_size)
+{
+  const std::unique_ptr<DiscIO::ChunkStoreReader> first_disc = OpenDisc(path, 0);
+  if (!first_disc)
+    return false;
+
+  constexpr u64 SEQUENTIAL_READ_SIZE = 0x200000;
+  constexpr u64 RANDOM_READ_SIZE = 0x8000;
+  constexpr u32 RANDOM_READS_PER_DISC = 4096;
+
+  std::vector<u8> buffer(SEQUENTIAL_READ_SIZE);
+  std::mt19937_64 rng(0);
+
+  u64 total_data_size = 0;
+  u64 sequential_us = 0;
+  u64 random_us = 0;
+  u64 random_bytes = 0;
+
+  for (u32 i = 0; i < first_disc->GetNumberOfDiscs(); ++i)
+  {
+    const std::unique_ptr<DiscIO::ChunkStoreReader> disc = OpenDisc(path, i);
+    if (!disc)
+      return false;
+
+    const u64 data_size = disc->GetDataSize();
+    total_data_size += data_size;
+
+    u64 start = Common::Timer::NowUs();
+    for (u64 offset = 0; offset < data_size; offset += SEQUENTIAL_READ_SIZE)
+    {
+      if (!disc->Read(offset, std::min(SEQUENTIAL_READ_SIZE, data_size - offset), buffer.data()))
+        return false;
+    }
+    sequential_us += Common::Timer::NowUs() - start;
+
+    if (data_size < RANDOM_READ_SIZE)
+      continue;
+
+    start = Common::Timer::NowUs();
+    for (u32 j = 0; j < RANDOM_READS_PER_DISC; ++j)
+    {
+      const u64 offset = rng() % (data_size - RANDOM_READ_SIZE + 1);
+      if (!disc->Read(offset, RANDOM_READ_SIZE, buffer.data()))
+        return false;
+      random_bytes += RANDOM_READ_SIZE;
+    }
+    random_us += Common::Timer::NowUs() - start;
+  }
+
+  const u64 store_size = first_disc->GetRawSize();
+  fmt::println(std::cout, "Discs:              {}", first_disc->GetNumberOfDiscs());
+  fmt::println(std::cout, "Unique chunks:      {}", first_disc->GetNumberOfChunks());
+  fmt::println(std::cout, "Disc data:          {:.1f} MiB", ToMiB(total_data_size));
+  if (input_size)
+    fmt::println(std::cout, "Input files:        {:.1f} MiB", ToMiB(*input_size));
+  fmt::println(std::cout, "Store size:         {:.1f} MiB ({:.1f}% of disc data)",
+               ToMiB(store_size), total_data_size ? 100.0 * store_size / total_data_size : 0.0);
+  fmt::println(std::cout, "Sequential reads:   {:.1f} MiB/s",
+               ToMiBPerSecond(total_data_size, sequential_us));
+  fmt::println(std::cout, "Random 32 KiB reads: {:.1f} MiB/s",
+               ToMiBPerSecond(random_bytes, random_us));
+
+  return true;
+}
+
+int ArchiveCommand(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+
+  parser.usage("usage: archive [options]... [FILE]...");
+
+  parser.add_option("-u", "--user")
+      .type("string")
+      .action("store")
+      .help("User folder path, which holds the configuration used while reading the disc images. "
+            "Will be automatically created if this option is not set.")
+      .set_default("");
+
+  parser.add_option("-o", "--output")
+      .type("string")
+      .action("store")
+      .help("Create a chunk store at FILE containing every disc image given as an argument.")
+      .metavar("FILE");
+
+  parser.add_option("-i", "--input")
+      .type("string")
+      .action("store")
+      .help("Path to an existing chunk store FILE. Lists its discs unless --extract is set.")
+      .metavar("FILE");
+
+  parser.add_option("-l", "--compression_level")
+      .type("int")
+      .action("store")
+      .help("Zstandard compression level to use when creating a chunk store. Default is 5.")
+      .set_default(5);
+
+  parser.add_option("-d", "--disc")
+      .type("int")
+      .action("store")
+      .help("Index of the disc to extract. Default is 0.")
+      .set_default(0);
+
+  parser.add_option("-x", "--extract")
+      .type("string")
+      .action("store")
+      .help("Extract the disc selected by --disc from the store given by --input to an ISO FILE.")
+      .metavar("FILE");
+
+  parser.add_option("-b", "--benchmark")
+      .action("store_true")
+      .help("Read back every disc in the store and report storage savings and read throughput.");
+
+  const optparse::Values& options = parser.parse_args(args);
+  const std::vector<std::string>& input_files = parser.args();
+
+  UICommon::SetUserDirectory(options["user"]);
+  UICommon::Init();
+
+  const bool benchmark = options.is_set("benchmark");
+
+  if (options.is_set("output") == options.is_set("input"))
+  {
+    fmt::println(std::cerr, "Error: Exactly one of --output and --input must be set");
+    return EXIT_FAILURE;
+  }
+
+  if (options.is_set("input"))
+  {
+    const std::string& store_path = options["input"];
+
+    if (options.is_set("extract"))
+    {
+      const std::unique_ptr<DiscIO::ChunkStoreReader> disc =
+          OpenDisc(store_path, static_cast<u32>(static_cast<int>(options.get("disc"))));
+      if (!disc)
+      {
+        fmt::println(std::cerr, "Error: Unable to open the selected disc in the chunk store");
+        return EXIT_FAILURE;
+      }
+
+      const auto NOOP_STATUS_CALLBACK = [](const std::string& text, float percent) {
+        return true;
+      };
+      if (!DiscIO::ConvertToPlain(disc.get(), store_path, options["extract"],
+                                  NOOP_STATUS_CALLBACK))
+      {
+        fmt::println(std::cerr, "Error: Extraction failed");
+        return EXIT_FAILURE;
+      }
+    }
+    else if (!benchmark && !ListDiscs(store_path))
+    {
+      fmt::println(std::cerr, "Error: Unable to read the chunk store");
+      return EXIT_FAILURE;
+    }
+
+    if (benchmark && !Benchmark(store_path, std::nullopt))
+    {
+      fmt::println(std::cerr, "Error: Reading the chunk store failed");
+      return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+  }
+
+  const std::string& output_file_path = options["output"];
+
+  if (input_files.empty())
+  {
+    fmt::println(std::cerr, "Error: No input files set");
+    return EXIT_FAILURE;
+  }
+
+  const int compression_level = static_cast<int>(options.get("compression_level"));
+  const std::pair<int, int> range =
+      DiscIO::GetAllowedCompressionLevels(DiscIO::WIARVZCompressionType::Zstd, false);
+  if (compression_level < range.first || compression_level > range.second)
+  {
+    fmt::println(std::cerr, "Error: Compression level not in acceptable range");
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::unique_ptr<DiscIO::BlobReader>> blob_readers;
+  std::vector<DiscIO::BlobReader*> infiles;
+  u64 input_size = 0;
+  for (const std::string& input_file : input_files)
+  {
+    std::unique_ptr<DiscIO::BlobReader> blob_reader = DiscIO::CreateBlobReader(input_file);
+    if (!blob_reader)
+    {
+      fmt::println(std::cerr, "Error: The input file {} could not be opened.", input_file);
+      return EXIT_FAILURE;
+    }
+
+    if (blob_reader->GetDataSizeType() != DiscIO::DataSizeType::Accurate)
+    {
+      fmt::println(std::cerr,
+                   "Warning: The size of {} is not accurately known. The stored disc may "
+                   "contain padding. Continuing anyway.",
+                   input_file);
+    }
+
+    input_size += blob_reader->GetRawSize();
+    infiles.push_back(blob_reader.get());
+    blob_readers.push_back(std::move(blob_reader));
+  }
+
+  const auto STATUS_CALLBACK = [](const std::string& text, float percent) {
+    fmt::print(std::cerr, "\r{} ({}%)   ", text, static_cast<int>(percent * 100));
+    return true;
+  };
+
+  const u64 start = Common::Timer::NowUs();
+  const bool success = DiscIO::ConvertToChunkStore(infiles, input_files, output_file_path,
+                                                   compression_level, STATUS_CALLBACK);
+  const u64 elapsed_us = Common::Timer::NowUs() - start;
+  fmt::println(std::cerr, "");
+
+  if (!success)
+  {
+    fmt::println(std::cerr, "Error: Creating the chunk store failed");
+    return EXIT_FAILURE;
+  }
+
+  fmt::println(std::cout, "Stored {} discs in {:.1f} s ({:.1f} MiB/s)", infiles.size(),
+               elapsed_us / 1000000.0, ToMiBPerSecond(input_size, elapsed_us));
+
+  if (benchmark && !Benchmark(output_file_path, input_size))
+  {
+    fmt::println(std::cerr, "Error: Reading the chunk store failed");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+}  // namespace DolphinTool
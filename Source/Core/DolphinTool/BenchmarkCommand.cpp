@@ -0,0 +1,207 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/BenchmarkCommand.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <OptionParser.h>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+#include "Common/Timer.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/FileBlob.h"
+#include "UICommon/UICommon.h"
+
+namespace DolphinTool
+{
+constexpr u64 SEQUENTIAL_READ_SIZE = 0x200000;
+// The size of a typical DVD read request made by games
+constexpr u64 RANDOM_READ_SIZE = 0x8000;
+
+struct BenchmarkResult
+{
+  u64 sequential_bytes = 0;
+  u64 sequential_us = 0;
+  u64 random_bytes = 0;
+  u64 random_us = 0;
+};
+
+static double ToMiBPerSecond(u64 bytes, u64 microseconds)
+{
+  return microseconds == 0 ? 0.0 : bytes / (1024.0 * 1024.0) * 1000000.0 / microseconds;
+}
+
+static bool RunBenchmark(DiscIO::BlobReader& blob, u64 sequential_size, u32 random_reads,
+                         BenchmarkResult* result)
+{
+  std::vector<u8> buffer(SEQUENTIAL_READ_SIZE);
+
+  const u64 data_size = std::min(blob.GetDataSize(), sequential_size);
+
+  u64 start = Common::Timer::NowUs();
+  for (u64 offset = 0; offset < data_size; offset += SEQUENTIAL_READ_SIZE)
+  {
+    const u64 size = std::min(SEQUENTIAL_READ_SIZE, data_size - offset);
+    if (!blob.Read(offset, size, buffer.data()))
+      return false;
+    result->sequential_bytes += size;
+  }
+  result->sequential_us = Common::Timer::NowUs() - start;
+
+  if (blob.GetDataSize() < RANDOM_READ_SIZE)
+    return true;
+
+  // Use the same seed for every run so that every access mode reads the same offsets
+  std::mt19937_64 rng(0);
+
+  start = Common::Timer::NowUs();
+  for (u32 i = 0; i < random_reads; ++i)
+  {
+    const u64 offset = rng() % (blob.GetDataSize() - RANDOM_READ_SIZE + 1);
+    if (!blob.Read(offset, RANDOM_READ_SIZE, buffer.data()))
+      return false;
+    result->random_bytes += RANDOM_READ_SIZE;
+  }
+  result->random_us = Common::Timer::NowUs() - start;
+
+  return true;
+}
+
+static void PrintResult(std::string_view name, const BenchmarkResult& result)
+{
+  fmt::println(std::cout, "{:<28} {:>10.1f} MiB/s {:>10.1f} MiB/s", name,
+               ToMiBPerSecond(result.sequential_bytes, result.sequential_us),
+               ToMiBPerSecond(result.random_bytes, result.random_us));
+}
+
+int BenchmarkCommand(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+
+  parser.usage("usage: benchmark [options]...");
+
+  parser.add_option("-u", "--user")
+      .type("string")
+      .action("store")
+      .help("User folder path, required for temporary processing files. "
+            "Will be automatically created if this option is not set.")
+      .set_default("");
+
+  parser.add_option("-i", "--input")
+      .type("string")
+      .action("store")
+      .help("Path to disc image FILE.")
+      .metavar("FILE");
+
+  parser.add_option("-s", "--size")
+      .type("int")
+      .action("store")
+      .help("Read at most this many MiB sequentially. Default is the whole image.")
+      .set_default(0);
+
+  parser.add_option("-n", "--random_reads")
+      .type("int")
+      .action("store")
+      .help("Number of random 32 KiB reads to make. Default is 16384.")
+      .set_default(16384);
+
+  const optparse::Values& options = parser.parse_args(args);
+
+  UICommon::SetUserDirectory(options["user"]);
+  UICommon::Init();
+
+  if (!options.is_set("input"))
+  {
+    fmt::println(std::cerr, "Error: No input set");
+    return EXIT_FAILURE;
+  }
+  const std::string& input_file_path = options["input"];
+
+  const int size_mib = static_cast<int>(options.get("size"));
+  const int random_reads = static_cast<int>(options.get("random_reads"));
+  if (size_mib < 0 || random_reads < 0)
+  {
+    fmt::println(std::cerr, "Error: --size and --random_reads must not be negative");
+    return EXIT_FAILURE;
+  }
+  const u64 sequential_size =
+      size_mib == 0 ? std::numeric_limits<u64>::max() : u64(size_mib) * 1024 * 1024;
+
+  std::unique_ptr<DiscIO::BlobReader> blob_reader = DiscIO::CreateBlobReader(input_file_path);
+  if (!blob_reader)
+  {
+    fmt::println(std::cerr, "Error: The input file could not be opened.");
+    return EXIT_FAILURE;
+  }
+
+  // Read everything once first so that all runs are measured with the same (warm) page cache.
+  // What's being compared is the overhead of each access method, not the speed of the storage.
+  BenchmarkResult warmup;
+  if (!RunBenchmark(*blob_reader, sequential_size, static_cast<u32>(random_reads), &warmup))
+  {
+    fmt::println(std::cerr, "Error: Reading the input file failed");
+    return EXIT_FAILURE;
+  }
+
+  fmt::println(std::cout, "{:<28} {:>16} {:>16}", "", "Sequential", "Random 32 KiB");
+
+  if (blob_reader->GetBlobType() != DiscIO::BlobType::PLAIN)
+  {
+    BenchmarkResult result;
+    if (!RunBenchmark(*blob_reader, sequential_size, static_cast<u32>(random_reads), &result))
+    {
+      fmt::println(std::cerr, "Error: Reading the input file failed");
+      return EXIT_FAILURE;
+    }
+    PrintResult(DiscIO::GetName(blob_reader->GetBlobType(), false), result);
+    return EXIT_SUCCESS;
+  }
+
+  constexpr std::array<std::pair<DiscIO::PlainFileAccess, std::string_view>, 3> ACCESS_MODES{{
+      {DiscIO::PlainFileAccess::Buffered, "Buffered (seek + read)"},
+      {DiscIO::PlainFileAccess::MemoryMapped, "Memory mapped"},
+      {DiscIO::PlainFileAccess::MemoryMappedSequential, "Memory mapped, sequential"},
+  }};
+
+  for (const auto& [access, name] : ACCESS_MODES)
+  {
+    const std::unique_ptr<DiscIO::PlainFileReader> reader =
+        DiscIO::PlainFileReader::Create(File::IOFile(input_file_path, "rb"), access);
+    if (!reader)
+    {
+      fmt::println(std::cerr, "Error: The input file could not be opened.");
+      return EXIT_FAILURE;
+    }
+
+    if (reader->GetAccess() != access)
+    {
+      fmt::println(std::cerr, "Warning: Memory mapping failed, skipping \"{}\"", name);
+      continue;
+    }
+
+    BenchmarkResult result;
+    if (!RunBenchmark(*reader, sequential_size, static_cast<u32>(random_reads), &result))
+    {
+      fmt::println(std::cerr, "Error: Reading the input file failed");
+      return EXIT_FAILURE;
+    }
+    PrintResult(name, result);
+  }
+
+  return EXIT_SUCCESS;
+}
+}  // namespace DolphinTool
@@ -0,0 +1,167 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/CacheBenchmarkCommand.h"
+
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <OptionParser.h>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/LinearDiskCache.h"
+#include "Common/Timer.h"
+
+namespace DolphinTool
+{
+// About the size of a shader UID.
+using BenchmarkKey = std::array<u8, 64>;
+using BenchmarkCache = Common::LinearDiskCache<BenchmarkKey, u8>;
+
+static BenchmarkKey MakeKey(u32 index)
+{
+  BenchmarkKey key{};
+  std::mt19937 rng(index);
+  for (u8& byte : key)
+    byte = static_cast<u8>(rng());
+  return key;
+}
+
+static void PrintTime(std::string_view name, u64 us)
+{
+  fmt::println(std::cout, "{:<32} {:>10.1f} ms", name, us / 1000.0);
+}
+
+int CacheBenchmarkCommand(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+
+  parser.usage(
+      "usage: cachebenchmark [options]...\n\n"
+      "Writes a shader cache sized cache file to a temporary folder, and compares how long "
+      "opening it takes when every entry is read and when it's opened indexed.");
+
+  parser.add_option("-n", "--entries")
+      .type("int")
+      .action("store")
+      .help("Number of entries in the cache. Default is 100000.")
+      .set_default(100000);
+
+  parser.add_option("-s", "--value_size")
+      .type("int")
+      .action("store")
+      .help("Average size of the values in bytes. Default is 2048.")
+      .set_default(2048);
+
+  parser.add_option("-l", "--lookups")
+      .type("int")
+      .action("store")
+      .help("Number of values to look up in the indexed cache. Default is 1000.")
+      .set_default(1000);
+
+  const optparse::Values& options = parser.parse_args(args);
+
+  const int entries = static_cast<int>(options.get("entries"));
+  const int value_size = static_cast<int>(options.get("value_size"));
+  const int lookups = static_cast<int>(options.get("lookups"));
+  if (entries <= 0 || value_size <= 0 || lookups < 0)
+  {
+    fmt::println(std::cerr, "Error: --entries and --value_size must be positive, and --lookups "
+                            "must not be negative");
+    return EXIT_FAILURE;
+  }
+
+  const std::string directory = File::CreateTempDir();
+  if (directory.empty())
+  {
+    fmt::println(std::cerr, "Error: Could not create a temporary folder");
+    return EXIT_FAILURE;
+  }
+  const std::string filename = directory + "/benchmark.cache";
+
+  {
+    class NullReader : public Common::LinearDiskCacheReader<BenchmarkKey, u8>
+    {
+    public:
+      void Read(const BenchmarkKey& key, const u8* value, u32 value_size) override {}
+    };
+
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<u32> size_distribution(1, static_cast<u32>(value_size) * 2);
+    std::vector<u8> value(static_cast<size_t>(value_size) * 2);
+    for (u8& byte : value)
+      byte = static_cast<u8>(rng());
+
+    BenchmarkCache cache;
+    NullReader reader;
+    cache.OpenAndRead(filename, reader);
+    for (int i = 0; i < entries; i++)
+      cache.Append(MakeKey(i), value.data(), size_distribution(rng));
+  }
+  fmt::println(std::cout, "{} entries, {} MiB (the file is in the OS cache for all runs)",
+               entries, File::GetSize(filename) / (1024 * 1024));
+
+  // Reading every entry is what opening a shader cache used to do.
+  {
+    class CopyReader : public Common::LinearDiskCacheReader<BenchmarkKey, u8>
+    {
+    public:
+      void Read(const BenchmarkKey& key, const u8* value, u32 value_size) override
+      {
+        values.emplace(key, std::vector<u8>(value, value + value_size));
+      }
+
+      std::map<BenchmarkKey, std::vector<u8>> values;
+    };
+
+    const u64 start = Common::Timer::NowUs();
+    BenchmarkCache cache;
+    CopyReader reader;
+    cache.OpenAndRead(filename, reader);
+    PrintTime("OpenAndRead", Common::Timer::NowUs() - start);
+  }
+
+  std::vector<BenchmarkKey> lookup_keys;
+  std::mt19937 rng(1);
+  for (int i = 0; i < lookups; i++)
+    lookup_keys.push_back(MakeKey(rng() % entries));
+
+  bool success = true;
+  for (const std::string_view name : {"OpenIndexed, no index", "OpenIndexed"})
+  {
+    u64 start = Common::Timer::NowUs();
+    BenchmarkCache cache;
+    cache.OpenIndexed(filename);
+    PrintTime(name, Common::Timer::NowUs() - start);
+
+    std::vector<u8> value;
+    start = Common::Timer::NowUs();
+    for (const BenchmarkKey& key : lookup_keys)
+      success &= cache.Find(key, &value);
+    PrintTime(fmt::format("  {} lookups", lookups), Common::Timer::NowUs() - start);
+
+    start = Common::Timer::NowUs();
+    cache.Close();
+    PrintTime("  Close", Common::Timer::NowUs() - start);
+  }
+
+  File::DeleteDirRecursively(directory);
+
+  if (!success)
+  {
+    fmt::println(std::cerr, "Error: Some values were not found");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+}  // namespace DolphinTool
@@ -0,0 +1,179 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/CompactCacheCommand.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <OptionParser.h>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileSearch.h"
+#include "Common/FileUtil.h"
+#include "Common/LinearDiskCache.h"
+#include "Common/StringUtil.h"
+#include "DolphinTool/PipelineUIDCache.h"
+#include "UICommon/UICommon.h"
+#include "VideoCommon/GXPipelineTypes.h"
+#include "VideoCommon/ShaderCache.h"
+
+namespace DolphinTool
+{
+struct CompactionTotals
+{
+  u32 compacted = 0;
+  u32 removed = 0;
+  u32 failed = 0;
+  u64 old_size = 0;
+  u64 new_size = 0;
+};
+
+static void RemoveStaleCache(const std::string& filename, bool remove_stale,
+                             CompactionTotals* totals)
+{
+  if (!remove_stale)
+  {
+    fmt::println(std::cout, "{}: not usable by this version of Dolphin, skipping", filename);
+    return;
+  }
+
+  const u64 size = File::GetSize(filename);
+  if (!File::Delete(filename))
+  {
+    fmt::println(std::cerr, "Error: Could not remove {}", filename);
+    totals->failed++;
+    return;
+  }
+
+  fmt::println(std::cout, "{}: not usable by this version of Dolphin, removed", filename);
+  totals->removed++;
+  totals->old_size += size;
+}
+
+static void CompactPipelineUIDCache(const std::string& filename, bool remove_stale,
+                                    CompactionTotals* totals)
+{
+  std::optional<std::vector<VideoCommon::SerializedGXPipelineUid>> uids =
+      ReadPipelineUIDCache(filename);
+  if (!uids)
+  {
+    RemoveStaleCache(filename, remove_stale, totals);
+    return;
+  }
+
+  const auto less = [](const auto& a, const auto& b) {
+    return std::memcmp(&a, &b, sizeof(a)) < 0;
+  };
+  const auto equal = [](const auto& a, const auto& b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+  };
+  const size_t old_count = uids->size();
+  std::sort(uids->begin(), uids->end(), less);
+  uids->erase(std::unique(uids->begin(), uids->end(), equal), uids->end());
+
+  const u64 old_size = File::GetSize(filename);
+  if (!WritePipelineUIDCache(filename, *uids))
+  {
+    fmt::println(std::cerr, "Error: Could not write {}", filename);
+    totals->failed++;
+    return;
+  }
+
+  const u64 new_size = File::GetSize(filename);
+  fmt::println(std::cout, "{}: {} pipelines, {} duplicates removed", filename, uids->size(),
+               old_count - uids->size());
+  totals->compacted++;
+  totals->old_size += old_size;
+  totals->new_size += new_size;
+}
+
+static void CompactShaderCache(const std::string& filename, bool remove_stale,
+                               CompactionTotals* totals)
+{
+  if (!Common::IsCurrentLinearDiskCache(filename))
+  {
+    RemoveStaleCache(filename, remove_stale, totals);
+    return;
+  }
+
+  const std::optional<Common::LinearDiskCacheCompactionResult> result =
+      Common::CompactLinearDiskCache(filename);
+  if (!result)
+  {
+    fmt::println(std::cerr, "Error: Could not compact {}", filename);
+    totals->failed++;
+    return;
+  }
+
+  fmt::println(std::cout, "{}: {} entries, {} duplicates removed, {} KiB -> {} KiB", filename,
+               result->entries, result->removed_entries, result->old_size / 1024,
+               result->new_size / 1024);
+  totals->compacted++;
+  totals->old_size += result->old_size;
+  totals->new_size += result->new_size;
+}
+
+int CompactCacheCommand(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+
+  parser.usage(
+      "usage: compactcache [options]...\n\n"
+      "Compacts the pipeline UID caches (Cache/<game ID>.uidcache) and the shader caches "
+      "(Cache/Shaders) in the user folder. Duplicate entries and incomplete entries left "
+      "behind by crashes are removed, and the remaining entries are sorted.");
+
+  parser.add_option("-u", "--user")
+      .type("string")
+      .action("store")
+      .help("User folder path, which holds the caches. "
+            "Will be automatically created if this option is not set.")
+      .set_default("");
+
+  parser.add_option("-r", "--remove_stale")
+      .action("store_true")
+      .help("Remove caches written by other versions of Dolphin, which would be discarded "
+            "the next time they are used. Shaders in them are compiled again from the "
+            "pipeline UID caches.");
+
+  const optparse::Values& options = parser.parse_args(args);
+
+  UICommon::SetUserDirectory(options["user"]);
+  UICommon::Init();
+
+  const bool remove_stale = options.is_set("remove_stale");
+
+  CompactionTotals totals;
+  for (const std::string& filename :
+       Common::DoFileSearch({File::GetUserPath(D_CACHE_IDX)}, {".uidcache"}, false))
+  {
+    CompactPipelineUIDCache(filename, remove_stale, &totals);
+  }
+
+  for (const std::string& filename :
+       Common::DoFileSearch({File::GetUserPath(D_SHADERCACHE_IDX)}, {".cache"}, false))
+  {
+    // The shared SPIR-V cache is stored in least recently used order, and compacts itself.
+    std::string name;
+    SplitPath(filename, nullptr, &name, nullptr);
+    if (name == "spirv-shared")
+      continue;
+
+    CompactShaderCache(filename, remove_stale, &totals);
+  }
+
+  fmt::println(std::cout, "Compacted {} caches, removed {}: {} KiB -> {} KiB", totals.compacted,
+               totals.removed, totals.old_size / 1024, totals.new_size / 1024);
+
+  return totals.failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+}  // namespace DolphinTool
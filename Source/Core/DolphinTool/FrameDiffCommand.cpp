@@ -0,0 +1,218 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/FrameDiffCommand.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <OptionParser.h>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Image.h"
+#include "VideoCommon/FrameCapture.h"
+
+namespace DolphinTool
+{
+// Differing captures and errors get separate exit codes, so that scripts can tell them apart.
+constexpr int EXIT_DIFFERENT = 1;
+constexpr int EXIT_ERROR = 2;
+
+struct FrameDifference
+{
+  u64 differing_pixels = 0;
+  int max_difference = 0;
+};
+
+static FrameDifference CompareFrames(const std::vector<u8>& reference,
+                                     const std::vector<u8>& input, int tolerance,
+                                     std::vector<u8>* diff_image)
+{
+  FrameDifference result;
+  if (diff_image)
+    diff_image->resize(reference.size());
+
+  for (size_t i = 0; i < reference.size(); i += 4)
+  {
+    int difference = 0;
+    for (size_t channel = 0; channel < 4; ++channel)
+      difference = std::max(difference, std::abs(reference[i + channel] - input[i + channel]));
+
+    const bool differs = difference > tolerance;
+    if (differs)
+      ++result.differing_pixels;
+    result.max_difference = std::max(result.max_difference, difference);
+
+    if (diff_image)
+    {
+      // Differing pixels in red on top of a darkened copy of the reference frame.
+      u8* out = &(*diff_image)[i];
+      out[0] = differs ? 0xFF : reference[i] / 4;
+      out[1] = differs ? 0x00 : reference[i + 1] / 4;
+      out[2] = differs ? 0x00 : reference[i + 2] / 4;
+      out[3] = 0xFF;
+    }
+  }
+
+  return result;
+}
+
+int FrameDiffCommand(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+
+  parser.usage("usage: framediff [options]...\n\n"
+               "Compares two frame captures (.dfc) frame by frame. Exits with 0 if they match, "
+               "1 if they differ and 2 on errors.");
+
+  parser.add_option("-r", "--reference")
+      .type("string")
+      .action("store")
+      .help("Path to the reference capture FILE.")
+      .metavar("FILE");
+
+  parser.add_option("-i", "--input")
+      .type("string")
+      .action("store")
+      .help("Path to the capture FILE to compare against the reference.")
+      .metavar("FILE");
+
+  parser.add_option("-t", "--tolerance")
+      .type("int")
+      .action("store")
+      .help("Ignore channel differences up to this value. Default is 0.")
+      .set_default(0);
+
+  parser.add_option("-o", "--output")
+      .type("string")
+      .action("store")
+      .help("Write an image highlighting the differences of every differing frame to FOLDER.")
+      .metavar("FOLDER");
+
+  parser.add_option("-q", "--quiet")
+      .action("store_true")
+      .help("Only print the summary, not every differing frame.");
+
+  const optparse::Values& options = parser.parse_args(args);
+
+  if (!options.is_set("reference") || !options.is_set("input"))
+  {
+    fmt::println(std::cerr, "Error: --reference and --input must be set");
+    return EXIT_ERROR;
+  }
+
+  const int tolerance = static_cast<int>(options.get("tolerance"));
+  if (tolerance < 0)
+  {
+    fmt::println(std::cerr, "Error: --tolerance must not be negative");
+    return EXIT_ERROR;
+  }
+
+  std::string output_folder;
+  if (options.is_set("output"))
+  {
+    output_folder = options["output"];
+    if (!output_folder.empty() && output_folder.back() != '/')
+      output_folder += '/';
+    if (!File::CreateFullPath(output_folder))
+    {
+      fmt::println(std::cerr, "Error: Could not create {}", output_folder);
+      return EXIT_ERROR;
+    }
+  }
+
+  const bool quiet = options.is_set("quiet");
+
+  FrameCapture::Reader reference;
+  if (!reference.Open(options["reference"]))
+  {
+    fmt::println(std::cerr, "Error: {} is not a valid frame capture", options["reference"]);
+    return EXIT_ERROR;
+  }
+  FrameCapture::Reader input;
+  if (!input.Open(options["input"]))
+  {
+    fmt::println(std::cerr, "Error: {} is not a valid frame capture", options["input"]);
+    return EXIT_ERROR;
+  }
+
+  const u32 frame_count = std::min(reference.GetFrameCount(), input.GetFrameCount());
+  if (reference.GetFrameCount() != input.GetFrameCount())
+  {
+    fmt::println(std::cout, "Frame counts differ: {} in the reference, {} in the input",
+                 reference.GetFrameCount(), input.GetFrameCount());
+  }
+
+  u32 differing_frames = 0;
+  std::vector<u8> reference_pixels;
+  std::vector<u8> input_pixels;
+  std::vector<u8> diff_image;
+  for (u32 i = 0; i < frame_count; ++i)
+  {
+    const FrameCapture::FrameCaptureIndexEntry& reference_frame = reference.GetFrame(i);
+    const FrameCapture::FrameCaptureIndexEntry& input_frame = input.GetFrame(i);
+
+    const bool same_size = reference_frame.width == input_frame.width &&
+                           reference_frame.height == input_frame.height;
+    // Identical frames don't have to be decompressed.
+    if (same_size && reference_frame.hash == input_frame.hash)
+      continue;
+
+    if (!same_size)
+    {
+      ++differing_frames;
+      if (!quiet)
+      {
+        fmt::println(std::cout, "Frame {}: {}x{} in the reference, {}x{} in the input", i,
+                     reference_frame.width, reference_frame.height, input_frame.width,
+                     input_frame.height);
+      }
+      continue;
+    }
+
+    if (!reference.ReadFrame(i, &reference_pixels) || !input.ReadFrame(i, &input_pixels))
+    {
+      fmt::println(std::cerr, "Error: Frame {} could not be read", i);
+      return EXIT_ERROR;
+    }
+
+    const bool write_image = !output_folder.empty();
+    const FrameDifference difference = CompareFrames(reference_pixels, input_pixels, tolerance,
+                                                     write_image ? &diff_image : nullptr);
+    if (difference.differing_pixels == 0)
+      continue;
+
+    ++differing_frames;
+    if (!quiet)
+    {
+      fmt::println(std::cout, "Frame {} (emulated frame {}): {} pixels differ, by up to {}", i,
+                   input_frame.frame_number, difference.differing_pixels,
+                   difference.max_difference);
+    }
+
+    if (write_image)
+    {
+      const std::string path = fmt::format("{}frame_{}.png", output_folder, i);
+      if (!Common::SavePNG(path, diff_image.data(), Common::ImageByteFormat::RGBA,
+                           reference_frame.width, reference_frame.height,
+                           reference_frame.width * 4))
+      {
+        fmt::println(std::cerr, "Error: Could not write {}", path);
+        return EXIT_ERROR;
+      }
+    }
+  }
+
+  fmt::println(std::cout, "{} of {} frames differ", differing_frames, frame_count);
+
+  const bool identical =
+      differing_frames == 0 && reference.GetFrameCount() == input.GetFrameCount();
+  return identical ? EXIT_SUCCESS : EXIT_DIFFERENT;
+}
+}  // namespace DolphinTool
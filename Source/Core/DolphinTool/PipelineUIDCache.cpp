@@ -0,0 +1,149 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/PipelineUIDCache.h"
+
+#include <memory>
+#include <unordered_map>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "VideoCommon/NativeVertexFormat.h"
+#include "VideoCommon/ShaderCache.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace DolphinTool
+{
+// Shader generation only needs the vertex declaration of a pipeline's vertex format.
+class DeclarationOnlyVertexFormat final : public NativeVertexFormat
+{
+public:
+  explicit DeclarationOnlyVertexFormat(const PortableVertexDeclaration& decl)
+      : NativeVertexFormat(decl)
+  {
+  }
+};
+
+void ApplyVulkanHostConfig(const ShaderHostConfig& host_config)
+{
+  VideoConfig& config = g_Config;
+
+  // Assumed to be supported by VulkanContext::PopulateBackendInfo.
+  config.backend_info.api_type = APIType::Vulkan;
+  config.backend_info.bSupportsPrimitiveRestart = true;
+  config.backend_info.bSupportsShaderBinaries = true;
+  config.backend_info.bSupportsCoarseDerivatives = true;
+  config.backend_info.bSupportsTextureQueryLevels = true;
+
+  config.backend_info.bSupportsDualSourceBlend = host_config.backend_dual_source_blend;
+  config.backend_info.bSupportsGeometryShaders = host_config.backend_geometry_shaders;
+  config.backend_info.bSupportsEarlyZ = host_config.backend_early_z;
+  config.backend_info.bSupportsBBox = host_config.backend_bbox;
+  config.backend_info.bSupportsGSInstancing = host_config.backend_gs_instancing;
+  config.backend_info.bSupportsClipControl = host_config.backend_clip_control;
+  config.backend_info.bSupportsSSAA = host_config.backend_ssaa;
+  config.backend_info.bSupportsFragmentStoresAndAtomics = host_config.backend_atomics;
+  config.backend_info.bSupportsDepthClamp = host_config.backend_depth_clamp;
+  config.backend_info.bSupportsReversedDepthRange = host_config.backend_reversed_depth_range;
+  config.backend_info.bSupportsBitfield = host_config.backend_bitfield;
+  config.backend_info.bSupportsDynamicSamplerIndexing =
+      host_config.backend_dynamic_sampler_indexing;
+  config.backend_info.bSupportsFramebufferFetch = host_config.backend_shader_framebuffer_fetch;
+  config.backend_info.bSupportsLogicOp = host_config.backend_logic_op;
+  config.backend_info.bSupportsPaletteConversion = host_config.backend_palette_conversion;
+  config.backend_info.bSupportsLodBiasInSampler = host_config.backend_sampler_lod_bias;
+  config.backend_info.bSupportsDynamicVertexLoader = host_config.backend_dynamic_vertex_loader;
+  config.backend_info.bSupportsVSLinePointExpand = host_config.backend_vs_point_line_expand;
+  config.backend_info.bSupportsGLLayerInFS = host_config.backend_gl_layer_in_fs;
+  config.bPreferVSForLinePointExpansion = host_config.backend_vs_point_line_expand;
+
+  config.iMultisamples = host_config.msaa ? 4 : 1;
+  config.bSSAA = host_config.ssaa;
+  config.stereo_mode = host_config.stereo ? StereoMode::SBS : StereoMode::Off;
+  config.bWireFrame = host_config.wireframe;
+  config.bEnablePixelLighting = host_config.per_pixel_lighting;
+  config.bFastDepthCalc = host_config.fast_depth_calc;
+  config.bBBoxEnable = host_config.bounding_box;
+
+  g_ActiveConfig = g_Config;
+}
+
+std::optional<std::vector<VideoCommon::SerializedGXPipelineUid>>
+ReadPipelineUIDCache(const std::string& filename)
+{
+  File::IOFile file(filename, "rb");
+  u32 magic;
+  u32 version;
+  if (!file.ReadArray(&magic, 1) || !file.ReadArray(&version, 1) ||
+      magic != VideoCommon::PIPELINE_UID_CACHE_MAGIC ||
+      version != VideoCommon::GX_PIPELINE_UID_VERSION)
+  {
+    return std::nullopt;
+  }
+
+  // An incomplete UID at the end is left over from a crash, and can be ignored.
+  const u64 uid_count =
+      (file.GetSize() - file.Tell()) / sizeof(VideoCommon::SerializedGXPipelineUid);
+  std::vector<VideoCommon::SerializedGXPipelineUid> uids(uid_count);
+  if (!file.ReadArray(uids.data(), uids.size()))
+    return std::nullopt;
+
+  return uids;
+}
+
+bool WritePipelineUIDCache(const std::string& filename,
+                           const std::vector<VideoCommon::SerializedGXPipelineUid>& uids)
+{
+  const std::string temp_filename = filename + ".tmp";
+  {
+    File::IOFile file(temp_filename, "wb");
+    if (!file.WriteArray(&VideoCommon::PIPELINE_UID_CACHE_MAGIC, 1) ||
+        !file.WriteArray(&VideoCommon::GX_PIPELINE_UID_VERSION, 1) ||
+        !file.WriteArray(uids.data(), uids.size()))
+    {
+      file.Close();
+      File::Delete(temp_filename);
+      return false;
+    }
+  }
+
+  return File::Rename(temp_filename, filename);
+}
+
+PipelineShaderUids
+GetPipelineShaderUids(const std::vector<VideoCommon::SerializedGXPipelineUid>& pipeline_uids,
+                      const ShaderHostConfig& host_config)
+{
+  PipelineShaderUids shader_uids;
+
+  std::unordered_map<PortableVertexDeclaration, std::unique_ptr<NativeVertexFormat>> formats;
+  for (const VideoCommon::SerializedGXPipelineUid& serialized_uid : pipeline_uids)
+  {
+    std::unique_ptr<NativeVertexFormat>& format = formats[serialized_uid.vertex_decl];
+    if (!format)
+      format = std::make_unique<DeclarationOnlyVertexFormat>(serialized_uid.vertex_decl);
+
+    VideoCommon::GXPipelineUid uid;
+    uid.vertex_format = format.get();
+    uid.vs_uid = serialized_uid.vs_uid;
+    uid.gs_uid = serialized_uid.gs_uid;
+    uid.ps_uid = serialized_uid.ps_uid;
+    uid.rasterization_state.hex = serialized_uid.rasterization_state_bits;
+    uid.depth_state.hex = serialized_uid.depth_state_bits;
+    uid.blending_state.hex = serialized_uid.blending_state_bits;
+    uid = VideoCommon::ApplyDriverBugs(uid);
+
+    shader_uids.vs.insert(uid.vs_uid);
+
+    PixelShaderUid ps_uid = uid.ps_uid;
+    ClearUnusedPixelShaderUidBits(APIType::Vulkan, host_config, &ps_uid);
+    shader_uids.ps.insert(ps_uid);
+
+    if (host_config.backend_geometry_shaders && !uid.gs_uid.GetUidData()->IsPassthrough())
+      shader_uids.gs.insert(uid.gs_uid);
+  }
+
+  return shader_uids;
+}
+}  // namespace DolphinTool
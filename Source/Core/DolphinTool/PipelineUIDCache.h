@@ -0,0 +1,43 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "VideoCommon/GXPipelineTypes.h"
+#include "VideoCommon/GeometryShaderGen.h"
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/ShaderGenCommon.h"
+#include "VideoCommon/VertexShaderGen.h"
+
+namespace DolphinTool
+{
+// The specialized shaders the pipelines of a game's pipeline UID cache are made of.
+struct PipelineShaderUids
+{
+  std::set<VertexShaderUid> vs;
+  std::set<PixelShaderUid> ps;
+  std::set<GeometryShaderUid> gs;
+};
+
+// Sets up the parts of the config that shader generation reads directly rather than through the
+// host config, so that they agree with the host config of the target Vulkan device.
+void ApplyVulkanHostConfig(const ShaderHostConfig& host_config);
+
+std::optional<std::vector<VideoCommon::SerializedGXPipelineUid>>
+ReadPipelineUIDCache(const std::string& filename);
+
+// Replaces the file with a pipeline UID cache holding the given UIDs.
+bool WritePipelineUIDCache(const std::string& filename,
+                           const std::vector<VideoCommon::SerializedGXPipelineUid>& uids);
+
+// Works out the shaders each pipeline needs the same way the shader cache does, after
+// ApplyVulkanHostConfig.
+PipelineShaderUids
+GetPipelineShaderUids(const std::vector<VideoCommon::SerializedGXPipelineUid>& pipeline_uids,
+                      const ShaderHostConfig& host_config);
+}  // namespace DolphinTool
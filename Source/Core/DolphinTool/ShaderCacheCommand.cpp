@@ -0,0 +1,284 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/ShaderCacheCommand.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <OptionParser.h>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/LinearDiskCache.h"
+#include "Common/StringUtil.h"
+#include "Common/Timer.h"
+#include "DolphinTool/PipelineUIDCache.h"
+#include "UICommon/UICommon.h"
+#include "VideoBackends/Vulkan/ShaderCompiler.h"
+#include "VideoBackends/Vulkan/VideoBackend.h"
+#include "VideoCommon/GeometryShaderGen.h"
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/ShaderCache.h"
+#include "VideoCommon/ShaderGenCommon.h"
+#include "VideoCommon/VertexShaderGen.h"
+#include "VideoCommon/VideoBackendBase.h"
+
+namespace DolphinTool
+{
+template <typename UidType>
+struct ShaderCacheFile
+{
+  const char* type;
+  bool include_gameid;
+  // Shaders that are already in the cache file
+  std::set<UidType> existing;
+  // Shaders to compile, and their SPIR-V once compiled (empty on failure)
+  std::map<UidType, std::vector<u8>> compiled;
+  Common::LinearDiskCache<UidType, u8> disk_cache;
+};
+
+template <typename UidType>
+static void OpenShaderCacheFile(const std::string& filename, ShaderCacheFile<UidType>* cache)
+{
+  class CacheReader : public Common::LinearDiskCacheReader<UidType, u8>
+  {
+  public:
+    explicit CacheReader(std::set<UidType>& existing_) : existing(existing_) {}
+    void Read(const UidType& key, const u8* value, u32 value_size) override
+    {
+      existing.insert(key);
+    }
+
+  private:
+    std::set<UidType>& existing;
+  };
+
+  CacheReader reader(cache->existing);
+  cache->disk_cache.OpenAndRead(filename, reader);
+}
+
+template <typename UidType>
+static void AddShader(const UidType& uid, ShaderCacheFile<UidType>* cache)
+{
+  if (!cache->existing.contains(uid))
+    cache->compiled.try_emplace(uid);
+}
+
+// Returns the number of shaders that were added.
+template <typename UidType>
+static u32 WriteShaderCacheFile(ShaderCacheFile<UidType>* cache)
+{
+  u32 written = 0;
+  for (const auto& [uid, binary] : cache->compiled)
+  {
+    if (binary.empty())
+      continue;
+    cache->disk_cache.Append(uid, binary.data(), static_cast<u32>(binary.size()));
+    ++written;
+  }
+  cache->disk_cache.Close();
+  return written;
+}
+
+// Shader caches store the same bytes as VKShader::GetBinary.
+static std::vector<u8> ToBinary(const std::optional<Vulkan::ShaderCompiler::SPIRVCodeVector>& spv)
+{
+  if (!spv)
+    return {};
+
+  const u8* begin = reinterpret_cast<const u8*>(spv->data());
+  const size_t size = spv->size() * sizeof(Vulkan::ShaderCompiler::SPIRVCodeType);
+  return std::vector<u8>(begin, begin + size);
+}
+
+int ShaderCacheCommand(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+
+  parser.usage(
+      "usage: shadercache [options]...\n\n"
+      "Compiles the shaders for all pipelines a game has recorded in its pipeline UID cache "
+      "(Cache/<game ID>.uidcache) to SPIR-V, and adds them to the Vulkan shader caches in the "
+      "user folder.");
+
+  parser.add_option("-u", "--user")
+      .type("string")
+      .action("store")
+      .help("User folder path, which holds the pipeline UID cache and receives the shader caches. "
+            "Will be automatically created if this option is not set.")
+      .set_default("");
+
+  parser.add_option("-g", "--game_id")
+      .type("string")
+      .action("store")
+      .help("ID of the game to compile shaders for.")
+      .metavar("ID");
+
+  parser.add_option("-c", "--host_config")
+      .type("string")
+      .action("store")
+      .help("Shader host config of the target device, in hex. It's the last part of the name "
+            "of the shader caches the device writes, e.g. Vulkan-specialized-ps-<game ID>-<host "
+            "config>.cache.")
+      .metavar("HEX");
+
+  parser.add_option("-s", "--subgroup_operations")
+      .action("store_true")
+      .help("Target a device with Vulkan 1.1 subgroup operations.");
+
+  parser.add_option("-j", "--jobs")
+      .type("int")
+      .action("store")
+      .help("Number of compiler threads. Default is the number of CPU cores.")
+      .set_default(0);
+
+  const optparse::Values& options = parser.parse_args(args);
+
+  UICommon::SetUserDirectory(options["user"]);
+  UICommon::Init();
+
+  if (!options.is_set("game_id"))
+  {
+    fmt::println(std::cerr, "Error: No game ID set");
+    return EXIT_FAILURE;
+  }
+  const std::string& game_id = options["game_id"];
+
+  ShaderHostConfig host_config{};
+  if (!options.is_set("host_config") ||
+      !TryParse(options["host_config"], &host_config.bits, 16))
+  {
+    fmt::println(std::cerr, "Error: No valid host config set");
+    return EXIT_FAILURE;
+  }
+
+  const bool supports_subgroup_operations = options.is_set("subgroup_operations");
+
+  const int jobs = static_cast<int>(options.get("jobs"));
+  if (jobs < 0)
+  {
+    fmt::println(std::cerr, "Error: --jobs must not be negative");
+    return EXIT_FAILURE;
+  }
+  const u32 thread_count =
+      jobs != 0 ? static_cast<u32>(jobs) : std::max(std::thread::hardware_concurrency(), 1u);
+
+  const std::string uid_cache_filename = VideoCommon::GetPipelineUIDCacheFileName(game_id);
+  const std::optional<std::vector<VideoCommon::SerializedGXPipelineUid>> pipeline_uids =
+      ReadPipelineUIDCache(uid_cache_filename);
+  if (!pipeline_uids)
+  {
+    fmt::println(std::cerr, "Error: {} is missing or not a valid pipeline UID cache",
+                 uid_cache_filename);
+    return EXIT_FAILURE;
+  }
+
+  // Compiling shaders reports errors through the active backend.
+  VideoBackendBase::ActivateBackend(Vulkan::VideoBackend::NAME);
+  ApplyVulkanHostConfig(host_config);
+
+  ShaderCacheFile<VertexShaderUid> vs_cache{"specialized-vs", true};
+  ShaderCacheFile<PixelShaderUid> ps_cache{"specialized-ps", true};
+  ShaderCacheFile<GeometryShaderUid> gs_cache{"gs", false};
+  const auto get_filename = [&](const char* type, bool include_gameid) {
+    return GetDiskShaderCacheFileName(APIType::Vulkan, type, include_gameid ? game_id : "",
+                                      host_config);
+  };
+  OpenShaderCacheFile(get_filename(vs_cache.type, vs_cache.include_gameid), &vs_cache);
+  OpenShaderCacheFile(get_filename(ps_cache.type, ps_cache.include_gameid), &ps_cache);
+  if (host_config.backend_geometry_shaders)
+    OpenShaderCacheFile(get_filename(gs_cache.type, gs_cache.include_gameid), &gs_cache);
+
+  const PipelineShaderUids shader_uids = GetPipelineShaderUids(*pipeline_uids, host_config);
+  for (const VertexShaderUid& uid : shader_uids.vs)
+    AddShader(uid, &vs_cache);
+  for (const PixelShaderUid& uid : shader_uids.ps)
+    AddShader(uid, &ps_cache);
+  for (const GeometryShaderUid& uid : shader_uids.gs)
+    AddShader(uid, &gs_cache);
+
+  std::vector<std::function<void()>> work;
+  for (auto& [uid, binary] : vs_cache.compiled)
+  {
+    work.emplace_back([&, &uid = uid, &binary = binary] {
+      const ShaderCode code =
+          GenerateVertexShaderCode(APIType::Vulkan, host_config, uid.GetUidData());
+      binary = ToBinary(Vulkan::ShaderCompiler::CompileVertexShader(
+          code.GetBuffer(), supports_subgroup_operations));
+    });
+  }
+  for (auto& [uid, binary] : ps_cache.compiled)
+  {
+    work.emplace_back([&, &uid = uid, &binary = binary] {
+      const ShaderCode code =
+          GeneratePixelShaderCode(APIType::Vulkan, host_config, uid.GetUidData(), {});
+      binary = ToBinary(Vulkan::ShaderCompiler::CompileFragmentShader(
+          code.GetBuffer(), supports_subgroup_operations));
+    });
+  }
+  for (auto& [uid, binary] : gs_cache.compiled)
+  {
+    work.emplace_back([&, &uid = uid, &binary = binary] {
+      const ShaderCode code =
+          GenerateGeometryShaderCode(APIType::Vulkan, host_config, uid.GetUidData());
+      binary = ToBinary(Vulkan::ShaderCompiler::CompileGeometryShader(
+          code.GetBuffer(), supports_subgroup_operations));
+    });
+  }
+
+  fmt::println(std::cout, "{} pipelines, {} shaders to compile on {} threads",
+               pipeline_uids->size(), work.size(), thread_count);
+
+  const u64 start = Common::Timer::NowUs();
+  std::atomic<size_t> next_work{0};
+  std::vector<std::thread> threads;
+  for (u32 i = 0; i < std::min<size_t>(thread_count, work.size()); ++i)
+  {
+    threads.emplace_back([&] {
+      for (size_t j = next_work++; j < work.size(); j = next_work++)
+        work[j]();
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+  const u64 elapsed_us = Common::Timer::NowUs() - start;
+
+  u32 compiled = 0;
+  const auto write_cache = [&](auto& cache) {
+    if (cache.existing.empty() && cache.compiled.empty())
+      return;
+    const u32 written = WriteShaderCacheFile(&cache);
+    compiled += written;
+    const std::string filename = get_filename(cache.type, cache.include_gameid);
+    fmt::println(std::cout, "{}: {} shaders, {} KiB", filename, cache.existing.size() + written,
+                 File::GetSize(filename) / 1024);
+  };
+  write_cache(vs_cache);
+  write_cache(ps_cache);
+  write_cache(gs_cache);
+
+  const double seconds = elapsed_us / 1000000.0;
+  fmt::println(std::cout, "Compiled {} shaders in {:.2f} s ({:.1f} shaders/s)", compiled, seconds,
+               seconds == 0.0 ? 0.0 : compiled / seconds);
+
+  if (compiled != work.size())
+  {
+    fmt::println(std::cerr, "Error: {} shaders failed to compile", work.size() - compiled);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+}  // namespace DolphinTool
@@ -0,0 +1,215 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/ShaderGenCommand.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <OptionParser.h>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileSearch.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/Timer.h"
+#include "DolphinTool/PipelineUIDCache.h"
+#include "UICommon/UICommon.h"
+#include "VideoCommon/GeometryShaderGen.h"
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/ShaderCache.h"
+#include "VideoCommon/ShaderGenCommon.h"
+#include "VideoCommon/UberShaderPixel.h"
+#include "VideoCommon/UberShaderVertex.h"
+#include "VideoCommon/VertexShaderGen.h"
+
+namespace DolphinTool
+{
+struct GenerationResult
+{
+  u64 shaders = 0;
+  u64 bytes = 0;
+  u64 us = 0;
+};
+
+template <typename UidType, typename GenerateFunction>
+static GenerationResult RunBenchmark(const std::set<UidType>& uids, u32 iterations,
+                                     GenerateFunction generate)
+{
+  GenerationResult result;
+  const u64 start = Common::Timer::NowUs();
+  for (u32 i = 0; i < iterations; ++i)
+  {
+    for (const UidType& uid : uids)
+    {
+      const ShaderCode code = generate(uid);
+      result.bytes += code.GetBuffer().size();
+    }
+  }
+  result.us = Common::Timer::NowUs() - start;
+  result.shaders = uids.size() * iterations;
+  return result;
+}
+
+static void PrintResult(std::string_view name, size_t uid_count, const GenerationResult& result)
+{
+  if (uid_count == 0)
+    return;
+
+  fmt::println(std::cout, "{:<18} {:>8} {:>12.1f} {:>12.2f} {:>12.1f}", name, uid_count,
+               result.shaders == 0 ? 0.0 : result.bytes / 1024.0 / result.shaders,
+               result.shaders == 0 ? 0.0 : double(result.us) / result.shaders,
+               result.us == 0 ? 0.0 : result.bytes / (1024.0 * 1024.0) * 1000000.0 / result.us);
+}
+
+int ShaderGenCommand(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+
+  parser.usage(
+      "usage: shadergen [options]...\n\n"
+      "Generates the Vulkan shader source of all shaders recorded in pipeline UID caches "
+      "(Cache/<game ID>.uidcache) and reports how long generating them takes.");
+
+  parser.add_option("-u", "--user")
+      .type("string")
+      .action("store")
+      .help("User folder path, which holds the pipeline UID caches. "
+            "Will be automatically created if this option is not set.")
+      .set_default("");
+
+  parser.add_option("-g", "--game_id")
+      .type("string")
+      .action("store")
+      .help("Only use the pipeline UID cache of this game. Default is all of them.")
+      .metavar("ID");
+
+  parser.add_option("-c", "--host_config")
+      .type("string")
+      .action("store")
+      .help("Shader host config to generate shaders for, in hex. Default is 0.")
+      .metavar("HEX");
+
+  parser.add_option("-n", "--iterations")
+      .type("int")
+      .action("store")
+      .help("Number of times to generate every shader. Default is 5.")
+      .set_default(5);
+
+  parser.add_option("-b", "--ubershaders")
+      .action("store_true")
+      .help("Also generate all ubershaders.");
+
+  const optparse::Values& options = parser.parse_args(args);
+
+  UICommon::SetUserDirectory(options["user"]);
+  UICommon::Init();
+
+  ShaderHostConfig host_config{};
+  if (options.is_set("host_config") && !TryParse(options["host_config"], &host_config.bits, 16))
+  {
+    fmt::println(std::cerr, "Error: Invalid host config");
+    return EXIT_FAILURE;
+  }
+
+  const int iterations = static_cast<int>(options.get("iterations"));
+  if (iterations <= 0)
+  {
+    fmt::println(std::cerr, "Error: --iterations must be positive");
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::string> uid_cache_filenames;
+  if (options.is_set("game_id"))
+  {
+    uid_cache_filenames.push_back(VideoCommon::GetPipelineUIDCacheFileName(options["game_id"]));
+  }
+  else
+  {
+    uid_cache_filenames =
+        Common::DoFileSearch({File::GetUserPath(D_CACHE_IDX)}, {".uidcache"}, false);
+  }
+
+  ApplyVulkanHostConfig(host_config);
+
+  size_t pipeline_count = 0;
+  PipelineShaderUids shader_uids;
+  for (const std::string& filename : uid_cache_filenames)
+  {
+    const std::optional<std::vector<VideoCommon::SerializedGXPipelineUid>> pipeline_uids =
+        ReadPipelineUIDCache(filename);
+    if (!pipeline_uids)
+    {
+      fmt::println(std::cerr, "Warning: {} is not a valid pipeline UID cache, skipping",
+                   filename);
+      continue;
+    }
+
+    pipeline_count += pipeline_uids->size();
+    PipelineShaderUids game_shader_uids = GetPipelineShaderUids(*pipeline_uids, host_config);
+    shader_uids.vs.merge(game_shader_uids.vs);
+    shader_uids.ps.merge(game_shader_uids.ps);
+    shader_uids.gs.merge(game_shader_uids.gs);
+  }
+
+  std::set<UberShader::VertexShaderUid> uber_vs_uids;
+  std::set<UberShader::PixelShaderUid> uber_ps_uids;
+  if (options.is_set("ubershaders"))
+  {
+    UberShader::EnumerateVertexShaderUids(
+        [&](const UberShader::VertexShaderUid& uid) { uber_vs_uids.insert(uid); });
+    UberShader::EnumeratePixelShaderUids([&](const UberShader::PixelShaderUid& uid) {
+      UberShader::PixelShaderUid cleared_uid = uid;
+      UberShader::ClearUnusedPixelShaderUidBits(APIType::Vulkan, host_config, &cleared_uid);
+      uber_ps_uids.insert(cleared_uid);
+    });
+  }
+
+  if (shader_uids.vs.empty() && uber_vs_uids.empty())
+  {
+    fmt::println(std::cerr, "Error: No shaders to generate");
+    return EXIT_FAILURE;
+  }
+
+  fmt::println(std::cout, "{} pipelines from {} pipeline UID caches", pipeline_count,
+               uid_cache_filenames.size());
+  fmt::println(std::cout, "{:<18} {:>8} {:>12} {:>12} {:>12}", "", "Shaders", "KiB/shader",
+               "us/shader", "MiB/s");
+
+  const u32 count = static_cast<u32>(iterations);
+  PrintResult("Vertex", shader_uids.vs.size(),
+              RunBenchmark(shader_uids.vs, count, [&](const VertexShaderUid& uid) {
+                return GenerateVertexShaderCode(APIType::Vulkan, host_config, uid.GetUidData());
+              }));
+  PrintResult("Pixel", shader_uids.ps.size(),
+              RunBenchmark(shader_uids.ps, count, [&](const PixelShaderUid& uid) {
+                return GeneratePixelShaderCode(APIType::Vulkan, host_config, uid.GetUidData(),
+                                               {});
+              }));
+  PrintResult("Geometry", shader_uids.gs.size(),
+              RunBenchmark(shader_uids.gs, count, [&](const GeometryShaderUid& uid) {
+                return GenerateGeometryShaderCode(APIType::Vulkan, host_config,
+                                                  uid.GetUidData());
+              }));
+  PrintResult("Vertex ubershader", uber_vs_uids.size(),
+              RunBenchmark(uber_vs_uids, count, [&](const UberShader::VertexShaderUid& uid) {
+                return UberShader::GenVertexShader(APIType::Vulkan, host_config,
+                                                   uid.GetUidData());
+              }));
+  PrintResult("Pixel ubershader", uber_ps_uids.size(),
+              RunBenchmark(uber_ps_uids, count, [&](const UberShader::PixelShaderUid& uid) {
+                return UberShader::GenPixelShader(APIType::Vulkan, host_config, uid.GetUidData(),
+                                                  {});
+              }));
+
+  return EXIT_SUCCESS;
+}
+}  // namespace DolphinTool
@@ -0,0 +1,259 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "DolphinTool/SpirvBenchmarkCommand.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <OptionParser.h>
+#include <fmt/format.h>
+#include <fmt/ostream.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/Timer.h"
+#include "DolphinTool/PipelineUIDCache.h"
+#include "UICommon/UICommon.h"
+#include "VideoBackends/Vulkan/ShaderCompiler.h"
+#include "VideoBackends/Vulkan/VideoBackend.h"
+#include "VideoCommon/AbstractShader.h"
+#include "VideoCommon/GeometryShaderGen.h"
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/ShaderCache.h"
+#include "VideoCommon/ShaderGenCommon.h"
+#include "VideoCommon/SpirvCompilerPool.h"
+#include "VideoCommon/VertexShaderGen.h"
+#include "VideoCommon/VideoBackendBase.h"
+
+namespace DolphinTool
+{
+using SPIRVCodeVector = Vulkan::ShaderCompiler::SPIRVCodeVector;
+
+struct ShaderSource
+{
+  ShaderStage stage;
+  std::string code;
+};
+
+static std::optional<SPIRVCodeVector> CompileShader(const ShaderSource& shader,
+                                                    bool supports_subgroup_operations)
+{
+  switch (shader.stage)
+  {
+  case ShaderStage::Vertex:
+    return Vulkan::ShaderCompiler::CompileVertexShader(shader.code, supports_subgroup_operations);
+  case ShaderStage::Geometry:
+    return Vulkan::ShaderCompiler::CompileGeometryShader(shader.code,
+                                                         supports_subgroup_operations);
+  case ShaderStage::Pixel:
+    return Vulkan::ShaderCompiler::CompileFragmentShader(shader.code,
+                                                         supports_subgroup_operations);
+  default:
+    return std::nullopt;
+  }
+}
+
+// Returns the time it took in microseconds.
+static u64 CompileShaders(const std::vector<ShaderSource>& shaders, u32 thread_count,
+                          bool supports_subgroup_operations,
+                          std::vector<std::optional<SPIRVCodeVector>>* results)
+{
+  results->assign(shaders.size(), std::nullopt);
+
+  const u64 start = Common::Timer::NowUs();
+  std::atomic<size_t> next_shader{0};
+  std::vector<std::thread> threads;
+  for (u32 i = 0; i < std::min<size_t>(thread_count, shaders.size()); ++i)
+  {
+    threads.emplace_back([&] {
+      for (size_t j = next_shader++; j < shaders.size(); j = next_shader++)
+        (*results)[j] = CompileShader(shaders[j], supports_subgroup_operations);
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+  return Common::Timer::NowUs() - start;
+}
+
+static void PrintResult(std::string_view name, size_t shader_count, u64 elapsed_us)
+{
+  const double seconds = elapsed_us / 1000000.0;
+  fmt::println(std::cout, "{:<12} {:>8} {:>10.2f} {:>12.1f}", name, shader_count, seconds,
+               seconds == 0.0 ? 0.0 : shader_count / seconds);
+}
+
+int SpirvBenchmarkCommand(const std::vector<std::string>& args)
+{
+  optparse::OptionParser parser;
+
+  parser.usage(
+      "usage: spirvbenchmark [options]...\n\n"
+      "Compiles the shaders for all pipelines a game has recorded in its pipeline UID cache "
+      "(Cache/<game ID>.uidcache) to SPIR-V, first on compiler threads in this process and then "
+      "through a pool of compiler processes, and compares the time it takes. No shader caches "
+      "are written.");
+
+  parser.add_option("-u", "--user")
+      .type("string")
+      .action("store")
+      .help("User folder path, which holds the pipeline UID cache. "
+            "Will be automatically created if this option is not set.")
+      .set_default("");
+
+  parser.add_option("-g", "--game_id")
+      .type("string")
+      .action("store")
+      .help("ID of the game whose shaders to compile.")
+      .metavar("ID");
+
+  parser.add_option("-c", "--host_config")
+      .type("string")
+      .action("store")
+      .help("Shader host config to generate the shaders for, in hex. It's the last part of the "
+            "name of the shader caches a device writes.")
+      .metavar("HEX");
+
+  parser.add_option("-s", "--subgroup_operations")
+      .action("store_true")
+      .help("Target a device with Vulkan 1.1 subgroup operations.");
+
+  parser.add_option("-j", "--jobs")
+      .type("int")
+      .action("store")
+      .help("Number of compiler threads. Default is the number of CPU cores.")
+      .set_default(0);
+
+  parser.add_option("-p", "--processes")
+      .type("int")
+      .action("store")
+      .help("Number of compiler processes. Default is the number of compiler threads.")
+      .set_default(0);
+
+  const optparse::Values& options = parser.parse_args(args);
+
+  UICommon::SetUserDirectory(options["user"]);
+  UICommon::Init();
+
+  if (!options.is_set("game_id"))
+  {
+    fmt::println(std::cerr, "Error: No game ID set");
+    return EXIT_FAILURE;
+  }
+
+  ShaderHostConfig host_config{};
+  if (!options.is_set("host_config") ||
+      !TryParse(options["host_config"], &host_config.bits, 16))
+  {
+    fmt::println(std::cerr, "Error: No valid host config set");
+    return EXIT_FAILURE;
+  }
+
+  const bool supports_subgroup_operations = options.is_set("subgroup_operations");
+
+  const int jobs = static_cast<int>(options.get("jobs"));
+  const int processes = static_cast<int>(options.get("processes"));
+  if (jobs < 0 || processes < 0)
+  {
+    fmt::println(std::cerr, "Error: --jobs and --processes must not be negative");
+    return EXIT_FAILURE;
+  }
+  const u32 thread_count =
+      jobs != 0 ? static_cast<u32>(jobs) : std::max(std::thread::hardware_concurrency(), 1u);
+  const u32 process_count = processes != 0 ? static_cast<u32>(processes) : thread_count;
+
+  const std::string uid_cache_filename =
+      VideoCommon::GetPipelineUIDCacheFileName(options["game_id"]);
+  const std::optional<std::vector<VideoCommon::SerializedGXPipelineUid>> pipeline_uids =
+      ReadPipelineUIDCache(uid_cache_filename);
+  if (!pipeline_uids)
+  {
+    fmt::println(std::cerr, "Error: {} is missing or not a valid pipeline UID cache",
+                 uid_cache_filename);
+    return EXIT_FAILURE;
+  }
+
+  // Compiling shaders reports errors through the active backend.
+  VideoBackendBase::ActivateBackend(Vulkan::VideoBackend::NAME);
+  ApplyVulkanHostConfig(host_config);
+
+  const PipelineShaderUids shader_uids = GetPipelineShaderUids(*pipeline_uids, host_config);
+  std::vector<ShaderSource> shaders;
+  for (const VertexShaderUid& uid : shader_uids.vs)
+  {
+    shaders.push_back({ShaderStage::Vertex,
+                       GenerateVertexShaderCode(APIType::Vulkan, host_config, uid.GetUidData())
+                           .GetBuffer()});
+  }
+  for (const PixelShaderUid& uid : shader_uids.ps)
+  {
+    shaders.push_back({ShaderStage::Pixel,
+                       GeneratePixelShaderCode(APIType::Vulkan, host_config, uid.GetUidData(), {})
+                           .GetBuffer()});
+  }
+  for (const GeometryShaderUid& uid : shader_uids.gs)
+  {
+    shaders.push_back({ShaderStage::Geometry,
+                       GenerateGeometryShaderCode(APIType::Vulkan, host_config, uid.GetUidData())
+                           .GetBuffer()});
+  }
+
+  if (shaders.empty())
+  {
+    fmt::println(std::cerr, "Error: No shaders to compile");
+    return EXIT_FAILURE;
+  }
+
+  fmt::println(std::cout, "{} pipelines, {} shaders, {} compiler threads, {} compiler processes",
+               pipeline_uids->size(), shaders.size(), thread_count, process_count);
+  fmt::println(std::cout, "{:<12} {:>8} {:>10} {:>12}", "", "Shaders", "Seconds", "Shaders/s");
+
+  std::vector<std::optional<SPIRVCodeVector>> in_process_results;
+  const u64 in_process_us =
+      CompileShaders(shaders, thread_count, supports_subgroup_operations, &in_process_results);
+  PrintResult("In-process", shaders.size(), in_process_us);
+
+  // The workers are this same executable.
+  auto pool = std::make_shared<SPIRV::CompilerPool>();
+  if (!pool->Start(File::GetExePath(), process_count))
+  {
+    fmt::println(std::cerr, "Error: Failed to start compiler processes");
+    return EXIT_FAILURE;
+  }
+  SPIRV::SetCompilerPool(std::move(pool));
+  std::vector<std::optional<SPIRVCodeVector>> pooled_results;
+  const u64 pooled_us =
+      CompileShaders(shaders, thread_count, supports_subgroup_operations, &pooled_results);
+  SPIRV::SetCompilerPool(nullptr);
+  PrintResult("Pooled", shaders.size(), pooled_us);
+
+  if (pooled_us != 0)
+    fmt::println(std::cout, "Speedup: {:.2f}x", double(in_process_us) / pooled_us);
+
+  size_t failed = 0;
+  size_t mismatched = 0;
+  for (size_t i = 0; i < shaders.size(); ++i)
+  {
+    failed += !in_process_results[i];
+    mismatched += in_process_results[i] != pooled_results[i];
+  }
+  if (failed != 0)
+    fmt::println(std::cerr, "Error: {} shaders failed to compile", failed);
+  if (mismatched != 0)
+  {
+    fmt::println(std::cerr, "Error: {} shaders compiled differently in the compiler processes",
+                 mismatched);
+  }
+
+  return failed == 0 && mismatched == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+}  // namespace DolphinTool
@@ -11,19 +11,41 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 #include "Core/Core.h"
+#include "VideoCommon/SpirvCompilerPool.h"
 
+#include "DolphinTool/ArchiveCommand.h"
+#include "DolphinTool/BenchmarkCommand.h"
+#include "DolphinTool/CacheBenchmarkCommand.h"
+#include "DolphinTool/CompactCacheCommand.h"
 #include "DolphinTool/ConvertCommand.h"
 #include "DolphinTool/ExtractCommand.h"
+#include "DolphinTool/FrameDiffCommand.h"
 #include "DolphinTool/HeaderCommand.h"
+#include "DolphinTool/ShaderGenCommand.h"
 #include "DolphinTool/VerifyCommand.h"
 
+#ifdef HAS_VULKAN
+#include "DolphinTool/ShaderCacheCommand.h"
+#include "DolphinTool/SpirvBenchmarkCommand.h"
+#endif
+
 static void PrintUsage()
 {
   fmt::print(std::cerr, "usage: dolphin-tool COMMAND -h\n"
                         "\n"
-                        "commands supported: [convert, verify, header, extract]\n");
+                        "commands supported: [convert, verify, header, extract, archive, "
+                        "benchmark, framediff, shadergen, "
+#ifdef HAS_VULKAN
+                        "shadercache, "
+#endif
+                        "compactcache, cachebenchmark"
+#ifdef HAS_VULKAN
+                        ", spirvbenchmark"
+#endif
+                        "]\n");
 }
 
 #ifdef _WIN32
@@ -52,6 +74,30 @@ int main(int argc, char* argv[])
     return DolphinTool::HeaderCommand(args);
   else if (command_str == "extract")
     return DolphinTool::Extract(args);
+  else if (command_str == "archive")
+    return DolphinTool::ArchiveCommand(args);
+  else if (command_str == "benchmark")
+    return DolphinTool::BenchmarkCommand(args);
+  else if (command_str == "framediff")
+    return DolphinTool::FrameDiffCommand(args);
+  else if (command_str == "shadergen")
+    return DolphinTool::ShaderGenCommand(args);
+  else if (command_str == "compactcache")
+    return DolphinTool::CompactCacheCommand(args);
+  else if (command_str == "cachebenchmark")
+    return DolphinTool::CacheBenchmarkCommand(args);
+  else if (command_str == "spirvworker")
+  {
+    // Started by SPIRV::CompilerPool, which reports compile errors itself.
+    Common::SetEnableAlert(false);
+    return SPIRV::RunCompilerWorker();
+  }
+#ifdef HAS_VULKAN
+  else if (command_str == "shadercache")
+    return DolphinTool::ShaderCacheCommand(args);
+  else if (command_str == "spirvbenchmark")
+    return DolphinTool::SpirvBenchmarkCommand(args);
+#endif
   PrintUsage();
   return EXIT_FAILURE;
 }
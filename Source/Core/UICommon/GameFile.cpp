@@ -7,6 +7,7 @@
 #include <array>
 #include <cstdio>
 #include <cstring>
+#include <filesystem>
 #include <iterator>
 #include <map>
 #include <memory>
@@ -101,9 +102,17 @@ GameFile::LookupUsingConfigLanguage(const std::map<DiscIO::Language, std::string
 
 GameFile::GameFile() = default;
 
+static s64 GetFileModificationTime(const std::string& path)
+{
+  std::error_code error;
+  const auto time = std::filesystem::last_write_time(StringToPath(path), error);
+  return error ? 0 : static_cast<s64>(time.time_since_epoch().count());
+}
+
 GameFile::GameFile(std::string path) : m_file_path(std::move(path))
 {
   m_file_name = PathToFileName(m_file_path);
+  m_file_modification_time = GetFileModificationTime(m_file_path);
 
   {
     std::unique_ptr<DiscIO::Volume> volume(DiscIO::CreateVolume(m_file_path));
@@ -298,6 +307,7 @@ void GameFile::DoState(PointerWrap& p)
   p.Do(m_file_name);
 
   p.Do(m_file_size);
+  p.Do(m_file_modification_time);
   p.Do(m_volume_size);
   p.Do(m_volume_size_type);
   p.Do(m_is_datel_disc);
@@ -334,6 +344,11 @@ void GameFile::DoState(PointerWrap& p)
   m_custom_cover.DoState(p);
 }
 
+bool GameFile::FileChanged() const
+{
+  return GetFileModificationTime(m_file_path) != m_file_modification_time;
+}
+
 std::string GameFile::GetExtension() const
 {
   std::string extension;
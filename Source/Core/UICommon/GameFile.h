@@ -112,6 +112,8 @@ public:
   const GameBanner& GetBannerImage() const;
   const GameCover& GetCoverImage() const;
   void DoState(PointerWrap& p);
+  // Returns true if the file has been modified since this object was created from it
+  bool FileChanged() const;
   bool XMLMetadataChanged();
   void XMLMetadataCommit();
   bool WiiBannerChanged();
@@ -146,6 +148,7 @@ private:
   std::string m_file_name;
 
   u64 m_file_size{};
+  s64 m_file_modification_time{};
   u64 m_volume_size{};
   DiscIO::DataSizeType m_volume_size_type{};
   bool m_is_datel_disc{};
@@ -4,12 +4,14 @@
 #include "UICommon/GameFileCache.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstring>
 #include <functional>
-#include <list>
 #include <memory>
-#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -19,6 +21,7 @@
 #include "Common/FileSearch.h"
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
+#include "Common/MappedFile.h"
 
 #include "DiscIO/DirectoryBlob.h"
 
@@ -26,14 +29,41 @@
 
 namespace UICommon
 {
-static constexpr u32 CACHE_REVISION = 25;  // Last changed in PR 12702
+static constexpr u32 CACHE_REVISION = 26;  // Last changed when adding the file modification time
+
+static constexpr u32 CACHE_MAGIC = 0x43464744;  // "DGFC"
+
+// The cache file consists of a header, followed by a table with one entry for each cached game,
+// followed by the serialized games. Since every game is stored separately, they can be
+// deserialized in parallel straight from a memory mapping of the file.
+// The records themselves still use PointerWrap. A GameFile is mostly strings, maps of localized
+// names and image buffers, so giving it a fixed layout that could be used in place would mean
+// duplicating the whole class, and the game list needs every entry right after loading anyway.
+struct CacheFileHeader
+{
+  u32 magic;
+  u32 revision;
+  u64 number_of_entries;
+};
+static_assert(sizeof(CacheFileHeader) == 0x10);
+
+struct CacheFileEntry
+{
+  u64 offset;
+  u64 size;
+};
+static_assert(sizeof(CacheFileEntry) == 0x10);
+
+// New games are processed in batches of this size, so that the callback passed to Update keeps
+// getting called while a large library is being processed
+static constexpr size_t PARALLEL_BATCH_SIZE = 64;
 
 std::vector<std::string> FindAllGamePaths(const std::vector<std::string>& directories_to_scan,
                                           bool recursive_scan)
 {
   static const std::vector<std::string> search_extensions = {
       ".gcm", ".tgc", ".iso", ".ciso", ".gcz", ".wbfs", ".wia",
-      ".rvz", ".nfs", ".wad", ".dol",  ".elf", ".json"};
+      ".rvz", ".nfs", ".dcs", ".wad",  ".dol", ".elf",  ".json"};
 
   // TODO: We could process paths iteratively as they are found
   return Common::DoFileSearch(directories_to_scan, search_extensions, recursive_scan);
@@ -43,6 +73,42 @@ GameFileCache::GameFileCache() : m_path(File::GetUserPath(D_CACHE_IDX) + "gameli
 {
 }
 
+void GameFileCache::ParallelFor(size_t count, const std::function<void(size_t)>& function)
+{
+  const size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+  const size_t thread_count = std::min(count, max_threads);
+  if (thread_count <= 1)
+  {
+    for (size_t i = 0; i < count; ++i)
+      function(i);
+    return;
+  }
+
+  // The worker threads are started the first time they're needed and reused after that
+  if (m_workers.empty())
+  {
+    for (size_t i = 1; i < max_threads; ++i)
+    {
+      m_workers.push_back(std::make_unique<Common::WorkQueueThread<std::function<void()>>>(
+          "GameFileCache Worker", [](std::function<void()> work) { work(); }));
+    }
+  }
+
+  std::atomic<size_t> next_index = 0;
+  const auto worker = [&] {
+    for (size_t i = next_index++; i < count; i = next_index++)
+      function(i);
+  };
+
+  for (size_t i = 1; i < thread_count; ++i)
+    m_workers[i - 1]->Push(worker);
+
+  worker();
+
+  for (size_t i = 1; i < thread_count; ++i)
+    m_workers[i - 1]->WaitForCompletion();
+}
+
 void GameFileCache::ForEach(const ForEachFn& f) const
 {
   for (const std::shared_ptr<GameFile>& item : m_cached_files)
@@ -60,23 +126,54 @@ void GameFileCache::Clear(DeleteOnDisk delete_on_disk)
     File::Delete(m_path);
 
   m_cached_files.clear();
+  m_path_index.clear();
+}
+
+void GameFileCache::RemoveFromCache(size_t index)
+{
+  // For the sake of speed, we don't care about maintaining the order of m_cached_files.
+  m_path_index.erase(m_cached_files[index]->GetFilePath());
+  if (index != m_cached_files.size() - 1)
+  {
+    m_cached_files[index] = std::move(m_cached_files.back());
+    m_path_index[m_cached_files[index]->GetFilePath()] = index;
+  }
+  m_cached_files.pop_back();
+}
+
+void GameFileCache::RebuildPathIndex()
+{
+  m_path_index.clear();
+  m_path_index.reserve(m_cached_files.size());
+  for (size_t i = 0; i < m_cached_files.size(); ++i)
+    m_path_index.emplace(m_cached_files[i]->GetFilePath(), i);
 }
 
 std::shared_ptr<const GameFile> GameFileCache::AddOrGet(const std::string& path,
                                                         bool* cache_changed)
 {
-  auto it = std::find_if(
-      m_cached_files.begin(), m_cached_files.end(),
-      [&path](const std::shared_ptr<GameFile>& file) { return file->GetFilePath() == path; });
-  const bool found = it != m_cached_files.cend();
-  if (!found)
+  const auto it = m_path_index.find(path);
+  const bool found = it != m_path_index.end();
+  if (found && m_cached_files[it->second]->FileChanged())
+  {
+    std::shared_ptr<GameFile> game = std::make_shared<GameFile>(path);
+    *cache_changed = true;
+    if (!game->IsValid())
+    {
+      RemoveFromCache(it->second);
+      return nullptr;
+    }
+    m_cached_files[it->second] = std::move(game);
+  }
+  else if (!found)
   {
     std::shared_ptr<UICommon::GameFile> game = std::make_shared<GameFile>(path);
     if (!game->IsValid())
       return nullptr;
+    m_path_index.emplace(path, m_cached_files.size());
     m_cached_files.emplace_back(std::move(game));
   }
-  std::shared_ptr<GameFile>& result = found ? *it : m_cached_files.back();
+  std::shared_ptr<GameFile>& result = found ? m_cached_files[it->second] : m_cached_files.back();
   if (UpdateAdditionalMetadata(&result) || !found)
     *cache_changed = true;
 
@@ -101,6 +198,20 @@ bool GameFileCache::Update(std::span<const std::string> all_game_paths,
 
   bool cache_changed = false;
 
+  // Find the cached files that have been modified since they were cached. They are removed from
+  // the cache below and then added again like any new file.
+  std::vector<char> file_changed(m_cached_files.size());
+  ParallelFor(m_cached_files.size(), [&](size_t i) {
+    if (!processing_halted)
+      file_changed[i] = m_cached_files[i]->FileChanged();
+  });
+  std::unordered_set<std::string> changed_paths;
+  for (size_t i = 0; i < m_cached_files.size(); ++i)
+  {
+    if (file_changed[i])
+      changed_paths.insert(m_cached_files[i]->GetFilePath());
+  }
+
   // Delete paths that aren't in game_paths from m_cached_files,
   // while simultaneously deleting paths that are in m_cached_files from game_paths.
   // For the sake of speed, we don't care about maintaining the order of m_cached_files.
@@ -112,14 +223,15 @@ bool GameFileCache::Update(std::span<const std::string> all_game_paths,
       if (processing_halted)
         break;
 
-      if (game_paths.erase((*it)->GetFilePath()))
+      const std::string& path = (*it)->GetFilePath();
+      if (!changed_paths.contains(path) && game_paths.erase(path))
       {
         ++it;
       }
       else
       {
         if (game_removed_from_cache)
-          game_removed_from_cache((*it)->GetFilePath());
+          game_removed_from_cache(path);
 
         cache_changed = true;
         --end;
@@ -131,22 +243,36 @@ bool GameFileCache::Update(std::span<const std::string> all_game_paths,
 
   // Now that the previous loop has run, game_paths only contains paths that
   // aren't in m_cached_files, so we simply add all of them to m_cached_files.
-  for (const std::string& path : game_paths)
+  // Reading the metadata of a game means opening its volume and decoding its banner,
+  // so this is done on several threads at once.
+  const std::vector<std::string> new_paths(game_paths.begin(), game_paths.end());
+  for (size_t batch_start = 0; batch_start < new_paths.size(); batch_start += PARALLEL_BATCH_SIZE)
   {
     if (processing_halted)
       break;
 
-    auto file = std::make_shared<GameFile>(path);
-    if (file->IsValid())
+    const size_t batch_size = std::min(PARALLEL_BATCH_SIZE, new_paths.size() - batch_start);
+    std::vector<std::shared_ptr<GameFile>> files(batch_size);
+    ParallelFor(batch_size, [&](size_t i) {
+      if (!processing_halted)
+        files[i] = std::make_shared<GameFile>(new_paths[batch_start + i]);
+    });
+
+    for (std::shared_ptr<GameFile>& file : files)
     {
-      if (game_added_to_cache)
-        game_added_to_cache(file);
+      if (file && file->IsValid())
+      {
+        if (game_added_to_cache)
+          game_added_to_cache(file);
 
-      cache_changed = true;
-      m_cached_files.push_back(std::move(file));
+        cache_changed = true;
+        m_cached_files.push_back(std::move(file));
+      }
     }
   }
 
+  RebuildPathIndex();
+
   return cache_changed;
 }
 
@@ -155,6 +281,8 @@ bool GameFileCache::UpdateAdditionalMetadata(const GameUpdatedFn& game_updated,
 {
   bool cache_changed = false;
 
+  // This stays on one thread. It downloads covers and replaces entries that other threads may be
+  // reading, and the network requests wouldn't get any faster by running them concurrently.
   for (std::shared_ptr<GameFile>& file : m_cached_files)
   {
     if (processing_halted)
@@ -208,49 +336,102 @@ bool GameFileCache::UpdateAdditionalMetadata(std::shared_ptr<GameFile>* game_fil
 
 bool GameFileCache::Load()
 {
-  return SyncCacheFile(false);
-}
+  File::IOFile f(m_path, "rb");
+  if (!f)
+    return false;
 
-bool GameFileCache::Save()
-{
-  return SyncCacheFile(true);
+  const std::unique_ptr<Common::MappedFile> mapping =
+      Common::MappedFile::Map(f, Common::MappedFile::AccessPattern::Normal);
+  f.Close();
+
+  const auto load = [&] {
+    if (!mapping || mapping->GetSize() < sizeof(CacheFileHeader))
+      return false;
+
+    const u8* data = mapping->GetData();
+    const u64 size = mapping->GetSize();
+
+    CacheFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != CACHE_MAGIC || header.revision != CACHE_REVISION ||
+        header.number_of_entries > (size - sizeof(header)) / sizeof(CacheFileEntry))
+    {
+      return false;
+    }
+
+    std::vector<CacheFileEntry> entries(header.number_of_entries);
+    std::memcpy(entries.data(), data + sizeof(header), entries.size() * sizeof(CacheFileEntry));
+    for (const CacheFileEntry& entry : entries)
+    {
+      if (entry.offset > size || entry.size > size - entry.offset)
+        return false;
+    }
+
+    std::vector<std::shared_ptr<GameFile>> files(entries.size());
+    std::atomic_bool success = true;
+    ParallelFor(entries.size(), [&](size_t i) {
+      // PointerWrap never writes through the pointer in read mode
+      u8* const start = const_cast<u8*>(data) + entries[i].offset;
+      u8* ptr = start;
+      PointerWrap p(&ptr, entries[i].size, PointerWrap::Mode::Read);
+      files[i] = std::make_shared<GameFile>();
+      files[i]->DoState(p);
+      if (!p.IsReadMode() || ptr != start + entries[i].size)
+        success = false;
+    });
+    if (!success)
+      return false;
+
+    m_cached_files = std::move(files);
+    RebuildPathIndex();
+    return true;
+  };
+
+  if (!load())
+  {
+    // Delete the probably-corrupted or outdated cache
+    File::Delete(m_path);
+    return false;
+  }
+
+  return true;
 }
 
-bool GameFileCache::SyncCacheFile(bool save)
+bool GameFileCache::Save()
 {
-  const char* open_mode = save ? "wb" : "rb";
-  File::IOFile f(m_path, open_mode);
-  if (!f)
-    return false;
-  bool success = false;
-  if (save)
-  {
+  // Serializing a game doesn't depend on any of the others, so this is done in parallel
+  std::vector<std::vector<u8>> records(m_cached_files.size());
+  ParallelFor(m_cached_files.size(), [&](size_t i) {
     // Measure the size of the buffer.
     u8* ptr = nullptr;
     PointerWrap p_measure(&ptr, 0, PointerWrap::Mode::Measure);
-    DoState(&p_measure);
+    m_cached_files[i]->DoState(p_measure);
     const size_t buffer_size = reinterpret_cast<size_t>(ptr);
 
     // Then actually do the write.
-    std::vector<u8> buffer(buffer_size);
-    ptr = buffer.data();
+    records[i].resize(buffer_size);
+    ptr = records[i].data();
     PointerWrap p(&ptr, buffer_size, PointerWrap::Mode::Write);
-    DoState(&p, buffer_size);
-    if (f.WriteBytes(buffer.data(), buffer.size()))
-      success = true;
-  }
-  else
+    m_cached_files[i]->DoState(p);
+  });
+
+  const CacheFileHeader header{CACHE_MAGIC, CACHE_REVISION, records.size()};
+  std::vector<CacheFileEntry> entries(records.size());
+  u64 offset = sizeof(header) + entries.size() * sizeof(CacheFileEntry);
+  for (size_t i = 0; i < records.size(); ++i)
   {
-    std::vector<u8> buffer(f.GetSize());
-    if (!buffer.empty() && f.ReadBytes(buffer.data(), buffer.size()))
-    {
-      u8* ptr = buffer.data();
-      PointerWrap p(&ptr, buffer.size(), PointerWrap::Mode::Read);
-      DoState(&p, buffer.size());
-      if (p.IsReadMode())
-        success = true;
-    }
+    entries[i] = {offset, records[i].size()};
+    offset += records[i].size();
   }
+
+  File::IOFile f(m_path, "wb");
+  if (!f)
+    return false;
+
+  bool success = f.WriteArray(&header, 1) && f.WriteArray(entries.data(), entries.size());
+  for (size_t i = 0; success && i < records.size(); ++i)
+    success = f.WriteBytes(records[i].data(), records[i].size());
+
   if (!success)
   {
     // If some file operation failed, try to delete the probably-corrupted cache
@@ -260,27 +441,4 @@ bool GameFileCache::SyncCacheFile(bool save)
   return success;
 }
 
-void GameFileCache::DoState(PointerWrap* p, u64 size)
-{
-  struct
-  {
-    u32 revision;
-    u64 expected_size;
-  } header = {CACHE_REVISION, size};
-  p->Do(header);
-  if (p->IsReadMode())
-  {
-    if (header.revision != CACHE_REVISION || header.expected_size != size)
-    {
-      p->SetMeasureMode();
-      return;
-    }
-  }
-  p->DoEachElement(m_cached_files, [](PointerWrap& state, std::shared_ptr<GameFile>& elem) {
-    if (state.IsReadMode())
-      elem = std::make_shared<GameFile>();
-    elem->DoState(state);
-  });
-}
-
 }  // namespace UICommon
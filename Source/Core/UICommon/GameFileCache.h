@@ -9,11 +9,11 @@
 #include <memory>
 #include <span>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Common/CommonTypes.h"
-
-class PointerWrap;
+#include "Common/WorkQueueThread.h"
 
 namespace UICommon
 {
@@ -47,6 +47,7 @@ public:
   std::shared_ptr<const GameFile> AddOrGet(const std::string& path, bool* cache_changed);
 
   // These functions return true if the call modified the cache.
+  // Files that are already in the cache are only processed again if they have been modified.
   bool Update(std::span<const std::string> all_game_paths,
               const GameAddedToCacheFn& game_added_to_cache = {},
               const GameRemovedFromCacheFn& game_removed_from_cache = {},
@@ -59,12 +60,16 @@ public:
 
 private:
   bool UpdateAdditionalMetadata(std::shared_ptr<GameFile>* game_file);
-
-  bool SyncCacheFile(bool save);
-  void DoState(PointerWrap* p, u64 size = 0);
+  void RemoveFromCache(size_t index);
+  void RebuildPathIndex();
+  // Calls function once for every index in [0, count), using the worker threads as well
+  void ParallelFor(size_t count, const std::function<void(size_t)>& function);
 
   std::string m_path;
   std::vector<std::shared_ptr<GameFile>> m_cached_files;
+  // Maps file paths to indexes in m_cached_files
+  std::unordered_map<std::string, size_t> m_path_index;
+  std::vector<std::unique_ptr<Common::WorkQueueThread<std::function<void()>>>> m_workers;
 };
 
 }  // namespace UICommon
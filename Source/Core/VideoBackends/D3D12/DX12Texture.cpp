@@ -785,6 +785,13 @@ void DXStagingTexture::Flush()
     g_dx_context->WaitForFence(m_completed_fence);
 }
 
+bool DXStagingTexture::IsCopyComplete() const
+{
+  // The command list containing the copy must have been executed and seen to complete.
+  return !m_needs_flush || (m_completed_fence != g_dx_context->GetCurrentFenceValue() &&
+                            g_dx_context->GetCompletedFenceValue() >= m_completed_fence);
+}
+
 std::unique_ptr<DXStagingTexture> DXStagingTexture::Create(StagingTextureType type,
                                                            const TextureConfig& config)
 {
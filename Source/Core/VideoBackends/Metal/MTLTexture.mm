@@ -189,6 +189,11 @@ void Metal::StagingTexture::Flush()
   m_wait_buffer = nullptr;
 }
 
+bool Metal::StagingTexture::IsCopyComplete() const
+{
+  return !m_wait_buffer || [m_wait_buffer status] == MTLCommandBufferStatusCompleted;
+}
+
 static void InitDesc(id desc, AbstractTexture* tex)
 {
   [desc setTexture:static_cast<Metal::Texture*>(tex)->GetMTLTexture()];
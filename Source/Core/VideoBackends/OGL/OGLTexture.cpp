@@ -625,6 +625,17 @@ void OGLStagingTexture::Flush()
   m_needs_flush = false;
 }
 
+bool OGLStagingTexture::IsCopyComplete() const
+{
+  // Without buffer storage the transfer happens on Map(), so there is nothing to wait for.
+  if (m_fence == nullptr)
+    return true;
+
+  GLint status = GL_UNSIGNALED;
+  glGetSynciv(m_fence, GL_SYNC_STATUS, 1, nullptr, &status);
+  return status == GL_SIGNALED;
+}
+
 bool OGLStagingTexture::Map()
 {
   if (m_map_pointer)
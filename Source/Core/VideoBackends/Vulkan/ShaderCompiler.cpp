@@ -89,7 +89,8 @@ static const char SUBGROUP_HELPER_HEADER[] = R"(
   #define SUBGROUP_MAX(value) value = subgroupMax(value)
 )";
 
-static std::string GetShaderCode(std::string_view source, std::string_view header)
+static std::string GetShaderCode(std::string_view source, std::string_view header,
+                                 bool supports_subgroup_operations)
 {
   std::string full_source_code;
   if (!header.empty())
@@ -97,7 +98,7 @@ static std::string GetShaderCode(std::string_view source, std::string_view heade
     constexpr size_t subgroup_helper_header_length = std::size(SUBGROUP_HELPER_HEADER) - 1;
     full_source_code.reserve(header.size() + subgroup_helper_header_length + source.size());
     full_source_code.append(header);
-    if (g_vulkan_context->SupportsShaderSubgroupOperations())
+    if (supports_subgroup_operations)
       full_source_code.append(SUBGROUP_HELPER_HEADER, subgroup_helper_header_length);
     if (DriverDetails::HasBug(DriverDetails::BUG_INVERTED_IS_HELPER))
     {
@@ -112,10 +113,10 @@ static std::string GetShaderCode(std::string_view source, std::string_view heade
   return full_source_code;
 }
 
-static glslang::EShTargetLanguageVersion GetLanguageVersion()
+static glslang::EShTargetLanguageVersion GetLanguageVersion(bool supports_subgroup_operations)
 {
   // Sub-group operations require Vulkan 1.1 and SPIR-V 1.3.
-  if (g_vulkan_context->SupportsShaderSubgroupOperations())
+  if (supports_subgroup_operations)
     return glslang::EShTargetSpv_1_3;
 
   return glslang::EShTargetSpv_1_0;
@@ -123,25 +124,48 @@ static glslang::EShTargetLanguageVersion GetLanguageVersion()
 
 std::optional<SPIRVCodeVector> CompileVertexShader(std::string_view source_code)
 {
-  return SPIRV::CompileVertexShader(GetShaderCode(source_code, SHADER_HEADER), APIType::Vulkan,
-                                    GetLanguageVersion());
+  return CompileVertexShader(source_code, g_vulkan_context->SupportsShaderSubgroupOperations());
 }
 
 std::optional<SPIRVCodeVector> CompileGeometryShader(std::string_view source_code)
 {
-  return SPIRV::CompileGeometryShader(GetShaderCode(source_code, SHADER_HEADER), APIType::Vulkan,
-                                      GetLanguageVersion());
+  return CompileGeometryShader(source_code, g_vulkan_context->SupportsShaderSubgroupOperations());
 }
 
 std::optional<SPIRVCodeVector> CompileFragmentShader(std::string_view source_code)
 {
-  return SPIRV::CompileFragmentShader(GetShaderCode(source_code, SHADER_HEADER), APIType::Vulkan,
-                                      GetLanguageVersion());
+  return CompileFragmentShader(source_code, g_vulkan_context->SupportsShaderSubgroupOperations());
 }
 
 std::optional<SPIRVCodeVector> CompileComputeShader(std::string_view source_code)
 {
-  return SPIRV::CompileComputeShader(GetShaderCode(source_code, COMPUTE_SHADER_HEADER),
-                                     APIType::Vulkan, GetLanguageVersion());
+  const bool supports_subgroup_operations = g_vulkan_context->SupportsShaderSubgroupOperations();
+  return SPIRV::CompileComputeShader(
+      GetShaderCode(source_code, COMPUTE_SHADER_HEADER, supports_subgroup_operations),
+      APIType::Vulkan, GetLanguageVersion(supports_subgroup_operations));
+}
+
+std::optional<SPIRVCodeVector> CompileVertexShader(std::string_view source_code,
+                                                   bool supports_subgroup_operations)
+{
+  return SPIRV::CompileVertexShader(
+      GetShaderCode(source_code, SHADER_HEADER, supports_subgroup_operations), APIType::Vulkan,
+      GetLanguageVersion(supports_subgroup_operations));
+}
+
+std::optional<SPIRVCodeVector> CompileGeometryShader(std::string_view source_code,
+                                                     bool supports_subgroup_operations)
+{
+  return SPIRV::CompileGeometryShader(
+      GetShaderCode(source_code, SHADER_HEADER, supports_subgroup_operations), APIType::Vulkan,
+      GetLanguageVersion(supports_subgroup_operations));
+}
+
+std::optional<SPIRVCodeVector> CompileFragmentShader(std::string_view source_code,
+                                                     bool supports_subgroup_operations)
+{
+  return SPIRV::CompileFragmentShader(
+      GetShaderCode(source_code, SHADER_HEADER, supports_subgroup_operations), APIType::Vulkan,
+      GetLanguageVersion(supports_subgroup_operations));
 }
 }  // namespace Vulkan::ShaderCompiler
@@ -27,4 +27,13 @@ std::optional<SPIRVCodeVector> CompileFragmentShader(std::string_view source_cod
 
 // Compile a compute shader to SPIR-V.
 std::optional<SPIRVCodeVector> CompileComputeShader(std::string_view source_code);
+
+// Variants that don't need a device, for building shader caches ahead of time.
+// supports_subgroup_operations must match the device the shaders are meant for.
+std::optional<SPIRVCodeVector> CompileVertexShader(std::string_view source_code,
+                                                   bool supports_subgroup_operations);
+std::optional<SPIRVCodeVector> CompileGeometryShader(std::string_view source_code,
+                                                     bool supports_subgroup_operations);
+std::optional<SPIRVCodeVector> CompileFragmentShader(std::string_view source_code,
+                                                     bool supports_subgroup_operations);
 }  // namespace Vulkan::ShaderCompiler
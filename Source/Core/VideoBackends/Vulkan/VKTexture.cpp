@@ -1009,6 +1009,14 @@ void VKStagingTexture::Flush()
   m_needs_flush = false;
 }
 
+bool VKStagingTexture::IsCopyComplete() const
+{
+  // The command buffer containing the copy must have been submitted and seen to complete.
+  return !m_needs_flush ||
+         (m_flush_fence_counter != g_command_buffer_mgr->GetCurrentFenceCounter() &&
+          g_command_buffer_mgr->GetCompletedFenceCounter() >= m_flush_fence_counter);
+}
+
 VKFramebuffer::VKFramebuffer(VKTexture* color_attachment, VKTexture* depth_attachment,
                              std::vector<AbstractTexture*> additional_color_attachments, u32 width,
                              u32 height, u32 layers, u32 samples, VkFramebuffer fb,
@@ -67,6 +67,10 @@ public:
   // call to CopyFromTexture()/CopyToTexture() and the Flush() call.
   virtual void Flush() = 0;
 
+  // Returns true if the GPU has finished the last copy to or from this texture, so that Flush()
+  // will not have to wait for it. Backends which can't check this without waiting return true.
+  virtual bool IsCopyComplete() const { return true; }
+
   // Reads the specified rectangle from the staging texture to out_ptr, with the specified stride
   // (length in bytes of each row). CopyFromTexture must be called first. The contents of any
   // texels outside of the rectangle used for CopyFromTexture is undefined.
@@ -3,7 +3,11 @@
 
 #include "VideoCommon/Assets/CustomAssetLoader.h"
 
+#include <algorithm>
+
 #include "Common/MemoryUtil.h"
+#include "Common/Thread.h"
+#include "Common/Timer.h"
 #include "VideoCommon/Assets/CustomAssetLibrary.h"
 
 namespace VideoCommon
@@ -44,34 +48,35 @@ void CustomAssetLoader::Init()
     }
   });
 
-  m_asset_load_thread.Reset("Custom Asset Loader", [this](std::weak_ptr<CustomAsset> asset) {
-    if (auto ptr = asset.lock())
-    {
-      if (m_memory_exceeded)
-        return;
+  {
+    std::lock_guard lk(m_asset_queue_lock);
+    m_asset_load_threads_shutdown = false;
+    m_assets_loaded = 0;
+    m_assets_failed = 0;
+    m_total_load_latency_us = 0;
+    m_max_load_latency_us = 0;
+  }
 
-      if (ptr->Load())
-      {
-        std::lock_guard lk(m_asset_load_lock);
-        const std::size_t asset_memory_size = ptr->GetByteSizeInMemory();
-        m_total_bytes_loaded += asset_memory_size;
-        m_assets_to_monitor.try_emplace(ptr->GetAssetId(), ptr);
-        if (m_total_bytes_loaded > m_max_memory_available)
-        {
-          ERROR_LOG_FMT(VIDEO,
-                        "Asset memory exceeded with asset '{}', future assets won't load until "
-                        "memory is available.",
-                        ptr->GetAssetId());
-          m_memory_exceeded = true;
-        }
-      }
-    }
-  });
+  // Decoding textures is mostly CPU bound, leave some cores for the emulator itself.
+  const u32 num_threads =
+      std::clamp(std::thread::hardware_concurrency() / 2, 1u, MAX_ASSET_LOAD_THREADS);
+  for (u32 i = 0; i < num_threads; i++)
+    m_asset_load_threads.emplace_back(&CustomAssetLoader::AssetLoadThread, this);
 }
 
 void CustomAssetLoader ::Shutdown()
 {
-  m_asset_load_thread.Shutdown(true);
+  {
+    std::lock_guard lk(m_asset_queue_lock);
+    m_asset_load_threads_shutdown = true;
+    for (auto& queue : m_asset_load_queues)
+      queue.clear();
+    m_pending_asset_loads.clear();
+  }
+  m_asset_queue_cv.notify_all();
+  for (std::thread& thread : m_asset_load_threads)
+    thread.join();
+  m_asset_load_threads.clear();
 
   m_asset_monitor_thread_shutdown.Set();
   m_asset_monitor_thread.join();
@@ -79,11 +84,132 @@ void CustomAssetLoader ::Shutdown()
   m_total_bytes_loaded = 0;
 }
 
+void CustomAssetLoader::QueueAssetLoad(const CustomAssetLibrary::AssetID& asset_id,
+                                       std::weak_ptr<CustomAsset> asset, LoadPriority priority)
+{
+  {
+    std::lock_guard lk(m_asset_queue_lock);
+    if (m_asset_load_threads_shutdown)
+      return;
+
+    const u64 sequence = m_next_asset_load_sequence++;
+    m_pending_asset_loads.insert_or_assign(
+        asset_id, PendingAssetLoad{std::move(asset), priority, sequence, Common::Timer::NowUs()});
+    m_asset_load_queues[static_cast<size_t>(priority)].push_back(
+        QueuedAssetLoad{asset_id, sequence});
+  }
+  m_asset_queue_cv.notify_one();
+}
+
+void CustomAssetLoader::PrioritizeAsset(const CustomAssetLibrary::AssetID& asset_id)
+{
+  std::lock_guard lk(m_asset_queue_lock);
+  const auto it = m_pending_asset_loads.find(asset_id);
+  if (it == m_pending_asset_loads.end() || it->second.priority == LoadPriority::Immediate)
+    return;
+
+  // The entry left in the preload queue is skipped, as its sequence no longer matches.
+  it->second.priority = LoadPriority::Immediate;
+  it->second.sequence = m_next_asset_load_sequence++;
+  m_asset_load_queues[static_cast<size_t>(LoadPriority::Immediate)].push_back(
+      QueuedAssetLoad{asset_id, it->second.sequence});
+  m_asset_queue_cv.notify_one();
+}
+
+void CustomAssetLoader::AssetLoadThread()
+{
+  Common::SetCurrentThreadName("Custom Asset Loader");
+
+  while (true)
+  {
+    std::shared_ptr<CustomAsset> ptr;
+    u64 queue_time_us;
+    {
+      std::unique_lock lk(m_asset_queue_lock);
+      m_asset_queue_cv.wait(lk, [this] {
+        return m_asset_load_threads_shutdown ||
+               std::any_of(m_asset_load_queues.begin(), m_asset_load_queues.end(),
+                           [](const auto& queue) { return !queue.empty(); });
+      });
+      if (m_asset_load_threads_shutdown)
+        return;
+
+      auto& queue = *std::find_if(m_asset_load_queues.begin(), m_asset_load_queues.end(),
+                                  [](const auto& q) { return !q.empty(); });
+      const QueuedAssetLoad queued = std::move(queue.front());
+      queue.pop_front();
+
+      const auto it = m_pending_asset_loads.find(queued.asset_id);
+      if (it == m_pending_asset_loads.end() || it->second.sequence != queued.sequence)
+        continue;
+      ptr = it->second.asset.lock();
+      queue_time_us = it->second.queue_time_us;
+      m_pending_asset_loads.erase(it);
+    }
+
+    if (!ptr || m_memory_exceeded)
+      continue;
+
+    const bool loaded = ptr->Load();
+    if (loaded)
+    {
+      std::lock_guard lk(m_asset_load_lock);
+      const std::size_t asset_memory_size = ptr->GetByteSizeInMemory();
+      m_total_bytes_loaded += asset_memory_size;
+      m_assets_to_monitor.try_emplace(ptr->GetAssetId(), ptr);
+      if (m_total_bytes_loaded > m_max_memory_available)
+      {
+        ERROR_LOG_FMT(VIDEO,
+                      "Asset memory exceeded with asset '{}', future assets won't load until "
+                      "memory is available.",
+                      ptr->GetAssetId());
+        m_memory_exceeded = true;
+      }
+    }
+
+    const u64 latency_us = Common::Timer::NowUs() - queue_time_us;
+    std::lock_guard lk(m_asset_queue_lock);
+    if (loaded)
+    {
+      m_assets_loaded++;
+      m_total_load_latency_us += latency_us;
+      m_max_load_latency_us = std::max(m_max_load_latency_us, latency_us);
+    }
+    else
+    {
+      m_assets_failed++;
+    }
+  }
+}
+
+CustomAssetLoader::Statistics CustomAssetLoader::GetStatistics() const
+{
+  Statistics statistics;
+  {
+    std::lock_guard lk(m_asset_queue_lock);
+    statistics.queued = m_pending_asset_loads.size();
+    statistics.loaded = m_assets_loaded;
+    statistics.failed = m_assets_failed;
+    if (m_assets_loaded != 0)
+      statistics.average_latency_us = m_total_load_latency_us / m_assets_loaded;
+    statistics.max_latency_us = m_max_load_latency_us;
+  }
+  {
+    std::lock_guard lk(m_asset_load_lock);
+    statistics.bytes_loaded = m_total_bytes_loaded;
+    statistics.max_bytes = m_max_memory_available;
+  }
+  statistics.memory_exceeded = m_memory_exceeded;
+  return statistics;
+}
+
 std::shared_ptr<GameTextureAsset>
 CustomAssetLoader::LoadGameTexture(const CustomAssetLibrary::AssetID& asset_id,
-                                   std::shared_ptr<CustomAssetLibrary> library)
+                                   std::shared_ptr<CustomAssetLibrary> library,
+                                   LoadPriority priority)
 {
-  return LoadOrCreateAsset<GameTextureAsset>(asset_id, m_game_textures, std::move(library));
+  return LoadOrCreateAsset<GameTextureAsset>(asset_id, m_game_textures, std::move(library),
+                                             priority);
 }
 
 std::shared_ptr<PixelShaderAsset>
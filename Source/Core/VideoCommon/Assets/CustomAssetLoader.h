@@ -3,15 +3,19 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
+#include "Common/CommonTypes.h"
 #include "Common/Flag.h"
 #include "Common/Logging/Log.h"
-#include "Common/WorkQueueThread.h"
 #include "VideoCommon/Assets/CustomAsset.h"
 #include "VideoCommon/Assets/MaterialAsset.h"
 #include "VideoCommon/Assets/MeshAsset.h"
@@ -32,6 +36,26 @@ public:
   CustomAssetLoader& operator=(const CustomAssetLoader&) = delete;
   CustomAssetLoader& operator=(CustomAssetLoader&&) = delete;
 
+  // Assets that a draw is waiting for are loaded before assets that are loaded ahead of time
+  enum class LoadPriority
+  {
+    Immediate,
+    Preload,
+  };
+
+  struct Statistics
+  {
+    std::size_t queued = 0;
+    u64 loaded = 0;
+    u64 failed = 0;
+    // Time from queueing an asset until it is loaded
+    u64 average_latency_us = 0;
+    u64 max_latency_us = 0;
+    std::size_t bytes_loaded = 0;
+    std::size_t max_bytes = 0;
+    bool memory_exceeded = false;
+  };
+
   void Init();
   void Shutdown();
 
@@ -40,8 +64,10 @@ public:
   // Loads happen asynchronously where the data will be set now or in the future
   // Callees are expected to query the underlying data with 'GetData()'
   // from the 'CustomLoadableAsset' class to determine if the data is ready for use
-  std::shared_ptr<GameTextureAsset> LoadGameTexture(const CustomAssetLibrary::AssetID& asset_id,
-                                                    std::shared_ptr<CustomAssetLibrary> library);
+  std::shared_ptr<GameTextureAsset>
+  LoadGameTexture(const CustomAssetLibrary::AssetID& asset_id,
+                  std::shared_ptr<CustomAssetLibrary> library,
+                  LoadPriority priority = LoadPriority::Immediate);
 
   std::shared_ptr<PixelShaderAsset> LoadPixelShader(const CustomAssetLibrary::AssetID& asset_id,
                                                     std::shared_ptr<CustomAssetLibrary> library);
@@ -52,13 +78,19 @@ public:
   std::shared_ptr<MeshAsset> LoadMesh(const CustomAssetLibrary::AssetID& asset_id,
                                       std::shared_ptr<CustomAssetLibrary> library);
 
+  // Moves an asset that is waiting to be preloaded to the front of the queue
+  void PrioritizeAsset(const CustomAssetLibrary::AssetID& asset_id);
+
+  Statistics GetStatistics() const;
+
 private:
   // TODO C++20: use a 'derived_from' concept against 'CustomAsset' when available
   template <typename AssetType>
   std::shared_ptr<AssetType>
   LoadOrCreateAsset(const CustomAssetLibrary::AssetID& asset_id,
                     std::map<CustomAssetLibrary::AssetID, std::weak_ptr<AssetType>>& asset_map,
-                    std::shared_ptr<CustomAssetLibrary> library)
+                    std::shared_ptr<CustomAssetLibrary> library,
+                    LoadPriority priority = LoadPriority::Immediate)
   {
     auto [it, inserted] = asset_map.try_emplace(asset_id);
     if (!inserted)
@@ -81,11 +113,31 @@ private:
       delete a;
     });
     it->second = ptr;
-    m_asset_load_thread.Push(it->second);
+    QueueAssetLoad(asset_id, ptr, priority);
     return ptr;
   }
 
+  struct QueuedAssetLoad
+  {
+    CustomAssetLibrary::AssetID asset_id;
+    // Prioritizing an asset queues it a second time, the sequence finds the stale entry
+    u64 sequence;
+  };
+
+  struct PendingAssetLoad
+  {
+    std::weak_ptr<CustomAsset> asset;
+    LoadPriority priority;
+    u64 sequence;
+    u64 queue_time_us;
+  };
+
+  void QueueAssetLoad(const CustomAssetLibrary::AssetID& asset_id,
+                      std::weak_ptr<CustomAsset> asset, LoadPriority priority);
+  void AssetLoadThread();
+
   static constexpr auto TIME_BETWEEN_ASSET_MONITOR_CHECKS = std::chrono::milliseconds{500};
+  static constexpr u32 MAX_ASSET_LOAD_THREADS = 4;
 
   std::map<CustomAssetLibrary::AssetID, std::weak_ptr<GameTextureAsset>> m_game_textures;
   std::map<CustomAssetLibrary::AssetID, std::weak_ptr<PixelShaderAsset>> m_pixel_shaders;
@@ -102,7 +154,20 @@ private:
 
   // Use a recursive mutex to handle the scenario where an asset goes out of scope while
   // iterating over the assets to monitor which calls the lock above in 'LoadOrCreateAsset'
-  std::recursive_mutex m_asset_load_lock;
-  Common::WorkQueueThread<std::weak_ptr<CustomAsset>> m_asset_load_thread;
+  mutable std::recursive_mutex m_asset_load_lock;
+
+  std::vector<std::thread> m_asset_load_threads;
+  mutable std::mutex m_asset_queue_lock;
+  std::condition_variable m_asset_queue_cv;
+  // Indexed by LoadPriority
+  std::array<std::deque<QueuedAssetLoad>, 2> m_asset_load_queues;
+  std::map<CustomAssetLibrary::AssetID, PendingAssetLoad> m_pending_asset_loads;
+  u64 m_next_asset_load_sequence = 0;
+  bool m_asset_load_threads_shutdown = false;
+
+  u64 m_assets_loaded = 0;
+  u64 m_assets_failed = 0;
+  u64 m_total_load_latency_us = 0;
+  u64 m_max_load_latency_us = 0;
 };
 }  // namespace VideoCommon
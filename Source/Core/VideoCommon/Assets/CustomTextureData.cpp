@@ -4,16 +4,23 @@
 #include "VideoCommon/Assets/CustomTextureData.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <functional>
+#include <memory>
+
+#include <fmt/format.h>
 
 #include "Common/Align.h"
+#include "Common/FileUtil.h"
 #include "Common/IOFile.h"
 #include "Common/Image.h"
 #include "Common/Logging/Log.h"
+#include "Common/MappedFile.h"
 #include "Common/Swap.h"
+#include "VideoCommon/AbstractTexture.h"
 #include "VideoCommon/VideoConfig.h"
 
 namespace
@@ -593,4 +600,154 @@ bool LoadPNGTexture(CustomTextureData::ArraySlice::Level* level, const std::vect
   level->row_length = level->width;
   return true;
 }
+
+namespace
+{
+constexpr u32 CACHED_TEXTURE_MAGIC = 0x58544344;  // "DCTX"
+constexpr u32 CACHED_TEXTURE_VERSION = 2;
+
+// The data of every level starts at a multiple of this, so it can be used straight from a mapping.
+constexpr u64 CACHED_TEXTURE_DATA_ALIGNMENT = 16;
+
+#pragma pack(push, 1)
+struct CachedTextureHeader
+{
+  u32 magic;
+  u32 version;
+  s64 source_time;
+  u32 num_levels;
+};
+
+// The header is followed by one of these for each level, and then by the uncompressed data of the
+// levels.
+struct CachedTextureLevel
+{
+  u32 format;
+  u32 width;
+  u32 height;
+  u32 row_length;
+  u64 offset;
+  u64 size;
+};
+#pragma pack(pop)
+
+// Far bigger than any texture a GPU can use, but small enough that nothing below overflows.
+constexpr u32 MAX_CACHED_TEXTURE_SIZE = 0x10000;
+
+// Checks that the dimensions, the format and the data size of a level agree with each other.
+bool IsValidCachedTextureLevel(const CachedTextureLevel& level)
+{
+  if (level.format >= static_cast<u32>(AbstractTextureFormat::Undefined) || level.width == 0 ||
+      level.height == 0 || level.height > MAX_CACHED_TEXTURE_SIZE ||
+      level.row_length < level.width || level.row_length > MAX_CACHED_TEXTURE_SIZE)
+  {
+    return false;
+  }
+
+  const auto format = static_cast<AbstractTextureFormat>(level.format);
+  const u32 block_size = AbstractTexture::GetBlockSizeForFormat(format);
+  const u64 stride = AbstractTexture::CalculateStrideForFormat(format, level.row_length);
+  return level.size == stride * GetBlockCount(level.height, block_size);
+}
+
+// Gives every write its own temporary file. The asset monitor and the loader threads can save the
+// same texture at the same time.
+std::string GetTemporaryCacheFilename(const std::string& filename)
+{
+  static std::atomic<u32> s_counter = 0;
+  return fmt::format("{}.{}.tmp", filename, s_counter++);
+}
+}  // namespace
+
+bool LoadCachedTexture(CustomTextureData::ArraySlice* slice, const std::string& filename,
+                       s64 source_time)
+{
+  File::IOFile file(filename, "rb");
+  if (!file.IsOpen())
+    return false;
+
+  // The levels are stored uncompressed, so they are copied straight out of the mapping, which is
+  // much cheaper than decoding a PNG.
+  const std::unique_ptr<Common::MappedFile> mapping =
+      Common::MappedFile::Map(file, Common::MappedFile::AccessPattern::Sequential);
+  file.Close();
+  if (!mapping || mapping->GetSize() < sizeof(CachedTextureHeader))
+    return false;
+
+  const u8* data = mapping->GetData();
+  const u64 size = mapping->GetSize();
+
+  CachedTextureHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != CACHED_TEXTURE_MAGIC || header.version != CACHED_TEXTURE_VERSION ||
+      header.source_time != source_time || header.num_levels == 0 ||
+      header.num_levels > (size - sizeof(header)) / sizeof(CachedTextureLevel))
+  {
+    return false;
+  }
+
+  std::vector<CustomTextureData::ArraySlice::Level> levels(header.num_levels);
+  for (u32 i = 0; i < header.num_levels; ++i)
+  {
+    CachedTextureLevel level_header;
+    std::memcpy(&level_header, data + sizeof(header) + i * sizeof(level_header),
+                sizeof(level_header));
+    if (!IsValidCachedTextureLevel(level_header) || level_header.offset > size ||
+        level_header.size > size - level_header.offset)
+    {
+      return false;
+    }
+
+    CustomTextureData::ArraySlice::Level& level = levels[i];
+    level.format = static_cast<AbstractTextureFormat>(level_header.format);
+    level.width = level_header.width;
+    level.height = level_header.height;
+    level.row_length = level_header.row_length;
+    level.data.assign(data + level_header.offset, data + level_header.offset + level_header.size);
+  }
+
+  slice->m_levels = std::move(levels);
+  return true;
+}
+
+bool SaveCachedTexture(const CustomTextureData::ArraySlice& slice, const std::string& filename,
+                       s64 source_time)
+{
+  const CachedTextureHeader header{CACHED_TEXTURE_MAGIC, CACHED_TEXTURE_VERSION, source_time,
+                                   static_cast<u32>(slice.m_levels.size())};
+
+  std::vector<CachedTextureLevel> level_headers;
+  level_headers.reserve(slice.m_levels.size());
+  u64 offset = sizeof(header) + slice.m_levels.size() * sizeof(CachedTextureLevel);
+  for (const CustomTextureData::ArraySlice::Level& level : slice.m_levels)
+  {
+    offset = Common::AlignUp(offset, CACHED_TEXTURE_DATA_ALIGNMENT);
+    level_headers.push_back({static_cast<u32>(level.format), level.width, level.height,
+                             level.row_length, offset, level.data.size()});
+    offset += level.data.size();
+  }
+
+  // Write to a temporary file first, so that other sessions never see a partial texture.
+  const std::string temp_filename = GetTemporaryCacheFilename(filename);
+  {
+    File::IOFile file(temp_filename, "wb");
+    bool success = file.IsOpen() && file.WriteArray(&header, 1) &&
+                   file.WriteArray(level_headers.data(), level_headers.size());
+    for (size_t i = 0; success && i < slice.m_levels.size(); ++i)
+    {
+      const std::vector<u8>& level_data = slice.m_levels[i].data;
+      success = file.Seek(static_cast<s64>(level_headers[i].offset), File::SeekOrigin::Begin) &&
+                file.WriteBytes(level_data.data(), level_data.size());
+    }
+
+    if (!success)
+    {
+      ERROR_LOG_FMT(VIDEO, "Could not write cached texture {}", filename);
+      file.Close();
+      File::Delete(temp_filename);
+      return false;
+    }
+  }
+  return File::Rename(temp_filename, filename);
+}
 }  // namespace VideoCommon
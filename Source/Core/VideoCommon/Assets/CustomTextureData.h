@@ -34,4 +34,11 @@ bool LoadDDSTexture(CustomTextureData::ArraySlice::Level* level, const std::stri
                     u32 mip_level);
 bool LoadPNGTexture(CustomTextureData::ArraySlice::Level* level, const std::string& filename);
 bool LoadPNGTexture(CustomTextureData::ArraySlice::Level* level, const std::vector<u8>& buffer);
+
+// Decoded textures can be cached on disk, so that later sessions don't have to decode them again.
+// A cached texture is only loaded if it was saved with the same source time.
+bool LoadCachedTexture(CustomTextureData::ArraySlice* slice, const std::string& filename,
+                       s64 source_time);
+bool SaveCachedTexture(const CustomTextureData::ArraySlice& slice, const std::string& filename,
+                       s64 source_time);
 }  // namespace VideoCommon
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include <fmt/std.h>
+#include <xxhash.h>
 
 #include "Common/FileUtil.h"
 #include "Common/IOFile.h"
@@ -49,6 +50,27 @@ std::size_t GetAssetSize(const CustomTextureData& data)
   }
   return total;
 }
+
+// Returns the number of additional mip files next to the texture (see LoadMips) and raises
+// 'newest_write_time' to the newest of their write times.
+u32 GetMipFileWriteTimes(const std::filesystem::path& texture_path,
+                         std::chrono::system_clock::time_point* newest_write_time)
+{
+  std::string path;
+  std::string filename;
+  std::string extension;
+  SplitPath(PathToString(texture_path), &path, &filename, &extension);
+
+  for (u32 mip_level = 1;; mip_level++)
+  {
+    std::error_code ec;
+    const auto tp = std::filesystem::last_write_time(
+        StringToPath(path + filename + fmt::format("_mip{}", mip_level) + extension), ec);
+    if (ec)
+      return mip_level - 1;
+    *newest_write_time = std::max(*newest_write_time, FileTimeToSysTime(tp));
+  }
+}
 }  // namespace
 CustomAssetLibrary::TimeType
 DirectFilesystemAssetLibrary::GetLastAssetWriteTime(const AssetID& asset_id) const
@@ -413,6 +435,22 @@ CustomAssetLibrary::LoadInfo DirectFilesystemAssetLibrary::LoadTexture(const Ass
       data->m_texture.m_slices.push_back({});
 
     auto& slice = data->m_texture.m_slices[0];
+
+    // The cached copy holds the decoded texture and all of its mips, so it is only up to date if
+    // it is newer than every one of those files and has a level for each of them.
+    TimeType write_time = GetLastAssetWriteTime(asset_id);
+    const u32 num_mip_files = GetMipFileWriteTimes(texture_path->second, &write_time);
+    const s64 source_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(write_time.time_since_epoch())
+            .count();
+    const std::string cache_filename = GetTextureCacheFileName(texture_path->second);
+    if (!cache_filename.empty() && LoadCachedTexture(&slice, cache_filename, source_time))
+    {
+      if (slice.m_levels.size() == num_mip_files + 1)
+        return LoadInfo{GetAssetSize(data->m_texture) + metadata_size, write_time};
+      slice.m_levels.clear();
+    }
+
     // If we have no levels, create one to pass into LoadPNGTexture
     if (slice.m_levels.empty())
       slice.m_levels.push_back({});
@@ -426,7 +464,10 @@ CustomAssetLibrary::LoadInfo DirectFilesystemAssetLibrary::LoadTexture(const Ass
     if (!LoadMips(texture_path->second, &slice))
       return {};
 
-    return LoadInfo{GetAssetSize(data->m_texture) + metadata_size, GetLastAssetWriteTime(asset_id)};
+    if (!cache_filename.empty())
+      SaveCachedTexture(slice, cache_filename, source_time);
+
+    return LoadInfo{GetAssetSize(data->m_texture) + metadata_size, write_time};
   }
 
   ERROR_LOG_FMT(VIDEO, "Asset '{}' error - extension '{}' unknown!", asset_id, ext);
@@ -492,6 +533,27 @@ bool DirectFilesystemAssetLibrary::LoadMips(const std::filesystem::path& asset_p
   return true;
 }
 
+void DirectFilesystemAssetLibrary::SetTextureCacheDirectory(std::string directory)
+{
+  if (!directory.empty())
+    File::CreateFullPath(directory);
+
+  std::lock_guard lk(m_lock);
+  m_texture_cache_directory = std::move(directory);
+}
+
+std::string DirectFilesystemAssetLibrary::GetTextureCacheFileName(
+    const std::filesystem::path& texture_path) const
+{
+  std::lock_guard lk(m_lock);
+  if (m_texture_cache_directory.empty())
+    return {};
+
+  const std::string path = PathToString(texture_path);
+  return fmt::format("{}{:016x}.tex", m_texture_cache_directory,
+                     XXH64(path.data(), path.size(), 0));
+}
+
 DirectFilesystemAssetLibrary::AssetMap
 DirectFilesystemAssetLibrary::GetAssetMapForID(const AssetID& asset_id) const
 {
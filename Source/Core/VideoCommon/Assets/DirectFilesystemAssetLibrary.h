@@ -33,6 +33,9 @@ public:
   // file as the asset.  But a model file data might have its data spread across multiple files
   void SetAssetIDMapData(const AssetID& asset_id, AssetMap asset_path_map);
 
+  // Decoded PNG textures are cached in the given directory, an empty string disables the cache
+  void SetTextureCacheDirectory(std::string directory);
+
 private:
   // Loads additional mip levels into the texture structure until _mip<N> texture is not found
   bool LoadMips(const std::filesystem::path& asset_path, CustomTextureData::ArraySlice* data);
@@ -40,7 +43,11 @@ private:
   // Gets the asset map given an asset id
   AssetMap GetAssetMapForID(const AssetID& asset_id) const;
 
+  // Gets the file in the texture cache for a texture, or an empty string if there is no cache
+  std::string GetTextureCacheFileName(const std::filesystem::path& texture_path) const;
+
   mutable std::mutex m_lock;
   std::map<AssetID, std::map<std::string, std::filesystem::path>> m_assetid_to_asset_map_path;
+  std::string m_texture_cache_directory;
 };
 }  // namespace VideoCommon
@@ -3,11 +3,14 @@
 
 #include "VideoCommon/AsyncShaderCompiler.h"
 
+#include <algorithm>
+#include <bit>
 #include <thread>
 
 #include "Common/Assert.h"
 #include "Common/Logging/Log.h"
 #include "Common/Thread.h"
+#include "Common/Timer.h"
 
 #include "Core/Core.h"
 #include "Core/System.h"
@@ -25,30 +28,111 @@ AsyncShaderCompiler::~AsyncShaderCompiler()
   ASSERT(!HasWorkerThreads());
 }
 
-void AsyncShaderCompiler::QueueWorkItem(WorkItemPtr item, u32 priority)
+static size_t GetHistogramBucket(u64 time_us)
+{
+  const u64 time_ms = time_us / 1000;
+  return std::min<size_t>(std::bit_width(time_ms),
+                          AsyncShaderCompiler::Metrics::HISTOGRAM_BUCKETS - 1);
+}
+
+AsyncShaderCompiler::WorkItemID AsyncShaderCompiler::QueueWorkItem(WorkItemPtr item, u32 priority)
 {
   // If no worker threads are available, compile synchronously.
   if (!HasWorkerThreads())
   {
     item->Compile();
     m_completed_work.push_back(std::move(item));
+    return INVALID_WORK_ITEM_ID;
+  }
+
+  const WorkItemID id = m_next_work_item_id++;
+  WorkQueue& queue = *m_work_queues[m_next_work_queue];
+  m_next_work_queue = (m_next_work_queue + 1) % m_worker_threads.size();
+  {
+    std::lock_guard<std::mutex> guard(queue.lock);
+    const auto iter =
+        queue.items.emplace(priority, PendingWorkItem{id, std::move(item), Common::Timer::NowUs()});
+    queue.item_ids.emplace(id, iter);
+    queue.UpdateFirstPriority();
+    m_pending_work_count++;
+  }
+
+  // Taking the lock makes sure that a worker that's about to wait sees the new work item.
+  {
+    std::lock_guard<std::mutex> guard(m_worker_thread_wake_lock);
+  }
+  m_worker_thread_wake.notify_one();
+
+  return id;
+}
+
+void AsyncShaderCompiler::PromoteWorkItem(WorkItemID id, u32 priority)
+{
+  for (const std::unique_ptr<WorkQueue>& queue : m_work_queues)
+  {
+    std::lock_guard<std::mutex> guard(queue->lock);
+    const auto id_iter = queue->item_ids.find(id);
+    if (id_iter == queue->item_ids.end())
+      continue;
+
+    if (id_iter->second->first > priority)
+    {
+      auto node = queue->items.extract(id_iter->second);
+      node.key() = priority;
+      id_iter->second = queue->items.insert(std::move(node));
+      queue->UpdateFirstPriority();
+
+      std::lock_guard<std::mutex> metrics_guard(m_metrics_lock);
+      m_metrics.promoted++;
+    }
+    return;
   }
-  else
+}
+
+bool AsyncShaderCompiler::CancelWorkItem(WorkItemID id)
+{
+  for (const std::unique_ptr<WorkQueue>& queue : m_work_queues)
   {
-    std::lock_guard<std::mutex> guard(m_pending_work_lock);
-    m_pending_work.emplace(priority, std::move(item));
-    m_worker_thread_wake.notify_one();
+    WorkItemPtr item;
+    {
+      std::lock_guard<std::mutex> guard(queue->lock);
+      const auto id_iter = queue->item_ids.find(id);
+      if (id_iter == queue->item_ids.end())
+        continue;
+
+      item = std::move(id_iter->second->second.item);
+      queue->items.erase(id_iter->second);
+      queue->item_ids.erase(id_iter);
+      queue->UpdateFirstPriority();
+      m_pending_work_count--;
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(m_completed_work_lock);
+      m_cancelled_work.push_back(std::move(item));
+    }
+
+    std::lock_guard<std::mutex> metrics_guard(m_metrics_lock);
+    m_metrics.cancelled++;
+    return true;
   }
+
+  return false;
 }
 
 void AsyncShaderCompiler::RetrieveWorkItems()
 {
   std::deque<WorkItemPtr> completed_work;
+  std::vector<WorkItemPtr> cancelled_work;
   {
     std::lock_guard<std::mutex> guard(m_completed_work_lock);
     m_completed_work.swap(completed_work);
+    m_cancelled_work.swap(cancelled_work);
   }
 
+  for (WorkItemPtr& item : cancelled_work)
+    item->Cancel();
+
   while (!completed_work.empty())
   {
     completed_work.front()->Retrieve();
@@ -58,14 +142,13 @@ void AsyncShaderCompiler::RetrieveWorkItems()
 
 bool AsyncShaderCompiler::HasPendingWork()
 {
-  std::lock_guard<std::mutex> guard(m_pending_work_lock);
-  return !m_pending_work.empty() || m_busy_workers.load() != 0;
+  return m_pending_work_count.load() != 0 || m_busy_workers.load() != 0;
 }
 
 bool AsyncShaderCompiler::HasCompletedWork()
 {
   std::lock_guard<std::mutex> guard(m_completed_work_lock);
-  return !m_completed_work.empty();
+  return !m_completed_work.empty() || !m_cancelled_work.empty();
 }
 
 bool AsyncShaderCompiler::WaitUntilCompletion(
@@ -88,10 +171,8 @@ bool AsyncShaderCompiler::WaitUntilCompletion(
   // Grab the number of pending items. We use this to work out how many are left.
   size_t total_items;
   {
-    // Safe to hold both locks here, since nowhere else does.
-    std::lock_guard<std::mutex> pending_guard(m_pending_work_lock);
     std::lock_guard<std::mutex> completed_guard(m_completed_work_lock);
-    total_items = m_completed_work.size() + m_pending_work.size() + m_busy_workers.load() + 1;
+    total_items = m_completed_work.size() + m_pending_work_count.load() + m_busy_workers.load() + 1;
   }
 
   // Update progress while the compiles complete.
@@ -100,13 +181,9 @@ bool AsyncShaderCompiler::WaitUntilCompletion(
     if (Core::GetState(Core::System::GetInstance()) == Core::State::Stopping)
       return false;
 
-    size_t remaining_items;
-    {
-      std::lock_guard<std::mutex> pending_guard(m_pending_work_lock);
-      if (m_pending_work.empty() && !m_busy_workers.load())
-        break;
-      remaining_items = m_pending_work.size();
-    }
+    if (!HasPendingWork())
+      break;
+    const size_t remaining_items = m_pending_work_count.load();
 
     progress_callback(total_items - remaining_items, total_items);
     std::this_thread::sleep_for(CHECK_INTERVAL);
@@ -114,11 +191,22 @@ bool AsyncShaderCompiler::WaitUntilCompletion(
   return true;
 }
 
+AsyncShaderCompiler::Metrics AsyncShaderCompiler::GetMetrics() const
+{
+  std::lock_guard<std::mutex> guard(m_metrics_lock);
+  Metrics metrics = m_metrics;
+  metrics.queue_depth = m_pending_work_count.load();
+  return metrics;
+}
+
 bool AsyncShaderCompiler::StartWorkerThreads(u32 num_worker_threads)
 {
   if (num_worker_threads == 0)
     return true;
 
+  while (m_work_queues.size() < num_worker_threads)
+    m_work_queues.push_back(std::make_unique<WorkQueue>());
+
   for (u32 i = 0; i < num_worker_threads; i++)
   {
     void* thread_param = nullptr;
@@ -130,7 +218,8 @@ bool AsyncShaderCompiler::StartWorkerThreads(u32 num_worker_threads)
 
     m_worker_thread_start_result.store(false);
 
-    std::thread thr(&AsyncShaderCompiler::WorkerThreadEntryPoint, this, thread_param);
+    std::thread thr(&AsyncShaderCompiler::WorkerThreadEntryPoint, this, thread_param,
+                    m_worker_threads.size());
     m_init_event.Wait();
 
     if (!m_worker_thread_start_result.load())
@@ -143,6 +232,7 @@ bool AsyncShaderCompiler::StartWorkerThreads(u32 num_worker_threads)
     m_worker_threads.push_back(std::move(thr));
   }
 
+  m_next_work_queue = 0;
   return HasWorkerThreads();
 }
 
@@ -167,7 +257,7 @@ void AsyncShaderCompiler::StopWorkerThreads()
 
   // Signal worker threads to stop, and wake all of them.
   {
-    std::lock_guard<std::mutex> guard(m_pending_work_lock);
+    std::lock_guard<std::mutex> guard(m_worker_thread_wake_lock);
     m_exit_flag.Set();
     m_worker_thread_wake.notify_all();
   }
@@ -193,7 +283,7 @@ void AsyncShaderCompiler::WorkerThreadExit(void* param)
 {
 }
 
-void AsyncShaderCompiler::WorkerThreadEntryPoint(void* param)
+void AsyncShaderCompiler::WorkerThreadEntryPoint(void* param, size_t queue_index)
 {
   Common::SetCurrentThreadName("AsyncShaderCompiler Worker");
 
@@ -209,35 +299,92 @@ void AsyncShaderCompiler::WorkerThreadEntryPoint(void* param)
   m_worker_thread_start_result.store(true);
   m_init_event.Set();
 
-  WorkerThreadRun();
+  WorkerThreadRun(queue_index);
 
   WorkerThreadExit(param);
 }
 
-void AsyncShaderCompiler::WorkerThreadRun()
+std::optional<AsyncShaderCompiler::PendingWorkItem>
+AsyncShaderCompiler::TakeWorkItem(size_t queue_index, bool* stolen)
 {
-  std::unique_lock<std::mutex> pending_lock(m_pending_work_lock);
-  while (!m_exit_flag.IsSet())
+  while (m_pending_work_count.load() != 0)
   {
-    m_worker_thread_wake.wait(pending_lock);
-
-    while (!m_pending_work.empty() && !m_exit_flag.IsSet())
+    // Ties go to our own queue, so work is only stolen when it's more urgent.
+    size_t best_queue = queue_index;
+    u32 best_priority = m_work_queues[queue_index]->first_priority.load();
+    for (size_t i = 0; i < m_work_queues.size(); i++)
     {
-      m_busy_workers++;
-      auto iter = m_pending_work.begin();
-      WorkItemPtr item(std::move(iter->second));
-      m_pending_work.erase(iter);
-      pending_lock.unlock();
-
-      if (item->Compile())
+      const u32 priority = m_work_queues[i]->first_priority.load();
+      if (priority < best_priority)
       {
-        std::lock_guard<std::mutex> completed_guard(m_completed_work_lock);
-        m_completed_work.push_back(std::move(item));
+        best_queue = i;
+        best_priority = priority;
       }
+    }
+
+    // Another worker is about to finish taking the last work item.
+    if (best_priority == NO_WORK)
+      return std::nullopt;
+
+    WorkQueue& queue = *m_work_queues[best_queue];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    if (queue.items.empty())
+      continue;
+
+    const auto iter = queue.items.begin();
+    PendingWorkItem work = std::move(iter->second);
+    queue.item_ids.erase(work.id);
+    queue.items.erase(iter);
+    queue.UpdateFirstPriority();
+
+    // Count the worker as busy first, so that HasPendingWork() doesn't see a gap.
+    m_busy_workers++;
+    m_pending_work_count--;
 
-      pending_lock.lock();
-      m_busy_workers--;
+    *stolen = best_queue != queue_index;
+    return work;
+  }
+
+  return std::nullopt;
+}
+
+void AsyncShaderCompiler::WorkerThreadRun(size_t queue_index)
+{
+  while (!m_exit_flag.IsSet())
+  {
+    bool stolen = false;
+    std::optional<PendingWorkItem> work = TakeWorkItem(queue_index, &stolen);
+    if (!work)
+    {
+      std::unique_lock<std::mutex> wake_lock(m_worker_thread_wake_lock);
+      m_worker_thread_wake.wait(wake_lock, [this] {
+        return m_exit_flag.IsSet() || m_pending_work_count.load() != 0;
+      });
+      continue;
     }
+
+    const u64 start_time_us = Common::Timer::NowUs();
+    const bool compiled = work->item->Compile();
+    const u64 end_time_us = Common::Timer::NowUs();
+
+    if (compiled)
+    {
+      std::lock_guard<std::mutex> completed_guard(m_completed_work_lock);
+      m_completed_work.push_back(std::move(work->item));
+    }
+
+    {
+      std::lock_guard<std::mutex> metrics_guard(m_metrics_lock);
+      if (compiled)
+        m_metrics.compiled++;
+      else
+        m_metrics.failed++;
+      m_metrics.stolen += stolen;
+      m_metrics.wait_time[GetHistogramBucket(start_time_us - work->queue_time_us)]++;
+      m_metrics.compile_time[GetHistogramBucket(end_time_us - start_time_us)]++;
+    }
+
+    m_busy_workers--;
   }
 }
 
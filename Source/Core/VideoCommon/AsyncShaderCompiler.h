@@ -3,14 +3,18 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <functional>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -29,10 +33,39 @@ public:
     virtual ~WorkItem() = default;
     virtual bool Compile() = 0;
     virtual void Retrieve() = 0;
+
+    // Called on the main thread instead of Compile() and Retrieve() if the work item was
+    // cancelled before it started compiling.
+    virtual void Cancel() {}
   };
 
   using WorkItemPtr = std::unique_ptr<WorkItem>;
 
+  // Identifies a queued work item, to promote or cancel it later.
+  using WorkItemID = u64;
+  // Returned for work items that were compiled right away, because there are no worker threads.
+  static constexpr WorkItemID INVALID_WORK_ITEM_ID = 0;
+
+  struct Metrics
+  {
+    // Bucket 0 counts work items that took less than 1 ms, bucket i those that took less than
+    // 2^i ms, and the last bucket all of the ones that took longer.
+    static constexpr size_t HISTOGRAM_BUCKETS = 12;
+    using Histogram = std::array<u32, HISTOGRAM_BUCKETS>;
+
+    size_t queue_depth = 0;
+    u64 compiled = 0;
+    // Work items whose Compile() returned false. These aren't counted as compiled.
+    u64 failed = 0;
+    u64 promoted = 0;
+    u64 cancelled = 0;
+    // Work items compiled by a worker other than the one they were queued to.
+    u64 stolen = 0;
+    // Time from queueing a work item until it started compiling.
+    Histogram wait_time{};
+    Histogram compile_time{};
+  };
+
   AsyncShaderCompiler();
   virtual ~AsyncShaderCompiler();
 
@@ -44,7 +77,13 @@ public:
 
   // Queues a new work item to the compiler threads. The lower the priority, the sooner
   // this work item will be compiled, relative to the other work items.
-  void QueueWorkItem(WorkItemPtr item, u32 priority);
+  WorkItemID QueueWorkItem(WorkItemPtr item, u32 priority);
+  // Moves a work item that hasn't started compiling yet up to the given priority, if it's
+  // currently queued with a later one.
+  void PromoteWorkItem(WorkItemID id, u32 priority);
+  // Removes a work item that hasn't started compiling yet from the queue. Its Cancel() method is
+  // called by the next RetrieveWorkItems(). Returns false if the work item has already started.
+  bool CancelWorkItem(WorkItemID id);
   void RetrieveWorkItems();
   bool HasPendingWork();
   bool HasCompletedWork();
@@ -53,6 +92,8 @@ public:
   // Returns false if interrupted.
   bool WaitUntilCompletion(const std::function<void(size_t, size_t)>& progress_callback);
 
+  Metrics GetMetrics() const;
+
   // Needed because of calling virtual methods in shutdown procedure.
   bool StartWorkerThreads(u32 num_worker_threads);
   bool ResizeWorkerThreads(u32 num_worker_threads);
@@ -65,8 +106,39 @@ protected:
   virtual void WorkerThreadExit(void* param);
 
 private:
-  void WorkerThreadEntryPoint(void* param);
-  void WorkerThreadRun();
+  static constexpr u32 NO_WORK = std::numeric_limits<u32>::max();
+
+  struct PendingWorkItem
+  {
+    WorkItemID id;
+    WorkItemPtr item;
+    u64 queue_time_us;
+  };
+
+  // Every worker thread has a queue of its own, and new work items are spread across them. Workers
+  // take the most urgent work item of all queues, preferring their own one, so a worker that runs
+  // out of work steals from the others instead of waiting for a shared lock.
+  struct WorkQueue
+  {
+    using ItemMap = std::multimap<u32, PendingWorkItem>;
+
+    void UpdateFirstPriority()
+    {
+      first_priority.store(items.empty() ? NO_WORK : items.begin()->first);
+    }
+
+    std::mutex lock;
+    // A multimap is used to store the work items. We can't use a priority_queue here, because
+    // there's no way to obtain a non-const reference, which we need for the unique_ptr.
+    ItemMap items;
+    std::unordered_map<WorkItemID, ItemMap::iterator> item_ids;
+    // The priority of the first item, so that workers can compare queues without locking them.
+    std::atomic<u32> first_priority{NO_WORK};
+  };
+
+  void WorkerThreadEntryPoint(void* param, size_t queue_index);
+  void WorkerThreadRun(size_t queue_index);
+  std::optional<PendingWorkItem> TakeWorkItem(size_t queue_index, bool* stolen);
 
   Common::Flag m_exit_flag;
   Common::Event m_init_event;
@@ -74,15 +146,22 @@ private:
   std::vector<std::thread> m_worker_threads;
   std::atomic_bool m_worker_thread_start_result{false};
 
-  // A multimap is used to store the work items. We can't use a priority_queue here, because
-  // there's no way to obtain a non-const reference, which we need for the unique_ptr.
-  std::multimap<u32, WorkItemPtr> m_pending_work;
-  std::mutex m_pending_work_lock;
-  std::condition_variable m_worker_thread_wake;
+  // There are as many queues as the most worker threads there have been, so that work queued
+  // before the worker threads were resized isn't lost. Only modified without worker threads.
+  std::vector<std::unique_ptr<WorkQueue>> m_work_queues;
+  size_t m_next_work_queue = 0;
+  WorkItemID m_next_work_item_id = 1;
+  std::atomic_size_t m_pending_work_count{0};
   std::atomic_size_t m_busy_workers{0};
+  std::mutex m_worker_thread_wake_lock;
+  std::condition_variable m_worker_thread_wake;
 
   std::deque<WorkItemPtr> m_completed_work;
+  std::vector<WorkItemPtr> m_cancelled_work;
   std::mutex m_completed_work_lock;
+
+  Metrics m_metrics;
+  mutable std::mutex m_metrics_lock;
 };
 
 }  // namespace VideoCommon
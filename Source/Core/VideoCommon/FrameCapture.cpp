@@ -0,0 +1,198 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/FrameCapture.h"
+
+#include <cstring>
+
+#include <xxhash.h>
+#include <zstd.h>
+
+#include "Common/Logging/Log.h"
+
+namespace FrameCapture
+{
+Writer::Writer() = default;
+
+Writer::~Writer()
+{
+  Close();
+  ZSTD_freeCCtx(m_compression_context);
+}
+
+bool Writer::Open(const std::string& path, int compression_level)
+{
+  Close();
+
+  if (!m_compression_context)
+    m_compression_context = ZSTD_createCCtx();
+  if (!m_compression_context ||
+      ZSTD_isError(ZSTD_CCtx_setParameter(m_compression_context, ZSTD_c_compressionLevel,
+                                          compression_level)))
+  {
+    ERROR_LOG_FMT(FRAMEDUMP, "Could not set up zstd compression");
+    return false;
+  }
+
+  if (!m_file.Open(path, "wb"))
+  {
+    ERROR_LOG_FMT(FRAMEDUMP, "Could not open {} for writing", path);
+    return false;
+  }
+
+  // The header is written again with the index offset once the capture is closed.
+  const FrameCaptureHeader header{MAGIC, VERSION, 0, 0, 0};
+  if (!m_file.WriteArray(&header, 1))
+  {
+    m_file.Close();
+    return false;
+  }
+
+  m_index.clear();
+  return true;
+}
+
+bool Writer::AddFrame(const u8* data, u32 width, u32 height, u32 stride, u64 ticks,
+                      s32 frame_number)
+{
+  if (!IsOpen())
+    return false;
+
+  // Drop any padding at the end of the rows, so that captures from different backends match.
+  const u32 row_size = width * 4;
+  const u8* pixels = data;
+  if (stride != row_size)
+  {
+    m_pixels.resize(size_t{row_size} * height);
+    for (u32 y = 0; y < height; ++y)
+      std::memcpy(&m_pixels[size_t{y} * row_size], data + size_t{y} * stride, row_size);
+    pixels = m_pixels.data();
+  }
+  const size_t size = size_t{row_size} * height;
+
+  m_compressed.resize(ZSTD_compressBound(size));
+  const size_t compressed_size =
+      ZSTD_compress2(m_compression_context, m_compressed.data(), m_compressed.size(), pixels, size);
+  if (ZSTD_isError(compressed_size))
+  {
+    ERROR_LOG_FMT(FRAMEDUMP, "Could not compress frame: {}", ZSTD_getErrorName(compressed_size));
+    return false;
+  }
+
+  FrameCaptureIndexEntry entry;
+  entry.data_offset = m_file.Tell();
+  entry.ticks = ticks;
+  entry.hash = XXH64(pixels, size, 0);
+  entry.compressed_size = static_cast<u32>(compressed_size);
+  entry.width = width;
+  entry.height = height;
+  entry.frame_number = frame_number;
+
+  if (!m_file.WriteBytes(m_compressed.data(), compressed_size))
+  {
+    ERROR_LOG_FMT(FRAMEDUMP, "Could not write frame");
+    return false;
+  }
+
+  m_index.push_back(entry);
+  return true;
+}
+
+bool Writer::Close()
+{
+  if (!IsOpen())
+    return true;
+
+  const FrameCaptureHeader header{MAGIC, VERSION, GetFrameCount(), 0, m_file.Tell()};
+  const bool success = m_file.WriteArray(m_index.data(), m_index.size()) &&
+                       m_file.Seek(0, File::SeekOrigin::Begin) && m_file.WriteArray(&header, 1);
+  m_file.Close();
+
+  if (!success)
+    ERROR_LOG_FMT(FRAMEDUMP, "Could not write frame capture index");
+  return success;
+}
+
+Reader::Reader() = default;
+
+Reader::~Reader()
+{
+  ZSTD_freeDCtx(m_decompression_context);
+}
+
+bool Reader::Open(const std::string& path)
+{
+  m_index.clear();
+
+  if (!m_file.Open(path, "rb"))
+    return false;
+
+  FrameCaptureHeader header;
+  if (!m_file.ReadArray(&header, 1) || header.magic != MAGIC || header.version != VERSION)
+    return false;
+
+  // A capture that was never closed has no index.
+  if (header.index_offset == 0)
+    return false;
+
+  // The index is at the end of the file, after the frames.
+  const u64 file_size = m_file.GetSize();
+  if (header.index_offset < sizeof(header) || header.index_offset > file_size ||
+      header.frame_count > (file_size - header.index_offset) / sizeof(FrameCaptureIndexEntry))
+  {
+    ERROR_LOG_FMT(FRAMEDUMP, "The index of {} is out of bounds", path);
+    return false;
+  }
+
+  m_index.resize(header.frame_count);
+  if (!m_file.Seek(header.index_offset, File::SeekOrigin::Begin) ||
+      !m_file.ReadArray(m_index.data(), m_index.size()))
+  {
+    m_index.clear();
+    return false;
+  }
+
+  for (const FrameCaptureIndexEntry& entry : m_index)
+  {
+    if (entry.data_offset < sizeof(header) || entry.data_offset > header.index_offset ||
+        entry.compressed_size > header.index_offset - entry.data_offset)
+    {
+      ERROR_LOG_FMT(FRAMEDUMP, "A frame of {} is out of bounds", path);
+      m_index.clear();
+      return false;
+    }
+  }
+
+  if (!m_decompression_context)
+    m_decompression_context = ZSTD_createDCtx();
+  return m_decompression_context != nullptr;
+}
+
+bool Reader::ReadFrame(u32 index, std::vector<u8>* pixels)
+{
+  if (index >= m_index.size())
+    return false;
+  const FrameCaptureIndexEntry& entry = m_index[index];
+
+  m_compressed.resize(entry.compressed_size);
+  if (!m_file.Seek(entry.data_offset, File::SeekOrigin::Begin) ||
+      !m_file.ReadBytes(m_compressed.data(), m_compressed.size()))
+  {
+    return false;
+  }
+
+  // The dimensions have to match the size the frame decompresses to before anything is allocated
+  // for it. This also rejects frames whose size is unknown or which aren't zstd frames at all.
+  const u64 content_size = ZSTD_getFrameContentSize(m_compressed.data(), m_compressed.size());
+  if (content_size % 4 != 0 || u64{entry.width} * entry.height != content_size / 4)
+    return false;
+
+  pixels->resize(content_size);
+  const size_t size = ZSTD_decompressDCtx(m_decompression_context, pixels->data(), pixels->size(),
+                                          m_compressed.data(), m_compressed.size());
+  if (ZSTD_isError(size) || size != pixels->size())
+    return false;
+
+  return XXH64(pixels->data(), pixels->size(), 0) == entry.hash;
+}
+}  // namespace FrameCapture
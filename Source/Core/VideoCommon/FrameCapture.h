@@ -0,0 +1,104 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <zstd.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/IOFile.h"
+
+// Frame captures (.dfc) are a lossless frame dump format that is cheap to write and to compare,
+// meant for recording the output of regression tests. Every frame is stored as zstd compressed,
+// tightly packed RGBA8 pixels. The file ends with an index of all frames, which also holds a hash
+// of every frame so that identical frames can be skipped without decompressing them.
+//
+// File layout:
+//   FrameCaptureHeader
+//   Compressed frame data, in order
+//   FrameCaptureIndexEntry for every frame, at header.index_offset
+
+namespace FrameCapture
+{
+constexpr u32 MAGIC = 0x50434644;  // "DFCP" (byteswapped to little endian)
+constexpr u32 VERSION = 1;
+
+#pragma pack(push, 1)
+struct FrameCaptureHeader
+{
+  u32 magic;
+  u32 version;
+  u32 frame_count;
+  u32 reserved;
+  u64 index_offset;  // Zero if the capture wasn't closed properly
+};
+static_assert(sizeof(FrameCaptureHeader) == 0x18, "Wrong size for frame capture header");
+
+struct FrameCaptureIndexEntry
+{
+  u64 data_offset;
+  u64 ticks;
+  u64 hash;  // XXH64 of the uncompressed pixels
+  u32 compressed_size;
+  u32 width;
+  u32 height;
+  s32 frame_number;
+};
+static_assert(sizeof(FrameCaptureIndexEntry) == 0x28, "Wrong size for frame capture index entry");
+#pragma pack(pop)
+
+class Writer
+{
+public:
+  Writer();
+  ~Writer();
+
+  Writer(const Writer&) = delete;
+  Writer& operator=(const Writer&) = delete;
+
+  bool Open(const std::string& path, int compression_level = 1);
+  bool IsOpen() const { return m_file.IsOpen(); }
+
+  // Compresses and appends a frame of RGBA8 pixels. stride is the distance between rows in bytes.
+  bool AddFrame(const u8* data, u32 width, u32 height, u32 stride, u64 ticks, s32 frame_number);
+
+  // Writes the index. The capture can't be read without it.
+  bool Close();
+
+  u32 GetFrameCount() const { return static_cast<u32>(m_index.size()); }
+
+private:
+  File::IOFile m_file;
+  std::vector<FrameCaptureIndexEntry> m_index;
+  std::vector<u8> m_pixels;
+  std::vector<u8> m_compressed;
+  ZSTD_CCtx* m_compression_context = nullptr;
+};
+
+class Reader
+{
+public:
+  Reader();
+  ~Reader();
+
+  Reader(const Reader&) = delete;
+  Reader& operator=(const Reader&) = delete;
+
+  bool Open(const std::string& path);
+
+  u32 GetFrameCount() const { return static_cast<u32>(m_index.size()); }
+  const FrameCaptureIndexEntry& GetFrame(u32 index) const { return m_index[index]; }
+
+  // Decompresses a frame to tightly packed RGBA8 pixels, and checks it against its hash.
+  bool ReadFrame(u32 index, std::vector<u8>* pixels);
+
+private:
+  File::IOFile m_file;
+  std::vector<FrameCaptureIndexEntry> m_index;
+  std::vector<u8> m_compressed;
+  ZSTD_DCtx* m_decompression_context = nullptr;
+};
+}  // namespace FrameCapture
@@ -7,6 +7,7 @@
 #define __STDC_CONSTANT_MACROS 1
 #endif
 
+#include <algorithm>
 #include <array>
 #include <sstream>
 #include <string>
@@ -265,6 +266,11 @@ bool FFMpegFrameDump::CreateVideoFile()
   m_context->codec->gop_size = 1;
   m_context->codec->level = 1;
 
+  // Let the encoder use several threads, so that it keeps up with the emulator. Frame threading
+  // adds latency, which doesn't matter here since the frames are written to a file.
+  m_context->codec->thread_count = std::max(g_Config.iDumpEncoderThreads, 0);
+  m_context->codec->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
   AVPixelFormat pix_fmt = AV_PIX_FMT_NONE;
 
   const std::string& pixel_format_string = g_Config.sDumpPixelFormat;
@@ -299,6 +305,8 @@ bool FFMpegFrameDump::CreateVideoFile()
     return false;
   }
 
+  INFO_LOG_FMT(FRAMEDUMP, "Encoding with {} threads", m_context->codec->thread_count);
+
   m_context->src_frame = av_frame_alloc();
   m_context->scaled_frame = av_frame_alloc();
 
@@ -3,12 +3,20 @@
 
 #include "VideoCommon/FrameDumper.h"
 
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
 #include "Common/Assert.h"
 #include "Common/FileUtil.h"
 #include "Common/Image.h"
 
 #include "Core/Config/GraphicsSettings.h"
 #include "Core/Config/MainSettings.h"
+#include "Core/ConfigManager.h"
 
 #include "VideoCommon/AbstractFramebuffer.h"
 #include "VideoCommon/AbstractGfx.h"
@@ -44,6 +52,8 @@ void FrameDumper::DumpCurrentFrame(const AbstractTexture* src_texture,
                                    const MathUtil::Rectangle<int>& target_rect, u64 ticks,
                                    int frame_number)
 {
+  const auto start_time = std::chrono::steady_clock::now();
+
   int source_width = src_rect.GetWidth();
   int source_height = src_rect.GetHeight();
   int target_width = target_rect.GetWidth();
@@ -62,13 +72,16 @@ void FrameDumper::DumpCurrentFrame(const AbstractTexture* src_texture,
     copy_rect = src_texture->GetRect();
   }
 
-  if (!CheckFrameDumpReadbackTexture(target_width, target_height))
+  ReadbackTexture* readback = GetNextReadbackTexture(target_width, target_height);
+  if (!readback)
     return;
 
-  m_frame_dump_readback_texture->CopyFromTexture(src_texture, copy_rect, 0, 0,
-                                                 m_frame_dump_readback_texture->GetRect());
-  m_last_frame_state = m_ffmpeg_dump.FetchState(ticks, frame_number);
-  m_frame_dump_needs_flush = true;
+  readback->texture->CopyFromTexture(src_texture, copy_rect, 0, 0, readback->texture->GetRect());
+  readback->state = m_ffmpeg_dump.FetchState(ticks, frame_number);
+  readback->needs_flush = true;
+  m_next_readback_texture = (m_next_readback_texture + 1) % READBACK_TEXTURE_COUNT;
+
+  m_statistics.video_thread_time += std::chrono::steady_clock::now() - start_time;
 }
 
 bool FrameDumper::CheckFrameDumpRenderTexture(u32 target_width, u32 target_height)
@@ -99,11 +112,36 @@ bool FrameDumper::CheckFrameDumpRenderTexture(u32 target_width, u32 target_heigh
   return true;
 }
 
-bool FrameDumper::CheckFrameDumpReadbackTexture(u32 target_width, u32 target_height)
+FrameDumper::ReadbackTexture* FrameDumper::GetNextReadbackTexture(u32 target_width,
+                                                                  u32 target_height)
 {
-  std::unique_ptr<AbstractStagingTexture>& rbtex = m_frame_dump_readback_texture;
+  ReadbackTexture& readback = m_readback_textures[m_next_readback_texture];
+
+  // The next texture is the oldest one. If the ring is full of frames the GPU hasn't finished
+  // copying yet, pass this one on anyway.
+  if (readback.needs_flush)
+  {
+    ++m_statistics.forced_readbacks;
+    QueueReadbackTexture(&readback);
+  }
+
+  if (readback.mapped)
+  {
+    if (m_frames_processed.load(std::memory_order_acquire) < readback.sequence)
+    {
+      // The encoder is falling behind, so we have to wait for it.
+      const auto stall_start = std::chrono::steady_clock::now();
+      WaitForProcessedFrames(readback.sequence);
+      ++m_statistics.encoder_stalls;
+      m_statistics.encoder_stall_time += std::chrono::steady_clock::now() - stall_start;
+    }
+    readback.texture->Unmap();
+    readback.mapped = false;
+  }
+
+  std::unique_ptr<AbstractStagingTexture>& rbtex = readback.texture;
   if (rbtex && rbtex->GetWidth() == target_width && rbtex->GetHeight() == target_height)
-    return true;
+    return &readback;
 
   rbtex.reset();
   rbtex = g_gfx->CreateStagingTexture(StagingTextureType::Readback,
@@ -111,51 +149,70 @@ bool FrameDumper::CheckFrameDumpReadbackTexture(u32 target_width, u32 target_hei
                                                     AbstractTextureFormat::RGBA8, 0,
                                                     AbstractTextureType::Texture_2DArray));
   if (!rbtex)
-    return false;
+    return nullptr;
 
-  return true;
+  return &readback;
 }
 
 void FrameDumper::FlushFrameDump()
 {
-  if (!m_frame_dump_needs_flush)
-    return;
-
-  // Ensure dumping thread is done with output texture before swapping.
-  FinishFrameData();
+  const auto start_time = std::chrono::steady_clock::now();
+  QueueReadbackTextures(false);
+  m_statistics.video_thread_time += std::chrono::steady_clock::now() - start_time;
 
-  std::swap(m_frame_dump_output_texture, m_frame_dump_readback_texture);
+  // Shutdown frame dumping if it is no longer active.
+  if (!IsFrameDumping())
+    ShutdownFrameDumping();
+}
 
-  // Queue encoding of the last frame dumped.
-  auto& output = m_frame_dump_output_texture;
-  output->Flush();
-  if (output->Map())
+void FrameDumper::QueueReadbackTextures(bool force)
+{
+  for (u32 i = 0; i < READBACK_TEXTURE_COUNT; ++i)
   {
-    DumpFrameData(reinterpret_cast<u8*>(output->GetMappedPointer()), output->GetConfig().width,
-                  output->GetConfig().height, static_cast<int>(output->GetMappedStride()));
+    ReadbackTexture& readback =
+        m_readback_textures[(m_next_readback_texture + i) % READBACK_TEXTURE_COUNT];
+    if (!readback.needs_flush)
+      continue;
+
+    // Frames have to be encoded in order, so stop at the first one that isn't ready.
+    if (!force && !readback.texture->IsCopyComplete())
+      break;
+
+    QueueReadbackTexture(&readback);
   }
-  else
+}
+
+void FrameDumper::QueueReadbackTexture(ReadbackTexture* readback)
+{
+  AbstractStagingTexture* texture = readback->texture.get();
+  texture->Flush();
+  readback->needs_flush = false;
+  if (!texture->Map())
   {
     ERROR_LOG_FMT(VIDEO, "Failed to map texture for dumping.");
+    return;
   }
 
-  m_frame_dump_needs_flush = false;
-
-  // Shutdown frame dumping if it is no longer active.
-  if (!IsFrameDumping())
-    ShutdownFrameDumping();
+  DumpFrameData(reinterpret_cast<u8*>(texture->GetMappedPointer()), texture->GetConfig().width,
+                texture->GetConfig().height, static_cast<int>(texture->GetMappedStride()),
+                readback->state);
+  readback->mapped = true;
+  readback->sequence = m_frames_queued;
 }
 
 void FrameDumper::ShutdownFrameDumping()
 {
-  // Ensure the last queued readback has been sent to the encoder.
-  FlushFrameDump();
+  // Ensure all copied frames have been sent to the encoder.
+  QueueReadbackTextures(true);
 
   if (!m_frame_dump_thread_running.IsSet())
+  {
+    m_statistics = {};
     return;
+  }
 
-  // Ensure previous frame has been encoded.
-  FinishFrameData();
+  // Ensure all queued frames have been encoded.
+  WaitForProcessedFrames(m_frames_queued);
 
   // Wake thread up, and wait for it to exit.
   m_frame_dump_thread_running.Clear();
@@ -165,14 +222,20 @@ void FrameDumper::ShutdownFrameDumping()
   m_frame_dump_render_framebuffer.reset();
   m_frame_dump_render_texture.reset();
 
-  m_frame_dump_readback_texture.reset();
-  m_frame_dump_output_texture.reset();
+  for (ReadbackTexture& readback : m_readback_textures)
+  {
+    if (readback.mapped)
+      readback.texture->Unmap();
+    readback = {};
+  }
+  m_next_readback_texture = 0;
+
+  LogStatistics();
+  m_statistics = {};
 }
 
-void FrameDumper::DumpFrameData(const u8* data, int w, int h, int stride)
+void FrameDumper::DumpFrameData(const u8* data, int w, int h, int stride, const FrameState& state)
 {
-  m_frame_dump_data = FrameData{data, w, h, stride, m_last_frame_state};
-
   if (!m_frame_dump_thread_running.IsSet())
   {
     if (m_frame_dump_thread.joinable())
@@ -181,27 +244,50 @@ void FrameDumper::DumpFrameData(const u8* data, int w, int h, int stride)
     m_frame_dump_thread = std::thread(&FrameDumper::FrameDumpThreadFunc, this);
   }
 
+  // The queue can't overflow, since it holds at most one frame per readback texture.
+  const FrameData frame{data, w, h, stride, state};
+  const size_t pushed = m_frame_dump_queue.Push(&frame, 1);
+  ASSERT(pushed == 1);
+  ++m_frames_queued;
+  ++m_statistics.frames;
+  m_statistics.max_queued_frames =
+      std::max(m_statistics.max_queued_frames,
+               m_frames_queued - m_frames_processed.load(std::memory_order_acquire));
+
   // Wake worker thread up.
   m_frame_dump_start.Set();
-  m_frame_dump_frame_running = true;
 }
 
-void FrameDumper::FinishFrameData()
+void FrameDumper::WaitForProcessedFrames(u64 count)
 {
-  if (!m_frame_dump_frame_running)
-    return;
+  while (m_frames_processed.load(std::memory_order_acquire) < count)
+    m_frame_dump_done.Wait();
+}
 
-  m_frame_dump_done.Wait();
-  m_frame_dump_frame_running = false;
+void FrameDumper::LogStatistics() const
+{
+  if (m_statistics.frames == 0)
+    return;
 
-  m_frame_dump_output_texture->Unmap();
+  using Milliseconds = std::chrono::duration<double, std::milli>;
+  const double frames = static_cast<double>(m_statistics.frames);
+  NOTICE_LOG_FMT(
+      VIDEO,
+      "Frame dump: {} frames, {:.3f} ms per frame on the video thread, {:.3f} ms per frame "
+      "encoding. Waited for the encoder {} times ({:.1f} ms in total), read back {} frames "
+      "before the GPU was done with them, up to {} frames were queued.",
+      m_statistics.frames, Milliseconds(m_statistics.video_thread_time).count() / frames,
+      Milliseconds(m_statistics.encode_time).count() / frames, m_statistics.encoder_stalls,
+      Milliseconds(m_statistics.encoder_stall_time).count(), m_statistics.forced_readbacks,
+      m_statistics.max_queued_frames);
 }
 
 void FrameDumper::FrameDumpThreadFunc()
 {
   Common::SetCurrentThreadName("FrameDumping");
 
-  bool dump_to_ffmpeg = !g_ActiveConfig.bDumpFramesAsImages;
+  const bool dump_to_capture = g_ActiveConfig.bDumpFramesAsCapture;
+  bool dump_to_ffmpeg = !dump_to_capture && !g_ActiveConfig.bDumpFramesAsImages;
   bool frame_dump_started = false;
 
 // If Dolphin was compiled without ffmpeg, we only support dumping to images.
@@ -220,52 +306,66 @@ void FrameDumper::FrameDumpThreadFunc()
     if (!m_frame_dump_thread_running.IsSet())
       break;
 
-    auto frame = m_frame_dump_data;
-
-    // Save screenshot
-    if (m_screenshot_request.TestAndClear())
+    FrameData frame;
+    while (m_frame_dump_queue.Pop(&frame, 1) != 0)
     {
-      std::lock_guard<std::mutex> lk(m_screenshot_lock);
-
-      if (DumpFrameToPNG(frame, m_screenshot_name))
-        OSD::AddMessage("Screenshot saved to " + m_screenshot_name);
-
-      // Reset settings
-      m_screenshot_name.clear();
-      m_screenshot_completed.Set();
-    }
+      const auto start_time = std::chrono::steady_clock::now();
 
-    if (Config::Get(Config::MAIN_MOVIE_DUMP_FRAMES))
-    {
-      if (!frame_dump_started)
+      // Save screenshot
+      if (m_screenshot_request.TestAndClear())
       {
-        if (dump_to_ffmpeg)
-          frame_dump_started = StartFrameDumpToFFMPEG(frame);
-        else
-          frame_dump_started = StartFrameDumpToImage(frame);
+        std::lock_guard<std::mutex> lk(m_screenshot_lock);
 
-        // Stop frame dumping if we fail to start.
-        if (!frame_dump_started)
-          Config::SetCurrent(Config::MAIN_MOVIE_DUMP_FRAMES, false);
+        if (DumpFrameToPNG(frame, m_screenshot_name))
+          OSD::AddMessage("Screenshot saved to " + m_screenshot_name);
+
+        // Reset settings
+        m_screenshot_name.clear();
+        m_screenshot_completed.Set();
       }
 
-      // If we failed to start frame dumping, don't write a frame.
-      if (frame_dump_started)
+      if (Config::Get(Config::MAIN_MOVIE_DUMP_FRAMES))
       {
-        if (dump_to_ffmpeg)
-          DumpFrameToFFMPEG(frame);
-        else
-          DumpFrameToImage(frame);
+        if (!frame_dump_started)
+        {
+          if (dump_to_capture)
+            frame_dump_started = StartFrameDumpToCapture(frame);
+          else if (dump_to_ffmpeg)
+            frame_dump_started = StartFrameDumpToFFMPEG(frame);
+          else
+            frame_dump_started = StartFrameDumpToImage(frame);
+
+          // Stop frame dumping if we fail to start.
+          if (!frame_dump_started)
+            Config::SetCurrent(Config::MAIN_MOVIE_DUMP_FRAMES, false);
+        }
+
+        // If we failed to start frame dumping, don't write a frame.
+        if (frame_dump_started)
+        {
+          if (dump_to_capture)
+            DumpFrameToCapture(frame);
+          else if (dump_to_ffmpeg)
+            DumpFrameToFFMPEG(frame);
+          else
+            DumpFrameToImage(frame);
+        }
       }
-    }
 
-    m_frame_dump_done.Set();
+      m_statistics.encode_time += std::chrono::steady_clock::now() - start_time;
+
+      // Lets the video thread reuse the readback texture.
+      m_frames_processed.fetch_add(1, std::memory_order_release);
+      m_frame_dump_done.Set();
+    }
   }
 
   if (frame_dump_started)
   {
     // No additional cleanup is needed when dumping to images.
-    if (dump_to_ffmpeg)
+    if (dump_to_capture)
+      StopFrameDumpToCapture();
+    else if (dump_to_ffmpeg)
       StopFrameDumpToFFMPEG();
   }
 }
@@ -339,6 +439,45 @@ void FrameDumper::DumpFrameToImage(const FrameData& frame)
   m_frame_dump_image_counter++;
 }
 
+bool FrameDumper::StartFrameDumpToCapture(const FrameData&)
+{
+  std::string path = g_ActiveConfig.sDumpPath;
+  if (path.empty())
+  {
+    path = fmt::format("{}{}_{:%Y-%m-%d_%H-%M-%S}.dfc", File::GetUserPath(D_DUMPFRAMES_IDX),
+                       SConfig::GetInstance().GetGameID(), fmt::localtime(std::time(nullptr)));
+  }
+
+  if (File::Exists(path) && !Config::Get(Config::MAIN_MOVIE_DUMP_FRAMES_SILENT) &&
+      !AskYesNoFmtT("Delete the existing file '{0}'?", path))
+  {
+    return false;
+  }
+
+  File::CreateFullPath(path);
+  if (!m_frame_capture.Open(path))
+  {
+    OSD::AddMessage("FrameDump Start failed");
+    return false;
+  }
+
+  OSD::AddMessage(fmt::format("Capturing frames to \"{}\"", path));
+  return true;
+}
+
+void FrameDumper::DumpFrameToCapture(const FrameData& frame)
+{
+  m_frame_capture.AddFrame(frame.data, frame.width, frame.height, frame.stride, frame.state.ticks,
+                           frame.state.frame_number);
+}
+
+void FrameDumper::StopFrameDumpToCapture()
+{
+  const u32 frame_count = m_frame_capture.GetFrameCount();
+  if (m_frame_capture.Close())
+    OSD::AddMessage(fmt::format("Stopped capturing frames ({} frames)", frame_count));
+}
+
 void FrameDumper::SaveScreenshot(std::string filename)
 {
   std::lock_guard<std::mutex> lk(m_screenshot_lock);
@@ -359,7 +498,8 @@ bool FrameDumper::IsFrameDumping() const
 
 int FrameDumper::GetRequiredResolutionLeastCommonMultiple() const
 {
-  if (Config::Get(Config::MAIN_MOVIE_DUMP_FRAMES))
+  // Frame captures are kept at the original resolution, so that they can be compared exactly.
+  if (Config::Get(Config::MAIN_MOVIE_DUMP_FRAMES) && !g_ActiveConfig.bDumpFramesAsCapture)
     return VIDEO_ENCODER_LCM;
   return 1;
 }
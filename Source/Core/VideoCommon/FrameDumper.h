@@ -3,12 +3,22 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
 #include "Common/Flag.h"
 #include "Common/MathUtil.h"
+#include "Common/SPSCQueue.h"
 #include "Common/Thread.h"
 
+#include "VideoCommon/FrameCapture.h"
 #include "VideoCommon/FrameDumpFFMpeg.h"
 #include "VideoCommon/VideoEvents.h"
 
@@ -22,10 +32,10 @@ public:
   FrameDumper();
   ~FrameDumper();
 
-  // Ensures all rendered frames are queued for encoding.
+  // Queues the frames whose readback has completed for encoding. Called after every frame.
   void FlushFrameDump();
 
-  // Fills the frame dump staging texture with the current XFB texture.
+  // Copies the current XFB texture to the next frame dump staging texture.
   void DumpCurrentFrame(const AbstractTexture* src_texture,
                         const MathUtil::Rectangle<int>& src_rect,
                         const MathUtil::Rectangle<int>& target_rect, u64 ticks, int frame_number);
@@ -38,6 +48,22 @@ public:
   void DoState(PointerWrap& p);
 
 private:
+  // Number of frames which can be in flight between the GPU copy and the encoder.
+  static constexpr u32 READBACK_TEXTURE_COUNT = 4;
+
+  struct ReadbackTexture
+  {
+    std::unique_ptr<AbstractStagingTexture> texture;
+    // Emulation state of the frame that was copied to the texture.
+    FrameState state;
+    // Set when the texture holds a frame that hasn't been passed to the dump thread yet.
+    bool needs_flush = false;
+    // Set while the dump thread may read from the texture. It is done with it once
+    // m_frames_processed reaches sequence.
+    bool mapped = false;
+    u64 sequence = 0;
+  };
+
   // NOTE: The methods below are called on the framedumping thread.
   void FrameDumpThreadFunc();
   bool StartFrameDumpToFFMPEG(const FrameData&);
@@ -46,20 +72,31 @@ private:
   std::string GetFrameDumpNextImageFileName() const;
   bool StartFrameDumpToImage(const FrameData&);
   void DumpFrameToImage(const FrameData&);
+  bool StartFrameDumpToCapture(const FrameData&);
+  void DumpFrameToCapture(const FrameData&);
+  void StopFrameDumpToCapture();
 
   void ShutdownFrameDumping();
 
   // Checks that the frame dump render texture exists and is the correct size.
   bool CheckFrameDumpRenderTexture(u32 target_width, u32 target_height);
 
-  // Checks that the frame dump readback texture exists and is the correct size.
-  bool CheckFrameDumpReadbackTexture(u32 target_width, u32 target_height);
+  // Returns the next texture of the ring, once the dump thread is done with it, with the given
+  // size. Returns nullptr if the texture could not be created.
+  ReadbackTexture* GetNextReadbackTexture(u32 target_width, u32 target_height);
+
+  // Passes the frames which have finished copying to the dump thread, oldest first. If force is
+  // set, waits for the GPU instead of stopping at the first frame which isn't ready yet.
+  void QueueReadbackTextures(bool force);
+  void QueueReadbackTexture(ReadbackTexture* readback);
+
+  // Waits until the dump thread has processed the given number of frames.
+  void WaitForProcessedFrames(u64 count);
 
   // Asynchronously encodes the specified pointer of frame data to the frame dump.
-  void DumpFrameData(const u8* data, int w, int h, int stride);
+  void DumpFrameData(const u8* data, int w, int h, int stride, const FrameState& state);
 
-  // Ensures all encoded frames have been written to the output file.
-  void FinishFrameData();
+  void LogStatistics() const;
 
   std::thread m_frame_dump_thread;
   Common::Flag m_frame_dump_thread_running;
@@ -70,28 +107,43 @@ private:
   // Set by frame dump thread on frame completion.
   Common::Event m_frame_dump_done;
 
-  // Holds emulation state during the last swap when dumping.
-  FrameState m_last_frame_state;
-
-  // Communication of frame between video and dump threads.
-  FrameData m_frame_dump_data;
+  // Frames waiting to be processed by the dump thread. They point into mapped readback textures.
+  Common::SPSCRingBuffer<FrameData, READBACK_TEXTURE_COUNT> m_frame_dump_queue;
+  u64 m_frames_queued = 0;
+  std::atomic<u64> m_frames_processed = 0;
 
   // Texture used for screenshot/frame dumping
   std::unique_ptr<AbstractTexture> m_frame_dump_render_texture;
   std::unique_ptr<AbstractFramebuffer> m_frame_dump_render_framebuffer;
 
-  // Double buffer:
-  std::unique_ptr<AbstractStagingTexture> m_frame_dump_readback_texture;
-  std::unique_ptr<AbstractStagingTexture> m_frame_dump_output_texture;
-  // Set when readback texture holds a frame that needs to be dumped.
-  bool m_frame_dump_needs_flush = false;
-  // Set when thread is processing output texture.
-  bool m_frame_dump_frame_running = false;
+  // Ring of readback textures, so that the video thread neither has to wait for the GPU to finish
+  // the copy nor for the encoder to finish the previous frame.
+  std::array<ReadbackTexture, READBACK_TEXTURE_COUNT> m_readback_textures;
+  // Index of the texture the next frame is copied to. This is also the oldest frame in the ring.
+  u32 m_next_readback_texture = 0;
+
+  // Measurements of the cost of frame dumping, logged when it stops.
+  struct Statistics
+  {
+    u64 frames = 0;
+    // Time the video thread spent copying frames and passing them to the dump thread.
+    std::chrono::steady_clock::duration video_thread_time{};
+    // Times the video thread had to wait for the dump thread to free a readback texture.
+    u64 encoder_stalls = 0;
+    std::chrono::steady_clock::duration encoder_stall_time{};
+    // Times a frame had to be passed on before the GPU was known to have finished the copy.
+    u64 forced_readbacks = 0;
+    u64 max_queued_frames = 0;
+    // Only accessed by the dump thread while it is running.
+    std::chrono::steady_clock::duration encode_time{};
+  };
+  Statistics m_statistics;
 
   // Used to generate screenshot names.
   u32 m_frame_dump_image_counter = 0;
 
   FFMpegFrameDump m_ffmpeg_dump;
+  FrameCapture::Writer m_frame_capture;
 
   // Screenshots
   Common::Flag m_screenshot_request;
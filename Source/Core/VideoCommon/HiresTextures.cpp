@@ -102,6 +102,12 @@ void HiresTexture::Update()
 
   auto& system = Core::System::GetInstance();
 
+  s_file_library->SetTextureCacheDirectory(
+      g_ActiveConfig.bHiresTextureDiskCache ?
+          fmt::format("{}" HIRESTEXTURECACHE_DIR DIR_SEP "{}" DIR_SEP,
+                      File::GetUserPath(D_CACHE_IDX), game_id) :
+          "");
+
   for (const auto& texture_directory : texture_directories)
   {
     const auto texture_paths =
@@ -137,7 +143,9 @@ void HiresTexture::Update()
           {
             auto hires_texture = std::make_shared<HiresTexture>(
                 has_arbitrary_mipmaps,
-                system.GetCustomAssetLoader().LoadGameTexture(filename, s_file_library));
+                system.GetCustomAssetLoader().LoadGameTexture(
+                    filename, s_file_library,
+                    VideoCommon::CustomAssetLoader::LoadPriority::Preload));
             s_hires_texture_cache.try_emplace(filename, std::move(hires_texture));
           }
         }
@@ -178,6 +186,9 @@ std::shared_ptr<HiresTexture> HiresTexture::Search(const TextureInfo& texture_in
 
   if (auto iter = s_hires_texture_cache.find(base_filename); iter != s_hires_texture_cache.end())
   {
+    // The texture is needed now, so it shouldn't wait for the other textures being preloaded.
+    if (!iter->second->GetAsset()->GetData())
+      Core::System::GetInstance().GetCustomAssetLoader().PrioritizeAsset(base_filename);
     return iter->second;
   }
   else
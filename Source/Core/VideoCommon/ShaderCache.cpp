@@ -3,6 +3,10 @@
 
 #include "VideoCommon/ShaderCache.h"
 
+#include <algorithm>
+#include <set>
+#include <vector>
+
 #include <fmt/format.h>
 
 #include "Common/Assert.h"
@@ -16,6 +20,8 @@
 #include "VideoCommon/FramebufferManager.h"
 #include "VideoCommon/FramebufferShaderGen.h"
 #include "VideoCommon/Present.h"
+#include "VideoCommon/SpirvCache.h"
+#include "VideoCommon/SpirvCompilerPool.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
@@ -42,6 +48,26 @@ bool ShaderCache::Initialize()
   m_api_type = g_ActiveConfig.backend_info.api_type;
   m_host_config.bits = ShaderHostConfig::GetCurrent().bits;
 
+  // All backends except OpenGL compile shaders through SPIR-V.
+  if (g_ActiveConfig.bShaderCache && g_ActiveConfig.iSharedShaderCacheSize > 0 &&
+      m_api_type != APIType::OpenGL && m_api_type != APIType::Nothing)
+  {
+    auto cache = std::make_shared<SPIRV::SharedCache>();
+    cache->Open(GetDiskShaderCacheFileName(m_api_type, "spirv-shared", false, false, false),
+                static_cast<u64>(g_ActiveConfig.iSharedShaderCacheSize) * 1024 * 1024);
+    SPIRV::SetSharedCache(std::move(cache));
+  }
+
+  const u32 compiler_processes = g_ActiveConfig.GetShaderCompilerProcesses();
+  if (compiler_processes > 0 && m_api_type != APIType::OpenGL && m_api_type != APIType::Nothing)
+  {
+    auto pool = std::make_shared<SPIRV::CompilerPool>();
+    if (pool->Start(SPIRV::GetCompilerWorkerPath(), compiler_processes))
+      SPIRV::SetCompilerPool(std::move(pool));
+    else
+      WARN_LOG_FMT(VIDEO, "No shader compiler processes, compiling shaders in-process");
+  }
+
   if (!CompileSharedPipelines())
     return false;
 
@@ -60,6 +86,18 @@ void ShaderCache::InitializeShaderCache()
   {
     LoadCaches();
     LoadPipelineUIDCache();
+
+    // The UID cache doesn't depend on the Dolphin version, so after an update the pipelines in it
+    // are compiled again below and fill the new shader caches.
+    if (DiscardedStaleCaches())
+    {
+      const auto missing = std::ranges::count_if(
+          m_gx_pipeline_cache, [](const auto& it) { return it.second.first == nullptr; });
+      NOTICE_LOG_FMT(VIDEO,
+                     "Shader caches are from another version of Dolphin, recompiling {} "
+                     "pipelines from the UID cache",
+                     missing);
+    }
   }
 
   // Queue ubershader precompiling if required.
@@ -102,6 +140,12 @@ void ShaderCache::Reload()
 void ShaderCache::RetrieveAsyncShaders()
 {
   m_async_shader_compiler->RetrieveWorkItems();
+
+  m_frame_count++;
+  if (m_frame_count % STALE_PIPELINE_CHECK_INTERVAL == 0)
+    CancelStalePipelineCompiles();
+
+  g_stats.shader_compiler = m_async_shader_compiler->GetMetrics();
 }
 
 void ShaderCache::Shutdown()
@@ -112,6 +156,11 @@ void ShaderCache::Shutdown()
     m_async_shader_compiler->StopWorkerThreads();
 
   ClosePipelineUIDCache();
+
+  // Other compilers, like the one of the custom shader cache, are only stopped later. Shaders they
+  // are still compiling keep their own references to these.
+  SPIRV::SetSharedCache(nullptr);
+  SPIRV::SetCompilerPool(nullptr);
 }
 
 const AbstractPipeline* ShaderCache::GetPipelineForUid(const GXPipelineUid& uid)
@@ -138,8 +187,10 @@ std::optional<const AbstractPipeline*> ShaderCache::GetPipelineForUidAsync(const
     // .second is the pending flag, i.e. compiling in the background.
     if (!it->second.second)
       return it->second.first.get();
-    else
-      return {};
+
+    // A draw needs it now, so it shouldn't wait behind pipelines that are compiled ahead of time.
+    PromotePipelineCompile(uid);
+    return {};
   }
 
   AppendGXPipelineUID(uid);
@@ -160,6 +211,22 @@ const AbstractPipeline* ShaderCache::GetUberPipelineForUid(const GXUberPipelineU
   return InsertGXUberPipeline(uid, std::move(pipeline));
 }
 
+std::optional<const AbstractPipeline*>
+ShaderCache::GetUberPipelineForUidAsync(const GXUberPipelineUid& uid)
+{
+  auto it = m_gx_uber_pipeline_cache.find(uid);
+  if (it != m_gx_uber_pipeline_cache.end())
+  {
+    if (!it->second.second)
+      return it->second.first.get();
+
+    return {};
+  }
+
+  QueueUberPipelineCompile(uid, COMPILE_PRIORITY_UBERSHADER_VARIANT_PIPELINE);
+  return {};
+}
+
 void ShaderCache::WaitForAsyncCompiler()
 {
   bool running = true;
@@ -225,6 +292,31 @@ static void UnserializePipelineUid(const SerializedUidType& uid, UidType& real_u
   real_uid.blending_state.hex = uid.blending_state_bits;
 }
 
+template <typename T, typename K>
+static auto InsertCachedShader(ShaderStage stage, T& cache, const K& key,
+                               std::unique_ptr<AbstractShader> shader)
+{
+  auto iter = cache.shader_map.try_emplace(key).first;
+  iter->second.shader = std::move(shader);
+  iter->second.pending = false;
+
+  switch (stage)
+  {
+  case ShaderStage::Vertex:
+    INCSTAT(g_stats.num_vertex_shaders_created);
+    INCSTAT(g_stats.num_vertex_shaders_alive);
+    break;
+  case ShaderStage::Pixel:
+    INCSTAT(g_stats.num_pixel_shaders_created);
+    INCSTAT(g_stats.num_pixel_shaders_alive);
+    break;
+  default:
+    break;
+  }
+
+  return iter;
+}
+
 template <ShaderStage stage, typename K, typename T>
 void ShaderCache::LoadShaderCache(T& cache, APIType api_type, const char* type, bool include_gameid)
 {
@@ -236,25 +328,7 @@ void ShaderCache::LoadShaderCache(T& cache, APIType api_type, const char* type,
     {
       auto shader = g_gfx->CreateShaderFromBinary(stage, value, value_size);
       if (shader)
-      {
-        auto& entry = cache.shader_map[key];
-        entry.shader = std::move(shader);
-        entry.pending = false;
-
-        switch (stage)
-        {
-        case ShaderStage::Vertex:
-          INCSTAT(g_stats.num_vertex_shaders_created);
-          INCSTAT(g_stats.num_vertex_shaders_alive);
-          break;
-        case ShaderStage::Pixel:
-          INCSTAT(g_stats.num_pixel_shaders_created);
-          INCSTAT(g_stats.num_pixel_shaders_alive);
-          break;
-        default:
-          break;
-        }
-      }
+        InsertCachedShader(stage, cache, key, std::move(shader));
     }
 
   private:
@@ -267,6 +341,33 @@ void ShaderCache::LoadShaderCache(T& cache, APIType api_type, const char* type,
   INFO_LOG_FMT(VIDEO, "Loaded {} cached shaders from {}", count, filename);
 }
 
+template <typename T>
+void ShaderCache::OpenIndexedShaderCache(T& cache, APIType api_type, const char* type)
+{
+  std::string filename = GetDiskShaderCacheFileName(api_type, type, true, true);
+  u32 count = cache.disk_cache.OpenIndexed(filename);
+  INFO_LOG_FMT(VIDEO, "Opened {} with {} cached shaders", filename, count);
+}
+
+template <ShaderStage stage, typename T, typename K>
+auto ShaderCache::FindShader(T& cache, const K& uid) -> decltype(cache.shader_map.find(uid))
+{
+  auto iter = cache.shader_map.find(uid);
+  if (iter != cache.shader_map.end())
+    return iter;
+
+  // Shader caches that are opened indexed are only read when a shader isn't found.
+  std::vector<u8> binary;
+  if (!cache.disk_cache.Find(uid, &binary))
+    return iter;
+
+  auto shader = g_gfx->CreateShaderFromBinary(stage, binary.data(), binary.size());
+  if (!shader)
+    return iter;
+
+  return InsertCachedShader(stage, cache, uid, std::move(shader));
+}
+
 template <typename T>
 void ShaderCache::ClearShaderCache(T& cache)
 {
@@ -364,11 +465,10 @@ void ShaderCache::LoadCaches()
       LoadShaderCache<ShaderStage::Geometry, GeometryShaderUid>(m_gs_cache, m_api_type, "gs",
                                                                 false);
 
-    // Specialized shaders, gameid-specific.
-    LoadShaderCache<ShaderStage::Vertex, VertexShaderUid>(m_vs_cache, m_api_type, "specialized-vs",
-                                                          true);
-    LoadShaderCache<ShaderStage::Pixel, PixelShaderUid>(m_ps_cache, m_api_type, "specialized-ps",
-                                                        true);
+    // Specialized shaders, gameid-specific. These grow the longer a game is played, so they're
+    // only read as the shaders are needed.
+    OpenIndexedShaderCache(m_vs_cache, m_api_type, "specialized-vs");
+    OpenIndexedShaderCache(m_ps_cache, m_api_type, "specialized-ps");
   }
 
   if (g_ActiveConfig.backend_info.bSupportsPipelineCacheData)
@@ -381,9 +481,21 @@ void ShaderCache::LoadCaches()
   }
 }
 
+bool ShaderCache::DiscardedStaleCaches() const
+{
+  return m_vs_cache.disk_cache.DiscardedStaleCache() ||
+         m_gs_cache.disk_cache.DiscardedStaleCache() ||
+         m_ps_cache.disk_cache.DiscardedStaleCache() ||
+         m_uber_vs_cache.disk_cache.DiscardedStaleCache() ||
+         m_uber_ps_cache.disk_cache.DiscardedStaleCache() ||
+         m_gx_pipeline_disk_cache.DiscardedStaleCache() ||
+         m_gx_uber_pipeline_disk_cache.DiscardedStaleCache();
+}
+
 void ShaderCache::ClearCaches()
 {
   ClearPipelineCache(m_gx_pipeline_cache, m_gx_pipeline_disk_cache);
+  m_pending_gx_pipelines.clear();
   ClearShaderCache(m_vs_cache);
   ClearShaderCache(m_gs_cache);
   ClearShaderCache(m_ps_cache);
@@ -605,7 +717,7 @@ AbstractPipelineConfig ShaderCache::GetGXPipelineConfig(
 }
 
 /// Edits the UID based on driver bugs and other special configurations
-static GXPipelineUid ApplyDriverBugs(const GXPipelineUid& in)
+GXPipelineUid ApplyDriverBugs(const GXPipelineUid& in)
 {
   GXPipelineUid out;
   // TODO: static_assert(std::is_trivially_copyable_v<GXPipelineUid>);
@@ -742,7 +854,7 @@ ShaderCache::GetGXPipelineConfig(const GXPipelineUid& config_in)
 {
   GXPipelineUid config = ApplyDriverBugs(config_in);
   const AbstractShader* vs;
-  auto vs_iter = m_vs_cache.shader_map.find(config.vs_uid);
+  auto vs_iter = FindShader<ShaderStage::Vertex>(m_vs_cache, config.vs_uid);
   if (vs_iter != m_vs_cache.shader_map.end() && !vs_iter->second.pending)
     vs = vs_iter->second.shader.get();
   else
@@ -752,7 +864,7 @@ ShaderCache::GetGXPipelineConfig(const GXPipelineUid& config_in)
   ClearUnusedPixelShaderUidBits(m_api_type, m_host_config, &ps_uid);
 
   const AbstractShader* ps;
-  auto ps_iter = m_ps_cache.shader_map.find(ps_uid);
+  auto ps_iter = FindShader<ShaderStage::Pixel>(m_ps_cache, ps_uid);
   if (ps_iter != m_ps_cache.shader_map.end() && !ps_iter->second.pending)
     ps = ps_iter->second.shader.get();
   else
@@ -872,6 +984,8 @@ ShaderCache::GetGXPipelineConfig(const GXUberPipelineUid& config_in)
 const AbstractPipeline* ShaderCache::InsertGXPipeline(const GXPipelineUid& config,
                                                       std::unique_ptr<AbstractPipeline> pipeline)
 {
+  m_pending_gx_pipelines.erase(config);
+
   auto& entry = m_gx_pipeline_cache[config];
   entry.second = false;
   if (!entry.first && pipeline)
@@ -920,12 +1034,15 @@ ShaderCache::InsertGXUberPipeline(const GXUberPipelineUid& config,
   return entry.first.get();
 }
 
+std::string GetPipelineUIDCacheFileName(std::string_view game_id)
+{
+  return fmt::format("{}{}.uidcache", File::GetUserPath(D_CACHE_IDX), game_id);
+}
+
 void ShaderCache::LoadPipelineUIDCache()
 {
-  constexpr u32 CACHE_FILE_MAGIC = 0x44495550;  // PUID
   constexpr size_t CACHE_HEADER_SIZE = sizeof(u32) + sizeof(u32);
-  std::string filename =
-      File::GetUserPath(D_CACHE_IDX) + SConfig::GetInstance().GetGameID() + ".uidcache";
+  std::string filename = GetPipelineUIDCacheFileName(SConfig::GetInstance().GetGameID());
   if (m_gx_pipeline_uid_cache_file.Open(filename, "rb+"))
   {
     // If an existing case exists, validate the version before reading entries.
@@ -934,7 +1051,7 @@ void ShaderCache::LoadPipelineUIDCache()
     bool uid_file_valid = false;
     if (m_gx_pipeline_uid_cache_file.ReadBytes(&existing_magic, sizeof(existing_magic)) &&
         m_gx_pipeline_uid_cache_file.ReadBytes(&existing_version, sizeof(existing_version)) &&
-        existing_magic == CACHE_FILE_MAGIC && existing_version == GX_PIPELINE_UID_VERSION)
+        existing_magic == PIPELINE_UID_CACHE_MAGIC && existing_version == GX_PIPELINE_UID_VERSION)
     {
       // Ensure the expected size matches the actual size of the file. If it doesn't, it means
       // the cache file may be corrupted, and we should not proceed with loading potentially
@@ -978,7 +1095,8 @@ void ShaderCache::LoadPipelineUIDCache()
     if (m_gx_pipeline_uid_cache_file.Open(filename, "wb"))
     {
       // Write the version identifier.
-      m_gx_pipeline_uid_cache_file.WriteBytes(&CACHE_FILE_MAGIC, sizeof(GX_PIPELINE_UID_VERSION));
+      m_gx_pipeline_uid_cache_file.WriteBytes(&PIPELINE_UID_CACHE_MAGIC,
+                                              sizeof(PIPELINE_UID_CACHE_MAGIC));
       m_gx_pipeline_uid_cache_file.WriteBytes(&GX_PIPELINE_UID_VERSION,
                                               sizeof(GX_PIPELINE_UID_VERSION));
 
@@ -1045,15 +1163,25 @@ void ShaderCache::QueueVertexShaderCompile(const VertexShaderUid& uid, u32 prior
 
     void Retrieve() override { shader_cache->InsertVertexShader(uid, std::move(shader)); }
 
+    void Cancel() override
+    {
+      // The next pipeline that needs this shader queues it again.
+      auto& shader_map = shader_cache->m_vs_cache.shader_map;
+      auto iter = shader_map.find(uid);
+      if (iter != shader_map.end() && !iter->second.shader)
+        shader_map.erase(iter);
+    }
+
   private:
     ShaderCache* shader_cache;
     std::unique_ptr<AbstractShader> shader;
     VertexShaderUid uid;
   };
 
-  m_vs_cache.shader_map[uid].pending = true;
+  auto& entry = m_vs_cache.shader_map[uid];
+  entry.pending = true;
   auto wi = m_async_shader_compiler->CreateWorkItem<VertexShaderWorkItem>(this, uid);
-  m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+  entry.work_item = m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
 void ShaderCache::QueueVertexUberShaderCompile(const UberShader::VertexShaderUid& uid, u32 priority)
@@ -1103,15 +1231,25 @@ void ShaderCache::QueuePixelShaderCompile(const PixelShaderUid& uid, u32 priorit
 
     void Retrieve() override { shader_cache->InsertPixelShader(uid, std::move(shader)); }
 
+    void Cancel() override
+    {
+      // The next pipeline that needs this shader queues it again.
+      auto& shader_map = shader_cache->m_ps_cache.shader_map;
+      auto iter = shader_map.find(uid);
+      if (iter != shader_map.end() && !iter->second.shader)
+        shader_map.erase(iter);
+    }
+
   private:
     ShaderCache* shader_cache;
     std::unique_ptr<AbstractShader> shader;
     PixelShaderUid uid;
   };
 
-  m_ps_cache.shader_map[uid].pending = true;
+  auto& entry = m_ps_cache.shader_map[uid];
+  entry.pending = true;
   auto wi = m_async_shader_compiler->CreateWorkItem<PixelShaderWorkItem>(this, uid);
-  m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+  entry.work_item = m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
 void ShaderCache::QueuePixelUberShaderCompile(const UberShader::PixelShaderUid& uid, u32 priority)
@@ -1163,7 +1301,8 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
 
       GXPipelineUid actual_uid = ApplyDriverBugs(uid);
 
-      auto vs_it = shader_cache->m_vs_cache.shader_map.find(actual_uid.vs_uid);
+      auto vs_it = shader_cache->FindShader<ShaderStage::Vertex>(shader_cache->m_vs_cache,
+                                                                 actual_uid.vs_uid);
       stages_ready &= vs_it != shader_cache->m_vs_cache.shader_map.end() && !vs_it->second.pending;
       if (vs_it == shader_cache->m_vs_cache.shader_map.end())
         shader_cache->QueueVertexShaderCompile(actual_uid.vs_uid, priority);
@@ -1171,7 +1310,7 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
       PixelShaderUid ps_uid = actual_uid.ps_uid;
       ClearUnusedPixelShaderUidBits(shader_cache->m_api_type, shader_cache->m_host_config, &ps_uid);
 
-      auto ps_it = shader_cache->m_ps_cache.shader_map.find(ps_uid);
+      auto ps_it = shader_cache->FindShader<ShaderStage::Pixel>(shader_cache->m_ps_cache, ps_uid);
       stages_ready &= ps_it != shader_cache->m_ps_cache.shader_map.end() && !ps_it->second.pending;
       if (ps_it == shader_cache->m_ps_cache.shader_map.end())
         shader_cache->QueuePixelShaderCompile(ps_uid, priority);
@@ -1194,10 +1333,10 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
       }
       else
       {
-        // Re-queue for next frame.
-        auto wi = shader_cache->m_async_shader_compiler->CreateWorkItem<PipelineWorkItem>(
-            shader_cache, uid, priority);
-        shader_cache->m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+        // Re-queue for next frame, unless the compile was cancelled in the meantime.
+        const auto iter = shader_cache->m_pending_gx_pipelines.find(uid);
+        if (iter != shader_cache->m_pending_gx_pipelines.end())
+          shader_cache->QueuePipelineCompile(uid, iter->second.priority);
       }
     }
 
@@ -1210,11 +1349,110 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
     bool stages_ready;
   };
 
+  const auto [iter, inserted] = m_pending_gx_pipelines.try_emplace(uid);
+  PendingPipeline& pending = iter->second;
+  if (inserted)
+  {
+    pending.queued_on_demand = priority == COMPILE_PRIORITY_ONDEMAND_PIPELINE;
+    pending.last_used_frame = m_frame_count;
+  }
+  pending.priority = priority;
+
   auto wi = m_async_shader_compiler->CreateWorkItem<PipelineWorkItem>(this, uid, priority);
-  m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+  pending.work_item = m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
   m_gx_pipeline_cache[uid].second = true;
 }
 
+void ShaderCache::PromotePipelineCompile(const GXPipelineUid& uid)
+{
+  const auto iter = m_pending_gx_pipelines.find(uid);
+  if (iter == m_pending_gx_pipelines.end())
+  {
+    // The compile was cancelled, because nothing needed the pipeline for a while.
+    QueuePipelineCompile(uid, COMPILE_PRIORITY_ONDEMAND_PIPELINE);
+    return;
+  }
+
+  PendingPipeline& pending = iter->second;
+  pending.last_used_frame = m_frame_count;
+  if (pending.priority <= COMPILE_PRIORITY_ONDEMAND_PIPELINE)
+    return;
+
+  pending.priority = COMPILE_PRIORITY_ONDEMAND_PIPELINE;
+  m_async_shader_compiler->PromoteWorkItem(pending.work_item, pending.priority);
+
+  // The pipeline can't be created before its shaders are compiled.
+  const GXPipelineUid actual_uid = ApplyDriverBugs(uid);
+  const auto vs_it = m_vs_cache.shader_map.find(actual_uid.vs_uid);
+  if (vs_it != m_vs_cache.shader_map.end() && vs_it->second.pending)
+    m_async_shader_compiler->PromoteWorkItem(vs_it->second.work_item, pending.priority);
+
+  PixelShaderUid ps_uid = actual_uid.ps_uid;
+  ClearUnusedPixelShaderUidBits(m_api_type, m_host_config, &ps_uid);
+  const auto ps_it = m_ps_cache.shader_map.find(ps_uid);
+  if (ps_it != m_ps_cache.shader_map.end() && ps_it->second.pending)
+    m_async_shader_compiler->PromoteWorkItem(ps_it->second.work_item, pending.priority);
+}
+
+void ShaderCache::CancelStalePipelineCompiles()
+{
+  std::vector<GXPipelineUid> cancelled_pipelines;
+  for (auto iter = m_pending_gx_pipelines.begin(); iter != m_pending_gx_pipelines.end();)
+  {
+    const PendingPipeline& pending = iter->second;
+    if (!pending.queued_on_demand ||
+        m_frame_count - pending.last_used_frame < STALE_PIPELINE_FRAMES)
+    {
+      ++iter;
+      continue;
+    }
+
+    // If the work item has already started, its Retrieve() won't queue it again.
+    m_async_shader_compiler->CancelWorkItem(pending.work_item);
+    cancelled_pipelines.push_back(ApplyDriverBugs(iter->first));
+    iter = m_pending_gx_pipelines.erase(iter);
+  }
+
+  if (cancelled_pipelines.empty())
+    return;
+
+  // Also cancel the shaders that no other pending pipeline needs.
+  std::set<VertexShaderUid> needed_vs;
+  std::set<PixelShaderUid> needed_ps;
+  const auto get_ps_uid = [this](const GXPipelineUid& uid) {
+    PixelShaderUid ps_uid = uid.ps_uid;
+    ClearUnusedPixelShaderUidBits(m_api_type, m_host_config, &ps_uid);
+    return ps_uid;
+  };
+  for (const auto& [uid, pending] : m_pending_gx_pipelines)
+  {
+    const GXPipelineUid actual_uid = ApplyDriverBugs(uid);
+    needed_vs.insert(actual_uid.vs_uid);
+    needed_ps.insert(get_ps_uid(actual_uid));
+  }
+
+  for (const GXPipelineUid& uid : cancelled_pipelines)
+  {
+    const auto vs_it = m_vs_cache.shader_map.find(uid.vs_uid);
+    if (vs_it != m_vs_cache.shader_map.end() && vs_it->second.pending &&
+        !needed_vs.contains(uid.vs_uid))
+    {
+      m_async_shader_compiler->CancelWorkItem(vs_it->second.work_item);
+    }
+
+    const PixelShaderUid ps_uid = get_ps_uid(uid);
+    const auto ps_it = m_ps_cache.shader_map.find(ps_uid);
+    if (ps_it != m_ps_cache.shader_map.end() && ps_it->second.pending &&
+        !needed_ps.contains(ps_uid))
+    {
+      m_async_shader_compiler->CancelWorkItem(ps_it->second.work_item);
+    }
+  }
+
+  INFO_LOG_FMT(VIDEO, "Cancelled {} pipeline compiles that are no longer needed",
+               cancelled_pipelines.size());
+}
+
 void ShaderCache::QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 priority)
 {
   class UberPipelineWorkItem final : public AsyncShaderCompiler::WorkItem
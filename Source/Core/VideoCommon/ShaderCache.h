@@ -10,6 +10,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 
@@ -69,6 +70,7 @@ public:
   // Accesses ShaderGen shader caches asynchronously.
   // The optional will be empty if this pipeline is now background compiling.
   std::optional<const AbstractPipeline*> GetPipelineForUidAsync(const GXPipelineUid& uid);
+  std::optional<const AbstractPipeline*> GetUberPipelineForUidAsync(const GXUberPipelineUid& uid);
 
   // Shared shaders
   const AbstractShader* GetScreenQuadVertexShader() const
@@ -168,30 +170,44 @@ private:
   void QueuePixelShaderCompile(const PixelShaderUid& uid, u32 priority);
   void QueuePixelUberShaderCompile(const UberShader::PixelShaderUid& uid, u32 priority);
   void QueuePipelineCompile(const GXPipelineUid& uid, u32 priority);
+  void PromotePipelineCompile(const GXPipelineUid& uid);
+  void CancelStalePipelineCompiles();
   void QueueUberPipelineCompile(const GXUberPipelineUid& uid, u32 priority);
 
   // Populating various caches.
   template <ShaderStage stage, typename K, typename T>
   void LoadShaderCache(T& cache, APIType api_type, const char* type, bool include_gameid);
   template <typename T>
+  void OpenIndexedShaderCache(T& cache, APIType api_type, const char* type);
+  template <ShaderStage stage, typename T, typename K>
+  auto FindShader(T& cache, const K& uid) -> decltype(cache.shader_map.find(uid));
+  template <typename T>
   void ClearShaderCache(T& cache);
   template <typename KeyType, typename DiskKeyType, typename T>
   void LoadPipelineCache(T& cache, Common::LinearDiskCache<DiskKeyType, u8>& disk_cache,
                          APIType api_type, const char* type, bool include_gameid);
   template <typename T, typename Y>
   void ClearPipelineCache(T& cache, Y& disk_cache);
+  bool DiscardedStaleCaches() const;
 
   // Priorities for compiling. The lower the value, the sooner the pipeline is compiled.
   // The shader cache is compiled last, as it is the least likely to be required. On demand
   // shaders are always compiled before pending ubershaders, as we want to use the ubershader
-  // for as few frames as possible, otherwise we risk framerate drops.
+  // for as few frames as possible, otherwise we risk framerate drops. Ubershader variants come
+  // next, as the generic ubershader is drawing in their place until they're ready.
   enum : u32
   {
     COMPILE_PRIORITY_ONDEMAND_PIPELINE = 100,
+    COMPILE_PRIORITY_UBERSHADER_VARIANT_PIPELINE = 150,
     COMPILE_PRIORITY_UBERSHADER_PIPELINE = 200,
     COMPILE_PRIORITY_SHADERCACHE_PIPELINE = 300
   };
 
+  // Pipelines that were queued on demand and haven't been needed by a draw for this many frames
+  // aren't compiled anymore, so that they don't hold up the pipelines the game needs now.
+  static constexpr u64 STALE_PIPELINE_FRAMES = 120;
+  static constexpr u64 STALE_PIPELINE_CHECK_INTERVAL = 30;
+
   // Configuration bits.
   APIType m_api_type;
   ShaderHostConfig m_host_config = {};
@@ -214,6 +230,7 @@ private:
     {
       std::unique_ptr<AbstractShader> shader;
       bool pending = false;
+      AsyncShaderCompiler::WorkItemID work_item = AsyncShaderCompiler::INVALID_WORK_ITEM_ID;
     };
     std::map<Uid, Shader> shader_map;
     Common::LinearDiskCache<Uid, u8> disk_cache;
@@ -228,6 +245,18 @@ private:
   std::map<GXPipelineUid, std::pair<std::unique_ptr<AbstractPipeline>, bool>> m_gx_pipeline_cache;
   std::map<GXUberPipelineUid, std::pair<std::unique_ptr<AbstractPipeline>, bool>>
       m_gx_uber_pipeline_cache;
+
+  // Specialized pipelines that are compiling in the background.
+  struct PendingPipeline
+  {
+    AsyncShaderCompiler::WorkItemID work_item = AsyncShaderCompiler::INVALID_WORK_ITEM_ID;
+    u32 priority = 0;
+    bool queued_on_demand = false;
+    u64 last_used_frame = 0;
+  };
+  std::map<GXPipelineUid, PendingPipeline> m_pending_gx_pipelines;
+  u64 m_frame_count = 0;
+
   File::IOFile m_gx_pipeline_uid_cache_file;
   Common::LinearDiskCache<SerializedGXPipelineUid, u8> m_gx_pipeline_disk_cache;
   Common::LinearDiskCache<SerializedGXUberPipelineUid, u8> m_gx_uber_pipeline_disk_cache;
@@ -255,6 +284,15 @@ private:
   Common::EventHook m_frame_end_handler;
 };
 
+// Pipeline UID caches record the pipelines a game has used, so they can be compiled ahead of time.
+// They start with PIPELINE_UID_CACHE_MAGIC and GX_PIPELINE_UID_VERSION (both u32), followed by
+// SerializedGXPipelineUids.
+constexpr u32 PIPELINE_UID_CACHE_MAGIC = 0x44495550;  // PUID
+std::string GetPipelineUIDCacheFileName(std::string_view game_id);
+
+// Applies the host-specific adjustments that are made to a pipeline before compiling its shaders.
+GXPipelineUid ApplyDriverBugs(const GXPipelineUid& in);
+
 }  // namespace VideoCommon
 
 extern std::unique_ptr<VideoCommon::ShaderCache> g_shader_cache;
@@ -3,6 +3,9 @@
 
 #include "VideoCommon/ShaderGenCommon.h"
 
+#include <utility>
+#include <vector>
+
 #include <fmt/format.h>
 
 #include "Common/Assert.h"
@@ -12,6 +15,44 @@
 #include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
 
+namespace
+{
+// Enough for the few shaders that are generated at the same time, e.g. a vertex shader's input
+// extraction code. Ubershaders are the largest shaders, at around 100 KiB.
+constexpr size_t MAX_POOLED_BUFFERS = 4;
+constexpr size_t MAX_POOLED_BUFFER_CAPACITY = 1024 * 1024;
+constexpr size_t INITIAL_BUFFER_CAPACITY = 16384;
+
+thread_local std::vector<std::string> s_shader_code_buffers;
+}  // namespace
+
+ShaderCode::ShaderCode()
+{
+  if (!s_shader_code_buffers.empty())
+  {
+    m_buffer = std::move(s_shader_code_buffers.back());
+    s_shader_code_buffers.pop_back();
+    m_buffer.clear();
+  }
+  else
+  {
+    m_buffer.reserve(INITIAL_BUFFER_CAPACITY);
+  }
+}
+
+ShaderCode::~ShaderCode()
+{
+  // Moved-from buffers have nothing worth keeping.
+  if (m_buffer.capacity() < INITIAL_BUFFER_CAPACITY ||
+      m_buffer.capacity() > MAX_POOLED_BUFFER_CAPACITY ||
+      s_shader_code_buffers.size() >= MAX_POOLED_BUFFERS)
+  {
+    return;
+  }
+
+  s_shader_code_buffers.push_back(std::move(m_buffer));
+}
+
 ShaderHostConfig ShaderHostConfig::GetCurrent()
 {
   ShaderHostConfig bits = {};
@@ -53,6 +94,17 @@ ShaderHostConfig ShaderHostConfig::GetCurrent()
 
 std::string GetDiskShaderCacheFileName(APIType api_type, const char* type, bool include_gameid,
                                        bool include_host_config, bool include_api)
+{
+  const std::string game_id = include_gameid ? SConfig::GetInstance().GetGameID() : std::string();
+  const std::optional<ShaderHostConfig> host_config =
+      include_host_config ? std::make_optional(ShaderHostConfig::GetCurrent()) : std::nullopt;
+  return GetDiskShaderCacheFileName(api_type, type, game_id, host_config, include_api);
+}
+
+std::string GetDiskShaderCacheFileName(APIType api_type, const char* type,
+                                       std::string_view game_id,
+                                       std::optional<ShaderHostConfig> host_config,
+                                       bool include_api)
 {
   if (!File::Exists(File::GetUserPath(D_SHADERCACHE_IDX)))
     File::CreateDir(File::GetUserPath(D_SHADERCACHE_IDX));
@@ -82,17 +134,16 @@ std::string GetDiskShaderCacheFileName(APIType api_type, const char* type, bool
 
   filename += type;
 
-  if (include_gameid)
+  if (!game_id.empty())
   {
     filename += '-';
-    filename += SConfig::GetInstance().GetGameID();
+    filename += game_id;
   }
 
-  if (include_host_config)
+  if (host_config)
   {
     // We're using 21 bits, so 6 hex characters.
-    ShaderHostConfig host_config = ShaderHostConfig::GetCurrent();
-    filename += fmt::format("-{:06X}", host_config.bits);
+    filename += fmt::format("-{:06X}", host_config->bits);
   }
 
   filename += ".cache";
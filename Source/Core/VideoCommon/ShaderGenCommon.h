@@ -6,6 +6,7 @@
 #include <cstring>
 #include <functional>
 #include <iterator>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <type_traits>
@@ -107,7 +108,16 @@ private:
 class ShaderCode : public ShaderGeneratorInterface
 {
 public:
-  ShaderCode() { m_buffer.reserve(16384); }
+  // The buffer is taken from a pool of buffers that earlier shaders on the same thread were
+  // generated in, and returned to it on destruction. Generating a shader usually doesn't allocate.
+  ShaderCode();
+  ~ShaderCode();
+
+  ShaderCode(const ShaderCode&) = default;
+  ShaderCode(ShaderCode&&) = default;
+  ShaderCode& operator=(const ShaderCode&) = default;
+  ShaderCode& operator=(ShaderCode&&) = default;
+
   const std::string& GetBuffer() const { return m_buffer; }
 
   // Writes format strings using fmtlib format strings.
@@ -188,6 +198,12 @@ union ShaderHostConfig
 // Gets the filename of the specified type of cache object (e.g. vertex shader, pipeline).
 std::string GetDiskShaderCacheFileName(APIType api_type, const char* type, bool include_gameid,
                                        bool include_host_config, bool include_api = true);
+// Same as above, for a given game and host config instead of the current ones. An empty game_id or
+// host_config leaves them out of the filename.
+std::string GetDiskShaderCacheFileName(APIType api_type, const char* type,
+                                       std::string_view game_id,
+                                       std::optional<ShaderHostConfig> host_config,
+                                       bool include_api = true);
 
 void WriteIsNanHeader(ShaderCode& out, APIType api_type);
 void WriteBitfieldExtractHeader(ShaderCode& out, APIType api_type,
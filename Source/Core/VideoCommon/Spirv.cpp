@@ -3,17 +3,22 @@
 
 #include "VideoCommon/Spirv.h"
 
+#include <array>
+
 // glslang includes
 #include "GlslangToSpv.h"
 #include "ResourceLimits.h"
 #include "disassemble.h"
 
+#include "Common/Crypto/SHA1.h"
 #include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 #include "Common/Version.h"
 
+#include "VideoCommon/SpirvCache.h"
+#include "VideoCommon/SpirvCompilerPool.h"
 #include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoConfig.h"
 
@@ -21,34 +26,160 @@ namespace
 {
 bool InitializeGlslang()
 {
-  static bool glslang_initialized = false;
-  if (glslang_initialized)
+  // Shaders can be compiled from several threads at once, so let the static handle the locking.
+  static const bool glslang_initialized = [] {
+    if (!glslang::InitializeProcess())
+    {
+      PanicAlertFmt("Failed to initialize glslang shader compiler");
+      return false;
+    }
+
+    std::atexit([]() { glslang::FinalizeProcess(); });
     return true;
+  }();
+
+  return glslang_initialized;
+}
+
+const TBuiltInResource* GetCompilerResourceLimits()
+{
+  return &glslang::DefaultTBuiltInResource;
+}
 
-  if (!glslang::InitializeProcess())
+const char* GetStageFilename(EShLanguage stage)
+{
+  switch (stage)
   {
-    PanicAlertFmt("Failed to initialize glslang shader compiler");
-    return false;
+  case EShLangVertex:
+    return "vs";
+  case EShLangGeometry:
+    return "gs";
+  case EShLangFragment:
+    return "ps";
+  case EShLangCompute:
+    return "cs";
+  default:
+    return "shader";
   }
+}
 
-  std::atexit([]() { glslang::FinalizeProcess(); });
+std::optional<SPIRV::CodeVector> ReportCompileResult(EShLanguage stage, std::string_view source,
+                                                     SPIRV::CompileResult result)
+{
+  if (!result.error.empty())
+  {
+    static int counter = 0;
+    std::string filename = VideoBackendBase::BadShaderFilename(GetStageFilename(stage), counter++);
+    std::ofstream stream;
+    File::OpenFStream(stream, filename, std::ios_base::out);
+    if (stream.good())
+    {
+      stream << source << std::endl;
+      stream << result.error << std::endl;
+      stream << "Shader Info Log:" << std::endl;
+      stream << result.shader_info_log << std::endl;
+      stream << result.shader_debug_log << std::endl;
+      if (!result.program_info_log.empty() || !result.program_debug_log.empty())
+      {
+        stream << "Program Info Log:" << std::endl;
+        stream << result.program_info_log << std::endl;
+        stream << result.program_debug_log << std::endl;
+      }
+    }
 
-  glslang_initialized = true;
-  return true;
+    stream << "\n";
+    stream << "Dolphin Version: " + Common::GetScmRevStr() + "\n";
+    stream << "Video Backend: " + g_video_backend->GetDisplayName();
+    stream.close();
+
+    PanicAlertFmt("{} (written to {})\nDebug info:\n{}", result.error, filename,
+                  result.shader_info_log);
+    return std::nullopt;
+  }
+
+  // Write out messages
+  // Temporary: skip if it contains "Warning, version 450 is not yet complete; most version-specific
+  // features are present, but some are missing."
+  if (result.shader_info_log.size() > 108)
+    WARN_LOG_FMT(VIDEO, "Shader info log: {}", result.shader_info_log);
+  if (!result.shader_debug_log.empty())
+    WARN_LOG_FMT(VIDEO, "Shader debug info log: {}", result.shader_debug_log);
+  if (result.program_info_log.size() > 25)
+    WARN_LOG_FMT(VIDEO, "Program info log: {}", result.program_info_log);
+  if (!result.program_debug_log.empty())
+    WARN_LOG_FMT(VIDEO, "Program debug info log: {}", result.program_debug_log);
+  if (!result.spv_messages.empty())
+    WARN_LOG_FMT(VIDEO, "SPIR-V conversion messages: {}", result.spv_messages);
+
+  return std::move(result.code);
 }
 
-const TBuiltInResource* GetCompilerResourceLimits()
+std::optional<SPIRV::CodeVector>
+CompileShaderWithGlslang(EShLanguage stage, APIType api_type,
+                         glslang::EShTargetLanguageVersion language_version,
+                         std::string_view source)
 {
-  return &glslang::DefaultTBuiltInResource;
+  const bool debug_info = g_ActiveConfig.bEnableValidationLayer;
+
+  // A crashing compiler process is reported as a failed compile, only processes that can't be
+  // started fall back to compiling here.
+  std::optional<SPIRV::CompileResult> result;
+  if (const std::shared_ptr<SPIRV::CompilerPool> pool = SPIRV::GetCompilerPool())
+    result = pool->Compile(stage, api_type, language_version, debug_info, source);
+  if (!result)
+    result = SPIRV::CompileShader(stage, api_type, language_version, debug_info, source);
+
+  return ReportCompileResult(stage, source, std::move(*result));
+}
+
+SPIRV::SharedCache::Key GetSharedCacheKey(EShLanguage stage, APIType api_type,
+                                          glslang::EShTargetLanguageVersion language_version,
+                                          std::string_view source)
+{
+  // Increment this when the compiler options change in a way that changes the generated code.
+  constexpr u32 SHARED_CACHE_VERSION = 1;
+
+  const std::array<u32, 5> options{SHARED_CACHE_VERSION, static_cast<u32>(stage),
+                                   static_cast<u32>(api_type), static_cast<u32>(language_version),
+                                   g_ActiveConfig.bEnableValidationLayer};
+  const auto context = Common::SHA1::CreateContext();
+  context->Update(reinterpret_cast<const u8*>(options.data()), sizeof(options));
+  context->Update(reinterpret_cast<const u8*>(source.data()), source.size());
+  return context->Finish();
 }
 
 std::optional<SPIRV::CodeVector>
 CompileShaderToSPV(EShLanguage stage, APIType api_type,
-                   glslang::EShTargetLanguageVersion language_version, const char* stage_filename,
-                   std::string_view source)
+                   glslang::EShTargetLanguageVersion language_version, std::string_view source)
+{
+  const std::shared_ptr<SPIRV::SharedCache> cache = SPIRV::GetSharedCache();
+  if (!cache)
+    return CompileShaderWithGlslang(stage, api_type, language_version, source);
+
+  const SPIRV::SharedCache::Key key = GetSharedCacheKey(stage, api_type, language_version, source);
+  if (std::optional<SPIRV::CodeVector> code = cache->Lookup(key))
+    return code;
+
+  std::optional<SPIRV::CodeVector> code =
+      CompileShaderWithGlslang(stage, api_type, language_version, source);
+  if (code)
+    cache->Insert(key, *code);
+  return code;
+}
+}  // namespace
+
+namespace SPIRV
 {
+CompileResult CompileShader(EShLanguage stage, APIType api_type,
+                            glslang::EShTargetLanguageVersion language_version, bool debug_info,
+                            std::string_view source)
+{
+  CompileResult result;
   if (!InitializeGlslang())
-    return std::nullopt;
+  {
+    result.error = "Failed to initialize glslang shader compiler";
+    return result;
+  }
 
   std::unique_ptr<glslang::TShader> shader = std::make_unique<glslang::TShader>(stage);
   std::unique_ptr<glslang::TProgram> program;
@@ -66,65 +197,41 @@ CompileShaderToSPV(EShLanguage stage, APIType api_type,
 
   shader->setStringsWithLengths(&pass_source_code, &pass_source_code_length, 1);
 
-  auto DumpBadShader = [&](const char* msg) {
-    static int counter = 0;
-    std::string filename = VideoBackendBase::BadShaderFilename(stage_filename, counter++);
-    std::ofstream stream;
-    File::OpenFStream(stream, filename, std::ios_base::out);
-    if (stream.good())
+  const auto fail = [&](const char* msg) {
+    result.error = msg;
+    result.shader_info_log = shader->getInfoLog();
+    result.shader_debug_log = shader->getInfoDebugLog();
+    if (program)
     {
-      stream << source << std::endl;
-      stream << msg << std::endl;
-      stream << "Shader Info Log:" << std::endl;
-      stream << shader->getInfoLog() << std::endl;
-      stream << shader->getInfoDebugLog() << std::endl;
-      if (program)
-      {
-        stream << "Program Info Log:" << std::endl;
-        stream << program->getInfoLog() << std::endl;
-        stream << program->getInfoDebugLog() << std::endl;
-      }
+      result.program_info_log = program->getInfoLog();
+      result.program_debug_log = program->getInfoDebugLog();
     }
-
-    stream << "\n";
-    stream << "Dolphin Version: " + Common::GetScmRevStr() + "\n";
-    stream << "Video Backend: " + g_video_backend->GetDisplayName();
-    stream.close();
-
-    PanicAlertFmt("{} (written to {})\nDebug info:\n{}", msg, filename, shader->getInfoLog());
+    return result;
   };
 
   if (!shader->parse(GetCompilerResourceLimits(), default_version, profile, false, true, messages,
                      includer))
   {
-    DumpBadShader("Failed to parse shader");
-    return std::nullopt;
+    return fail("Failed to parse shader");
   }
 
   // Even though there's only a single shader, we still need to link it to generate SPV
   program = std::make_unique<glslang::TProgram>();
   program->addShader(shader.get());
   if (!program->link(messages))
-  {
-    DumpBadShader("Failed to link program");
-    return std::nullopt;
-  }
+    return fail("Failed to link program");
 
   glslang::TIntermediate* intermediate = program->getIntermediate(stage);
   if (!intermediate)
-  {
-    DumpBadShader("Failed to generate SPIR-V");
-    return std::nullopt;
-  }
+    return fail("Failed to generate SPIR-V");
 
-  SPIRV::CodeVector out_code;
   spv::SpvBuildLogger logger;
   glslang::SpvOptions options;
 
-  if (g_ActiveConfig.bEnableValidationLayer)
+  if (debug_info)
   {
     // Attach the source code to the SPIR-V for tools like RenderDoc.
-    intermediate->setSourceFile(stage_filename);
+    intermediate->setSourceFile(GetStageFilename(stage));
     intermediate->addSourceText(pass_source_code, pass_source_code_length);
 
     options.generateDebugInfo = true;
@@ -139,50 +246,37 @@ CompileShaderToSPV(EShLanguage stage, APIType api_type,
     options.stripDebugInfo = true;
   }
 
-  glslang::GlslangToSpv(*intermediate, out_code, &logger, &options);
+  glslang::GlslangToSpv(*intermediate, result.code, &logger, &options);
 
-  // Write out messages
-  // Temporary: skip if it contains "Warning, version 450 is not yet complete; most version-specific
-  // features are present, but some are missing."
-  if (strlen(shader->getInfoLog()) > 108)
-    WARN_LOG_FMT(VIDEO, "Shader info log: {}", shader->getInfoLog());
-  if (strlen(shader->getInfoDebugLog()) > 0)
-    WARN_LOG_FMT(VIDEO, "Shader debug info log: {}", shader->getInfoDebugLog());
-  if (strlen(program->getInfoLog()) > 25)
-    WARN_LOG_FMT(VIDEO, "Program info log: {}", program->getInfoLog());
-  if (strlen(program->getInfoDebugLog()) > 0)
-    WARN_LOG_FMT(VIDEO, "Program debug info log: {}", program->getInfoDebugLog());
-  const std::string spv_messages = logger.getAllMessages();
-  if (!spv_messages.empty())
-    WARN_LOG_FMT(VIDEO, "SPIR-V conversion messages: {}", spv_messages);
-
-  return out_code;
+  result.shader_info_log = shader->getInfoLog();
+  result.shader_debug_log = shader->getInfoDebugLog();
+  result.program_info_log = program->getInfoLog();
+  result.program_debug_log = program->getInfoDebugLog();
+  result.spv_messages = logger.getAllMessages();
+  return result;
 }
-}  // namespace
 
-namespace SPIRV
-{
 std::optional<CodeVector> CompileVertexShader(std::string_view source_code, APIType api_type,
                                               glslang::EShTargetLanguageVersion language_version)
 {
-  return CompileShaderToSPV(EShLangVertex, api_type, language_version, "vs", source_code);
+  return CompileShaderToSPV(EShLangVertex, api_type, language_version, source_code);
 }
 
 std::optional<CodeVector> CompileGeometryShader(std::string_view source_code, APIType api_type,
                                                 glslang::EShTargetLanguageVersion language_version)
 {
-  return CompileShaderToSPV(EShLangGeometry, api_type, language_version, "gs", source_code);
+  return CompileShaderToSPV(EShLangGeometry, api_type, language_version, source_code);
 }
 
 std::optional<CodeVector> CompileFragmentShader(std::string_view source_code, APIType api_type,
                                                 glslang::EShTargetLanguageVersion language_version)
 {
-  return CompileShaderToSPV(EShLangFragment, api_type, language_version, "ps", source_code);
+  return CompileShaderToSPV(EShLangFragment, api_type, language_version, source_code);
 }
 
 std::optional<CodeVector> CompileComputeShader(std::string_view source_code, APIType api_type,
                                                glslang::EShTargetLanguageVersion language_version)
 {
-  return CompileShaderToSPV(EShLangCompute, api_type, language_version, "cs", source_code);
+  return CompileShaderToSPV(EShLangCompute, api_type, language_version, source_code);
 }
 }  // namespace SPIRV
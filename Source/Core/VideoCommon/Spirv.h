@@ -5,6 +5,7 @@
 
 #include <cstddef>
 #include <optional>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -19,6 +20,26 @@ namespace SPIRV
 using CodeType = u32;
 using CodeVector = std::vector<CodeType>;
 
+// What glslang produced for a shader, before any of it is reported.
+struct CompileResult
+{
+  // Empty if compiling failed.
+  CodeVector code;
+  // The step that failed, empty on success.
+  std::string error;
+  std::string shader_info_log;
+  std::string shader_debug_log;
+  std::string program_info_log;
+  std::string program_debug_log;
+  std::string spv_messages;
+};
+
+// Compiles a shader with glslang, without reporting errors or going through the shader caches.
+// This is the part of compiling that the compiler worker processes run.
+CompileResult CompileShader(EShLanguage stage, APIType api_type,
+                            glslang::EShTargetLanguageVersion language_version, bool debug_info,
+                            std::string_view source);
+
 // Compile a vertex shader to SPIR-V.
 std::optional<CodeVector> CompileVertexShader(std::string_view source_code, APIType api_type,
                                               glslang::EShTargetLanguageVersion language_version);
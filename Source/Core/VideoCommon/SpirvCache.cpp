@@ -0,0 +1,225 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/SpirvCache.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+
+namespace SPIRV
+{
+namespace
+{
+std::mutex s_shared_cache_lock;
+std::shared_ptr<SharedCache> s_shared_cache;
+}  // namespace
+
+std::shared_ptr<SharedCache> GetSharedCache()
+{
+  std::lock_guard lk(s_shared_cache_lock);
+  return s_shared_cache;
+}
+
+void SetSharedCache(std::shared_ptr<SharedCache> cache)
+{
+  // The old cache is closed outside of the lock, once nothing else uses it anymore.
+  std::lock_guard lk(s_shared_cache_lock);
+  s_shared_cache.swap(cache);
+}
+
+SharedCache::~SharedCache()
+{
+  Close();
+}
+
+void SharedCache::Open(const std::string& filename, u64 max_size)
+{
+  class CacheReader : public Common::LinearDiskCacheReader<Key, CodeType>
+  {
+  public:
+    explicit CacheReader(SharedCache* cache_) : cache(cache_) {}
+    void Read(const Key& key, const CodeType* value, u32 value_size) override
+    {
+      if (value_size == 0)
+      {
+        // A usage record
+        const auto it = cache->m_entries.find(key);
+        if (it != cache->m_entries.end())
+          it->second.last_use = ++cache->m_use_counter;
+        ++cache->m_usage_records;
+        return;
+      }
+
+      Entry& entry = cache->m_entries[key];
+      cache->m_size -= entry.code.size() * sizeof(CodeType);
+      entry.code.assign(value, value + value_size);
+      entry.last_use = ++cache->m_use_counter;
+      cache->m_size += entry.code.size() * sizeof(CodeType);
+    }
+
+  private:
+    SharedCache* cache;
+  };
+
+  std::lock_guard lk(m_mutex);
+
+  m_filename = filename;
+  m_max_size = max_size;
+  m_entries.clear();
+  m_size = 0;
+  m_use_counter = 0;
+  m_usage_records = 0;
+  m_needs_compaction = false;
+  m_statistics = {};
+
+  CacheReader reader(this);
+  m_disk_cache.OpenAndRead(filename, reader);
+  m_session_start = m_use_counter;
+
+  // Don't let the file fill up with usage records.
+  if (m_usage_records > m_entries.size())
+    m_needs_compaction = true;
+
+  EvictLeastRecentlyUsed();
+
+  INFO_LOG_FMT(VIDEO, "Loaded {} shared SPIR-V shaders ({} KiB) from {}", m_entries.size(),
+               m_size / 1024, filename);
+}
+
+void SharedCache::Close()
+{
+  std::lock_guard lk(m_mutex);
+
+  if (m_filename.empty())
+    return;
+
+  m_disk_cache.Close();
+  if (m_needs_compaction)
+    Compact();
+
+  const u64 lookups = m_statistics.hits + m_statistics.misses;
+  if (lookups != 0)
+  {
+    NOTICE_LOG_FMT(VIDEO,
+                   "Shared SPIR-V cache: {} hits, {} misses ({:.1f}% hit rate), {} shaders "
+                   "evicted, {} shaders ({} KiB) cached.",
+                   m_statistics.hits, m_statistics.misses, 100.0 * m_statistics.hits / lookups,
+                   m_statistics.evictions, m_entries.size(), m_size / 1024);
+  }
+
+  m_entries.clear();
+  m_filename.clear();
+}
+
+std::optional<CodeVector> SharedCache::Lookup(const Key& key)
+{
+  std::lock_guard lk(m_mutex);
+
+  const auto it = m_entries.find(key);
+  if (it == m_entries.end())
+  {
+    ++m_statistics.misses;
+    return std::nullopt;
+  }
+
+  ++m_statistics.hits;
+
+  // Only record the first use in every session, which is enough to order shaders by their use.
+  if (it->second.last_use <= m_session_start)
+  {
+    m_disk_cache.Append(key, it->second.code.data(), 0);
+    ++m_usage_records;
+  }
+  it->second.last_use = ++m_use_counter;
+
+  return it->second.code;
+}
+
+void SharedCache::Insert(const Key& key, const CodeVector& code)
+{
+  std::lock_guard lk(m_mutex);
+
+  if (m_filename.empty() || code.empty())
+    return;
+
+  const auto [it, inserted] = m_entries.try_emplace(key);
+  if (!inserted)
+    return;
+
+  it->second.code = code;
+  it->second.last_use = ++m_use_counter;
+  m_size += code.size() * sizeof(CodeType);
+  m_disk_cache.Append(key, code.data(), static_cast<u32>(code.size()));
+
+  EvictLeastRecentlyUsed();
+}
+
+SharedCache::Statistics SharedCache::GetStatistics() const
+{
+  std::lock_guard lk(m_mutex);
+  return m_statistics;
+}
+
+void SharedCache::EvictLeastRecentlyUsed()
+{
+  if (m_size <= m_max_size)
+    return;
+
+  std::vector<std::map<Key, Entry>::iterator> entries;
+  entries.reserve(m_entries.size());
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    entries.push_back(it);
+  std::sort(entries.begin(), entries.end(),
+            [](const auto& a, const auto& b) { return a->second.last_use < b->second.last_use; });
+
+  // Evict down to 90% of the limit, so that the next few shaders don't evict again right away.
+  const u64 target_size = m_max_size / 10 * 9;
+  for (const auto& it : entries)
+  {
+    if (m_size <= target_size)
+      break;
+    m_size -= it->second.code.size() * sizeof(CodeType);
+    m_entries.erase(it);
+    ++m_statistics.evictions;
+  }
+
+  m_needs_compaction = true;
+}
+
+void SharedCache::Compact()
+{
+  class NullReader : public Common::LinearDiskCacheReader<Key, CodeType>
+  {
+  public:
+    void Read(const Key& key, const CodeType* value, u32 value_size) override {}
+  };
+
+  std::vector<const std::pair<const Key, Entry>*> entries;
+  entries.reserve(m_entries.size());
+  for (const auto& entry : m_entries)
+    entries.push_back(&entry);
+  std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) {
+    return a->second.last_use < b->second.last_use;
+  });
+
+  // Write the shaders from least to most recently used, which is the order they're loaded in.
+  const std::string temp_filename = m_filename + ".tmp";
+  File::Delete(temp_filename, File::IfAbsentBehavior::NoConsoleWarning);
+
+  Common::LinearDiskCache<Key, CodeType> disk_cache;
+  NullReader reader;
+  disk_cache.OpenAndRead(temp_filename, reader);
+  for (const auto* entry : entries)
+  {
+    disk_cache.Append(entry->first, entry->second.code.data(),
+                      static_cast<u32>(entry->second.code.size()));
+  }
+  disk_cache.Close();
+
+  if (!File::Rename(temp_filename, m_filename))
+    ERROR_LOG_FMT(VIDEO, "Could not replace {} with the compacted shared SPIR-V cache", m_filename);
+}
+}  // namespace SPIRV
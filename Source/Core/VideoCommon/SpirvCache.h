@@ -0,0 +1,85 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "Common/CommonTypes.h"
+#include "Common/Crypto/SHA1.h"
+#include "Common/LinearDiskCache.h"
+#include "VideoCommon/Spirv.h"
+
+namespace SPIRV
+{
+// Compiled SPIR-V shared by all games, addressed by a hash of the shader source and compiler
+// settings. The host config is part of the generated source, so it doesn't need to be hashed
+// separately. Games share a lot of identical shaders, which only have to be compiled once.
+//
+// Using a cached shader appends an empty record for it to the file, which tells the next session
+// that it was used recently. When the cache grows over its size limit, the least recently used
+// shaders are evicted, and the file is rewritten without them on Close().
+class SharedCache
+{
+public:
+  using Key = Common::SHA1::Digest;
+
+  struct Statistics
+  {
+    u64 hits = 0;
+    u64 misses = 0;
+    u64 evictions = 0;
+  };
+
+  SharedCache() = default;
+  ~SharedCache();
+
+  SharedCache(const SharedCache&) = delete;
+  SharedCache& operator=(const SharedCache&) = delete;
+
+  void Open(const std::string& filename, u64 max_size);
+  void Close();
+
+  // These can be called from any thread.
+  std::optional<CodeVector> Lookup(const Key& key);
+  void Insert(const Key& key, const CodeVector& code);
+
+  Statistics GetStatistics() const;
+
+private:
+  struct Entry
+  {
+    CodeVector code;
+    u64 last_use = 0;
+  };
+
+  void EvictLeastRecentlyUsed();
+  void Compact();
+
+  mutable std::mutex m_mutex;
+  std::map<Key, Entry> m_entries;
+  Common::LinearDiskCache<Key, CodeType> m_disk_cache;
+  std::string m_filename;
+
+  u64 m_max_size = 0;
+  u64 m_size = 0;
+  // Incremented on every use, to find the least recently used shaders.
+  u64 m_use_counter = 0;
+  // Shaders last used before this value haven't been used in this session yet.
+  u64 m_session_start = 0;
+  u32 m_usage_records = 0;
+  bool m_needs_compaction = false;
+
+  Statistics m_statistics;
+};
+
+// The cache used by CompileShaderToSPV, or nullptr if there is none. Shaders can be compiled on
+// any thread, so callers get their own reference, which keeps the cache open until they are done
+// with it even if it is replaced in the meantime.
+std::shared_ptr<SharedCache> GetSharedCache();
+void SetSharedCache(std::shared_ptr<SharedCache> cache);
+}  // namespace SPIRV
@@ -0,0 +1,296 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "VideoCommon/SpirvCompilerPool.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "Common/ChildProcess.h"
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+
+namespace SPIRV
+{
+namespace
+{
+std::mutex s_pool_lock;
+std::shared_ptr<CompilerPool> s_pool;
+
+// Messages are a header followed by the strings and code it gives the sizes of. Both processes are
+// the same build on the same machine, so the messages don't need to be portable.
+struct RequestHeader
+{
+  u32 stage;
+  u32 api_type;
+  u32 language_version;
+  u32 debug_info;
+  u32 source_size;
+};
+
+struct ResultHeader
+{
+  u32 code_size;
+  std::array<u32, 6> string_sizes;
+};
+
+// Anything bigger means that the worker sent garbage.
+constexpr u32 MAX_MESSAGE_PART_SIZE = 256 * 1024 * 1024;
+
+// The biggest ubershaders take a few seconds to compile, a worker that takes this long is stuck.
+constexpr std::chrono::milliseconds COMPILE_TIMEOUT = std::chrono::seconds(60);
+
+std::array<std::string*, 6> GetResultStrings(CompileResult& result)
+{
+  return {&result.error,           &result.shader_info_log,  &result.shader_debug_log,
+          &result.program_info_log, &result.program_debug_log, &result.spv_messages};
+}
+
+void AppendBytes(std::vector<u8>* message, const void* data, size_t size)
+{
+  const u8* bytes = static_cast<const u8*>(data);
+  message->insert(message->end(), bytes, bytes + size);
+}
+
+std::vector<u8> SerializeRequest(EShLanguage stage, APIType api_type,
+                                 glslang::EShTargetLanguageVersion language_version,
+                                 bool debug_info, std::string_view source)
+{
+  const RequestHeader header{static_cast<u32>(stage), static_cast<u32>(api_type),
+                             static_cast<u32>(language_version), debug_info,
+                             static_cast<u32>(source.size())};
+
+  std::vector<u8> message;
+  message.reserve(sizeof(header) + source.size());
+  AppendBytes(&message, &header, sizeof(header));
+  AppendBytes(&message, source.data(), source.size());
+  return message;
+}
+
+std::vector<u8> SerializeResult(CompileResult& result)
+{
+  const std::array<std::string*, 6> strings = GetResultStrings(result);
+
+  ResultHeader header{static_cast<u32>(result.code.size())};
+  for (size_t i = 0; i < strings.size(); ++i)
+    header.string_sizes[i] = static_cast<u32>(strings[i]->size());
+
+  std::vector<u8> message;
+  AppendBytes(&message, &header, sizeof(header));
+  AppendBytes(&message, result.code.data(), result.code.size() * sizeof(CodeType));
+  for (const std::string* string : strings)
+    AppendBytes(&message, string->data(), string->size());
+  return message;
+}
+
+std::optional<CompileResult> ReadResult(Common::ChildProcess& process)
+{
+  ResultHeader header;
+  if (!process.Read(&header, sizeof(header), COMPILE_TIMEOUT))
+    return std::nullopt;
+
+  CompileResult result;
+  if (header.code_size > MAX_MESSAGE_PART_SIZE / sizeof(CodeType))
+    return std::nullopt;
+  result.code.resize(header.code_size);
+  if (!process.Read(result.code.data(), result.code.size() * sizeof(CodeType), COMPILE_TIMEOUT))
+    return std::nullopt;
+
+  const std::array<std::string*, 6> strings = GetResultStrings(result);
+  for (size_t i = 0; i < strings.size(); ++i)
+  {
+    if (header.string_sizes[i] > MAX_MESSAGE_PART_SIZE)
+      return std::nullopt;
+    strings[i]->resize(header.string_sizes[i]);
+    if (!process.Read(strings[i]->data(), strings[i]->size(), COMPILE_TIMEOUT))
+      return std::nullopt;
+  }
+
+  return result;
+}
+}  // namespace
+
+std::shared_ptr<CompilerPool> GetCompilerPool()
+{
+  std::lock_guard lk(s_pool_lock);
+  return s_pool;
+}
+
+void SetCompilerPool(std::shared_ptr<CompilerPool> pool)
+{
+  // The old pool is stopped outside of the lock, once nothing else uses it anymore.
+  std::lock_guard lk(s_pool_lock);
+  s_pool.swap(pool);
+}
+
+CompilerPool::~CompilerPool()
+{
+  Stop();
+}
+
+bool CompilerPool::Start(const std::string& executable, u32 num_processes)
+{
+  Stop();
+
+  m_executable = executable;
+  for (u32 i = 0; i < num_processes; ++i)
+  {
+    auto process = std::make_unique<Common::ChildProcess>();
+    if (!StartProcess(*process))
+      break;
+
+    m_idle_processes.push_back(m_processes.size());
+    m_processes.push_back(std::move(process));
+  }
+
+  if (m_processes.empty())
+    return false;
+
+  INFO_LOG_FMT(VIDEO, "Started {} shader compiler processes", m_processes.size());
+  return true;
+}
+
+void CompilerPool::Stop()
+{
+  m_idle_processes.clear();
+  m_processes.clear();
+}
+
+bool CompilerPool::StartProcess(Common::ChildProcess& process)
+{
+  if (process.Start(m_executable, {"spirvworker"}))
+    return true;
+
+  WARN_LOG_FMT(VIDEO, "Failed to start shader compiler process {}", m_executable);
+  return false;
+}
+
+std::optional<CompileResult>
+CompilerPool::Compile(EShLanguage stage, APIType api_type,
+                      glslang::EShTargetLanguageVersion language_version, bool debug_info,
+                      std::string_view source)
+{
+  const std::vector<u8> request =
+      SerializeRequest(stage, api_type, language_version, debug_info, source);
+
+  size_t index;
+  {
+    std::unique_lock lock(m_lock);
+    m_process_available.wait(lock, [this] { return !m_idle_processes.empty(); });
+    index = m_idle_processes.back();
+    m_idle_processes.pop_back();
+  }
+
+  Common::ChildProcess& process = *m_processes[index];
+
+  // A process that has exited since its last shader, crashed on it or stopped taking input is
+  // restarted (which kills it first) before the shader is blamed for anything.
+  bool sent = process.IsRunning() && process.Write(request.data(), request.size(), COMPILE_TIMEOUT);
+  if (!sent)
+  {
+    sent = StartProcess(process) &&
+           process.Write(request.data(), request.size(), COMPILE_TIMEOUT);
+  }
+
+  std::optional<CompileResult> result;
+  if (sent)
+  {
+    const auto start_time = std::chrono::steady_clock::now();
+    result = ReadResult(process);
+    if (!result)
+    {
+      // Stopping the process also kills it if it's stuck.
+      process.Stop();
+      const bool timed_out = std::chrono::steady_clock::now() - start_time >= COMPILE_TIMEOUT;
+      ERROR_LOG_FMT(VIDEO, "Shader compiler process {}, restarting it for the next shader",
+                    timed_out ? "timed out" : "crashed");
+      result.emplace();
+      result->error = timed_out ? "Shader compiler process timed out" :
+                                  "Shader compiler process crashed";
+    }
+  }
+  else
+  {
+    process.Stop();
+  }
+
+  {
+    std::lock_guard lock(m_lock);
+    m_idle_processes.push_back(index);
+  }
+  m_process_available.notify_one();
+
+  return result;
+}
+
+std::string GetCompilerWorkerPath()
+{
+#if defined(_WIN32) && defined(_DEBUG)
+  return File::GetExeDirectory() + DIR_SEP "DolphinToolD.exe";
+#elif defined(_WIN32)
+  return File::GetExeDirectory() + DIR_SEP "DolphinTool.exe";
+#else
+  return File::GetExeDirectory() + DIR_SEP "dolphin-tool";
+#endif
+}
+
+int RunCompilerWorker()
+{
+  // Results go to a copy of standard output, which is then pointed at standard error. That way
+  // nothing else that gets printed can end up in the middle of a result.
+#ifdef _WIN32
+  _setmode(_fileno(stdin), _O_BINARY);
+  const int output_fd = _dup(_fileno(stdout));
+  _dup2(_fileno(stderr), _fileno(stdout));
+  _setmode(output_fd, _O_BINARY);
+  std::FILE* output = _fdopen(output_fd, "wb");
+#else
+  const int output_fd = dup(STDOUT_FILENO);
+  dup2(STDERR_FILENO, STDOUT_FILENO);
+  std::FILE* output = fdopen(output_fd, "wb");
+#endif
+  if (!output)
+    return EXIT_FAILURE;
+
+  for (;;)
+  {
+    RequestHeader header;
+    if (std::fread(&header, sizeof(header), 1, stdin) != 1)
+      return EXIT_SUCCESS;
+
+    if (header.source_size > MAX_MESSAGE_PART_SIZE)
+      return EXIT_FAILURE;
+    std::string source(header.source_size, '\0');
+    if (!source.empty() && std::fread(source.data(), source.size(), 1, stdin) != 1)
+      return EXIT_FAILURE;
+
+    CompileResult result =
+        CompileShader(static_cast<EShLanguage>(header.stage),
+                      static_cast<APIType>(header.api_type),
+                      static_cast<glslang::EShTargetLanguageVersion>(header.language_version),
+                      header.debug_info != 0, source);
+
+    const std::vector<u8> message = SerializeResult(result);
+    if (std::fwrite(message.data(), message.size(), 1, output) != 1 || std::fflush(output) != 0)
+      return EXIT_FAILURE;
+  }
+}
+}  // namespace SPIRV
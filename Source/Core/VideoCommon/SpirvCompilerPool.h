@@ -0,0 +1,73 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Common/ChildProcess.h"
+#include "Common/CommonTypes.h"
+#include "VideoCommon/Spirv.h"
+#include "VideoCommon/VideoCommon.h"
+
+namespace SPIRV
+{
+// Compiles shaders in worker processes (dolphin-tool spirvworker) instead of on the calling
+// thread. glslang holds a global lock for parts of every compile, so compiling in-process stops
+// scaling after a few threads, while every process has its own. A worker that crashes or gets
+// stuck only fails the shader it was compiling, and is restarted for the next one.
+//
+// The workers run with the same user, environment and privileges as Dolphin. They're isolated
+// from it only in that they have their own address space, not sandboxed.
+class CompilerPool
+{
+public:
+  CompilerPool() = default;
+  ~CompilerPool();
+
+  CompilerPool(const CompilerPool&) = delete;
+  CompilerPool& operator=(const CompilerPool&) = delete;
+
+  // Returns false if not a single worker process could be started.
+  bool Start(const std::string& executable, u32 num_processes);
+  // Must not be called while shaders are being compiled.
+  void Stop();
+
+  u32 GetProcessCount() const { return static_cast<u32>(m_processes.size()); }
+
+  // Can be called from any thread, and waits for a worker process to become free.
+  // Returns std::nullopt if the worker process could not be restarted, in which case the shader
+  // has to be compiled in-process.
+  std::optional<CompileResult> Compile(EShLanguage stage, APIType api_type,
+                                       glslang::EShTargetLanguageVersion language_version,
+                                       bool debug_info, std::string_view source);
+
+private:
+  bool StartProcess(Common::ChildProcess& process);
+
+  std::string m_executable;
+  std::vector<std::unique_ptr<Common::ChildProcess>> m_processes;
+
+  std::mutex m_lock;
+  std::condition_variable m_process_available;
+  std::vector<size_t> m_idle_processes;
+};
+
+// The dolphin-tool executable that is installed next to the running one.
+std::string GetCompilerWorkerPath();
+
+// Compiles the shaders sent to standard input and writes the results to standard output, until
+// standard input is closed. This is the worker process side of CompilerPool.
+int RunCompilerWorker();
+
+// The pool used by CompileShaderToSPV, or nullptr if shaders are compiled in-process. Callers get
+// their own reference, which keeps the worker processes alive until their compile has finished.
+std::shared_ptr<CompilerPool> GetCompilerPool();
+void SetCompilerPool(std::shared_ptr<CompilerPool> pool);
+}  // namespace SPIRV
@@ -3,6 +3,10 @@
 
 #include "VideoCommon/Statistics.h"
 
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cinttypes>
 #include <cstring>
 #include <utility>
 
@@ -12,6 +16,7 @@
 #include "Core/HW/SystemTimers.h"
 #include "Core/System.h"
 
+#include "VideoCommon/Assets/CustomAssetLoader.h"
 #include "VideoCommon/BPFunctions.h"
 #include "VideoCommon/VideoCommon.h"
 #include "VideoCommon/VideoConfig.h"
@@ -114,9 +119,40 @@ void Statistics::Display() const
   draw_statistic("EFB pokes:", "%d", this_frame.num_efb_pokes);
   draw_statistic("Draw dones:", "%d", this_frame.num_draw_done);
   draw_statistic("Tokens:", "%d/%d", this_frame.num_token, this_frame.num_token_int);
+  draw_statistic("Shader queue:", "%zu", shader_compiler.queue_depth);
+  draw_statistic("Shaders compiled:", "%" PRIu64 " (%" PRIu64 " failed)", shader_compiler.compiled,
+                 shader_compiler.failed);
+  draw_statistic("Shaders promoted:", "%" PRIu64, shader_compiler.promoted);
+  draw_statistic("Shaders cancelled:", "%" PRIu64, shader_compiler.cancelled);
+  draw_statistic("Shaders stolen:", "%" PRIu64, shader_compiler.stolen);
+
+  const VideoCommon::CustomAssetLoader::Statistics custom_assets =
+      Core::System::GetInstance().GetCustomAssetLoader().GetStatistics();
+  if (custom_assets.loaded != 0 || custom_assets.failed != 0 || custom_assets.queued != 0)
+  {
+    draw_statistic("Assets queued:", "%zu", custom_assets.queued);
+    draw_statistic("Assets loaded:", "%" PRIu64 " (%" PRIu64 " failed)", custom_assets.loaded,
+                   custom_assets.failed);
+    draw_statistic("Asset load time:", "%.1f ms avg, %.1f ms max",
+                   custom_assets.average_latency_us / 1000.0,
+                   custom_assets.max_latency_us / 1000.0);
+    draw_statistic("Asset memory:", "%zu / %zu MiB%s", custom_assets.bytes_loaded / (1024 * 1024),
+                   custom_assets.max_bytes / (1024 * 1024),
+                   custom_assets.memory_exceeded ? " (full)" : "");
+  }
 
   ImGui::Columns(1);
 
+  // The buckets are <1 ms, <2 ms, <4 ms and so on.
+  const auto draw_histogram = [scale](const char* name, const auto& histogram) {
+    std::array<float, VideoCommon::AsyncShaderCompiler::Metrics::HISTOGRAM_BUCKETS> values;
+    std::copy(histogram.begin(), histogram.end(), values.begin());
+    ImGui::PlotHistogram(name, values.data(), static_cast<int>(values.size()), 0, nullptr, 0.0f,
+                         FLT_MAX, ImVec2(0.0f, 40.0f * scale));
+  };
+  draw_histogram("Shader wait (ms)", shader_compiler.wait_time);
+  draw_histogram("Shader compile (ms)", shader_compiler.compile_time);
+
   ImGui::End();
 }
 
@@ -6,6 +6,7 @@
 #include <array>
 #include <vector>
 
+#include "VideoCommon/AsyncShaderCompiler.h"
 #include "VideoCommon/BPFunctions.h"
 
 struct Statistics
@@ -21,6 +22,9 @@ struct Statistics
 
   int num_vertex_loaders = 0;
 
+  // Updated by the shader cache every frame.
+  VideoCommon::AsyncShaderCompiler::Metrics shader_compiler;
+
   std::array<float, 6> proj{};
   std::array<float, 16> gproj{};
   std::array<float, 16> g2proj{};
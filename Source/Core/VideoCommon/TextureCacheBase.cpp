@@ -148,7 +148,8 @@ void TextureCacheBase::Invalidate()
 void TextureCacheBase::OnConfigChanged(const VideoConfig& config)
 {
   if (config.bHiresTextures != m_backup_config.hires_textures ||
-      config.bCacheHiresTextures != m_backup_config.cache_hires_textures)
+      config.bCacheHiresTextures != m_backup_config.cache_hires_textures ||
+      config.bHiresTextureDiskCache != m_backup_config.hires_texture_disk_cache)
   {
     HiresTexture::Update();
   }
@@ -251,6 +252,7 @@ void TextureCacheBase::SetBackupConfig(const VideoConfig& config)
   m_backup_config.texfmt_overlay_center = config.bTexFmtOverlayCenter;
   m_backup_config.hires_textures = config.bHiresTextures;
   m_backup_config.cache_hires_textures = config.bCacheHiresTextures;
+  m_backup_config.hires_texture_disk_cache = config.bHiresTextureDiskCache;
   m_backup_config.stereo_3d = config.stereo_mode != StereoMode::Off;
   m_backup_config.efb_mono_depth = config.bStereoEFBMonoDepth;
   m_backup_config.gpu_texture_decoding = config.bEnableGPUTextureDecoding;
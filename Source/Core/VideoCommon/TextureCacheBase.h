@@ -431,6 +431,7 @@ private:
     bool texfmt_overlay_center;
     bool hires_textures;
     bool cache_hires_textures;
+    bool hires_texture_disk_cache;
     bool copy_cache_enable;
     bool stereo_3d;
     bool efb_mono_depth;
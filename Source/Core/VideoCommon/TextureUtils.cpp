@@ -3,19 +3,31 @@
 
 #include "VideoCommon/TextureUtils.h"
 
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
 #include <fmt/format.h>
 
 #include "Common/FileSearch.h"
 #include "Common/FileUtil.h"
+#include "Common/Image.h"
 #include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
 
 #include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
 
+#include "VideoCommon/AbstractGfx.h"
+#include "VideoCommon/AbstractStagingTexture.h"
 #include "VideoCommon/AbstractTexture.h"
 
 namespace
 {
+constexpr u32 MAX_ENCODER_THREADS = 4;
+constexpr size_t MAX_QUEUED_BYTES = 256 * 1024 * 1024;
+constexpr char DUMP_INDEX_FILENAME[] = "dumped_textures.txt";
+
 std::string BuildDumpTextureFilename(std::string basename, u32 level, bool is_arbitrary)
 {
   if (is_arbitrary)
@@ -47,34 +59,133 @@ void DumpTexture(const ::AbstractTexture& texture, std::string basename, u32 lev
   texture.Save(filename, level, Config::Get(Config::GFX_TEXTURE_PNG_COMPRESSION_LEVEL));
 }
 
-void TextureDumper::DumpTexture(const ::AbstractTexture& texture, std::string basename, u32 level,
-                                bool is_arbitrary)
+TextureDumper::TextureDumper() = default;
+
+TextureDumper::~TextureDumper()
 {
-  const std::string dump_dir =
-      File::GetUserPath(D_DUMPTEXTURES_IDX) + SConfig::GetInstance().GetGameID();
+  // Write out everything that's still queued before the index is closed.
+  for (auto& thread : m_encoder_threads)
+    thread->Shutdown();
+}
 
-  if (m_dumped_textures.empty())
-  {
-    if (!File::IsDirectory(dump_dir))
-      File::CreateDir(dump_dir);
+void TextureDumper::LoadDumpedTextures(const std::string& dump_dir)
+{
+  if (!File::IsDirectory(dump_dir))
+    File::CreateDir(dump_dir);
 
+  // Deleting the index makes the next session search the dump directory again.
+  const std::string index_filename = fmt::format("{}/{}", dump_dir, DUMP_INDEX_FILENAME);
+  std::string index;
+  const bool has_index = File::ReadFileToString(index_filename, index);
+  if (has_index)
+  {
+    for (std::string& name : SplitString(index, '\n'))
+    {
+      if (!name.empty())
+        m_dumped_textures.insert(std::move(name));
+    }
+  }
+  else
+  {
     for (auto& filename : Common::DoFileSearch({dump_dir}, {".png"}, true))
     {
       std::string name;
       SplitPath(filename, nullptr, &name, nullptr);
       m_dumped_textures.insert(name);
     }
+  }
 
-    NOTICE_LOG_FMT(VIDEO, "Found {} dumped textures that will not be re-dumped.",
-                   m_dumped_textures.size());
+  m_index_file.Open(index_filename, "ab");
+  if (!has_index)
+  {
+    for (const std::string& name : m_dumped_textures)
+      m_index_file.WriteString(name + '\n');
+    m_index_file.Flush();
   }
 
-  const std::string name = BuildDumpTextureFilename(std::move(basename), level, is_arbitrary);
+  NOTICE_LOG_FMT(VIDEO, "Found {} dumped textures that will not be re-dumped.",
+                 m_dumped_textures.size());
+
+  const u32 thread_count =
+      std::clamp(std::thread::hardware_concurrency() / 2, 1u, MAX_ENCODER_THREADS);
+  for (u32 i = 0; i < thread_count; i++)
+  {
+    m_encoder_threads.push_back(std::make_unique<Common::WorkQueueThread<EncodeTask>>(
+        "Texture Dump Encoder", [this](EncodeTask task) { EncodeTexture(std::move(task)); }));
+  }
+}
+
+void TextureDumper::DumpTexture(const ::AbstractTexture& texture, std::string basename, u32 level,
+                                bool is_arbitrary)
+{
+  const std::string dump_dir =
+      File::GetUserPath(D_DUMPTEXTURES_IDX) + SConfig::GetInstance().GetGameID();
+
+  if (m_encoder_threads.empty())
+    LoadDumpedTextures(dump_dir);
+
+  std::string name = BuildDumpTextureFilename(std::move(basename), level, is_arbitrary);
   const bool file_existed = !m_dumped_textures.insert(name).second;
   if (file_existed)
     return;
 
-  texture.Save(fmt::format("{}/{}.png", dump_dir, name), level,
-               Config::Get(Config::GFX_TEXTURE_PNG_COMPRESSION_LEVEL));
+  // Reading the texture back needs the GPU, so only the PNG encoding is moved off this thread.
+  const u32 width = std::max(1u, texture.GetWidth() >> level);
+  const u32 height = std::max(1u, texture.GetHeight() >> level);
+  const size_t size = static_cast<size_t>(width) * height * 4;
+  WaitForQueueSpace(size);
+
+  const TextureConfig readback_config(width, height, 1, 1, 1, AbstractTextureFormat::RGBA8, 0,
+                                      AbstractTextureType::Texture_2DArray);
+  auto readback_texture =
+      g_gfx->CreateStagingTexture(StagingTextureType::Readback, readback_config);
+  if (!readback_texture)
+    return;
+
+  readback_texture->CopyFromTexture(&texture, 0, level);
+  readback_texture->Flush();
+  if (!readback_texture->Map())
+    return;
+
+  EncodeTask task{std::move(name), "", {}, width, height,
+                  Config::Get(Config::GFX_TEXTURE_PNG_COMPRESSION_LEVEL)};
+  task.filename = fmt::format("{}/{}.png", dump_dir, task.name);
+  task.data.resize(size);
+  const char* src = readback_texture->GetMappedPointer();
+  const size_t src_stride = readback_texture->GetMappedStride();
+  const size_t dst_stride = static_cast<size_t>(width) * 4;
+  for (u32 row = 0; row < height; row++)
+    std::memcpy(task.data.data() + row * dst_stride, src + row * src_stride, dst_stride);
+
+  m_queued_bytes += size;
+  m_encoder_threads[m_next_encoder_thread]->Push(std::move(task));
+  m_next_encoder_thread = (m_next_encoder_thread + 1) % m_encoder_threads.size();
+}
+
+void TextureDumper::WaitForQueueSpace(size_t size)
+{
+  // A texture larger than the limit is still queued once everything before it is written.
+  while (m_queued_bytes.load() != 0 && m_queued_bytes.load() + size > MAX_QUEUED_BYTES)
+    m_task_encoded.Wait();
+}
+
+void TextureDumper::EncodeTexture(EncodeTask task)
+{
+  const bool saved =
+      Common::SavePNG(task.filename, task.data.data(), Common::ImageByteFormat::RGBA, task.width,
+                      task.height, task.width * 4, task.compression);
+
+  m_queued_bytes -= task.data.size();
+  m_task_encoded.Set();
+
+  if (!saved)
+  {
+    ERROR_LOG_FMT(VIDEO, "Failed to dump texture to {}", task.filename);
+    return;
+  }
+
+  std::lock_guard guard(m_index_lock);
+  m_index_file.WriteString(task.name + '\n');
+  m_index_file.Flush();
 }
 }  // namespace VideoCommon::TextureUtils
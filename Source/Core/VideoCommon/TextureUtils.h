@@ -3,10 +3,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "Common/IOFile.h"
+#include "Common/WorkQueueThread.h"
 
 class AbstractTexture;
 
@@ -15,12 +22,46 @@ namespace VideoCommon::TextureUtils
 class TextureDumper
 {
 public:
+  TextureDumper();
+  ~TextureDumper();
+
+  TextureDumper(const TextureDumper&) = delete;
+  TextureDumper& operator=(const TextureDumper&) = delete;
+
   // Only dumps if texture did not already exist anywhere within the dump-textures path.
+  // The texture is read back on the calling thread, but encoded to PNG on a worker thread.
   void DumpTexture(const ::AbstractTexture& texture, std::string basename, u32 level,
                    bool is_arbitrary);
 
 private:
+  struct EncodeTask
+  {
+    std::string name;
+    std::string filename;
+    std::vector<u8> data;
+    u32 width;
+    u32 height;
+    int compression;
+  };
+
+  void LoadDumpedTextures(const std::string& dump_dir);
+  void EncodeTexture(EncodeTask task);
+  void WaitForQueueSpace(size_t size);
+
   std::unordered_set<std::string> m_dumped_textures;
+
+  // Names of the textures written to the dump directory, so that starting a dumping session
+  // doesn't have to search the whole directory.
+  std::mutex m_index_lock;
+  File::IOFile m_index_file;
+
+  u32 m_next_encoder_thread = 0;
+  std::vector<std::unique_ptr<Common::WorkQueueThread<EncodeTask>>> m_encoder_threads;
+
+  // Every queued task holds a full RGBA copy of its texture, so the amount of queued data is
+  // limited, and dumping waits for the encoders when it's reached.
+  std::atomic<size_t> m_queued_bytes{0};
+  Common::Event m_task_encoded;
 };
 
 void DumpTexture(const ::AbstractTexture& texture, std::string basename, u32 level,
@@ -293,6 +293,28 @@ PixelShaderUid GetPixelShaderUid()
   return out;
 }
 
+PixelShaderUid GetPixelShaderVariantUid(const PixelShaderUid& uid)
+{
+  PixelShaderUid out = uid;
+
+  pixel_ubershader_uid_data* const uid_data = out.GetUidData();
+  const u32 num_stages = bpmem.genMode.numtevstages + 1;
+  while (uid_data->tev_stage_limit < 3 && num_stages <= uid_data->GetMaxTevStages() / 2)
+    uid_data->tev_stage_limit++;
+
+  // Indirect texturing (including wrapping and adding the previous coordinates) only happens for
+  // stages with a non-zero tevind, and the ubershader only handles it when there are texgens.
+  if (uid_data->num_texgens != 0)
+  {
+    bool has_indirect_stages = false;
+    for (u32 i = 0; i < num_stages; i++)
+      has_indirect_stages |= bpmem.tevind[i].hex != 0;
+    uid_data->no_indirect_stages = !has_indirect_stages;
+  }
+
+  return out;
+}
+
 void ClearUnusedPixelShaderUidBits(APIType api_type, const ShaderHostConfig& host_config,
                                    PixelShaderUid* uid)
 {
@@ -326,6 +348,8 @@ ShaderCode GenPixelShader(APIType api_type, const ShaderHostConfig& host_config,
   const bool per_pixel_depth = uid_data->per_pixel_depth != 0;
   const bool bounding_box = host_config.bounding_box;
   const u32 numTexgen = uid_data->num_texgens;
+  const u32 max_tev_stages = uid_data->GetMaxTevStages();
+  const bool has_indirect_stages = !uid_data->no_indirect_stages;
   ShaderCode out;
 
   ASSERT_MSG(VIDEO, !(use_dual_source && use_framebuffer_fetch),
@@ -947,9 +971,22 @@ ShaderCode GenPixelShader(APIType api_type, const ShaderHostConfig& host_config,
 
   out.Write("  // Main tev loop\n");
 
-  out.Write("  for(uint stage = 0u; stage <= num_stages; stage++)\n"
-            "  {{\n"
-            "    StageState ss;\n"
+  if (max_tev_stages < 16)
+  {
+    // A constant trip count lets the driver unroll the loop for this variant.
+    out.Write("  for(uint stage = 0u; stage < {}u; stage++)\n"
+              "  {{\n"
+              "    if (stage > num_stages)\n"
+              "      break;\n"
+              "\n",
+              max_tev_stages);
+  }
+  else
+  {
+    out.Write("  for(uint stage = 0u; stage <= num_stages; stage++)\n"
+              "  {{\n");
+  }
+  out.Write("    StageState ss;\n"
             "    ss.stage = stage;\n"
             "    ss.cc = bpmem_combiners(stage).x;\n"
             "    ss.ac = bpmem_combiners(stage).y;\n"
@@ -977,6 +1014,9 @@ ShaderCode GenPixelShader(APIType api_type, const ShaderHostConfig& host_config,
               "\n"
               "    bool texture_enabled = (ss.order & {}u) != 0u;\n",
               1 << TwoTevStageOrders().enable_tex_even.StartBit());
+  }
+  if (numTexgen != 0 && has_indirect_stages)
+  {
     out.Write("\n"
               "    // Indirect textures\n"
               "    uint tevind = bpmem_tevind(stage);\n"
@@ -1083,8 +1123,17 @@ ShaderCode GenPixelShader(APIType api_type, const ShaderHostConfig& host_config,
               "    else\n"
               "    {{\n"
               "      tevcoord.xy = fixedPoint_uv;\n"
-              "    }}\n"
-              "\n"
+              "    }}\n");
+  }
+  else if (numTexgen != 0)
+  {
+    // No stage uses indirect texturing in this variant.
+    out.Write("\n"
+              "    tevcoord.xy = fixedPoint_uv;\n");
+  }
+  if (numTexgen != 0)
+  {
+    out.Write("\n"
               "    // Sample texture for stage\n"
               "    if (texture_enabled) {{\n"
               "      uint sampler_num = {};\n",
@@ -1239,7 +1288,7 @@ ShaderCode GenPixelShader(APIType api_type, const ShaderHostConfig& host_config,
   WriteSwitch(out, api_type, "alpha_dest", tev_a_set_table, 6, true);
   if (has_custom_shader_details)
   {
-    for (u32 stage_index = 0; stage_index < 16; stage_index++)
+    for (u32 stage_index = 0; stage_index < max_tev_stages; stage_index++)
     {
       out.Write("\tif (stage == {}u) {{\n", stage_index);
       // Color input
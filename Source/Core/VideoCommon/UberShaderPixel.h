@@ -20,6 +20,14 @@ struct pixel_ubershader_uid_data
   u32 uint_output : 1;
   u32 no_dual_src : 1;
 
+  // Variant selection. Zero is the generic ubershader, which can draw with any BP state.
+  // Variants only loop over 16 >> tev_stage_limit TEV stages, and leave out indirect texturing when
+  // no_indirect_stages is set.
+  u32 tev_stage_limit : 2;
+  u32 no_indirect_stages : 1;
+
+  u32 GetMaxTevStages() const { return 16u >> tev_stage_limit; }
+
   u32 NumValues() const { return sizeof(pixel_ubershader_uid_data); }
 };
 #pragma pack()
@@ -27,6 +35,9 @@ struct pixel_ubershader_uid_data
 using PixelShaderUid = ShaderUid<pixel_ubershader_uid_data>;
 
 PixelShaderUid GetPixelShaderUid();
+// Returns the variant of the given generic ubershader that is cheapest for the current BP state.
+// Variants are compiled on demand, so the generic ubershader should be used until it is ready.
+PixelShaderUid GetPixelShaderVariantUid(const PixelShaderUid& uid);
 
 ShaderCode GenPixelShader(APIType api_type, const ShaderHostConfig& host_config,
                           const pixel_ubershader_uid_data* uid_data,
@@ -45,7 +56,8 @@ struct fmt::formatter<UberShader::pixel_ubershader_uid_data>
   auto format(const UberShader::pixel_ubershader_uid_data& uid, FormatContext& ctx) const
   {
     return fmt::format_to(
-        ctx.out(), "Pixel UberShader for {} texgens{}{}{}{}", uid.num_texgens,
+        ctx.out(), "Pixel UberShader for {} texgens, up to {} TEV stages{}{}{}{}{}",
+        uid.num_texgens, uid.GetMaxTevStages(), uid.no_indirect_stages ? ", no indirect" : "",
         uid.early_depth ? ", early-depth" : "", uid.per_pixel_depth ? ", per-pixel depth" : "",
         uid.uint_output ? ", uint output" : "", uid.no_dual_src ? ", no dual-source blending" : "");
   }
@@ -820,6 +820,8 @@ void VertexManagerBase::UpdatePipelineConfig()
   {
     m_current_pipeline_config.ps_uid = ps_uid;
     m_current_uber_pipeline_config.ps_uid = UberShader::GetPixelShaderUid();
+    m_current_uber_ps_variant_uid =
+        UberShader::GetPixelShaderVariantUid(m_current_uber_pipeline_config.ps_uid);
     m_pipeline_config_changed = true;
   }
 
@@ -894,8 +896,7 @@ void VertexManagerBase::UpdatePipelineObject()
   case ShaderCompilationMode::SynchronousUberShaders:
   {
     // Exclusive ubershader mode, always use ubershaders.
-    m_current_pipeline_object =
-        g_shader_cache->GetUberPipelineForUid(m_current_uber_pipeline_config);
+    m_current_pipeline_object = GetUberPipelineObject();
   }
   break;
 
@@ -914,8 +915,7 @@ void VertexManagerBase::UpdatePipelineObject()
     if (g_ActiveConfig.iShaderCompilationMode == ShaderCompilationMode::AsynchronousUberShaders)
     {
       // Specialized shaders not ready, use the ubershaders.
-      m_current_pipeline_object =
-          g_shader_cache->GetUberPipelineForUid(m_current_uber_pipeline_config);
+      m_current_pipeline_object = GetUberPipelineObject();
     }
     else
     {
@@ -928,6 +928,27 @@ void VertexManagerBase::UpdatePipelineObject()
   }
 }
 
+const AbstractPipeline* VertexManagerBase::GetUberPipelineObject()
+{
+  // Without compiler threads, compiling the variant would stall just like a specialized shader.
+  if (g_ActiveConfig.bUberShaderVariants && g_ActiveConfig.GetShaderCompilerThreads() > 0)
+  {
+    // The ubershader variant for the current TEV configuration is much cheaper per pixel than the
+    // generic one, but isn't precompiled. Draw with the generic ubershader while it compiles.
+    VideoCommon::GXUberPipelineUid variant_config = m_current_uber_pipeline_config;
+    variant_config.ps_uid = m_current_uber_ps_variant_uid;
+    const auto res = g_shader_cache->GetUberPipelineForUidAsync(variant_config);
+    if (res && *res)
+      return *res;
+
+    // Try again next draw, so that the variant is used as soon as it is ready.
+    if (!res)
+      m_pipeline_config_changed = true;
+  }
+
+  return g_shader_cache->GetUberPipelineForUid(m_current_uber_pipeline_config);
+}
+
 void VertexManagerBase::OnConfigChange()
 {
   // Reload index generator function tables in case VS expand config changed
@@ -127,6 +127,8 @@ struct VideoConfig final
   float widescreen_heuristic_widescreen_ratio = 0.f;
   bool bCrop = false;  // Aspect ratio controls.
   bool bShaderCache = false;
+  // Size limit of the SPIR-V cache shared by all games in MiB. 0 disables it.
+  int iSharedShaderCacheSize = 0;
 
   // Enhancements
   u32 iMultisamples = 0;
@@ -190,13 +192,19 @@ struct VideoConfig final
   bool bDumpBaseTextures = false;
   bool bHiresTextures = false;
   bool bCacheHiresTextures = false;
+  // Keep decoded PNG custom textures in the cache folder, so that later sessions load faster.
+  bool bHiresTextureDiskCache = false;
   bool bDumpEFBTarget = false;
   bool bDumpXFBTarget = false;
   bool bDumpFramesAsImages = false;
+  // Takes priority over bDumpFramesAsImages.
+  bool bDumpFramesAsCapture = false;
   bool bUseFFV1 = false;
   std::string sDumpCodec;
   std::string sDumpPixelFormat;
   std::string sDumpEncoder;
+  // 0 lets FFmpeg pick the number of encoder threads.
+  int iDumpEncoderThreads = 0;
   std::string sDumpFormat;
   std::string sDumpPath;
   FrameDumpResolutionType frame_dumps_resolution_type =
@@ -268,12 +276,18 @@ struct VideoConfig final
   // Shader compilation settings.
   bool bWaitForShadersBeforeStarting = false;
   ShaderCompilationMode iShaderCompilationMode{};
+  // Draw with pixel ubershaders specialized for the current TEV stages once they are compiled.
+  bool bUberShaderVariants = false;
 
   // Number of shader compiler threads.
   // 0 disables background compilation.
   // -1 uses an automatic number based on the CPU threads.
   int iShaderCompilerThreads = 0;
   int iShaderPrecompilerThreads = 0;
+  // Number of processes compiling SPIR-V for the compiler threads.
+  // 0 compiles on the compiler threads themselves.
+  // -1 uses one process per compiler thread.
+  int iShaderCompilerProcesses = 0;
 
   // Loading custom drivers on Android
   std::string customDriverLibraryName;
@@ -381,6 +395,7 @@ struct VideoConfig final
   bool UsingUberShaders() const;
   u32 GetShaderCompilerThreads() const;
   u32 GetShaderPrecompilerThreads() const;
+  u32 GetShaderCompilerProcesses() const;
 
   float GetCustomAspectRatio() const { return (float)custom_aspect_width / custom_aspect_height; }
 };
@@ -14,20 +14,24 @@
 #include "Core/DSP/DSPDisassembler.h"
 #include "Core/DSP/DSPHost.h"
 #include "Core/DSP/DSPTables.h"
+#include "TraceBenchmark.h"
 
 // Stub out the dsplib host stuff, since this is just a simple cmdline tools.
 u8 DSP::Host::ReadHostMemory(u32 addr)
 {
-  return 0;
+  return TraceBenchmark::ReadARAM(addr);
 }
 void DSP::Host::WriteHostMemory(u8 value, u32 addr)
 {
+  TraceBenchmark::WriteARAM(value, addr);
 }
 void DSP::Host::DMAToDSP(u16* dst, u32 addr, u32 size)
 {
+  TraceBenchmark::DMAToDSP(dst, addr, size);
 }
 void DSP::Host::DMAFromDSP(const u16* src, u32 addr, u32 size)
 {
+  TraceBenchmark::DMAFromDSP(src, addr, size);
 }
 void DSP::Host::OSD_AddMessage(std::string str, u32 ms)
 {
@@ -42,12 +46,15 @@ bool DSP::Host::IsWiiHost()
 }
 void DSP::Host::CodeLoaded(DSPCore& dsp, u32 addr, size_t size)
 {
+  TraceBenchmark::CodeLoaded(dsp);
 }
 void DSP::Host::CodeLoaded(DSPCore& dsp, const u8* ptr, size_t size)
 {
+  TraceBenchmark::CodeLoaded(dsp);
 }
 void DSP::Host::InterruptRequest()
 {
+  TraceBenchmark::InterruptRequest();
 }
 void DSP::Host::UpdateDebugger()
 {
@@ -378,6 +385,8 @@ static bool IsHelpFlag(const std::string& argument)
 //   dsptool [-f] -h asdf.h asdf.txt
 // Print results from DSPSpy register dump
 //   dsptool -p dsp_dump0.bin
+// Benchmark the DSP cores with a ucode and a mail trace:
+//   dsptool -b -r Data/Sys/GC -t mails.txt ucode.bin
 int main(int argc, const char* argv[])
 {
   if (argc == 1 || (argc == 2 && IsHelpFlag(argv[1])))
@@ -396,6 +405,12 @@ int main(int argc, const char* argv[])
     printf("-pm <DUMP FILE>: Print results of DSPSpy register dump (convert PROD values)\n");
     printf("-psm <DUMP FILE>: Print results of DSPSpy register dump (convert PROD values/disable "
            "SR output)\n");
+    printf("-b: Benchmark the DSP interpreter and JIT with the input ucode binary\n");
+    printf("-r <DIR>: Directory containing the DSP ROMs (benchmark only)\n");
+    printf("-t <TRACE FILE>: Mails to send to the ucode (benchmark only)\n");
+    printf("-ram <RAM FILE>: Main RAM image for DMAs (benchmark only)\n");
+    printf("-e <PC>: Entry point of the ucode in hex (benchmark only)\n");
+    printf("-n <CYCLES>: Maximum number of DSP cycles to run (benchmark only)\n");
 
     return 0;
   }
@@ -405,7 +420,9 @@ int main(int argc, const char* argv[])
   std::string output_name;
 
   bool disassemble = false, compare = false, multiple = false, outputSize = false, force = false,
-       print_results = false, print_results_prodhack = false, print_results_srhack = false;
+       print_results = false, print_results_prodhack = false, print_results_srhack = false,
+       benchmark = false;
+  TraceBenchmark::Options benchmark_options;
   for (int i = 1; i < argc; i++)
   {
     const std::string argument = argv[i];
@@ -459,6 +476,41 @@ int main(int argc, const char* argv[])
       print_results_srhack = true;
       print_results_prodhack = true;
     }
+    else if (argument == "-b")
+    {
+      benchmark = true;
+    }
+    else if (argument == "-r")
+    {
+      if (++i < argc)
+        benchmark_options.rom_path = argv[i];
+    }
+    else if (argument == "-t")
+    {
+      if (++i < argc)
+        benchmark_options.trace_path = argv[i];
+    }
+    else if (argument == "-ram")
+    {
+      if (++i < argc)
+        benchmark_options.ram_path = argv[i];
+    }
+    else if (argument == "-e")
+    {
+      if (++i < argc && !TryParse(argv[i], &benchmark_options.entry_point, 16))
+      {
+        printf("ERROR: Invalid entry point.\n");
+        return 1;
+      }
+    }
+    else if (argument == "-n")
+    {
+      if (++i < argc && !TryParse(argv[i], &benchmark_options.max_cycles))
+      {
+        printf("ERROR: Invalid number of cycles.\n");
+        return 1;
+      }
+    }
     else
     {
       if (!input_name.empty())
@@ -482,6 +534,17 @@ int main(int argc, const char* argv[])
     return 1;
   }
 
+  if (benchmark)
+  {
+    if (input_name.empty() || benchmark_options.rom_path.empty())
+    {
+      printf("ERROR: Benchmarking requires a ucode binary and the DSP ROM directory.\n");
+      return 1;
+    }
+    benchmark_options.ucode_path = input_name;
+    return TraceBenchmark::Run(benchmark_options) ? 0 : 1;
+  }
+
   if (compare)
   {
     return PerformBinaryComparison(input_name, output_name) ? 0 : 1;
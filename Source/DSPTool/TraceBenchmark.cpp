@@ -0,0 +1,360 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "TraceBenchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Common/CommonPaths.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/MemoryUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/Swap.h"
+#include "Common/Timer.h"
+#include "Core/DSP/DSPCodeUtil.h"
+#include "Core/DSP/DSPCore.h"
+#include "Core/DSP/DSPTables.h"
+
+namespace TraceBenchmark
+{
+// The number of DSP cycles that are run between two checks of the mailboxes. This is in the same
+// range as the time slices that the DSP gets when it runs on the CPU thread.
+constexpr int SLICE_CYCLES = 1024;
+// Once the whole trace has been sent, the DSP gets this many more cycles to finish its work.
+constexpr u64 SETTLE_CYCLES = 1000000;
+// If the DSP neither reads nor sends a mail for this long, the ucode is assumed to be stuck.
+constexpr u64 STALL_CYCLES = 20000000;
+
+constexpr u32 RAM_SIZE = 0x1800000;
+constexpr u32 ARAM_SIZE = 0x1000000;
+
+struct TraceEntry
+{
+  enum class Type
+  {
+    Mail,
+    Interrupt,
+    Wait,
+  };
+
+  Type type;
+  u32 mail;
+  size_t line;
+};
+
+struct Roms
+{
+  std::array<u16, DSP::DSP_IROM_SIZE> irom;
+  std::array<u16, DSP::DSP_COEF_SIZE> coef;
+};
+
+struct Result
+{
+  u64 cycles = 0;
+  u64 host_us = 0;
+  u32 mails_sent = 0;
+  u32 mails_received = 0;
+  u32 interrupts = 0;
+  u64 mail_hash = 0xcbf29ce484222325;
+  bool stalled = false;
+  size_t stall_line = 0;
+};
+
+static std::vector<u8> s_ram;
+static std::vector<u8> s_aram;
+static u32 s_interrupts = 0;
+
+u8 ReadARAM(u32 address)
+{
+  return s_aram.empty() ? 0 : s_aram[address & (ARAM_SIZE - 1)];
+}
+
+void WriteARAM(u8 value, u32 address)
+{
+  if (!s_aram.empty())
+    s_aram[address & (ARAM_SIZE - 1)] = value;
+}
+
+void DMAToDSP(u16* dst, u32 address, u32 size)
+{
+  for (u32 i = 0; i < size / 2; ++i)
+  {
+    const u32 offset = ((address & 0x01ffffff) + i * 2) % RAM_SIZE;
+    dst[i] = s_ram.empty() ? 0 : static_cast<u16>(s_ram[offset] << 8 | s_ram[offset + 1]);
+  }
+}
+
+void DMAFromDSP(const u16* src, u32 address, u32 size)
+{
+  if (s_ram.empty())
+    return;
+
+  for (u32 i = 0; i < size / 2; ++i)
+  {
+    const u32 offset = ((address & 0x01ffffff) + i * 2) % RAM_SIZE;
+    s_ram[offset] = static_cast<u8>(src[i] >> 8);
+    s_ram[offset + 1] = static_cast<u8>(src[i]);
+  }
+}
+
+void CodeLoaded(DSP::DSPCore& dsp)
+{
+  dsp.ClearIRAM();
+  dsp.DSPState().GetAnalyzer().Analyze(dsp.DSPState());
+}
+
+void InterruptRequest()
+{
+  ++s_interrupts;
+}
+
+static bool LoadRom(u16* rom, const std::string& path, size_t size_in_bytes)
+{
+  std::string bytes;
+  if (!File::ReadFileToString(path, bytes) || bytes.size() != size_in_bytes)
+  {
+    fmt::print("ERROR: {} is missing or has the wrong size\n", path);
+    return false;
+  }
+
+  const u16* words = reinterpret_cast<const u16*>(bytes.c_str());
+  for (size_t i = 0; i < size_in_bytes / 2; ++i)
+    rom[i] = Common::swap16(words[i]);
+
+  return true;
+}
+
+static std::optional<std::vector<TraceEntry>> LoadTrace(const std::string& path)
+{
+  std::vector<TraceEntry> trace;
+  if (path.empty())
+    return trace;
+
+  std::string text;
+  if (!File::ReadFileToString(path, text))
+  {
+    fmt::print("ERROR: Could not read {}\n", path);
+    return std::nullopt;
+  }
+
+  std::istringstream stream(text);
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(stream, line))
+  {
+    ++line_number;
+    line = StripWhitespace(line);
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    if (line == "irq")
+    {
+      trace.push_back({TraceEntry::Type::Interrupt, 0, line_number});
+    }
+    else if (line == "wait")
+    {
+      trace.push_back({TraceEntry::Type::Wait, 0, line_number});
+    }
+    else
+    {
+      u32 mail;
+      if (line.size() > 8 || !TryParse(line, &mail, 16))
+      {
+        fmt::print("ERROR: {}:{}: Expected a mail, \"irq\" or \"wait\"\n", path, line_number);
+        return std::nullopt;
+      }
+      trace.push_back({TraceEntry::Type::Mail, mail, line_number});
+    }
+  }
+
+  return trace;
+}
+
+static std::optional<Result> RunCore(const Options& options, DSP::DSPInitOptions::CoreType type,
+                                     const Roms& roms, const std::vector<u16>& ucode,
+                                     const std::vector<TraceEntry>& trace,
+                                     const std::vector<u8>& ram)
+{
+  s_ram = ram;
+  s_aram.assign(ARAM_SIZE, 0);
+  s_interrupts = 0;
+
+  DSP::DSPInitOptions opts;
+  opts.irom_contents = roms.irom;
+  opts.coef_contents = roms.coef;
+  opts.core_type = type;
+
+  DSP::DSPCore dsp;
+  if (!dsp.Initialize(opts))
+  {
+    fmt::print("ERROR: Could not initialize the DSP\n");
+    return std::nullopt;
+  }
+
+  auto& state = dsp.DSPState();
+  Common::UnWriteProtectMemory(state.iram, DSP::DSP_IRAM_BYTE_SIZE, false);
+  std::copy(ucode.begin(), ucode.end(), state.iram);
+  Common::WriteProtectMemory(state.iram, DSP::DSP_IRAM_BYTE_SIZE, false);
+
+  dsp.Reset();
+  dsp.ClearIRAM();
+  state.pc = options.entry_point;
+  state.control_reg = 0;
+
+  Result result;
+  size_t next_entry = 0;
+  bool mail_since_send = true;
+  u64 last_progress = 0;
+  u64 end_cycles = options.max_cycles;
+
+  const u64 start_us = Common::Timer::NowUs();
+  while (result.cycles < end_cycles)
+  {
+    // Send mails from the trace whenever the ucode has read the previous one.
+    while (next_entry < trace.size())
+    {
+      const TraceEntry& entry = trace[next_entry];
+      if (entry.type == TraceEntry::Type::Wait)
+      {
+        if (!mail_since_send)
+          break;
+      }
+      else if (entry.type == TraceEntry::Type::Interrupt)
+      {
+        dsp.CheckExternalInterrupt();
+        dsp.CheckExceptions();
+      }
+      else
+      {
+        if ((dsp.PeekMailbox(DSP::Mailbox::CPU) & 0x80000000) != 0)
+          break;
+
+        dsp.WriteMailboxHigh(DSP::Mailbox::CPU, static_cast<u16>(entry.mail >> 16));
+        dsp.WriteMailboxLow(DSP::Mailbox::CPU, static_cast<u16>(entry.mail));
+        ++result.mails_sent;
+        mail_since_send = false;
+      }
+
+      ++next_entry;
+      last_progress = result.cycles;
+    }
+
+    if (next_entry == trace.size() && !trace.empty() &&
+        (dsp.PeekMailbox(DSP::Mailbox::CPU) & 0x80000000) == 0)
+    {
+      end_cycles = std::min(end_cycles, result.cycles + SETTLE_CYCLES);
+    }
+
+    if ((state.control_reg & DSP::CR_HALT) != 0)
+      break;
+
+    dsp.RunCycles(SLICE_CYCLES);
+    result.cycles += SLICE_CYCLES;
+
+    while ((dsp.PeekMailbox(DSP::Mailbox::DSP) & 0x80000000) != 0)
+    {
+      const u32 high = dsp.ReadMailboxHigh(DSP::Mailbox::DSP);
+      const u32 mail = high << 16 | dsp.ReadMailboxLow(DSP::Mailbox::DSP);
+      result.mail_hash = (result.mail_hash ^ mail) * 0x100000001b3;
+      ++result.mails_received;
+      mail_since_send = true;
+      last_progress = result.cycles;
+    }
+
+    if (next_entry < trace.size() && result.cycles - last_progress > STALL_CYCLES)
+    {
+      result.stalled = true;
+      result.stall_line = trace[next_entry].line;
+      break;
+    }
+  }
+  result.host_us = Common::Timer::NowUs() - start_us;
+  result.interrupts = s_interrupts;
+
+  dsp.Shutdown();
+  return result;
+}
+
+static void PrintResult(const char* name, const Result& result)
+{
+  const double seconds = result.host_us / 1000000.0;
+  fmt::print("{}: {} DSP cycles in {:.3f} s, {:.1f} million DSP cycles per second\n", name,
+             result.cycles, seconds, seconds > 0 ? result.cycles / seconds / 1000000.0 : 0.0);
+  fmt::print("  mails sent: {}, mails received: {} (hash {:016x}), interrupts: {}\n",
+             result.mails_sent, result.mails_received, result.mail_hash, result.interrupts);
+  if (result.stalled)
+    fmt::print("  stalled waiting for the DSP at trace line {}\n", result.stall_line);
+}
+
+bool Run(const Options& options)
+{
+  Roms roms;
+  if (!LoadRom(roms.irom.data(), options.rom_path + "/" DSP_IROM, DSP::DSP_IROM_BYTE_SIZE) ||
+      !LoadRom(roms.coef.data(), options.rom_path + "/" DSP_COEF, DSP::DSP_COEF_BYTE_SIZE))
+  {
+    return false;
+  }
+
+  std::string binary_code;
+  if (!File::ReadFileToString(options.ucode_path, binary_code))
+  {
+    fmt::print("ERROR: Could not read {}\n", options.ucode_path);
+    return false;
+  }
+  const std::vector<u16> ucode = DSP::BinaryStringBEToCode(binary_code);
+  if (ucode.empty() || ucode.size() > DSP::DSP_IRAM_SIZE)
+  {
+    fmt::print("ERROR: The ucode must contain between 1 and {} words\n", DSP::DSP_IRAM_SIZE);
+    return false;
+  }
+
+  const std::optional<std::vector<TraceEntry>> trace = LoadTrace(options.trace_path);
+  if (!trace)
+    return false;
+
+  DSP::InitInstructionTable();
+
+  std::vector<u8> ram(RAM_SIZE);
+  if (!options.ram_path.empty())
+  {
+    std::string ram_image;
+    if (!File::ReadFileToString(options.ram_path, ram_image))
+    {
+      fmt::print("ERROR: Could not read {}\n", options.ram_path);
+      return false;
+    }
+    std::memcpy(ram.data(), ram_image.data(), std::min<size_t>(ram_image.size(), RAM_SIZE));
+  }
+
+  const std::optional<Result> interpreter = RunCore(
+      options, DSP::DSPInitOptions::CoreType::Interpreter, roms, ucode, *trace, ram);
+  if (!interpreter)
+    return false;
+  PrintResult("Interpreter", *interpreter);
+
+#ifdef _M_X86_64
+  const std::optional<Result> jit =
+      RunCore(options, DSP::DSPInitOptions::CoreType::JIT64, roms, ucode, *trace, ram);
+  if (!jit)
+    return false;
+  PrintResult("JIT", *jit);
+
+  if (jit->mails_received != interpreter->mails_received ||
+      jit->mail_hash != interpreter->mail_hash)
+  {
+    fmt::print("WARNING: The mails sent by the interpreter and the JIT differ\n");
+  }
+#endif
+
+  return true;
+}
+}  // namespace TraceBenchmark
@@ -0,0 +1,46 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+namespace DSP
+{
+class DSPCore;
+}
+
+namespace TraceBenchmark
+{
+struct Options
+{
+  // Big endian ucode binary, as written by the "Dump DSP code" option. Loaded to IRAM address 0.
+  std::string ucode_path;
+  // Optional mail trace. Every line contains either a mail that the CPU sends to the DSP as eight
+  // hex digits, "irq" to raise the DSP external interrupt, or "wait" to wait until the DSP has
+  // sent a mail to the CPU. Lines starting with # are ignored.
+  std::string trace_path;
+  // Directory containing dsp_rom.bin and dsp_coef.bin.
+  std::string rom_path;
+  // Optional image of main RAM that DMAs from the DSP read from.
+  std::string ram_path;
+
+  u16 entry_point = 0;
+  u64 max_cycles = 81000000;
+};
+
+// Runs a ucode against a mail trace with the DSP interpreter and the DSP JIT and prints how many
+// DSP cycles each of them emulates per host second. The mails that the DSP sends back are counted
+// and hashed so that the results of the two cores can be compared.
+bool Run(const Options& options);
+
+// Implementations of the DSP host callbacks used while a benchmark is running.
+u8 ReadARAM(u32 address);
+void WriteARAM(u8 value, u32 address);
+void DMAToDSP(u16* dst, u32 address, u32 size);
+void DMAFromDSP(const u16* src, u32 address, u32 size);
+void CodeLoaded(DSP::DSPCore& dsp);
+void InterruptRequest();
+}  // namespace TraceBenchmark
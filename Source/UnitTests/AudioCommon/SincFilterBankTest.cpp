@@ -0,0 +1,107 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "AudioCommon/SincFilterBank.h"
+#include "Common/CommonTypes.h"
+#include "Common/MathUtil.h"
+
+using AudioCommon::SincFilterBank;
+
+namespace
+{
+using Taps = std::array<float, SincFilterBank::TAPS>;
+
+// A sine wave with the given frequency in cycles per input sample, sampled around the position
+// that SincFilterBank interpolates from.
+Taps GenerateTone(double frequency)
+{
+  Taps taps;
+  for (u32 i = 0; i < SincFilterBank::TAPS; ++i)
+    taps[i] = static_cast<float>(std::sin(MathUtil::TAU * frequency * i));
+  return taps;
+}
+
+// Fractions that hit phases exactly as well as ones that blend two phases.
+constexpr std::array<u16, 7> FRACTIONS = {0, 1, 0x3FF, 0x400, 0x8000, 0xC123, 0xFFFF};
+}  // namespace
+
+TEST(SincFilterBank, ConstantSignalKeepsItsLevel)
+{
+  SincFilterBank filter;
+  filter.SetRates(32000, 48000);
+
+  Taps left, right;
+  left.fill(0.5f);
+  right.fill(-1.0f);
+  for (const u16 fraction : FRACTIONS)
+  {
+    const auto [l, r] = filter.Interpolate(left.data(), right.data(), fraction);
+    EXPECT_NEAR(l, 0.5f, 1e-5f) << "fraction " << fraction;
+    EXPECT_NEAR(r, -1.0f, 1e-5f) << "fraction " << fraction;
+  }
+}
+
+TEST(SincFilterBank, ChannelsAreIndependent)
+{
+  SincFilterBank filter;
+  filter.SetRates(32000, 48000);
+
+  const Taps tone = GenerateTone(0.1);
+  const Taps silence{};
+  for (const u16 fraction : FRACTIONS)
+  {
+    const auto [l, r] = filter.Interpolate(tone.data(), silence.data(), fraction);
+    EXPECT_EQ(r, 0.0f) << "fraction " << fraction;
+
+    const auto [swapped_l, swapped_r] = filter.Interpolate(silence.data(), tone.data(), fraction);
+    EXPECT_EQ(swapped_l, 0.0f) << "fraction " << fraction;
+    EXPECT_EQ(swapped_r, l) << "fraction " << fraction;
+  }
+}
+
+TEST(SincFilterBank, InterpolatesLowFrequencies)
+{
+  SincFilterBank filter;
+  filter.SetRates(32000, 48000);
+
+  constexpr double FREQUENCY = 0.05;
+  const Taps tone = GenerateTone(FREQUENCY);
+  for (const u16 fraction : FRACTIONS)
+  {
+    const double position = SincFilterBank::HISTORY + fraction / 65536.0;
+    const float expected = static_cast<float>(std::sin(MathUtil::TAU * FREQUENCY * position));
+    const auto [l, r] = filter.Interpolate(tone.data(), tone.data(), fraction);
+    EXPECT_NEAR(l, expected, 0.01f) << "fraction " << fraction;
+    EXPECT_EQ(l, r);
+  }
+}
+
+TEST(SincFilterBank, DownsamplingLowersTheCutoff)
+{
+  // A tone above the output Nyquist frequency is passed through when upsampling, but mostly
+  // removed when downsampling to half the rate.
+  const Taps tone = GenerateTone(0.4);
+  const auto peak = [&tone](const SincFilterBank& filter) {
+    float result = 0.0f;
+    for (const u16 fraction : FRACTIONS)
+    {
+      const float sample = filter.Interpolate(tone.data(), tone.data(), fraction).first;
+      result = std::max(result, std::abs(sample));
+    }
+    return result;
+  };
+
+  SincFilterBank upsampling;
+  upsampling.SetRates(32000, 48000);
+  SincFilterBank downsampling;
+  downsampling.SetRates(48000, 24000);
+
+  EXPECT_GT(peak(upsampling), 0.5f);
+  EXPECT_LT(peak(downsampling), 0.01f);
+}
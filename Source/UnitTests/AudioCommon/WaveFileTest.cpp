@@ -0,0 +1,404 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include "AudioCommon/Enums.h"
+#include "AudioCommon/FlacEncoder.h"
+#include "AudioCommon/Mixer.h"
+#include "AudioCommon/WaveFile.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/Swap.h"
+
+namespace
+{
+constexpr u32 SAMPLE_RATE_DIVISOR = Mixer::FIXED_SAMPLE_RATE_DIVIDEND / 32000;
+
+// Interleaved left/right test signal with tones, noise and silence, so that the encoder has to
+// use all of its channel modes and subframe types.
+std::vector<s16> GenerateSignal(u32 count)
+{
+  std::vector<s16> samples(count * 2);
+  std::mt19937 rng(1234);
+  for (u32 i = 0; i < count; ++i)
+  {
+    const double t = i / 32000.0;
+    s16 left, right;
+    switch ((i / 10000) % 4)
+    {
+    case 0:
+      left = static_cast<s16>(12000 * std::sin(2 * 3.14159265 * 440 * t));
+      right = static_cast<s16>(12000 * std::sin(2 * 3.14159265 * 660 * t));
+      break;
+    case 1:
+      left = static_cast<s16>(rng());
+      right = static_cast<s16>(rng());
+      break;
+    case 2:
+      left = right = static_cast<s16>(20000 * std::sin(2 * 3.14159265 * 100 * t));
+      break;
+    default:
+      left = 0;
+      right = -32768;
+      break;
+    }
+    samples[2 * i] = left;
+    samples[2 * i + 1] = right;
+  }
+  return samples;
+}
+
+// What the mixer hands to the writer: big endian, right channel first.
+std::vector<s16> ToMixerOrder(const std::vector<s16>& samples)
+{
+  std::vector<s16> result(samples.size());
+  for (size_t i = 0; i < samples.size(); i += 2)
+  {
+    result[i] = static_cast<s16>(Common::swap16(static_cast<u16>(samples[i + 1])));
+    result[i + 1] = static_cast<s16>(Common::swap16(static_cast<u16>(samples[i])));
+  }
+  return result;
+}
+
+void WriteDump(const std::string& path, AudioCommon::AudioDumpFormat format,
+               const std::vector<s16>& mixer_samples, u32 chunk)
+{
+  WaveFileWriter writer;
+  ASSERT_TRUE(writer.Start(path, SAMPLE_RATE_DIVISOR, format));
+  const u32 count = static_cast<u32>(mixer_samples.size() / 2);
+  for (u32 i = 0; i < count; i += chunk)
+  {
+    writer.AddStereoSamplesBE(&mixer_samples[2 * i], std::min(chunk, count - i),
+                              SAMPLE_RATE_DIVISOR, 256, 256);
+  }
+  writer.Stop();
+}
+
+std::vector<u8> ReadFile(const std::string& path)
+{
+  File::IOFile file(path, "rb");
+  std::vector<u8> data(file.GetSize());
+  file.ReadBytes(data.data(), data.size());
+  return data;
+}
+
+class BitReader
+{
+public:
+  BitReader(const u8* data, size_t size) : m_data(data), m_size(size) {}
+
+  u32 Read(u32 bits)
+  {
+    u32 value = 0;
+    for (u32 i = 0; i < bits; ++i)
+    {
+      // Reading past the end gives ones, so that a truncated stream can't hang ReadUnary.
+      const u32 bit =
+          m_position / 8 < m_size ? (m_data[m_position / 8] >> (7 - m_position % 8)) & 1 : 1;
+      value = (value << 1) | bit;
+      ++m_position;
+    }
+    return value;
+  }
+
+  s32 ReadSigned(u32 bits)
+  {
+    const u32 value = Read(bits);
+    return static_cast<s32>(value << (32 - bits)) >> (32 - bits);
+  }
+
+  u32 ReadUnary()
+  {
+    u32 zeros = 0;
+    while (Read(1) == 0)
+      ++zeros;
+    return zeros;
+  }
+
+  void AlignToByte() { m_position = (m_position + 7) & ~size_t{7}; }
+  size_t GetBytePosition() const { return m_position / 8; }
+
+private:
+  const u8* m_data;
+  size_t m_size;
+  size_t m_position = 0;
+};
+
+void DecodeSubframe(BitReader* reader, u32 count, u32 bits_per_sample, s32* out)
+{
+  const u32 header = reader->Read(8);
+  const u32 type = header >> 1;
+  ASSERT_EQ(header & 1, 0u) << "wasted bits are not expected";
+
+  if (type == 0)
+  {
+    std::fill(out, out + count, reader->ReadSigned(bits_per_sample));
+    return;
+  }
+  if (type == 1)
+  {
+    for (u32 i = 0; i < count; ++i)
+      out[i] = reader->ReadSigned(bits_per_sample);
+    return;
+  }
+  ASSERT_EQ(type & 0b111000, 0b001000u) << "only fixed predictors are expected";
+
+  const u32 order = type & 0b111;
+  for (u32 i = 0; i < order; ++i)
+    out[i] = reader->ReadSigned(bits_per_sample);
+
+  ASSERT_EQ(reader->Read(2), 0u);
+  const u32 partition_order = reader->Read(4);
+  u32 i = order;
+  for (u32 partition = 0; partition < (1u << partition_order); ++partition)
+  {
+    const u32 parameter = reader->Read(4);
+    ASSERT_NE(parameter, 15u);
+    const u32 end = (partition + 1) * (count >> partition_order);
+    for (; i < end; ++i)
+    {
+      const u32 folded = (reader->ReadUnary() << parameter) | reader->Read(parameter);
+      const s32 residual = static_cast<s32>(folded >> 1) ^ -static_cast<s32>(folded & 1);
+      s32 prediction = 0;
+      switch (order)
+      {
+      case 1:
+        prediction = out[i - 1];
+        break;
+      case 2:
+        prediction = 2 * out[i - 1] - out[i - 2];
+        break;
+      case 3:
+        prediction = 3 * out[i - 1] - 3 * out[i - 2] + out[i - 3];
+        break;
+      case 4:
+        prediction = 4 * out[i - 1] - 6 * out[i - 2] + 4 * out[i - 3] - out[i - 4];
+        break;
+      }
+      out[i] = prediction + residual;
+    }
+  }
+}
+
+// Just enough of a FLAC decoder to read back what FlacEncoder writes.
+void DecodeFlac(const std::vector<u8>& data, u32* sample_rate, std::vector<s16>* samples)
+{
+  ASSERT_GE(data.size(), AudioCommon::FlacEncoder::HEADER_SIZE);
+  ASSERT_EQ(std::string(data.begin(), data.begin() + 4), "fLaC");
+
+  BitReader header(data.data() + 4, AudioCommon::FlacEncoder::HEADER_SIZE - 4);
+  ASSERT_EQ(header.Read(8), 0x80u);
+  ASSERT_EQ(header.Read(24), 34u);
+  header.Read(16 + 16 + 24 + 24);
+  *sample_rate = header.Read(20);
+  ASSERT_EQ(header.Read(3), 1u);
+  ASSERT_EQ(header.Read(5), 15u);
+  const u64 total_samples = (u64{header.Read(4)} << 32) | header.Read(32);
+
+  samples->clear();
+  size_t position = AudioCommon::FlacEncoder::HEADER_SIZE;
+  std::array<std::vector<s32>, 2> channels;
+  while (position < data.size())
+  {
+    BitReader reader(data.data() + position, data.size() - position);
+    ASSERT_EQ(reader.Read(16), 0xFFF8u);
+    const u32 block_size_code = reader.Read(4);
+    ASSERT_EQ(reader.Read(4), 0u);
+    const u32 assignment = reader.Read(4);
+    ASSERT_EQ(reader.Read(4), 0b1000u);
+    // UTF-8 coded frame number
+    const u32 lead = reader.Read(8);
+    for (u32 mask = 0x40; (lead & 0x80) && (lead & mask); mask >>= 1)
+      reader.Read(8);
+    u32 count = AudioCommon::FlacEncoder::BLOCK_SIZE;
+    if (block_size_code == 0b0111)
+      count = reader.Read(16) + 1;
+    else
+      ASSERT_EQ(block_size_code, 0b1100u);
+    reader.Read(8);
+
+    const bool first_is_side = assignment == 0b1001;
+    const bool second_is_side = assignment == 0b1000 || assignment == 0b1010;
+    for (u32 channel = 0; channel < 2; ++channel)
+    {
+      channels[channel].resize(count);
+      const bool side = channel == 0 ? first_is_side : second_is_side;
+      DecodeSubframe(&reader, count, side ? 17 : 16, channels[channel].data());
+      if (testing::Test::HasFatalFailure())
+        return;
+    }
+    reader.AlignToByte();
+    reader.Read(16);
+    position += reader.GetBytePosition();
+
+    for (u32 i = 0; i < count; ++i)
+    {
+      s32 left = channels[0][i];
+      s32 right = channels[1][i];
+      if (assignment == 0b1000)
+      {
+        right = left - right;
+      }
+      else if (assignment == 0b1001)
+      {
+        left += right;
+      }
+      else if (assignment == 0b1010)
+      {
+        const s32 mid = (left << 1) | (right & 1);
+        left = (mid + right) >> 1;
+        right = (mid - right) >> 1;
+      }
+      samples->push_back(static_cast<s16>(left));
+      samples->push_back(static_cast<s16>(right));
+    }
+  }
+  ASSERT_EQ(samples->size(), total_samples * 2);
+}
+}  // namespace
+
+class WaveFileTest : public testing::Test
+{
+protected:
+  void SetUp() override { m_dir = File::CreateTempDir(); }
+  void TearDown() override { File::DeleteDirRecursively(m_dir); }
+
+  std::string m_dir;
+};
+
+TEST_F(WaveFileTest, WavRoundTrip)
+{
+  const std::vector<s16> signal = GenerateSignal(100000);
+  const std::string path = m_dir + "/dump.wav";
+  WriteDump(path, AudioCommon::AudioDumpFormat::WAV, ToMixerOrder(signal), 560);
+
+  const std::vector<u8> data = ReadFile(path);
+  ASSERT_EQ(data.size(), 44 + signal.size() * 2);
+  EXPECT_EQ(std::string(data.begin(), data.begin() + 4), "RIFF");
+
+  u32 riff_size, data_size, sample_rate;
+  std::memcpy(&riff_size, &data[4], sizeof(u32));
+  std::memcpy(&sample_rate, &data[24], sizeof(u32));
+  std::memcpy(&data_size, &data[40], sizeof(u32));
+  EXPECT_EQ(riff_size, data.size() - 8);
+  EXPECT_EQ(data_size, signal.size() * 2);
+  EXPECT_EQ(sample_rate, 32000u);
+  EXPECT_EQ(std::memcmp(&data[44], signal.data(), signal.size() * 2), 0);
+}
+
+TEST_F(WaveFileTest, FlacRoundTrip)
+{
+  const std::vector<s16> signal = GenerateSignal(100000);
+  const std::string path = m_dir + "/dump.flac";
+  WriteDump(path, AudioCommon::AudioDumpFormat::FLAC, ToMixerOrder(signal), 560);
+
+  const std::vector<u8> data = ReadFile(path);
+  EXPECT_LT(data.size(), signal.size() * 2);
+
+  u32 sample_rate = 0;
+  std::vector<s16> decoded;
+  DecodeFlac(data, &sample_rate, &decoded);
+  EXPECT_EQ(sample_rate, 32000u);
+  EXPECT_EQ(decoded, signal);
+}
+
+TEST_F(WaveFileTest, EmptyDump)
+{
+  for (const auto format : {AudioCommon::AudioDumpFormat::WAV, AudioCommon::AudioDumpFormat::FLAC})
+  {
+    const std::string path = m_dir + "/empty";
+    WriteDump(path, format, {}, 560);
+    const std::vector<u8> data = ReadFile(path);
+    if (format == AudioCommon::AudioDumpFormat::WAV)
+    {
+      EXPECT_EQ(data.size(), 44u);
+    }
+    else
+    {
+      std::vector<s16> decoded;
+      u32 sample_rate;
+      DecodeFlac(data, &sample_rate, &decoded);
+      EXPECT_TRUE(decoded.empty());
+    }
+    File::Delete(path);
+  }
+}
+
+// Not a correctness test: measures how much dumping slows down a loop that produces audio at the
+// rate the emulated DSP does, with a stand-in for the rest of the emulation's work per chunk. The
+// loop runs much faster than real time, so it only produces as much audio as fits in the queue,
+// like the emulator would while the writer keeps up. The time spent inside AddStereoSamplesBE is
+// reported separately, since on a machine with few cores the total also includes the writer
+// thread competing for the CPU.
+TEST_F(WaveFileTest, DumpingOverhead)
+{
+  using Clock = std::chrono::steady_clock;
+  constexpr u32 CHUNK = 560;
+  constexpr u32 CHUNKS = 400;
+  const std::vector<s16> signal = ToMixerOrder(GenerateSignal(CHUNK * 64));
+
+  struct Result
+  {
+    s64 total_us;
+    s64 dump_calls_us;
+  };
+  const auto run = [&](std::optional<AudioCommon::AudioDumpFormat> format) {
+    WaveFileWriter writer;
+    if (format)
+      writer.Start(m_dir + "/overhead", SAMPLE_RATE_DIVISOR, *format);
+
+    // Unsigned, so that the busy work is allowed to wrap around.
+    std::vector<u32> work(CHUNK * 2);
+    u32 checksum = 0;
+    Clock::duration dump_calls{};
+    const auto start = Clock::now();
+    for (u32 chunk = 0; chunk < CHUNKS; ++chunk)
+    {
+      const s16* samples = &signal[(chunk % 64) * CHUNK * 2];
+      for (u32 pass = 0; pass < 16; ++pass)
+      {
+        for (u32 i = 0; i < CHUNK * 2; ++i)
+          work[i] = work[i] * 3 + static_cast<u32>(samples[i]);
+      }
+      checksum += work[chunk % work.size()];
+      if (format)
+      {
+        const auto call_start = Clock::now();
+        writer.AddStereoSamplesBE(samples, CHUNK, SAMPLE_RATE_DIVISOR, 256, 256);
+        dump_calls += Clock::now() - call_start;
+      }
+    }
+    const auto elapsed = Clock::now() - start;
+    writer.Stop();
+    File::Delete(m_dir + "/overhead");
+    EXPECT_NE(checksum, 1u);
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    return Result{duration_cast<microseconds>(elapsed).count(),
+                  duration_cast<microseconds>(dump_calls).count()};
+  };
+
+  const Result off = run(std::nullopt);
+  const Result wav = run(AudioCommon::AudioDumpFormat::WAV);
+  const Result flac = run(AudioCommon::AudioDumpFormat::FLAC);
+  fmt::print("Emulation thread time for {} chunks of {} samples:\n", CHUNKS, CHUNK);
+  fmt::print("  no dumping:   {:>7} us\n", off.total_us);
+  fmt::print("  WAV dumping:  {:>7} us ({} us in AddStereoSamplesBE)\n", wav.total_us,
+             wav.dump_calls_us);
+  fmt::print("  FLAC dumping: {:>7} us ({} us in AddStereoSamplesBE)\n", flac.total_us,
+             flac.dump_calls_us);
+}
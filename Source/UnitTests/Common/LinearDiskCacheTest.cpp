@@ -0,0 +1,212 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "Common/LinearDiskCache.h"
+
+namespace
+{
+class MapReader : public Common::LinearDiskCacheReader<u32, u16>
+{
+public:
+  void Read(const u32& key, const u16* value, u32 value_size) override
+  {
+    keys.push_back(key);
+    values[key] = std::vector<u16>(value, value + value_size);
+  }
+
+  std::vector<u32> keys;
+  std::map<u32, std::vector<u16>> values;
+};
+
+class LinearDiskCacheTest : public testing::Test
+{
+protected:
+  LinearDiskCacheTest()
+      : m_directory(File::CreateTempDir()), m_filename(m_directory + "/test.cache")
+  {
+  }
+
+  ~LinearDiskCacheTest() override
+  {
+    if (!m_directory.empty())
+      File::DeleteDirRecursively(m_directory);
+  }
+
+  void Append(Common::LinearDiskCache<u32, u16>& cache, u32 key, std::vector<u16> value)
+  {
+    cache.Append(key, value.data(), static_cast<u32>(value.size()));
+  }
+
+  const std::string m_directory;
+  const std::string m_filename;
+};
+}  // namespace
+
+TEST_F(LinearDiskCacheTest, CompactRemovesDuplicatesAndSorts)
+{
+  {
+    Common::LinearDiskCache<u32, u16> cache;
+    MapReader reader;
+    EXPECT_EQ(cache.OpenAndRead(m_filename, reader), 0u);
+    Append(cache, 3, {1, 2, 3});
+    Append(cache, 1, {});
+    Append(cache, 3, {4});
+    Append(cache, 2, {5, 6});
+    cache.Close();
+  }
+
+  const std::optional<Common::LinearDiskCacheCompactionResult> result =
+      Common::CompactLinearDiskCache(m_filename);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->entries, 3u);
+  EXPECT_EQ(result->removed_entries, 1u);
+  EXPECT_LT(result->new_size, result->old_size);
+  EXPECT_EQ(result->new_size, File::GetSize(m_filename));
+
+  Common::LinearDiskCache<u32, u16> cache;
+  MapReader reader;
+  EXPECT_EQ(cache.OpenAndRead(m_filename, reader), 3u);
+  EXPECT_FALSE(cache.DiscardedStaleCache());
+  EXPECT_EQ(reader.keys, (std::vector<u32>{1, 2, 3}));
+  EXPECT_EQ(reader.values[1], std::vector<u16>{});
+  EXPECT_EQ(reader.values[2], (std::vector<u16>{5, 6}));
+  EXPECT_EQ(reader.values[3], std::vector<u16>{4});
+}
+
+TEST_F(LinearDiskCacheTest, CompactDropsIncompleteEntry)
+{
+  {
+    Common::LinearDiskCache<u32, u16> cache;
+    MapReader reader;
+    cache.OpenAndRead(m_filename, reader);
+    Append(cache, 1, {1});
+    Append(cache, 2, {2, 2});
+    cache.Close();
+  }
+  {
+    File::IOFile file(m_filename, "r+b");
+    ASSERT_TRUE(file.Resize(file.GetSize() - 1));
+  }
+
+  const std::optional<Common::LinearDiskCacheCompactionResult> result =
+      Common::CompactLinearDiskCache(m_filename);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(result->entries, 1u);
+
+  Common::LinearDiskCache<u32, u16> cache;
+  MapReader reader;
+  EXPECT_EQ(cache.OpenAndRead(m_filename, reader), 1u);
+  EXPECT_EQ(reader.keys, std::vector<u32>{1});
+}
+
+TEST_F(LinearDiskCacheTest, StaleCacheIsNotCompacted)
+{
+  {
+    Common::LinearDiskCacheHeader header;
+    header.Init(sizeof(u32), sizeof(u16));
+    header.ver[0] ^= 1;
+    File::IOFile file(m_filename, "wb");
+    ASSERT_TRUE(file.WriteArray(&header, 1));
+  }
+
+  EXPECT_FALSE(Common::IsCurrentLinearDiskCache(m_filename));
+  EXPECT_FALSE(Common::CompactLinearDiskCache(m_filename).has_value());
+
+  Common::LinearDiskCache<u32, u16> cache;
+  MapReader reader;
+  EXPECT_EQ(cache.OpenAndRead(m_filename, reader), 0u);
+  EXPECT_TRUE(cache.DiscardedStaleCache());
+  cache.Close();
+  EXPECT_TRUE(Common::IsCurrentLinearDiskCache(m_filename));
+}
+
+TEST_F(LinearDiskCacheTest, IndexedFindsValues)
+{
+  {
+    Common::LinearDiskCache<u32, u16> cache;
+    MapReader reader;
+    cache.OpenAndRead(m_filename, reader);
+    Append(cache, 1, {1});
+    Append(cache, 2, {2, 2});
+    Append(cache, 1, {3, 3, 3});
+    cache.Close();
+  }
+
+  std::vector<u16> value;
+  {
+    Common::LinearDiskCache<u32, u16> cache;
+    EXPECT_EQ(cache.OpenIndexed(m_filename), 3u);
+    EXPECT_TRUE(cache.Find(1, &value));
+    EXPECT_EQ(value, (std::vector<u16>{3, 3, 3}));
+    EXPECT_TRUE(cache.Find(2, &value));
+    EXPECT_EQ(value, (std::vector<u16>{2, 2}));
+    EXPECT_FALSE(cache.Find(4, &value));
+
+    // Values appended in this session can be found before the index is written.
+    Append(cache, 4, {});
+    EXPECT_TRUE(cache.Find(4, &value));
+    EXPECT_TRUE(value.empty());
+  }
+  EXPECT_TRUE(File::Exists(m_filename + ".idx"));
+
+  {
+    Common::LinearDiskCache<u32, u16> cache;
+    EXPECT_EQ(cache.OpenIndexed(m_filename), 4u);
+    Append(cache, 2, {5});
+  }
+
+  Common::LinearDiskCache<u32, u16> cache;
+  EXPECT_EQ(cache.OpenIndexed(m_filename), 5u);
+  EXPECT_TRUE(cache.Find(1, &value));
+  EXPECT_EQ(value, (std::vector<u16>{3, 3, 3}));
+  EXPECT_TRUE(cache.Find(2, &value));
+  EXPECT_EQ(value, std::vector<u16>{5});
+  EXPECT_TRUE(cache.Find(4, &value));
+  cache.Close();
+
+  // Reading the whole cache still works as before.
+  MapReader reader;
+  EXPECT_EQ(cache.OpenAndRead(m_filename, reader), 5u);
+  EXPECT_EQ(reader.values[2], std::vector<u16>{5});
+}
+
+TEST_F(LinearDiskCacheTest, IndexOfOtherCacheIsIgnored)
+{
+  {
+    Common::LinearDiskCache<u32, u16> cache;
+    cache.OpenIndexed(m_filename);
+    Append(cache, 1, {1});
+    Append(cache, 2, {2});
+  }
+  ASSERT_TRUE(File::Copy(m_filename + ".idx", m_directory + "/old.idx"));
+
+  // Same layout, different keys.
+  File::Delete(m_filename);
+  {
+    Common::LinearDiskCache<u32, u16> cache;
+    MapReader reader;
+    cache.OpenAndRead(m_filename, reader);
+    Append(cache, 3, {1});
+    Append(cache, 4, {2});
+  }
+  EXPECT_FALSE(File::Exists(m_filename + ".idx"));
+  ASSERT_TRUE(File::Copy(m_directory + "/old.idx", m_filename + ".idx"));
+
+  Common::LinearDiskCache<u32, u16> cache;
+  std::vector<u16> value;
+  EXPECT_EQ(cache.OpenIndexed(m_filename), 2u);
+  EXPECT_FALSE(cache.Find(1, &value));
+  EXPECT_TRUE(cache.Find(3, &value));
+  EXPECT_TRUE(cache.Find(4, &value));
+  EXPECT_EQ(value, std::vector<u16>{2});
+}
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
 #include <thread>
 
 #include "Common/SPSCQueue.h"
@@ -68,3 +70,70 @@ TEST(SPSCQueue, MultiThreaded)
   popper_thread.join();
   inserter_thread.join();
 }
+
+TEST(SPSCRingBuffer, Simple)
+{
+  Common::SPSCRingBuffer<u32, 8> buffer;
+  std::array<u32, 8> data;
+
+  EXPECT_EQ(0u, buffer.Size());
+  EXPECT_EQ(0u, buffer.Pop(data.data(), data.size()));
+
+  const std::array<u32, 6> input{1, 2, 3, 4, 5, 6};
+  EXPECT_EQ(6u, buffer.Push(input.data(), input.size()));
+  EXPECT_EQ(6u, buffer.Size());
+  EXPECT_EQ(4u, buffer.Pop(data.data(), 4));
+  for (u32 i = 0; i < 4; ++i)
+    EXPECT_EQ(i + 1, data[i]);
+
+  // Only six elements fit, and they wrap around the end of the buffer.
+  EXPECT_EQ(6u, buffer.Push(input.data(), input.size()));
+  EXPECT_EQ(0u, buffer.Push(input.data(), input.size()));
+  EXPECT_EQ(8u, buffer.Size());
+  EXPECT_EQ(8u, buffer.Pop(data.data(), data.size()));
+  EXPECT_EQ((std::array<u32, 8>{5, 6, 1, 2, 3, 4, 5, 6}), data);
+
+  EXPECT_EQ(3u, buffer.Push(input.data(), 3));
+  buffer.Clear();
+  EXPECT_EQ(0u, buffer.Size());
+}
+
+TEST(SPSCRingBuffer, MultiThreaded)
+{
+  Common::SPSCRingBuffer<u32, 64> buffer;
+  constexpr u32 COUNT = 100000;
+
+  auto inserter = [&buffer]() {
+    std::array<u32, 13> data;
+    u32 next = 0;
+    while (next < COUNT)
+    {
+      const u32 count = std::min<u32>(static_cast<u32>(data.size()), COUNT - next);
+      for (u32 i = 0; i < count; ++i)
+        data[i] = next + i;
+      const u32 pushed = static_cast<u32>(buffer.Push(data.data(), count));
+      if (pushed == 0)
+        std::this_thread::yield();
+      next += pushed;
+    }
+  };
+
+  auto popper = [&buffer]() {
+    std::array<u32, 7> data;
+    u32 next = 0;
+    while (next < COUNT)
+    {
+      const size_t count = buffer.Pop(data.data(), data.size());
+      if (count == 0)
+        std::this_thread::yield();
+      for (size_t i = 0; i < count; ++i)
+        EXPECT_EQ(next++, data[i]);
+    }
+  };
+
+  std::thread popper_thread(popper);
+  std::thread inserter_thread(inserter);
+
+  popper_thread.join();
+  inserter_thread.join();
+}
@@ -0,0 +1,448 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/MathUtil.h"
+#include "Core/HW/DSPHLE/UCodes/AXMixing.h"
+#include "Core/HW/DSPHLE/UCodes/AXStructs.h"
+
+using namespace DSP::HLE;
+
+namespace
+{
+// Straightforward scalar versions of the AX mixing code, which the optimized kernels must match
+// bit for bit.
+
+void ReferenceMixAdd(int* out, const s16* input, u32 count, u16* volume, u16 volume_delta,
+                     s16* dpop)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    s64 sample = input[i];
+    sample *= *volume;
+    sample >>= 15;
+    sample = std::clamp((s32)sample, -32767, 32767);
+
+    out[i] += (s16)sample;
+    *volume += volume_delta;
+
+    *dpop = (s16)sample;
+  }
+}
+
+void ReferenceVolumeEnvelope(s16* samples, u32 count, s16* cur_volume, s16 cur_volume_delta,
+                             bool signed_volume)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    const s32 volume = signed_volume ? (s32)(s16)*cur_volume : (s32)(u16)*cur_volume;
+    const s32 sample = ((s32)samples[i] * volume) >> 15;
+    samples[i] = std::clamp(sample, -32767, 32767);
+    *cur_volume += cur_volume_delta;
+  }
+}
+
+u32 ReferenceResample(const s16* input, s16* output, u32 count, s16* last_samples, u32 curr_pos,
+                      u32 ratio, bool polyphase, const s16* coeffs)
+{
+  s16 temp[4];
+  u32 idx = 0;
+  u32 read_samples_count = 0;
+
+  temp[idx++ & 3] = last_samples[0];
+  temp[idx++ & 3] = last_samples[1];
+  temp[idx++ & 3] = last_samples[2];
+  temp[idx++ & 3] = last_samples[3];
+
+  for (u32 i = 0; i < count; ++i)
+  {
+    curr_pos += ratio;
+    while (curr_pos >= 0x10000)
+    {
+      temp[idx++ & 3] = input[read_samples_count++];
+      curr_pos -= 0x10000;
+    }
+
+    if (polyphase)
+    {
+      u16 curr_pos_frac = ((curr_pos & 0xFFFF) >> 9) << 2;
+      const s16* c = &coeffs[curr_pos_frac];
+
+      s64 t0 = temp[idx++ & 3];
+      s64 t1 = temp[idx++ & 3];
+      s64 t2 = temp[idx++ & 3];
+      s64 t3 = temp[idx++ & 3];
+
+      s64 samp = (t0 * c[0] + t1 * c[1] + t2 * c[2] + t3 * c[3]) >> 15;
+
+      output[i] = MathUtil::SaturatingCast<s16>(samp);
+    }
+    else
+    {
+      u16 curr_frac = curr_pos & 0xFFFF;
+      u16 inv_curr_frac = -curr_frac;
+
+      if (curr_frac)
+      {
+        s32 s0 = temp[idx++ & 3];
+        s32 s1 = temp[idx++ & 3];
+
+        output[i] = ((s0 * inv_curr_frac) + (s1 * curr_frac)) >> 16;
+        idx += 2;
+      }
+      else
+      {
+        output[i] = temp[idx++ & 3];
+        idx += 3;
+      }
+    }
+  }
+
+  last_samples[3] = temp[--idx & 3];
+  last_samples[2] = temp[--idx & 3];
+  last_samples[1] = temp[--idx & 3];
+  last_samples[0] = temp[--idx & 3];
+
+  return curr_pos;
+}
+
+u32 OptimizedResample(const AXMixing::Kernels& kernels, const s16* input, s16* output, u32 count,
+                      s16* last_samples, u32 curr_pos, u32 ratio, bool polyphase,
+                      const s16* coeffs)
+{
+  const u32 start_pos = curr_pos;
+  const u32 input_count = AXMixing::AdvanceResamplePosition(count, &curr_pos, ratio);
+
+  std::vector<s16> history(input_count + 4);
+  std::copy_n(last_samples, 4, history.begin());
+  std::copy_n(input, input_count, history.begin() + 4);
+
+  if (polyphase)
+    kernels.resample_polyphase(history.data(), output, count, start_pos, ratio, coeffs);
+  else
+    kernels.resample_linear(history.data(), output, count, start_pos, ratio);
+
+  std::copy_n(history.begin() + input_count, 4, last_samples);
+  return curr_pos;
+}
+
+std::vector<s16> RandomSamples(std::mt19937& rng, size_t count)
+{
+  std::uniform_int_distribution<int> dist(-32768, 32767);
+  std::vector<s16> samples(count);
+  for (s16& sample : samples)
+    sample = static_cast<s16>(dist(rng));
+
+  // Make sure the extremes are covered
+  if (count >= 2)
+  {
+    samples[0] = -32768;
+    samples[1] = 32767;
+  }
+  return samples;
+}
+
+constexpr std::array<VolumeData PBMixerWii::*, 12> MIXER_BUSES = {
+    &PBMixerWii::main_left,     &PBMixerWii::main_right,    &PBMixerWii::main_surround,
+    &PBMixerWii::auxA_left,     &PBMixerWii::auxA_right,    &PBMixerWii::auxA_surround,
+    &PBMixerWii::auxB_left,     &PBMixerWii::auxB_right,    &PBMixerWii::auxB_surround,
+    &PBMixerWii::auxC_left,     &PBMixerWii::auxC_right,    &PBMixerWii::auxC_surround,
+};
+
+constexpr std::array<s16 PBDpopWii::*, 12> DPOP_BUSES = {
+    &PBDpopWii::main_left,  &PBDpopWii::main_right,  &PBDpopWii::main_surround,
+    &PBDpopWii::auxA_left,  &PBDpopWii::auxA_right,  &PBDpopWii::auxA_surround,
+    &PBDpopWii::auxB_left,  &PBDpopWii::auxB_right,  &PBDpopWii::auxB_surround,
+    &PBDpopWii::auxC_left,  &PBDpopWii::auxC_right,  &PBDpopWii::auxC_surround,
+};
+
+constexpr u32 SAMPLES_PER_FRAME = 96;
+
+struct SyntheticVoice
+{
+  AXPBWii pb;
+  std::vector<s16> input;
+  u32 input_pos = 0;
+};
+
+// Builds parameter blocks with random mixer, envelope and sample rate converter settings.
+std::vector<SyntheticVoice> CreateSyntheticVoices(u32 count, u32 frames)
+{
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<u32> u16_dist(0, 0xFFFF);
+
+  std::vector<SyntheticVoice> voices(count);
+  for (SyntheticVoice& voice : voices)
+  {
+    AXPBWii& pb = voice.pb;
+    std::memset(&pb, 0, sizeof(pb));
+
+    pb.src_type = static_cast<u16>(rng() % 2 == 0 ? SRCTYPE_POLYPHASE : SRCTYPE_LINEAR);
+    pb.coef_select = static_cast<u16>(rng() % 3);
+    pb.mixer_control_lo = static_cast<u16>(u16_dist(rng));
+    pb.mixer_control_hi = static_cast<u16>(u16_dist(rng));
+
+    // Ratios between 1/8 and 4.0, which covers what games actually use
+    const u32 ratio = 0x2000 + rng() % 0x3E000;
+    pb.src.ratio_hi = static_cast<u16>(ratio >> 16);
+    pb.src.ratio_lo = static_cast<u16>(ratio);
+    pb.src.cur_addr_frac = static_cast<u16>(u16_dist(rng));
+
+    pb.vol_env.cur_volume = static_cast<s16>(u16_dist(rng));
+    pb.vol_env.cur_volume_delta = static_cast<s16>(rng() % 64) - 32;
+
+    for (auto bus : MIXER_BUSES)
+    {
+      (pb.mixer.*bus).volume = static_cast<u16>(u16_dist(rng));
+      (pb.mixer.*bus).volume_delta = static_cast<u16>(rng() % 32);
+    }
+
+    voice.input = RandomSamples(rng, (ratio * u64{SAMPLES_PER_FRAME} * frames >> 16) + 16);
+  }
+  return voices;
+}
+
+// Renders one frame of a voice the way ProcessVoice does, minus the ARAM access, with the given
+// kernels or with the reference code if kernels is null.
+void RenderVoice(SyntheticVoice& voice, const AXMixing::Kernels* kernels, const s16* coeffs,
+                 std::array<std::array<int, SAMPLES_PER_FRAME>, 12>& buses)
+{
+  AXPBWii& pb = voice.pb;
+  const u32 ratio = (u32(pb.src.ratio_hi) << 16) | pb.src.ratio_lo;
+  const bool polyphase = pb.src_type == SRCTYPE_POLYPHASE;
+  const s16* voice_coeffs = coeffs + pb.coef_select * 0x200;
+  const s16* input = voice.input.data() + voice.input_pos;
+
+  std::array<s16, SAMPLES_PER_FRAME> samples;
+  const u32 curr_pos =
+      kernels ? OptimizedResample(*kernels, input, samples.data(), SAMPLES_PER_FRAME,
+                                  pb.src.last_samples, pb.src.cur_addr_frac, ratio, polyphase,
+                                  voice_coeffs) :
+                ReferenceResample(input, samples.data(), SAMPLES_PER_FRAME, pb.src.last_samples,
+                                  pb.src.cur_addr_frac, ratio, polyphase, voice_coeffs);
+
+  u32 end_pos = pb.src.cur_addr_frac;
+  voice.input_pos += AXMixing::AdvanceResamplePosition(SAMPLES_PER_FRAME, &end_pos, ratio);
+  pb.src.cur_addr_frac = static_cast<u16>(curr_pos & 0xFFFF);
+
+  if (kernels)
+  {
+    u16 volume = static_cast<u16>(pb.vol_env.cur_volume);
+    kernels->apply_volume_envelope(samples.data(), SAMPLES_PER_FRAME, &volume,
+                                   static_cast<u16>(pb.vol_env.cur_volume_delta), false);
+    pb.vol_env.cur_volume = static_cast<s16>(volume);
+  }
+  else
+  {
+    ReferenceVolumeEnvelope(samples.data(), SAMPLES_PER_FRAME, &pb.vol_env.cur_volume,
+                            pb.vol_env.cur_volume_delta, false);
+  }
+
+  const u32 mixer_control = (u32(pb.mixer_control_hi) << 16) | pb.mixer_control_lo;
+  for (size_t i = 0; i < MIXER_BUSES.size(); ++i)
+  {
+    if (!((mixer_control >> (2 * i)) & 1))
+      continue;
+
+    VolumeData& vd = pb.mixer.*MIXER_BUSES[i];
+    const u16 volume_delta = ((mixer_control >> (2 * i)) & 2) ? vd.volume_delta : 0;
+    s16* dpop = &(pb.dpop.*DPOP_BUSES[i]);
+    if (kernels)
+    {
+      kernels->mix_add(buses[i].data(), samples.data(), SAMPLES_PER_FRAME, &vd.volume,
+                       volume_delta, dpop);
+    }
+    else
+    {
+      ReferenceMixAdd(buses[i].data(), samples.data(), SAMPLES_PER_FRAME, &vd.volume, volume_delta,
+                      dpop);
+    }
+  }
+}
+}  // namespace
+
+TEST(AXMixing, MixAddMatchesReference)
+{
+  for (const AXMixing::Kernels& kernels : AXMixing::GetSupportedKernels())
+  {
+    SCOPED_TRACE(kernels.name);
+    std::mt19937 rng(1);
+    for (u32 count = 0; count <= 100; ++count)
+    {
+      for (u32 iteration = 0; iteration < 20; ++iteration)
+      {
+        const std::vector<s16> input = RandomSamples(rng, count);
+        std::vector<int> expected(count);
+        for (int& value : expected)
+          value = static_cast<int>(rng() % 0x20000) - 0x10000;
+        std::vector<int> actual = expected;
+
+        const u16 start_volume = static_cast<u16>(rng());
+        const u16 volume_delta = iteration % 4 == 0 ? 0 : static_cast<u16>(rng());
+        u16 expected_volume = start_volume;
+        u16 actual_volume = start_volume;
+        s16 expected_dpop = 123;
+        s16 actual_dpop = 123;
+
+        ReferenceMixAdd(expected.data(), input.data(), count, &expected_volume, volume_delta,
+                        &expected_dpop);
+        kernels.mix_add(actual.data(), input.data(), count, &actual_volume, volume_delta,
+                        &actual_dpop);
+
+        EXPECT_EQ(expected, actual);
+        EXPECT_EQ(expected_volume, actual_volume);
+        EXPECT_EQ(expected_dpop, actual_dpop);
+      }
+    }
+  }
+}
+
+TEST(AXMixing, VolumeEnvelopeMatchesReference)
+{
+  for (const AXMixing::Kernels& kernels : AXMixing::GetSupportedKernels())
+  {
+    SCOPED_TRACE(kernels.name);
+    std::mt19937 rng(2);
+    for (bool signed_volume : {false, true})
+    {
+      for (u32 count = 0; count <= 100; ++count)
+      {
+        std::vector<s16> expected = RandomSamples(rng, count);
+        std::vector<s16> actual = expected;
+
+        s16 expected_volume = static_cast<s16>(rng());
+        const s16 volume_delta = static_cast<s16>(rng());
+        u16 actual_volume = static_cast<u16>(expected_volume);
+
+        ReferenceVolumeEnvelope(expected.data(), count, &expected_volume, volume_delta,
+                                signed_volume);
+        kernels.apply_volume_envelope(actual.data(), count, &actual_volume,
+                                      static_cast<u16>(volume_delta), signed_volume);
+
+        EXPECT_EQ(expected, actual);
+        EXPECT_EQ(static_cast<u16>(expected_volume), actual_volume);
+      }
+    }
+  }
+}
+
+TEST(AXMixing, ResamplingMatchesReference)
+{
+  std::mt19937 rng(3);
+  // Full range coefficients, including the -32768 * -32768 corner case
+  std::vector<s16> coeffs = RandomSamples(rng, 0x200);
+  coeffs[4] = coeffs[5] = coeffs[6] = coeffs[7] = -32768;
+
+  const std::array<u32, 9> fixed_ratios = {0, 1, 0x8000, 0xFFFF, 0x10000, 0x10001,
+                                           0x40000, 0x55555, 0x100000};
+  for (const AXMixing::Kernels& kernels : AXMixing::GetSupportedKernels())
+  {
+    SCOPED_TRACE(kernels.name);
+    for (bool polyphase : {false, true})
+    {
+      for (u32 count = 1; count <= 100; ++count)
+      {
+        for (u32 iteration = 0; iteration < 20; ++iteration)
+        {
+          const u32 ratio = iteration < fixed_ratios.size() ? fixed_ratios[iteration] :
+                                                              static_cast<u32>(rng() % 0x50000);
+          const u32 curr_pos = iteration % 3 == 0 ? 0 : rng() % 0x10000;
+
+          u32 end_pos = curr_pos;
+          const u32 input_count = AXMixing::AdvanceResamplePosition(count, &end_pos, ratio);
+          std::vector<s16> input = RandomSamples(rng, input_count);
+          if (iteration % 5 == 0)
+            std::fill(input.begin(), input.end(), s16(-32768));
+
+          std::array<s16, 4> expected_last_samples = {-32768, -32768, -32768, -32768};
+          if (iteration % 5 != 0)
+          {
+            for (s16& sample : expected_last_samples)
+              sample = static_cast<s16>(rng());
+          }
+          std::array<s16, 4> actual_last_samples = expected_last_samples;
+
+          std::vector<s16> expected(count);
+          std::vector<s16> actual(count);
+          const u32 expected_pos =
+              ReferenceResample(input.data(), expected.data(), count, expected_last_samples.data(),
+                                curr_pos, ratio, polyphase, coeffs.data());
+          const u32 actual_pos =
+              OptimizedResample(kernels, input.data(), actual.data(), count,
+                                actual_last_samples.data(), curr_pos, ratio, polyphase,
+                                coeffs.data());
+
+          EXPECT_EQ(expected, actual);
+          EXPECT_EQ(expected_last_samples, actual_last_samples);
+          EXPECT_EQ(expected_pos, actual_pos);
+          EXPECT_EQ(end_pos, actual_pos);
+        }
+      }
+    }
+  }
+}
+
+// Renders a set of synthetic voices with both the reference code and each set of optimized
+// kernels, checks that the output is identical and reports how long each took.
+TEST(AXMixing, RenderSyntheticVoices)
+{
+  constexpr u32 VOICES = 64;
+  constexpr u32 FRAMES = 200;
+
+  std::mt19937 rng(4);
+  const std::vector<s16> coeffs = RandomSamples(rng, 0x200 * 3);
+
+  for (const AXMixing::Kernels& kernels : AXMixing::GetSupportedKernels())
+  {
+    SCOPED_TRACE(kernels.name);
+
+    std::vector<SyntheticVoice> reference_voices = CreateSyntheticVoices(VOICES, FRAMES);
+    std::vector<SyntheticVoice> optimized_voices = reference_voices;
+
+    std::array<std::array<int, SAMPLES_PER_FRAME>, 12> reference_buses{};
+    std::array<std::array<int, SAMPLES_PER_FRAME>, 12> optimized_buses{};
+
+    std::chrono::steady_clock::duration reference_time{};
+    std::chrono::steady_clock::duration optimized_time{};
+
+    for (u32 frame = 0; frame < FRAMES; ++frame)
+    {
+      auto start = std::chrono::steady_clock::now();
+      for (SyntheticVoice& voice : reference_voices)
+        RenderVoice(voice, nullptr, coeffs.data(), reference_buses);
+      reference_time += std::chrono::steady_clock::now() - start;
+
+      start = std::chrono::steady_clock::now();
+      for (SyntheticVoice& voice : optimized_voices)
+        RenderVoice(voice, &kernels, coeffs.data(), optimized_buses);
+      optimized_time += std::chrono::steady_clock::now() - start;
+
+      ASSERT_EQ(reference_buses, optimized_buses) << "frame " << frame;
+    }
+
+    for (u32 i = 0; i < VOICES; ++i)
+    {
+      EXPECT_EQ(0, std::memcmp(&reference_voices[i].pb, &optimized_voices[i].pb,
+                               sizeof(AXPBWii)))
+          << "voice " << i;
+    }
+
+    const auto per_frame_us = [](std::chrono::steady_clock::duration time) {
+      return std::chrono::duration<double, std::micro>(time).count() / FRAMES;
+    };
+    fmt::print("{} voices, {} samples per frame: reference {:.2f} us/frame, "
+               "{} {:.2f} us/frame\n",
+               VOICES, SAMPLES_PER_FRAME, per_frame_us(reference_time), kernels.name,
+               per_frame_us(optimized_time));
+  }
+}
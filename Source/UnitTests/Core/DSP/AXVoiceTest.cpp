@@ -0,0 +1,296 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/DSP/DSPAccelerator.h"
+#include "Core/HW/DSP.h"
+#include "Core/HW/DSPHLE/DSPHLE.h"
+#include "Core/HW/DSPHLE/UCodes/AX.h"
+#include "Core/HW/DSPHLE/UCodes/AXStructs.h"
+#include "Core/HW/Memmap.h"
+#include "Core/System.h"
+
+using namespace DSP::HLE;
+
+namespace
+{
+// A newer GameCube AX ucode, which has the low pass filter in its PBs.
+constexpr u32 AX_CRC = 0x07f88145;
+
+constexpr u32 VOICES = 96;
+constexpr u32 FRAMES = 20;
+constexpr u32 RENDER_THREADS = 4;
+
+// Where the synthetic PB list and the updates of each voice are put in MEM1, and where the
+// samples of each voice are put in ARAM.
+constexpr u32 PB_LIST_ADDR = 0x00100000;
+constexpr u32 PB_STRIDE = 0x100;
+constexpr u32 UPDATES_ADDR = 0x00200000;
+constexpr u32 UPDATES_STRIDE = 0x40;
+constexpr u32 ARAM_VOICE_SIZE = 0x10000;
+
+static_assert(sizeof(AXPB) <= PB_STRIDE);
+
+constexpr u16 PBOffset(size_t offset)
+{
+  return static_cast<u16>(offset / sizeof(u16));
+}
+
+class TestAXUCode final : public AXUCode
+{
+public:
+  TestAXUCode(DSPHLE* dsphle, u32 voice_render_threads, const std::array<s16, 0x800>& coeffs)
+      : AXUCode(dsphle, AX_CRC)
+  {
+    m_voice_render_threads = voice_render_threads;
+    m_coeffs = coeffs;
+    m_coeffs_checksum = 0;
+  }
+
+  using AXUCode::ProcessPBList;
+
+  std::vector<int> GetBuses() const
+  {
+    std::vector<int> buses;
+    for (const auto& bus : {m_samples_main_left, m_samples_main_right, m_samples_main_surround,
+                            m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
+                            m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround})
+    {
+      buses.insert(buses.end(), bus, bus + 32 * 5);
+    }
+    return buses;
+  }
+
+  const DSP::Accelerator& GetAccelerator() const { return *m_accelerator; }
+};
+
+struct RenderResult
+{
+  std::vector<std::vector<int>> buses;
+  std::vector<u8> pbs;
+  std::array<u32, 7> accelerator_registers;
+  std::chrono::steady_clock::duration time;
+};
+
+class AXVoiceTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    auto& system = Core::System::GetInstance();
+    system.GetMemory().Init();
+    system.GetDSP().Reinit(true);
+
+    std::mt19937 rng(1);
+    for (s16& coeff : m_coeffs)
+      coeff = static_cast<s16>(rng());
+  }
+
+  void TearDown() override
+  {
+    auto& system = Core::System::GetInstance();
+    system.GetDSP().Shutdown();
+    system.GetMemory().Shutdown();
+  }
+
+  // Writes a list of voices with random settings to memory and random samples to ARAM. If
+  // update_next_pb is set, one voice has an update that makes the list skip the next voice, so it
+  // can't be rendered in parallel.
+  static void WritePBList(bool update_next_pb)
+  {
+    auto& system = Core::System::GetInstance();
+    auto& memory = system.GetMemory();
+
+    std::mt19937 rng(2);
+    const auto random_u16 = [&rng] { return static_cast<u16>(rng()); };
+
+    u8* aram = system.GetDSP().GetARAMPtr();
+    for (u32 i = 0; i < VOICES * ARAM_VOICE_SIZE; ++i)
+      aram[i] = static_cast<u8>(rng());
+
+    for (u32 i = 0; i < VOICES; ++i)
+    {
+      const u32 pb_addr = PB_LIST_ADDR + i * PB_STRIDE;
+      const u32 next_pb_addr = i + 1 < VOICES ? pb_addr + PB_STRIDE : 0;
+      const u32 updates_addr = UPDATES_ADDR + i * UPDATES_STRIDE;
+
+      AXPB pb{};
+      pb.next_pb_hi = static_cast<u16>(next_pb_addr >> 16);
+      pb.next_pb_lo = static_cast<u16>(next_pb_addr);
+      pb.this_pb_hi = static_cast<u16>(pb_addr >> 16);
+      pb.this_pb_lo = static_cast<u16>(pb_addr);
+
+      pb.src_type = static_cast<u16>(rng() % 2 == 0 ? SRCTYPE_POLYPHASE : SRCTYPE_LINEAR);
+      pb.coef_select = static_cast<u16>(rng() % 3);
+      pb.mixer_control = random_u16();
+      pb.running = static_cast<u16>(rng() % 8 != 0);
+      pb.is_stream = static_cast<u16>(rng() % 2);
+
+      for (VolumeData* vd : {&pb.mixer.main_left, &pb.mixer.main_right, &pb.mixer.auxA_left,
+                             &pb.mixer.auxA_right, &pb.mixer.auxB_left, &pb.mixer.auxB_right,
+                             &pb.mixer.auxB_surround, &pb.mixer.main_surround,
+                             &pb.mixer.auxA_surround})
+      {
+        vd->volume = random_u16();
+        vd->volume_delta = static_cast<u16>(rng() % 32);
+      }
+
+      pb.vol_env.cur_volume = static_cast<s16>(random_u16());
+      pb.vol_env.cur_volume_delta = static_cast<s16>(rng() % 64) - 32;
+
+      // ADPCM, 16-bit PCM and 8-bit PCM, whose addresses are in nibbles, words and bytes.
+      // Short one-shot voices reach their end in the middle of a frame.
+      constexpr std::array<u16, 3> formats = {0x00, 0x0A, 0x19};
+      const u16 format = formats[rng() % formats.size()];
+      const u32 aram_addr = i * ARAM_VOICE_SIZE;
+      const u32 start = format == 0x00 ? aram_addr * 2 :
+                        format == 0x0A ? aram_addr / 2 :
+                                         aram_addr;
+      const u32 length = 16 + rng() % 2000;
+      const u32 loop = start + rng() % length;
+      const u32 end = start + length;
+      const u32 current = start + rng() % length;
+      pb.audio_addr.looping = static_cast<u16>(rng() % 2);
+      pb.audio_addr.sample_format = format;
+      pb.audio_addr.loop_addr_hi = static_cast<u16>(loop >> 16);
+      pb.audio_addr.loop_addr_lo = static_cast<u16>(loop);
+      pb.audio_addr.end_addr_hi = static_cast<u16>(end >> 16);
+      pb.audio_addr.end_addr_lo = static_cast<u16>(end);
+      pb.audio_addr.cur_addr_hi = static_cast<u16>(current >> 16);
+      pb.audio_addr.cur_addr_lo = static_cast<u16>(current);
+
+      for (s16& coef : pb.adpcm.coefs)
+        coef = static_cast<s16>(random_u16());
+      pb.adpcm.pred_scale = random_u16() & 0x7F;
+      pb.adpcm.yn1 = static_cast<s16>(random_u16());
+      pb.adpcm.yn2 = static_cast<s16>(random_u16());
+      pb.adpcm_loop_info.pred_scale = random_u16() & 0x7F;
+      pb.adpcm_loop_info.yn1 = random_u16();
+      pb.adpcm_loop_info.yn2 = random_u16();
+
+      // Ratios between 1/8 and 4.0
+      const u32 ratio = 0x2000 + rng() % 0x3E000;
+      pb.src.ratio_hi = static_cast<u16>(ratio >> 16);
+      pb.src.ratio_lo = static_cast<u16>(ratio);
+      pb.src.cur_addr_frac = random_u16();
+      for (s16& sample : pb.src.last_samples)
+        sample = static_cast<s16>(random_u16());
+
+      pb.lpf.enabled = static_cast<u16>(rng() % 4 == 0);
+      pb.lpf.yn1 = static_cast<s16>(random_u16());
+      pb.lpf.a0 = random_u16() & 0x7FFF;
+      pb.lpf.b0 = random_u16() & 0x7FFF;
+
+      // Updates to the volume, mixer and sample rate don't stop the list from being rendered in
+      // parallel.
+      std::vector<u16> updates;
+      if (update_next_pb && i == VOICES / 2)
+      {
+        pb.updates.num_updates[2] = 1;
+        updates = {PBOffset(offsetof(AXPB, next_pb_lo)),
+                   static_cast<u16>(pb.next_pb_lo + PB_STRIDE)};
+      }
+      else if (i % 4 == 0)
+      {
+        pb.updates.num_updates[1] = 2;
+        pb.updates.num_updates[3] = 1;
+        updates = {PBOffset(offsetof(AXPB, vol_env.cur_volume)),
+                   random_u16(),
+                   PBOffset(offsetof(AXPB, mixer.main_left.volume)),
+                   random_u16(),
+                   PBOffset(offsetof(AXPB, src.ratio_lo)),
+                   random_u16()};
+      }
+      pb.updates.data_hi = static_cast<u16>(updates_addr >> 16);
+      pb.updates.data_lo = static_cast<u16>(updates_addr);
+
+      memory.CopyToEmuSwapped<u16>(pb_addr, reinterpret_cast<const u16*>(&pb), sizeof(pb));
+      memory.CopyToEmuSwapped<u16>(updates_addr, updates.data(), updates.size() * sizeof(u16));
+    }
+  }
+
+  RenderResult Render(u32 voice_render_threads, bool update_next_pb) const
+  {
+    WritePBList(update_next_pb);
+
+    auto& system = Core::System::GetInstance();
+    auto& dsphle = static_cast<DSPHLE&>(*system.GetDSP().GetDSPEmulator());
+    TestAXUCode ucode(&dsphle, voice_render_threads, m_coeffs);
+
+    RenderResult result{};
+    for (u32 frame = 0; frame < FRAMES; ++frame)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      ucode.ProcessPBList(PB_LIST_ADDR);
+      result.time += std::chrono::steady_clock::now() - start;
+      result.buses.push_back(ucode.GetBuses());
+    }
+
+    result.pbs.resize(VOICES * PB_STRIDE);
+    system.GetMemory().CopyFromEmu(result.pbs.data(), PB_LIST_ADDR, result.pbs.size());
+
+    const DSP::Accelerator& accelerator = ucode.GetAccelerator();
+    result.accelerator_registers = {accelerator.GetStartAddress(), accelerator.GetEndAddress(),
+                                    accelerator.GetCurrentAddress(),
+                                    accelerator.GetSampleFormat(),
+                                    static_cast<u16>(accelerator.GetYn1()),
+                                    static_cast<u16>(accelerator.GetYn2()),
+                                    accelerator.GetPredScale()};
+    return result;
+  }
+
+  static void ExpectSameResult(const RenderResult& expected, const RenderResult& actual)
+  {
+    for (u32 frame = 0; frame < FRAMES; ++frame)
+      EXPECT_EQ(expected.buses[frame], actual.buses[frame]) << "frame " << frame;
+    for (u32 i = 0; i < VOICES; ++i)
+    {
+      const size_t offset = i * PB_STRIDE;
+      EXPECT_EQ(0, std::memcmp(expected.pbs.data() + offset, actual.pbs.data() + offset,
+                               sizeof(AXPB)))
+          << "voice " << i;
+    }
+    EXPECT_EQ(expected.accelerator_registers, actual.accelerator_registers);
+  }
+
+  std::array<s16, 0x800> m_coeffs;
+};
+
+double PerFrameMicroseconds(std::chrono::steady_clock::duration time)
+{
+  return std::chrono::duration<double, std::micro>(time).count() / FRAMES;
+}
+}  // namespace
+
+// Renders a list of synthetic voices with one and with several threads, checks that the mixing
+// buffers, the PBs written back to memory and the accelerator state are identical and reports how
+// long each took.
+TEST_F(AXVoiceTest, ParallelRenderingMatchesSequential)
+{
+  const RenderResult sequential = Render(1, false);
+  const RenderResult parallel = Render(RENDER_THREADS, false);
+  ExpectSameResult(sequential, parallel);
+
+  fmt::print("{} voices, {} threads: sequential {:.2f} us/frame, parallel {:.2f} us/frame\n",
+             VOICES, RENDER_THREADS, PerFrameMicroseconds(sequential.time),
+             PerFrameMicroseconds(parallel.time));
+}
+
+// A list with an update that changes where it continues has to fall back to sequential rendering,
+// which is the only way that the voice it skips isn't rendered.
+TEST_F(AXVoiceTest, ListThatCantBeRenderedInParallel)
+{
+  const RenderResult sequential = Render(1, true);
+  const RenderResult parallel = Render(RENDER_THREADS, true);
+  ExpectSameResult(sequential, parallel);
+}
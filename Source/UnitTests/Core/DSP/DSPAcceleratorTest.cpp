@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <array>
+#include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -185,3 +187,84 @@ TEST(DSPAccelerator, CurrentAddressSkips)
   accelerator.TestRead();
   EXPECT_EQ(accelerator.GetCurrentAddress(), 0x00000013u);
 }
+
+// Accelerator backed by random memory, which restarts from the loop address on every other end
+// exception like a looping AX voice, and stops like a non-looping one otherwise.
+class MemoryAccelerator : public DSP::Accelerator
+{
+public:
+  explicit MemoryAccelerator(const std::vector<u8>& memory) : m_memory(memory) {}
+
+  u32 GetEndExceptionCount() const { return m_end_exceptions; }
+
+protected:
+  void OnEndException() override
+  {
+    if (++m_end_exceptions % 2 == 1)
+    {
+      SetPredScale(m_memory[m_end_exceptions % m_memory.size()]);
+      SetYn1(GetYn1());
+      SetYn2(GetYn2());
+    }
+  }
+  u8 ReadMemory(u32 address) override { return m_memory[address % m_memory.size()]; }
+  void WriteMemory(u32 address, u8 value) override {}
+
+private:
+  const std::vector<u8>& m_memory;
+  u32 m_end_exceptions = 0;
+};
+
+TEST(DSPAccelerator, ReadSamplesMatchesRead)
+{
+  std::mt19937 rng(0x1234);
+  std::vector<u8> memory(0x1000);
+  for (u8& byte : memory)
+    byte = static_cast<u8>(rng());
+
+  std::array<s16, 16> coefs;
+  for (s16& coef : coefs)
+    coef = static_cast<s16>(rng());
+
+  for (u16 format : {0x00, 0x0A, 0x19})
+  {
+    for (u32 test = 0; test < 200; ++test)
+    {
+      MemoryAccelerator single(memory);
+      MemoryAccelerator batched(memory);
+      const u32 start = rng() % 0x400;
+      const u32 end = start + rng() % 0x100;
+      const u32 current = start + rng() % (end - start + 1);
+      const s16 yn1 = static_cast<s16>(rng());
+      const s16 yn2 = static_cast<s16>(rng());
+      const u16 pred_scale = static_cast<u16>(rng());
+      for (MemoryAccelerator* accelerator : {&single, &batched})
+      {
+        accelerator->SetSampleFormat(format);
+        accelerator->SetStartAddress(start);
+        accelerator->SetEndAddress(end);
+        accelerator->SetCurrentAddress(current);
+        accelerator->SetYn1(yn1);
+        accelerator->SetYn2(yn2);
+        accelerator->SetPredScale(pred_scale);
+      }
+
+      for (u32 block = 0; block < 8; ++block)
+      {
+        const u32 count = 1 + rng() % 150;
+        std::vector<s16> expected(count);
+        std::vector<s16> actual(count);
+        for (s16& sample : expected)
+          sample = static_cast<s16>(single.Read(coefs.data()));
+        batched.ReadSamples(coefs.data(), actual.data(), count);
+
+        ASSERT_EQ(expected, actual) << "format " << format << ", test " << test;
+        EXPECT_EQ(single.GetCurrentAddress(), batched.GetCurrentAddress());
+        EXPECT_EQ(single.GetYn1(), batched.GetYn1());
+        EXPECT_EQ(single.GetYn2(), batched.GetYn2());
+        EXPECT_EQ(single.GetPredScale(), batched.GetPredScale());
+        EXPECT_EQ(single.GetEndExceptionCount(), batched.GetEndExceptionCount());
+      }
+    }
+  }
+}
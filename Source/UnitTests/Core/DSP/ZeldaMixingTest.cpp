@@ -0,0 +1,443 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/HW/DSPHLE/UCodes/ZeldaMixing.h"
+
+using namespace DSP::HLE;
+
+namespace
+{
+// The scalar mixing code of the Zelda ucode as it was written originally, which the optimized
+// kernels must match bit for bit.
+
+template <size_t B>
+void ReferenceApplyVolumeInPlace(s16* buf, size_t count, u16 vol)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    s32 tmp = (u32)buf[i] * (u32)vol;
+    tmp >>= 16 - B;
+
+    buf[i] = (s16)std::clamp(tmp, -0x8000, 0x7FFF);
+  }
+}
+
+s32 ReferenceAddBuffersWithVolumeRamp(s16* dst, const s16* src, size_t count, s32 vol, s32 step)
+{
+  if (!vol && !step)
+    return vol;
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    dst[i] += ((vol >> 16) * src[i]) >> 16;
+    vol += step;
+  }
+
+  return vol;
+}
+
+void ReferenceAddBuffersWithVolume(s16* dst, const s16* src, size_t count, u16 vol)
+{
+  while (count--)
+  {
+    s32 vol_src = ((s32)*src++ * (s32)vol) >> 15;
+    *dst++ += std::clamp(vol_src, -0x8000, 0x7FFF);
+  }
+}
+
+u32 ReferenceResample(const s16* src, s16* dst, size_t count, u32 pos, u32 ratio,
+                      const s16* resampling_coeffs)
+{
+  if ((ratio >> 12) >= 4)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      pos += ratio;
+      dst[i] = src[pos >> 12];
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      u32 coeffs_idx = ((pos & 0xFFF) >> 6) * 4;
+      const s16* coeffs = &resampling_coeffs[coeffs_idx];
+      const s16* input = &src[pos >> 12];
+
+      s64 dst_sample_unclamped = 0;
+      for (size_t j = 0; j < 4; ++j)
+        dst_sample_unclamped += (s64)2 * coeffs[j] * input[j];
+      dst_sample_unclamped >>= 16;
+
+      dst[i] = (s16)std::clamp<s64>(dst_sample_unclamped, -0x8000, 0x7FFF);
+
+      pos += ratio;
+    }
+  }
+  return pos;
+}
+
+void ReferenceApplyReverbFilter(s16* buffer, size_t count, const s16* filter_coeffs)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    s32 sample = 0;
+    for (size_t j = 0; j < 8; ++j)
+      sample += (s32)buffer[i + j] * filter_coeffs[j];
+    sample >>= 15;
+    buffer[i] = std::clamp(sample, -0x8000, 0x7FFF);
+  }
+}
+
+std::vector<s16> RandomSamples(std::mt19937& rng, size_t count)
+{
+  std::uniform_int_distribution<int> dist(-32768, 32767);
+  std::vector<s16> samples(count);
+  for (s16& sample : samples)
+    sample = static_cast<s16>(dist(rng));
+
+  // Make sure the extremes are covered
+  if (count >= 2)
+  {
+    samples[0] = -32768;
+    samples[1] = 32767;
+  }
+  return samples;
+}
+
+constexpr u32 SAMPLES_PER_FRAME = 0x50;
+constexpr u32 NUM_BUFFERS = 8;
+constexpr u32 NUM_CHANNELS = 6;
+
+using MixingBuffer = std::array<s16, SAMPLES_PER_FRAME>;
+using MixingBuffers = std::array<MixingBuffer, NUM_BUFFERS>;
+
+// The parts of a Zelda VPB that are used for resampling and mixing.
+struct SyntheticVoice
+{
+  u32 resampling_ratio;
+  u32 current_pos_frac;
+
+  struct Channel
+  {
+    u16 buffer;
+    s16 current_volume;
+    s16 target_volume;
+  };
+  std::array<Channel, NUM_CHANNELS> channels;
+
+  std::vector<s16> input;
+  u32 input_pos = 0;
+};
+
+std::vector<SyntheticVoice> CreateSyntheticVoices(u32 count, u32 frames)
+{
+  std::mt19937 rng(1234);
+
+  std::vector<SyntheticVoice> voices(count);
+  for (SyntheticVoice& voice : voices)
+  {
+    // Mostly interpolated voices, with the occasional one above 4:1.
+    voice.resampling_ratio = rng() % 8 == 0 ? 0x4000 + rng() % 0x1000 : 0x200 + rng() % 0x3E00;
+    voice.current_pos_frac = rng() % 0x1000;
+
+    for (auto& channel : voice.channels)
+    {
+      channel.buffer = static_cast<u16>(rng() % NUM_BUFFERS);
+      channel.current_volume = rng() % 4 == 0 ? 0 : static_cast<s16>(rng());
+      channel.target_volume = static_cast<s16>(rng());
+    }
+
+    const u32 samples_per_frame = ((SAMPLES_PER_FRAME * voice.resampling_ratio) >> 12) + 2;
+    voice.input = RandomSamples(rng, samples_per_frame * frames + 8);
+  }
+  return voices;
+}
+
+u32 OptimizedResample(const ZeldaMixing::Kernels& kernels, const s16* src, s16* dst, u32 count,
+                      u32 pos, u32 ratio, const s16* coeffs)
+{
+  // Ratios of 4:1 and more don't interpolate, so they don't use a kernel
+  if ((ratio >> 12) >= 4)
+    return ZeldaMixing::Resample(src, dst, count, pos, ratio, coeffs);
+  return kernels.resample_filtered(src, dst, count, pos, ratio, coeffs);
+}
+
+// Renders one frame of a voice the way AddVoice does for non-Dolby voices, minus the sample
+// loading and the VPB bookkeeping, with the given kernels or with the reference code if kernels
+// is null.
+void RenderVoice(SyntheticVoice& voice, const ZeldaMixing::Kernels* kernels, const s16* coeffs,
+                 MixingBuffers& buffers)
+{
+  MixingBuffer samples;
+  const s16* src = voice.input.data() + voice.input_pos;
+  const u32 pos =
+      kernels ? OptimizedResample(*kernels, src, samples.data(), SAMPLES_PER_FRAME,
+                                  voice.current_pos_frac, voice.resampling_ratio, coeffs) :
+                ReferenceResample(src, samples.data(), SAMPLES_PER_FRAME, voice.current_pos_frac,
+                                  voice.resampling_ratio, coeffs);
+  voice.input_pos += pos >> 12;
+  voice.current_pos_frac = pos & 0xFFF;
+
+  for (auto& channel : voice.channels)
+  {
+    const s16 volume_delta = channel.target_volume - channel.current_volume;
+    const s32 volume_step = (volume_delta << 16) / (s32)SAMPLES_PER_FRAME;
+    s16* dst = buffers[channel.buffer].data();
+
+    s32 new_volume;
+    if (kernels)
+    {
+      new_volume = channel.current_volume << 16;
+      if (new_volume || volume_step)
+      {
+        new_volume = kernels->add_with_volume_ramp(dst, samples.data(), SAMPLES_PER_FRAME,
+                                                   new_volume, volume_step);
+      }
+    }
+    else
+    {
+      new_volume = ReferenceAddBuffersWithVolumeRamp(
+          dst, samples.data(), SAMPLES_PER_FRAME, channel.current_volume << 16, volume_step);
+    }
+    channel.current_volume = static_cast<s16>(new_volume >> 16);
+  }
+}
+
+// Runs the reverb filter and output stage of a frame on the mixing buffers, with the given
+// kernels or with the reference code if kernels is null.
+void FinalizeFrame(const ZeldaMixing::Kernels* kernels, MixingBuffers& buffers,
+                   std::array<s16, 8>& last8, const s16* filter_coeffs, u16 reverb_volume,
+                   u16 output_volume)
+{
+  std::array<s16, SAMPLES_PER_FRAME + 8> reverb;
+  std::copy(last8.begin(), last8.end(), reverb.begin());
+  std::copy(buffers[7].begin(), buffers[7].end(), reverb.begin() + 8);
+  std::copy_n(reverb.begin() + SAMPLES_PER_FRAME, 8, last8.begin());
+
+  if (kernels)
+  {
+    kernels->apply_reverb_filter(reverb.data(), SAMPLES_PER_FRAME, filter_coeffs);
+    kernels->add_with_volume(buffers[0].data(), reverb.data(), SAMPLES_PER_FRAME, reverb_volume);
+    kernels->add_with_volume(buffers[1].data(), reverb.data() + 0x28, 0x28, reverb_volume);
+    kernels->apply_volume(buffers[0].data(), SAMPLES_PER_FRAME, output_volume, 12);
+    kernels->apply_volume(buffers[1].data(), SAMPLES_PER_FRAME, output_volume, 12);
+  }
+  else
+  {
+    ReferenceApplyReverbFilter(reverb.data(), SAMPLES_PER_FRAME, filter_coeffs);
+    ReferenceAddBuffersWithVolume(buffers[0].data(), reverb.data(), SAMPLES_PER_FRAME,
+                                  reverb_volume);
+    ReferenceAddBuffersWithVolume(buffers[1].data(), reverb.data() + 0x28, 0x28, reverb_volume);
+    ReferenceApplyVolumeInPlace<4>(buffers[0].data(), SAMPLES_PER_FRAME, output_volume);
+    ReferenceApplyVolumeInPlace<4>(buffers[1].data(), SAMPLES_PER_FRAME, output_volume);
+  }
+}
+}  // namespace
+
+TEST(ZeldaMixing, ApplyVolumeMatchesReference)
+{
+  for (const ZeldaMixing::Kernels& kernels : ZeldaMixing::GetSupportedKernels())
+  {
+    SCOPED_TRACE(kernels.name);
+    std::mt19937 rng(1);
+    for (u32 count = 0; count <= 100; ++count)
+    {
+      for (u32 iteration = 0; iteration < 20; ++iteration)
+      {
+        const u16 volume = iteration == 0 ? 0xFFFF : static_cast<u16>(rng());
+        const bool fixed_4_12 = iteration % 2 == 0;
+
+        std::vector<s16> expected = RandomSamples(rng, count);
+        std::vector<s16> actual = expected;
+        if (fixed_4_12)
+          ReferenceApplyVolumeInPlace<4>(expected.data(), count, volume);
+        else
+          ReferenceApplyVolumeInPlace<1>(expected.data(), count, volume);
+        kernels.apply_volume(actual.data(), count, volume, fixed_4_12 ? 12 : 15);
+
+        EXPECT_EQ(expected, actual);
+      }
+    }
+  }
+}
+
+TEST(ZeldaMixing, AddWithVolumeRampMatchesReference)
+{
+  for (const ZeldaMixing::Kernels& kernels : ZeldaMixing::GetSupportedKernels())
+  {
+    SCOPED_TRACE(kernels.name);
+    std::mt19937 rng(2);
+    for (u32 count = 0; count <= 100; ++count)
+    {
+      for (u32 iteration = 0; iteration < 20; ++iteration)
+      {
+        const std::vector<s16> src = RandomSamples(rng, count);
+        std::vector<s16> expected = RandomSamples(rng, count);
+        std::vector<s16> actual = expected;
+
+        const s32 volume = static_cast<s16>(rng()) / 2 * 0x10000;
+        const s32 step = iteration % 4 == 0 ? 0 : static_cast<s32>(rng() % 0x20000) - 0x10000;
+
+        const s32 expected_volume =
+            ReferenceAddBuffersWithVolumeRamp(expected.data(), src.data(), count, volume, step);
+        const s32 actual_volume =
+            kernels.add_with_volume_ramp(actual.data(), src.data(), count, volume, step);
+
+        EXPECT_EQ(expected, actual);
+        EXPECT_EQ(expected_volume, actual_volume);
+      }
+    }
+  }
+}
+
+TEST(ZeldaMixing, AddWithVolumeMatchesReference)
+{
+  for (const ZeldaMixing::Kernels& kernels : ZeldaMixing::GetSupportedKernels())
+  {
+    SCOPED_TRACE(kernels.name);
+    std::mt19937 rng(3);
+    for (u32 count = 0; count <= 100; ++count)
+    {
+      for (u32 iteration = 0; iteration < 20; ++iteration)
+      {
+        const std::vector<s16> src = RandomSamples(rng, count);
+        std::vector<s16> expected = RandomSamples(rng, count);
+        std::vector<s16> actual = expected;
+        const u16 volume = iteration == 0 ? 0xFFFF : static_cast<u16>(rng());
+
+        ReferenceAddBuffersWithVolume(expected.data(), src.data(), count, volume);
+        kernels.add_with_volume(actual.data(), src.data(), count, volume);
+
+        EXPECT_EQ(expected, actual);
+      }
+    }
+  }
+}
+
+TEST(ZeldaMixing, ResampleMatchesReference)
+{
+  const std::array<u32, 8> fixed_ratios = {0, 1, 0x800, 0xFFF, 0x1000, 0x1001, 0x3FFF, 0x4000};
+
+  for (const ZeldaMixing::Kernels& kernels : ZeldaMixing::GetSupportedKernels())
+  {
+    SCOPED_TRACE(kernels.name);
+    std::mt19937 rng(4);
+    // Full range coefficients, including the -32768 * -32768 corner case
+    std::vector<s16> coeffs = RandomSamples(rng, 0x100);
+    coeffs[4] = coeffs[5] = coeffs[6] = coeffs[7] = -32768;
+
+    for (u32 count = 1; count <= 100; ++count)
+    {
+      for (u32 iteration = 0; iteration < 20; ++iteration)
+      {
+        const u32 ratio = iteration < fixed_ratios.size() ? fixed_ratios[iteration] :
+                                                            static_cast<u32>(rng() % 0x5000);
+        const u32 pos = iteration % 3 == 0 ? 0 : rng() % 0x1000;
+
+        std::vector<s16> input = RandomSamples(rng, ((pos + count * u64{ratio}) >> 12) + 4);
+        if (iteration % 5 == 0)
+          std::fill(input.begin(), input.end(), s16(-32768));
+
+        std::vector<s16> expected(count);
+        std::vector<s16> actual(count);
+        const u32 expected_pos =
+            ReferenceResample(input.data(), expected.data(), count, pos, ratio, coeffs.data());
+        const u32 actual_pos = OptimizedResample(kernels, input.data(), actual.data(), count, pos,
+                                                 ratio, coeffs.data());
+
+        EXPECT_EQ(expected, actual);
+        EXPECT_EQ(expected_pos, actual_pos);
+      }
+    }
+  }
+}
+
+TEST(ZeldaMixing, ReverbFilterMatchesReference)
+{
+  for (const ZeldaMixing::Kernels& kernels : ZeldaMixing::GetSupportedKernels())
+  {
+    SCOPED_TRACE(kernels.name);
+    std::mt19937 rng(5);
+    for (u32 count = 0; count <= 100; ++count)
+    {
+      for (u32 iteration = 0; iteration < 20; ++iteration)
+      {
+        const std::vector<s16> coeffs = RandomSamples(rng, 8);
+        std::vector<s16> expected = RandomSamples(rng, count + 7);
+        std::vector<s16> actual = expected;
+
+        ReferenceApplyReverbFilter(expected.data(), count, coeffs.data());
+        kernels.apply_reverb_filter(actual.data(), count, coeffs.data());
+
+        EXPECT_EQ(expected, actual);
+      }
+    }
+  }
+}
+
+// Renders a set of synthetic voices with both the reference code and each set of kernels, and
+// checks that the output is identical.
+TEST(ZeldaMixing, RenderSyntheticVoices)
+{
+  constexpr u32 VOICES = 64;
+  constexpr u32 FRAMES = 200;
+
+  std::mt19937 rng(6);
+  const std::vector<s16> coeffs = RandomSamples(rng, 0x100);
+  const std::vector<s16> filter_coeffs = {0x1000, -0x800, 0x400, -0x200, 0x100, 0, 0, 0x2000};
+  const u16 reverb_volume = 0x4000;
+  const u16 output_volume = 0x1000;
+
+  for (const ZeldaMixing::Kernels& kernels : ZeldaMixing::GetSupportedKernels())
+  {
+    SCOPED_TRACE(kernels.name);
+
+    std::vector<SyntheticVoice> reference_voices = CreateSyntheticVoices(VOICES, FRAMES);
+    std::vector<SyntheticVoice> optimized_voices = reference_voices;
+
+    MixingBuffers reference_buffers{};
+    MixingBuffers optimized_buffers{};
+    std::array<s16, 8> reference_last8{};
+    std::array<s16, 8> optimized_last8{};
+
+    for (u32 frame = 0; frame < FRAMES; ++frame)
+    {
+      reference_buffers = {};
+      optimized_buffers = {};
+
+      for (SyntheticVoice& voice : reference_voices)
+        RenderVoice(voice, nullptr, coeffs.data(), reference_buffers);
+      FinalizeFrame(nullptr, reference_buffers, reference_last8, filter_coeffs.data(),
+                    reverb_volume, output_volume);
+
+      for (SyntheticVoice& voice : optimized_voices)
+        RenderVoice(voice, &kernels, coeffs.data(), optimized_buffers);
+      FinalizeFrame(&kernels, optimized_buffers, optimized_last8, filter_coeffs.data(),
+                    reverb_volume, output_volume);
+
+      ASSERT_EQ(reference_buffers, optimized_buffers) << "frame " << frame;
+      ASSERT_EQ(reference_last8, optimized_last8) << "frame " << frame;
+    }
+
+    for (u32 i = 0; i < VOICES; ++i)
+    {
+      EXPECT_EQ(reference_voices[i].current_pos_frac, optimized_voices[i].current_pos_frac);
+      EXPECT_EQ(reference_voices[i].input_pos, optimized_voices[i].input_pos);
+      for (u32 j = 0; j < NUM_CHANNELS; ++j)
+      {
+        EXPECT_EQ(reference_voices[i].channels[j].current_volume,
+                  optimized_voices[i].channels[j].current_volume)
+            << "voice " << i << " channel " << j;
+      }
+    }
+  }
+}
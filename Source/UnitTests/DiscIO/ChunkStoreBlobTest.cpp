@@ -0,0 +1,149 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "DiscIO/Blob.h"
+#include "DiscIO/ChunkStoreBlob.h"
+
+namespace
+{
+std::vector<u8> GenerateData(size_t size, u32 seed)
+{
+  std::mt19937 generator(seed);
+  std::vector<u8> data(size);
+  for (u8& byte : data)
+    byte = static_cast<u8>(generator());
+  return data;
+}
+
+// Returns the offsets at which the chunks of the given data end
+std::vector<size_t> FindBoundaries(const std::vector<u8>& data)
+{
+  std::vector<size_t> boundaries;
+  size_t offset = 0;
+  while (offset < data.size())
+  {
+    offset += DiscIO::FindChunkStoreBoundary(data.data() + offset, data.size() - offset);
+    boundaries.push_back(offset);
+  }
+  return boundaries;
+}
+
+class ChunkStoreBlobTest : public testing::Test
+{
+protected:
+  ChunkStoreBlobTest() : m_directory(File::CreateTempDir()) {}
+
+  ~ChunkStoreBlobTest() override
+  {
+    if (!m_directory.empty())
+      File::DeleteDirRecursively(m_directory);
+  }
+
+  const std::string m_directory;
+};
+}  // namespace
+
+TEST(ChunkStoreBoundary, ChunkSizesAreLimited)
+{
+  const std::vector<u8> data = GenerateData(0x400000, 1);
+
+  size_t previous = 0;
+  for (const size_t boundary : FindBoundaries(data))
+  {
+    if (boundary != data.size())
+    {
+      EXPECT_GE(boundary - previous, DiscIO::CHUNK_STORE_MIN_CHUNK_SIZE);
+      EXPECT_LE(boundary - previous, DiscIO::CHUNK_STORE_MAX_CHUNK_SIZE);
+    }
+    previous = boundary;
+  }
+
+  // Data that is too short to be cut is one chunk
+  EXPECT_EQ(DiscIO::FindChunkStoreBoundary(data.data(), DiscIO::CHUNK_STORE_MIN_CHUNK_SIZE),
+            DiscIO::CHUNK_STORE_MIN_CHUNK_SIZE);
+}
+
+TEST(ChunkStoreBoundary, BoundariesFollowMovedData)
+{
+  const std::vector<u8> data = GenerateData(0x400000, 2);
+
+  // The same data, but moved by an amount that isn't a multiple of any chunk size
+  constexpr size_t SHIFT = 12345;
+  std::vector<u8> moved_data = GenerateData(SHIFT, 3);
+  moved_data.insert(moved_data.end(), data.begin(), data.end());
+
+  const std::vector<size_t> boundaries = FindBoundaries(data);
+  const std::vector<size_t> moved_boundaries = FindBoundaries(moved_data);
+
+  // After the first few chunks, the boundaries have to line up again
+  size_t matching = 0;
+  for (const size_t boundary : moved_boundaries)
+  {
+    if (boundary > SHIFT &&
+        std::find(boundaries.begin(), boundaries.end(), boundary - SHIFT) != boundaries.end())
+    {
+      ++matching;
+    }
+  }
+  EXPECT_GE(matching + 4, boundaries.size());
+}
+
+TEST_F(ChunkStoreBlobTest, WriteAndReadBack)
+{
+  // The second disc contains all of the first one, moved to another offset
+  const std::vector<u8> first = GenerateData(0x300000, 4);
+  std::vector<u8> second = GenerateData(0x18000, 5);
+  second.insert(second.end(), first.begin(), first.end());
+
+  const std::vector<std::string> paths = {m_directory + "/first.iso",
+                                          m_directory + "/second.iso"};
+  ASSERT_TRUE(File::IOFile(paths[0], "wb").WriteBytes(first.data(), first.size()));
+  ASSERT_TRUE(File::IOFile(paths[1], "wb").WriteBytes(second.data(), second.size()));
+
+  std::vector<std::unique_ptr<DiscIO::BlobReader>> readers;
+  std::vector<DiscIO::BlobReader*> infiles;
+  for (const std::string& path : paths)
+  {
+    readers.push_back(DiscIO::CreateBlobReader(path));
+    ASSERT_TRUE(readers.back());
+    infiles.push_back(readers.back().get());
+  }
+
+  const std::string store_path = m_directory + "/store.dcs";
+  ASSERT_TRUE(DiscIO::ConvertToChunkStore(infiles, paths, store_path, 1,
+                                          [](const std::string&, float) { return true; }));
+
+  const std::vector<u8>* contents[] = {&first, &second};
+  for (u32 i = 0; i < 2; ++i)
+  {
+    const std::unique_ptr<DiscIO::ChunkStoreReader> store =
+        DiscIO::ChunkStoreReader::Create(File::IOFile(store_path, "rb"), store_path, i);
+    ASSERT_TRUE(store);
+    EXPECT_EQ(store->GetNumberOfDiscs(), 2u);
+    ASSERT_EQ(store->GetDataSize(), contents[i]->size());
+
+    std::vector<u8> data(contents[i]->size());
+    ASSERT_TRUE(store->Read(0, data.size(), data.data()));
+    EXPECT_EQ(data, *contents[i]);
+
+    // A read that starts and ends in the middle of chunks
+    std::vector<u8> part(0x23456);
+    ASSERT_TRUE(store->Read(0x12345, part.size(), part.data()));
+    EXPECT_TRUE(std::equal(part.begin(), part.end(), contents[i]->begin() + 0x12345));
+  }
+
+  // Random data doesn't compress, so the store can only be smaller than the two discs if the
+  // chunks they share were stored once
+  EXPECT_LT(File::GetSize(store_path), first.size() + first.size() / 2);
+}
@@ -0,0 +1,200 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "VideoCommon/AsyncShaderCompiler.h"
+
+using VideoCommon::AsyncShaderCompiler;
+
+namespace
+{
+class TestWorkItem final : public AsyncShaderCompiler::WorkItem
+{
+public:
+  TestWorkItem(int id_, std::vector<int>* compiled_, std::vector<int>* cancelled_,
+               Common::Event* gate_ = nullptr, bool succeeds_ = true)
+      : id(id_), compiled(compiled_), cancelled(cancelled_), gate(gate_), succeeds(succeeds_)
+  {
+  }
+
+  bool Compile() override
+  {
+    if (gate)
+      gate->Wait();
+    return succeeds;
+  }
+
+  // Both of these are called on the main thread, in the order the work items were compiled.
+  void Retrieve() override { compiled->push_back(id); }
+  void Cancel() override { cancelled->push_back(id); }
+
+private:
+  int id;
+  std::vector<int>* compiled;
+  std::vector<int>* cancelled;
+  Common::Event* gate;
+  bool succeeds;
+};
+
+void WaitForWorkers(AsyncShaderCompiler& compiler)
+{
+  while (compiler.HasPendingWork())
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+void WaitForQueue(AsyncShaderCompiler& compiler)
+{
+  while (compiler.GetMetrics().queue_depth != 0)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+}  // namespace
+
+TEST(AsyncShaderCompiler, CompilesInPriorityOrder)
+{
+  AsyncShaderCompiler compiler;
+  ASSERT_TRUE(compiler.StartWorkerThreads(1));
+
+  std::vector<int> compiled;
+  std::vector<int> cancelled;
+  Common::Event gate;
+
+  // Keep the worker busy until everything is queued.
+  compiler.QueueWorkItem(std::make_unique<TestWorkItem>(0, &compiled, &cancelled, &gate), 0);
+  WaitForQueue(compiler);
+
+  compiler.QueueWorkItem(std::make_unique<TestWorkItem>(3, &compiled, &cancelled), 300);
+  compiler.QueueWorkItem(std::make_unique<TestWorkItem>(1, &compiled, &cancelled), 100);
+  compiler.QueueWorkItem(std::make_unique<TestWorkItem>(2, &compiled, &cancelled), 200);
+  gate.Set();
+
+  WaitForWorkers(compiler);
+  compiler.RetrieveWorkItems();
+  compiler.StopWorkerThreads();
+
+  EXPECT_EQ(compiled, (std::vector<int>{0, 1, 2, 3}));
+  EXPECT_TRUE(cancelled.empty());
+}
+
+TEST(AsyncShaderCompiler, PromoteAndCancel)
+{
+  AsyncShaderCompiler compiler;
+  ASSERT_TRUE(compiler.StartWorkerThreads(1));
+
+  std::vector<int> compiled;
+  std::vector<int> cancelled;
+  Common::Event gate;
+
+  compiler.QueueWorkItem(std::make_unique<TestWorkItem>(0, &compiled, &cancelled, &gate), 0);
+  WaitForQueue(compiler);
+
+  const AsyncShaderCompiler::WorkItemID a =
+      compiler.QueueWorkItem(std::make_unique<TestWorkItem>(1, &compiled, &cancelled), 300);
+  const AsyncShaderCompiler::WorkItemID b =
+      compiler.QueueWorkItem(std::make_unique<TestWorkItem>(2, &compiled, &cancelled), 200);
+  compiler.QueueWorkItem(std::make_unique<TestWorkItem>(3, &compiled, &cancelled), 100);
+
+  compiler.PromoteWorkItem(a, 50);
+  EXPECT_TRUE(compiler.CancelWorkItem(b));
+  EXPECT_FALSE(compiler.CancelWorkItem(b));
+  gate.Set();
+
+  WaitForWorkers(compiler);
+  compiler.RetrieveWorkItems();
+  compiler.StopWorkerThreads();
+
+  EXPECT_EQ(compiled, (std::vector<int>{0, 1, 3}));
+  EXPECT_EQ(cancelled, (std::vector<int>{2}));
+
+  const AsyncShaderCompiler::Metrics metrics = compiler.GetMetrics();
+  EXPECT_EQ(metrics.compiled, 3u);
+  EXPECT_EQ(metrics.promoted, 1u);
+  EXPECT_EQ(metrics.cancelled, 1u);
+}
+
+TEST(AsyncShaderCompiler, CompilesEverythingOnSeveralWorkers)
+{
+  constexpr int WORK_ITEMS = 1000;
+
+  AsyncShaderCompiler compiler;
+  ASSERT_TRUE(compiler.StartWorkerThreads(4));
+
+  std::vector<int> compiled;
+  std::vector<int> cancelled;
+  for (int i = 0; i < WORK_ITEMS; i++)
+    compiler.QueueWorkItem(std::make_unique<TestWorkItem>(i, &compiled, &cancelled), i % 7);
+
+  // Work queued before resizing the worker threads isn't lost.
+  ASSERT_TRUE(compiler.ResizeWorkerThreads(2));
+
+  WaitForWorkers(compiler);
+  compiler.RetrieveWorkItems();
+  compiler.StopWorkerThreads();
+
+  EXPECT_EQ(compiled.size(), size_t(WORK_ITEMS));
+  EXPECT_EQ(compiler.GetMetrics().compiled, u64(WORK_ITEMS));
+}
+
+TEST(AsyncShaderCompiler, IdleWorkerStealsWork)
+{
+  AsyncShaderCompiler compiler;
+  ASSERT_TRUE(compiler.StartWorkerThreads(2));
+
+  std::vector<int> compiled;
+  std::vector<int> cancelled;
+  Common::Event gates[2];
+
+  // Keep both workers busy, one with each gated work item.
+  compiler.QueueWorkItem(std::make_unique<TestWorkItem>(0, &compiled, &cancelled, &gates[0]), 0);
+  compiler.QueueWorkItem(std::make_unique<TestWorkItem>(1, &compiled, &cancelled, &gates[1]), 0);
+  WaitForQueue(compiler);
+
+  // These are spread across both queues, but only one worker is free to compile them, so it has
+  // to take the other worker's share.
+  for (int i = 2; i < 6; i++)
+    compiler.QueueWorkItem(std::make_unique<TestWorkItem>(i, &compiled, &cancelled), i);
+  gates[1].Set();
+
+  while (compiler.GetMetrics().compiled != 5)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_EQ(compiler.GetMetrics().stolen, 2u);
+
+  gates[0].Set();
+  WaitForWorkers(compiler);
+  compiler.RetrieveWorkItems();
+  compiler.StopWorkerThreads();
+
+  EXPECT_EQ(compiled.size(), 6u);
+  EXPECT_EQ(compiler.GetMetrics().stolen, 2u);
+}
+
+TEST(AsyncShaderCompiler, FailedCompilesAreCountedSeparately)
+{
+  AsyncShaderCompiler compiler;
+  ASSERT_TRUE(compiler.StartWorkerThreads(1));
+
+  std::vector<int> compiled;
+  std::vector<int> cancelled;
+  for (int i = 0; i < 4; i++)
+  {
+    compiler.QueueWorkItem(
+        std::make_unique<TestWorkItem>(i, &compiled, &cancelled, nullptr, i % 2 == 0), 0);
+  }
+
+  WaitForWorkers(compiler);
+  compiler.RetrieveWorkItems();
+  compiler.StopWorkerThreads();
+
+  // Failed work items aren't retrieved.
+  EXPECT_EQ(compiled, (std::vector<int>{0, 2}));
+
+  const AsyncShaderCompiler::Metrics metrics = compiler.GetMetrics();
+  EXPECT_EQ(metrics.compiled, 2u);
+  EXPECT_EQ(metrics.failed, 2u);
+}
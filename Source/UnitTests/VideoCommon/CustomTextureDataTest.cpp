@@ -0,0 +1,122 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "VideoCommon/Assets/CustomTextureData.h"
+
+namespace
+{
+VideoCommon::CustomTextureData::ArraySlice MakeSlice()
+{
+  VideoCommon::CustomTextureData::ArraySlice slice;
+  for (u32 size = 8; size != 0; size /= 2)
+  {
+    VideoCommon::CustomTextureData::ArraySlice::Level level;
+    level.format = AbstractTextureFormat::RGBA8;
+    level.width = size;
+    level.height = size;
+    level.row_length = size;
+    for (u32 i = 0; i < size * size * 4; ++i)
+      level.data.push_back(static_cast<u8>(i * 7 + size));
+    slice.m_levels.push_back(std::move(level));
+  }
+  return slice;
+}
+
+class CustomTextureDataTest : public testing::Test
+{
+protected:
+  CustomTextureDataTest()
+      : m_directory(File::CreateTempDir()), m_path(m_directory + "/texture.tex")
+  {
+  }
+
+  ~CustomTextureDataTest() override
+  {
+    if (!m_directory.empty())
+      File::DeleteDirRecursively(m_directory);
+  }
+
+  const std::string m_directory;
+  const std::string m_path;
+};
+}  // namespace
+
+TEST_F(CustomTextureDataTest, CachedTextureRoundTrip)
+{
+  const VideoCommon::CustomTextureData::ArraySlice slice = MakeSlice();
+  ASSERT_TRUE(VideoCommon::SaveCachedTexture(slice, m_path, 1234));
+
+  VideoCommon::CustomTextureData::ArraySlice loaded;
+  ASSERT_TRUE(VideoCommon::LoadCachedTexture(&loaded, m_path, 1234));
+  ASSERT_EQ(loaded.m_levels.size(), slice.m_levels.size());
+  for (size_t i = 0; i < slice.m_levels.size(); ++i)
+  {
+    EXPECT_EQ(loaded.m_levels[i].format, slice.m_levels[i].format);
+    EXPECT_EQ(loaded.m_levels[i].width, slice.m_levels[i].width);
+    EXPECT_EQ(loaded.m_levels[i].height, slice.m_levels[i].height);
+    EXPECT_EQ(loaded.m_levels[i].row_length, slice.m_levels[i].row_length);
+    EXPECT_EQ(loaded.m_levels[i].data, slice.m_levels[i].data);
+  }
+}
+
+TEST_F(CustomTextureDataTest, CachedTextureIsStale)
+{
+  ASSERT_TRUE(VideoCommon::SaveCachedTexture(MakeSlice(), m_path, 1234));
+
+  // The source texture changed since it was cached.
+  VideoCommon::CustomTextureData::ArraySlice loaded;
+  EXPECT_FALSE(VideoCommon::LoadCachedTexture(&loaded, m_path, 5678));
+  EXPECT_TRUE(loaded.m_levels.empty());
+}
+
+TEST_F(CustomTextureDataTest, CachedTextureIsTruncated)
+{
+  ASSERT_TRUE(VideoCommon::SaveCachedTexture(MakeSlice(), m_path, 1234));
+  {
+    File::IOFile file(m_path, "r+b");
+    ASSERT_TRUE(file.Resize(file.GetSize() - 1));
+  }
+
+  VideoCommon::CustomTextureData::ArraySlice loaded;
+  EXPECT_FALSE(VideoCommon::LoadCachedTexture(&loaded, m_path, 1234));
+}
+
+TEST_F(CustomTextureDataTest, CachedTextureLevelsAreMappable)
+{
+  const VideoCommon::CustomTextureData::ArraySlice slice = MakeSlice();
+  ASSERT_TRUE(VideoCommon::SaveCachedTexture(slice, m_path, 1234));
+
+  // The levels are stored as they are, at aligned offsets, so they can be used from a mapping.
+  std::string contents;
+  ASSERT_TRUE(File::ReadFileToString(m_path, contents));
+  auto start = contents.cbegin();
+  for (const VideoCommon::CustomTextureData::ArraySlice::Level& level : slice.m_levels)
+  {
+    const auto it = std::search(start, contents.cend(), level.data.begin(), level.data.end(),
+                                [](char a, u8 b) { return static_cast<u8>(a) == b; });
+    ASSERT_NE(it, contents.cend());
+    EXPECT_EQ((it - contents.cbegin()) % 16, 0);
+    start = it + level.data.size();
+  }
+}
+
+TEST_F(CustomTextureDataTest, CachedTextureLeavesNoTemporaryFiles)
+{
+  ASSERT_TRUE(VideoCommon::SaveCachedTexture(MakeSlice(), m_path, 1234));
+  ASSERT_TRUE(VideoCommon::SaveCachedTexture(MakeSlice(), m_path, 5678));
+
+  const File::FSTEntry directory = File::ScanDirectoryTree(m_directory, false);
+  ASSERT_EQ(directory.children.size(), 1u);
+  EXPECT_EQ(directory.children[0].virtualName, "texture.tex");
+
+  VideoCommon::CustomTextureData::ArraySlice loaded;
+  EXPECT_TRUE(VideoCommon::LoadCachedTexture(&loaded, m_path, 5678));
+}
@@ -0,0 +1,181 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/IOFile.h"
+#include "VideoCommon/FrameCapture.h"
+
+class FrameCaptureTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_path = File::CreateTempDir() + "/capture.dfc";
+    ASSERT_FALSE(m_path.empty());
+  }
+
+  void TearDown() override { File::DeleteDirRecursively(m_path.substr(0, m_path.rfind('/'))); }
+
+  static std::vector<u8> MakeFrame(u32 width, u32 height, u32 stride, u8 seed)
+  {
+    std::vector<u8> data(size_t{stride} * height, 0xCD);
+    for (u32 y = 0; y < height; ++y)
+    {
+      for (u32 x = 0; x < width * 4; ++x)
+        data[size_t{y} * stride + x] = static_cast<u8>(x * 7 + y * 13 + seed);
+    }
+    return data;
+  }
+
+  std::string m_path;
+};
+
+TEST_F(FrameCaptureTest, RoundTrip)
+{
+  constexpr u32 WIDTH = 64;
+  constexpr u32 HEIGHT = 48;
+  constexpr u32 STRIDE = 80 * 4;
+
+  {
+    FrameCapture::Writer writer;
+    ASSERT_TRUE(writer.Open(m_path));
+    for (u8 i = 0; i < 3; ++i)
+    {
+      const std::vector<u8> frame = MakeFrame(WIDTH, HEIGHT, STRIDE, i);
+      EXPECT_TRUE(writer.AddFrame(frame.data(), WIDTH, HEIGHT, STRIDE, i * 1000, i + 10));
+    }
+    EXPECT_TRUE(writer.Close());
+  }
+
+  FrameCapture::Reader reader;
+  ASSERT_TRUE(reader.Open(m_path));
+  ASSERT_EQ(reader.GetFrameCount(), 3u);
+
+  std::vector<u8> pixels;
+  for (u8 i = 0; i < 3; ++i)
+  {
+    const FrameCapture::FrameCaptureIndexEntry& entry = reader.GetFrame(i);
+    EXPECT_EQ(entry.width, WIDTH);
+    EXPECT_EQ(entry.height, HEIGHT);
+    EXPECT_EQ(entry.ticks, i * 1000u);
+    EXPECT_EQ(entry.frame_number, i + 10);
+
+    ASSERT_TRUE(reader.ReadFrame(i, &pixels));
+    // The row padding is dropped.
+    EXPECT_EQ(pixels, MakeFrame(WIDTH, HEIGHT, WIDTH * 4, i));
+  }
+}
+
+TEST_F(FrameCaptureTest, UnclosedCaptureIsRejected)
+{
+  FrameCapture::Writer writer;
+  ASSERT_TRUE(writer.Open(m_path));
+  const std::vector<u8> frame = MakeFrame(16, 16, 16 * 4, 0);
+  ASSERT_TRUE(writer.AddFrame(frame.data(), 16, 16, 16 * 4, 0, 0));
+
+  FrameCapture::Reader reader;
+  EXPECT_FALSE(reader.Open(m_path));
+}
+
+TEST_F(FrameCaptureTest, CorruptFrameIsDetected)
+{
+  {
+    FrameCapture::Writer writer;
+    ASSERT_TRUE(writer.Open(m_path));
+    const std::vector<u8> frame = MakeFrame(16, 16, 16 * 4, 0);
+    ASSERT_TRUE(writer.AddFrame(frame.data(), 16, 16, 16 * 4, 0, 0));
+    ASSERT_TRUE(writer.Close());
+  }
+
+  FrameCapture::Reader reader;
+  ASSERT_TRUE(reader.Open(m_path));
+  const FrameCapture::FrameCaptureIndexEntry entry = reader.GetFrame(0);
+
+  // Flip a byte in the middle of the compressed frame.
+  {
+    File::IOFile file(m_path, "r+b");
+    std::vector<u8> data(entry.compressed_size);
+    ASSERT_TRUE(file.Seek(entry.data_offset, File::SeekOrigin::Begin));
+    ASSERT_TRUE(file.ReadBytes(data.data(), data.size()));
+    data[data.size() / 2] ^= 0xFF;
+    ASSERT_TRUE(file.Seek(entry.data_offset, File::SeekOrigin::Begin));
+    ASSERT_TRUE(file.WriteBytes(data.data(), data.size()));
+  }
+
+  ASSERT_TRUE(reader.Open(m_path));
+  std::vector<u8> pixels;
+  EXPECT_FALSE(reader.ReadFrame(0, &pixels));
+}
+
+TEST_F(FrameCaptureTest, OutOfBoundsIndexIsRejected)
+{
+  {
+    FrameCapture::Writer writer;
+    ASSERT_TRUE(writer.Open(m_path));
+    const std::vector<u8> frame = MakeFrame(16, 16, 16 * 4, 0);
+    ASSERT_TRUE(writer.AddFrame(frame.data(), 16, 16, 16 * 4, 0, 0));
+    ASSERT_TRUE(writer.Close());
+  }
+
+  FrameCapture::FrameCaptureHeader header;
+  FrameCapture::FrameCaptureIndexEntry entry;
+  {
+    File::IOFile file(m_path, "rb");
+    ASSERT_TRUE(file.ReadArray(&header, 1));
+    ASSERT_TRUE(file.Seek(header.index_offset, File::SeekOrigin::Begin));
+    ASSERT_TRUE(file.ReadArray(&entry, 1));
+  }
+
+  const auto write_capture = [&](const FrameCapture::FrameCaptureHeader& new_header,
+                                 const FrameCapture::FrameCaptureIndexEntry& new_entry) {
+    File::IOFile file(m_path, "r+b");
+    ASSERT_TRUE(file.WriteArray(&new_header, 1));
+    ASSERT_TRUE(file.Seek(header.index_offset, File::SeekOrigin::Begin));
+    ASSERT_TRUE(file.WriteArray(&new_entry, 1));
+  };
+
+  FrameCapture::Reader reader;
+
+  // More frames than fit between the index offset and the end of the file
+  FrameCapture::FrameCaptureHeader bad_header = header;
+  bad_header.frame_count = 0x10000000;
+  write_capture(bad_header, entry);
+  EXPECT_FALSE(reader.Open(m_path));
+
+  bad_header = header;
+  bad_header.index_offset = 0x100000000;
+  write_capture(bad_header, entry);
+  EXPECT_FALSE(reader.Open(m_path));
+
+  // A frame that overlaps the index
+  FrameCapture::FrameCaptureIndexEntry bad_entry = entry;
+  bad_entry.compressed_size += 1;
+  write_capture(header, bad_entry);
+  EXPECT_FALSE(reader.Open(m_path));
+
+  bad_entry = entry;
+  bad_entry.data_offset = 0xFFFFFFFFFFFFFFF0;
+  write_capture(header, bad_entry);
+  EXPECT_FALSE(reader.Open(m_path));
+
+  // Dimensions that don't match the compressed frame are rejected before anything is allocated
+  bad_entry = entry;
+  bad_entry.width = 0x10000;
+  bad_entry.height = 0x10000;
+  write_capture(header, bad_entry);
+  ASSERT_TRUE(reader.Open(m_path));
+  std::vector<u8> pixels;
+  EXPECT_FALSE(reader.ReadFrame(0, &pixels));
+  EXPECT_TRUE(pixels.empty());
+  EXPECT_FALSE(reader.ReadFrame(1, &pixels));
+
+  write_capture(header, entry);
+  ASSERT_TRUE(reader.Open(m_path));
+  EXPECT_TRUE(reader.ReadFrame(0, &pixels));
+}
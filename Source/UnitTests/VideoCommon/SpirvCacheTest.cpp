@@ -0,0 +1,136 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "VideoCommon/SpirvCache.h"
+
+namespace
+{
+SPIRV::SharedCache::Key MakeKey(u8 value)
+{
+  SPIRV::SharedCache::Key key{};
+  key[0] = value;
+  return key;
+}
+
+// 1 KiB of code per shader
+SPIRV::CodeVector MakeCode(u8 value)
+{
+  return SPIRV::CodeVector(256, value);
+}
+
+class SpirvCacheTest : public testing::Test
+{
+protected:
+  SpirvCacheTest()
+      : m_directory(File::CreateTempDir()), m_path(m_directory + "/spirv-shared.cache")
+  {
+  }
+
+  ~SpirvCacheTest() override
+  {
+    if (!m_directory.empty())
+      File::DeleteDirRecursively(m_directory);
+  }
+
+  const std::string m_directory;
+  const std::string m_path;
+};
+}  // namespace
+
+TEST_F(SpirvCacheTest, HitsAndMisses)
+{
+  SPIRV::SharedCache cache;
+  cache.Open(m_path, 1024 * 1024);
+
+  EXPECT_FALSE(cache.Lookup(MakeKey(1)));
+  cache.Insert(MakeKey(1), MakeCode(1));
+  EXPECT_EQ(cache.Lookup(MakeKey(1)), MakeCode(1));
+  EXPECT_FALSE(cache.Lookup(MakeKey(2)));
+
+  const SPIRV::SharedCache::Statistics statistics = cache.GetStatistics();
+  EXPECT_EQ(statistics.hits, 1u);
+  EXPECT_EQ(statistics.misses, 2u);
+  EXPECT_EQ(statistics.evictions, 0u);
+}
+
+TEST_F(SpirvCacheTest, Persistence)
+{
+  {
+    SPIRV::SharedCache cache;
+    cache.Open(m_path, 1024 * 1024);
+    cache.Insert(MakeKey(1), MakeCode(1));
+    cache.Insert(MakeKey(2), MakeCode(2));
+  }
+
+  SPIRV::SharedCache cache;
+  cache.Open(m_path, 1024 * 1024);
+  EXPECT_EQ(cache.Lookup(MakeKey(1)), MakeCode(1));
+  EXPECT_EQ(cache.Lookup(MakeKey(2)), MakeCode(2));
+}
+
+TEST_F(SpirvCacheTest, EvictsLeastRecentlyUsed)
+{
+  // Room for four shaders, and eviction down to 90% only has to evict one of them.
+  constexpr u64 MAX_SIZE = 4 * 1024 + 512;
+
+  {
+    SPIRV::SharedCache cache;
+    cache.Open(m_path, MAX_SIZE);
+    for (u8 i = 0; i < 4; ++i)
+      cache.Insert(MakeKey(i), MakeCode(i));
+  }
+
+  {
+    // Using shader 0 in the next session makes shader 1 the least recently used one.
+    SPIRV::SharedCache cache;
+    cache.Open(m_path, MAX_SIZE);
+    EXPECT_TRUE(cache.Lookup(MakeKey(0)));
+  }
+
+  {
+    SPIRV::SharedCache cache;
+    cache.Open(m_path, MAX_SIZE);
+    cache.Insert(MakeKey(4), MakeCode(4));
+    EXPECT_EQ(cache.GetStatistics().evictions, 1u);
+    EXPECT_FALSE(cache.Lookup(MakeKey(1)));
+  }
+
+  // The evicted shader stays gone after compaction, and the rest survive it.
+  SPIRV::SharedCache cache;
+  cache.Open(m_path, MAX_SIZE);
+  EXPECT_FALSE(cache.Lookup(MakeKey(1)));
+  for (u8 i : {0, 2, 3, 4})
+    EXPECT_EQ(cache.Lookup(MakeKey(i)), MakeCode(i));
+}
+
+TEST_F(SpirvCacheTest, UsageRecordsAreCompacted)
+{
+  {
+    SPIRV::SharedCache cache;
+    cache.Open(m_path, 1024 * 1024);
+    cache.Insert(MakeKey(1), MakeCode(1));
+  }
+  const u64 size_with_shader = File::GetSize(m_path);
+
+  // Every session that uses the shader appends a usage record for it. Once there are more usage
+  // records than shaders, the file is rewritten without them.
+  constexpr int SESSIONS = 10;
+  for (int i = 0; i < SESSIONS; ++i)
+  {
+    SPIRV::SharedCache cache;
+    cache.Open(m_path, 1024 * 1024);
+    EXPECT_EQ(cache.Lookup(MakeKey(1)), MakeCode(1));
+  }
+
+  EXPECT_LT(File::GetSize(m_path), size_with_shader + 3 * sizeof(SPIRV::SharedCache::Key));
+
+  SPIRV::SharedCache cache;
+  cache.Open(m_path, 1024 * 1024);
+  EXPECT_EQ(cache.Lookup(MakeKey(1)), MakeCode(1));
+}
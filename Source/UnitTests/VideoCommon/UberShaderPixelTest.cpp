@@ -0,0 +1,86 @@
+// Copyright 2024 Dolphin Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/UberShaderPixel.h"
+
+using UberShader::PixelShaderUid;
+
+namespace
+{
+PixelShaderUid CreateGenericUid(u32 num_texgens)
+{
+  PixelShaderUid uid;
+  UberShader::pixel_ubershader_uid_data* const uid_data = uid.GetUidData();
+  uid_data->num_texgens = num_texgens;
+  uid_data->early_depth = 1;
+  uid_data->no_dual_src = 1;
+  return uid;
+}
+
+void SetTevStages(u32 num_stages)
+{
+  std::memset(&bpmem, 0, sizeof(bpmem));
+  bpmem.genMode.numtevstages = num_stages - 1;
+}
+}  // namespace
+
+TEST(UberShaderPixel, VariantLimitsTevStages)
+{
+  // The smallest of 16, 8, 4 or 2 stages that still covers every active stage
+  static constexpr u32 max_stages[16] = {2, 2, 4, 4, 8, 8, 8, 8, 16, 16, 16, 16, 16, 16, 16, 16};
+
+  const PixelShaderUid generic_uid = CreateGenericUid(0);
+  for (u32 num_stages = 1; num_stages <= 16; num_stages++)
+  {
+    SetTevStages(num_stages);
+    const PixelShaderUid variant_uid = UberShader::GetPixelShaderVariantUid(generic_uid);
+    EXPECT_EQ(variant_uid.GetUidData()->GetMaxTevStages(), max_stages[num_stages - 1])
+        << num_stages << " stages";
+  }
+}
+
+TEST(UberShaderPixel, VariantLeavesOutUnusedIndirectStages)
+{
+  SetTevStages(2);
+
+  // Without texgens, the ubershader doesn't do any indirect texturing anyway.
+  bpmem.tevind[0].fb_addprev = true;
+  EXPECT_FALSE(UberShader::GetPixelShaderVariantUid(CreateGenericUid(0))
+                   .GetUidData()
+                   ->no_indirect_stages);
+
+  // An active stage with indirect texturing needs it.
+  EXPECT_FALSE(UberShader::GetPixelShaderVariantUid(CreateGenericUid(4))
+                   .GetUidData()
+                   ->no_indirect_stages);
+
+  // Inactive stages don't count.
+  bpmem.tevind[0].hex = 0;
+  bpmem.tevind[2].fb_addprev = true;
+  EXPECT_TRUE(UberShader::GetPixelShaderVariantUid(CreateGenericUid(4))
+                  .GetUidData()
+                  ->no_indirect_stages);
+}
+
+TEST(UberShaderPixel, VariantKeepsGenericFields)
+{
+  SetTevStages(1);
+
+  for (u32 num_texgens = 0; num_texgens <= 8; num_texgens++)
+  {
+    const PixelShaderUid generic_uid = CreateGenericUid(num_texgens);
+    PixelShaderUid variant_uid = UberShader::GetPixelShaderVariantUid(generic_uid);
+
+    // Clearing the variant selection gives back the generic ubershader.
+    EXPECT_NE(variant_uid, generic_uid);
+    variant_uid.GetUidData()->tev_stage_limit = 0;
+    variant_uid.GetUidData()->no_indirect_stages = 0;
+    EXPECT_EQ(variant_uid, generic_uid) << num_texgens << " texgens";
+  }
+}